@@ -0,0 +1,130 @@
+#include <pcp-test/results_comparison.hpp>
+#include <pcp-test/results_document.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/program_options.hpp>
+
+#include <string>
+
+namespace pcp_test {
+
+namespace po = boost::program_options;
+
+// Exit codes, for gating
+static const int NO_REGRESSIONS {0};
+static const int REGRESSIONS {1};
+static const int COMPARISON_ERROR {2};
+
+static void display_set(const std::string& name, const results_set& r_s)
+{
+    boost::nowide::cout << name << ": " << r_s.test << " test, pcp-test "
+                        << r_s.pcp_test_version << ", started at " << r_s.start
+                        << ", " << r_s.runs.size() << " runs\n";
+
+    for (const auto& uri : r_s.broker_ws_uris)
+        boost::nowide::cout << "  broker " << uri << "\n";
+}
+
+// Compare the JSON results files of two tests, as written by the
+// connection test, and flag the regressions of the candidate
+int main(int argc, char **argv)
+{
+    // Fix args on Windows to be UTF-8
+    boost::nowide::args arg_utf8 {argc, argv};
+
+    comparison_thresholds t {};
+    std::string baseline_path {};
+    std::string candidate_path {};
+
+    po::options_description options {"Options"};
+    options.add_options()
+        ("help,h", "display help")
+        ("max-throughput-drop-pct",
+         po::value<double>(&t.max_throughput_drop_pct)
+             ->default_value(t.max_throughput_drop_pct),
+         "flag throughput drops greater than this [%]")
+        ("max-latency-increase-pct",
+         po::value<double>(&t.max_latency_increase_pct)
+             ->default_value(t.max_latency_increase_pct),
+         "flag latency increases greater than this [%]")
+        ("min-latency-increase-ms",
+         po::value<double>(&t.min_latency_increase_ms)
+             ->default_value(t.min_latency_increase_ms),
+         "ignore latency increases not greater than this [ms]")
+        ("max-failure-rate-increase-pct",
+         po::value<double>(&t.max_failure_rate_increase_pct)
+             ->default_value(t.max_failure_rate_increase_pct),
+         "flag failure rate increases greater than this [percentage points]");
+
+    po::options_description files {};
+    files.add_options()
+        ("baseline", po::value<std::string>(&baseline_path)->required())
+        ("candidate", po::value<std::string>(&candidate_path)->required());
+
+    po::options_description all {};
+    all.add(options).add(files);
+
+    po::positional_options_description positional {};
+    positional.add("baseline", 1).add("candidate", 1);
+
+    po::variables_map vm {};
+
+    try {
+        po::store(po::command_line_parser(argc, argv)
+                      .options(all).positional(positional).run(), vm);
+
+        if (vm.count("help")) {
+            boost::nowide::cout << "Usage: pcp-test-compare [options] "
+                                   "<baseline file> <candidate file>\n\n"
+                                << options << std::endl;
+            return NO_REGRESSIONS;
+        }
+
+        po::notify(vm);
+    } catch (const po::error& e) {
+        boost::nowide::cerr << "Invalid arguments: " << e.what() << "\n"
+                            << "Usage: pcp-test-compare [options] "
+                               "<baseline file> <candidate file>" << std::endl;
+        return COMPARISON_ERROR;
+    }
+
+    try {
+        auto baseline = load_results(baseline_path);
+        auto candidate = load_results(candidate_path);
+
+        display_set("baseline", baseline);
+        display_set("candidate", candidate);
+
+        if (baseline.test != candidate.test) {
+            boost::nowide::cerr << "Cannot compare results of different tests ("
+                                << baseline.test << ", " << candidate.test << ")"
+                                << std::endl;
+            return COMPARISON_ERROR;
+        }
+
+        auto comparison = compare_results(baseline.runs, candidate.runs, t);
+        boost::nowide::cout << "\n" << comparison;
+
+        if (comparison.changes.empty()) {
+            boost::nowide::cerr << "No runs to compare" << std::endl;
+            return COMPARISON_ERROR;
+        }
+
+        auto regressions = comparison.has_regressions();
+        boost::nowide::cout << "\n" << (regressions ? "REGRESSIONS" : "no regressions")
+                            << std::endl;
+        return regressions ? REGRESSIONS : NO_REGRESSIONS;
+    } catch (const fatal_error& e) {
+        boost::nowide::cerr << "Fatal error: " << e.what() << std::endl;
+        return COMPARISON_ERROR;
+    }
+}
+
+}  // namespace pcp_test
+
+int main(int argc, char** argv)
+{
+    return pcp_test::main(argc, argv);
+}
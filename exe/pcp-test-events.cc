@@ -0,0 +1,49 @@
+#include <pcp-test/event_recorder.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+
+#include <stdexcept>
+
+namespace pcp_test {
+
+// Convert a connection events file, as recorded by the connection
+// test with the event-log parameter, to CSV on the standard output
+int main(int argc, char **argv)
+{
+    // Fix args on Windows to be UTF-8
+    boost::nowide::args arg_utf8 {argc, argv};
+
+    if (argc != 2) {
+        boost::nowide::cerr << "Usage: pcp-test-events <events file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    boost::nowide::ifstream in_stream {argv[1], std::ios::binary};
+
+    if (!in_stream.is_open()) {
+        boost::nowide::cerr << "Failed to open " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        boost::nowide::cout << "timestamp_us,endpoint_id,duration_us,run,"
+                               "phase,outcome\n";
+        convert_events_to_csv(in_stream, boost::nowide::cout);
+        boost::nowide::cout.flush();
+    } catch (const fatal_error& e) {
+        boost::nowide::cerr << "Fatal error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+}  // namespace pcp_test
+
+int main(int argc, char** argv)
+{
+    return pcp_test::main(argc, argv);
+}
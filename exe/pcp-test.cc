@@ -1,6 +1,11 @@
 #include <pcp-test/configuration.hpp>
 #include <pcp-test/test_trivial.hpp>
 #include <pcp-test/test_connection.hpp>
+#include <pcp-test/test_throughput.hpp>
+#include <pcp-test/test_fanout.hpp>
+#include <pcp-test/test_soak.hpp>
+#include <pcp-test/test_scenario.hpp>
+#include <pcp-test/distributed.hpp>
 #include <pcp-test/pcp-test.hpp>
 #include <pcp-test/errors.hpp>
 
@@ -26,6 +31,21 @@ void start(const application_options& a_o)
         case (test_type::connection):
             run_connection_test(a_o);
             break;
+        case (test_type::throughput):
+            run_throughput_test(a_o);
+            break;
+        case (test_type::fanout):
+            run_fanout_test(a_o);
+            break;
+        case (test_type::soak):
+            run_soak_test(a_o);
+            break;
+        case (test_type::scenario):
+            run_scenario_test(a_o);
+            break;
+        case (test_type::worker):
+            run_worker(a_o);
+            break;
         default:
             assert(false);
     }
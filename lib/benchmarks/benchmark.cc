@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>  // std::move
+
+namespace pcp_test {
+namespace benchmarks {
+
+using clock_type = std::chrono::steady_clock;
+
+std::vector<benchmark>& registry()
+{
+    // NB: function-local, so that registrations of any translation
+    // unit find it initialized
+    static std::vector<benchmark> benchmarks {};
+    return benchmarks;
+}
+
+registration::registration(std::string name, double max_ns_per_op, body_type body)
+{
+    registry().push_back(benchmark {std::move(name), max_ns_per_op, std::move(body)});
+}
+
+bool result::regressed(double threshold_scale) const
+{
+    return ns_per_op > max_ns_per_op * threshold_scale;
+}
+
+static double measure_ns(const benchmark& b, uint64_t iterations)
+{
+    auto start = clock_type::now();
+    b.body(iterations);
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock_type::now() - start).count());
+}
+
+void run_concurrently(unsigned int num_threads, uint64_t iterations,
+                      const body_type& body)
+{
+    std::mutex mtx {};
+    std::condition_variable cv {};
+    bool go {false};
+    std::vector<std::thread> threads {};
+
+    for (unsigned int idx = 0; idx < num_threads; idx++) {
+        auto share = iterations / num_threads + (idx < iterations % num_threads ? 1 : 0);
+        threads.push_back(std::thread([&mtx, &cv, &go, &body, share]() {
+            {
+                std::unique_lock<std::mutex> lck {mtx};
+                cv.wait(lck, [&go]() { return go; });
+            }
+            body(share);
+        }));
+    }
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx};
+        go = true;
+    }
+    cv.notify_all();
+
+    for (auto& t : threads)
+        t.join();
+}
+
+result run(const benchmark& b, unsigned int min_duration_ms, unsigned int repetitions)
+{
+    const double min_duration_ns {min_duration_ms * 1e6};
+    uint64_t iterations {1};
+    auto elapsed_ns = measure_ns(b, iterations);
+
+    // Calibrate; the first runs also warm up caches and allocators
+    while (elapsed_ns < min_duration_ns) {
+        auto factor = elapsed_ns > 0
+                      ? std::min(10.0, std::max(2.0, 1.2 * min_duration_ns / elapsed_ns))
+                      : 10.0;
+        iterations = static_cast<uint64_t>(iterations * factor);
+        elapsed_ns = measure_ns(b, iterations);
+    }
+
+    auto best_ns = elapsed_ns;
+
+    for (unsigned int idx = 1; idx < repetitions; idx++)
+        best_ns = std::min(best_ns, measure_ns(b, iterations));
+
+    return result {b.name, iterations, best_ns / iterations, b.max_ns_per_op};
+}
+
+}  // namespace benchmarks
+}  // namespace pcp_test
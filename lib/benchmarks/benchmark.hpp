@@ -0,0 +1,64 @@
+/**
+ * @file
+ * Minimal harness for measuring the cost per operation of pcp-test's
+ * hot paths, with regression thresholds.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+namespace benchmarks {
+
+// A benchmark body executes the measured operation `iterations` times,
+// in total across the threads it may start.
+using body_type = std::function<void(uint64_t iterations)>;
+
+struct benchmark
+{
+    std::string name;
+    double max_ns_per_op;  // regression threshold
+    body_type body;
+};
+
+// Registers a benchmark at static initialization time; define one
+// instance per benchmark, at namespace scope.
+struct registration
+{
+    registration(std::string name, double max_ns_per_op, body_type body);
+};
+
+std::vector<benchmark>& registry();
+
+struct result
+{
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;      // best of the repetitions
+    double max_ns_per_op;
+
+    bool regressed(double threshold_scale) const;
+};
+
+// The number of iterations is calibrated so that a repetition lasts at
+// least `min_duration_ms`; the best of `repetitions` is reported.
+result run(const benchmark& b, unsigned int min_duration_ms, unsigned int repetitions);
+
+// Split the iterations across the specified number of threads, that
+// start executing the body together; return once all are done.
+void run_concurrently(unsigned int num_threads, uint64_t iterations,
+                      const body_type& body);
+
+// Prevents the compiler from optimizing away the computation of value
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace benchmarks
+}  // namespace pcp_test
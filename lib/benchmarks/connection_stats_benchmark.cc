@@ -0,0 +1,65 @@
+#include "benchmark.hpp"
+
+#include <pcp-test/connection_stats.hpp>
+
+namespace pcp_test {
+namespace benchmarks {
+
+static registration accumulate_single_thread {
+    "connection_timings_accumulator::accumulate_tcp_us - 1 thread", 500,
+    [](uint64_t iterations)
+    {
+        connection_timings_accumulator acc {};
+
+        for (uint64_t idx = 0; idx < iterations; idx++)
+            acc.accumulate_tcp_us(static_cast<uint32_t>(idx & 0xffff));
+    }};
+
+static registration accumulate_contended {
+    "connection_timings_accumulator::accumulate_tcp_us - 4 threads", 5000,
+    [](uint64_t iterations)
+    {
+        connection_timings_accumulator acc {};
+
+        run_concurrently(4, iterations, [&acc](uint64_t n)
+        {
+            for (uint64_t idx = 0; idx < n; idx++)
+                acc.accumulate_tcp_us(static_cast<uint32_t>(idx & 0xffff));
+        });
+    }};
+
+// Sharded accumulation, as done by Connection Tasks, for comparison
+static registration accumulate_sharded {
+    "connection_timings_shard::accumulate_tcp_us - 4 threads", 500,
+    [](uint64_t iterations)
+    {
+        connection_timings_accumulator acc {};
+
+        run_concurrently(4, iterations, [&acc](uint64_t n)
+        {
+            auto shard = acc.get_shard();
+
+            for (uint64_t idx = 0; idx < n; idx++)
+                shard->accumulate_tcp_us(static_cast<uint32_t>(idx & 0xffff));
+
+            shard->seal();
+        });
+    }};
+
+static registration stats_from_accumulator {
+    "connection_timings_accumulator::get_connection_stats - 1000 timings", 500000,
+    [](uint64_t iterations)
+    {
+        connection_timings_accumulator acc {};
+
+        for (uint32_t idx = 0; idx < 1000; idx++)
+            acc.accumulate_association_ms(idx);
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            auto s = acc.get_connection_stats();
+            do_not_optimize(s);
+        }
+    }};
+
+}  // namespace benchmarks
+}  // namespace pcp_test
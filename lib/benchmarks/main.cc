@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+namespace bm = pcp_test::benchmarks;
+
+static const char* USAGE {
+    "Usage: pcp-test_benchmarks [options]\n"
+    "  --filter <text>           run only the benchmarks whose name contains text\n"
+    "  --min-duration-ms <ms>    minimum duration of a repetition (default 200)\n"
+    "  --repetitions <n>         repetitions per benchmark; the best is reported (default 3)\n"
+    "  --threshold-scale <x>     scale the regression thresholds; 0 disables them (default 1)\n"
+    "  --list                    list the benchmarks and their thresholds\n"};
+
+int main(int argc, char** argv) {
+    std::string filter {};
+    unsigned int min_duration_ms {200};
+    unsigned int repetitions {3};
+    double threshold_scale {1.0};
+    bool list {false};
+
+    for (int idx = 1; idx < argc; idx++) {
+        std::string arg {argv[idx]};
+        bool has_value {idx + 1 < argc};
+
+        if (arg == "--filter" && has_value) {
+            filter = argv[++idx];
+        } else if (arg == "--min-duration-ms" && has_value) {
+            min_duration_ms = static_cast<unsigned int>(std::strtoul(argv[++idx], nullptr, 10));
+        } else if (arg == "--repetitions" && has_value) {
+            repetitions = static_cast<unsigned int>(std::strtoul(argv[++idx], nullptr, 10));
+        } else if (arg == "--threshold-scale" && has_value) {
+            threshold_scale = std::strtod(argv[++idx], nullptr);
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            std::cerr << USAGE;
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    boost::format row_fmt {"%-68s %12s %12s %12s  %s\n"};
+    std::cout << (row_fmt % "benchmark" % "iterations" % "ns/op" % "max ns/op" % "").str();
+    int num_regressions {0};
+    int num_failures {0};
+
+    for (const auto& b : bm::registry()) {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos)
+            continue;
+
+        if (list) {
+            std::cout << (row_fmt % b.name % "-" % "-" % b.max_ns_per_op % "").str();
+            continue;
+        }
+
+        bm::result r {};
+
+        try {
+            r = bm::run(b, min_duration_ms, std::max(1u, repetitions));
+        } catch (const std::exception& e) {
+            std::cout << (row_fmt % b.name % "-" % "-" % b.max_ns_per_op % "FAILED").str()
+                      << "    " << e.what() << "\n" << std::flush;
+            num_failures++;
+            continue;
+        }
+
+        auto regressed = threshold_scale > 0 && r.regressed(threshold_scale);
+
+        if (regressed)
+            num_regressions++;
+
+        std::cout << (row_fmt % r.name % r.iterations
+                      % (boost::format("%.1f") % r.ns_per_op).str()
+                      % (r.max_ns_per_op * threshold_scale)
+                      % (regressed ? "REGRESSION" : "")).str()
+                  << std::flush;
+    }
+
+    if (num_failures)
+        std::cout << "\n" << num_failures << " benchmarks failed\n";
+
+    if (num_regressions)
+        std::cout << "\n" << num_regressions << " benchmarks exceeded their threshold\n";
+
+    if (num_failures || num_regressions)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
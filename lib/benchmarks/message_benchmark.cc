@@ -0,0 +1,132 @@
+#include "benchmark.hpp"
+
+#include <pcp-test/message.hpp>
+#include <pcp-test/schemas.hpp>
+
+#include <cpp-pcp-client/protocol/chunks.hpp>
+
+#include <string>
+
+namespace pcp_test {
+namespace benchmarks {
+
+static const std::string SENDER {"pcp://controller0001/throughput_controller"};
+static const std::string TRANSACTION {"controller0001_1234567"};
+static const std::string PAYLOAD(256, 'x');
+
+static message make_request()
+{
+    message msg {schemas::REQUEST_TYPE, SENDER, TRANSACTION};
+    msg.set_payload(PAYLOAD);
+    msg.set_send_info(42);
+    return msg;
+}
+
+static PCPClient::ParsedChunks make_parsed_response(bool binary)
+{
+    PCPClient::ParsedChunks parsed_chunks {};
+    auto msg = make_request();
+    auto message_type = binary ? schemas::BINARY_RESPONSE_TYPE : schemas::RESPONSE_TYPE;
+
+    parsed_chunks.envelope.set<std::string>("id", msg.id());
+    parsed_chunks.envelope.set<std::string>("message_type", message_type);
+    parsed_chunks.envelope.set<std::string>("sender", SENDER);
+    parsed_chunks.has_data     = true;
+    parsed_chunks.invalid_data = false;
+
+    if (binary) {
+        parsed_chunks.data_type   = PCPClient::ContentType::Binary;
+        parsed_chunks.binary_data = msg.get_binary_data();
+    } else {
+        parsed_chunks.data_type = PCPClient::ContentType::Json;
+        parsed_chunks.data      = msg.get_data();
+    }
+
+    return parsed_chunks;
+}
+
+// Includes the UUID generation and the formatting of the timestamp
+static registration construction {
+    "message - construction of a request", 20000,
+    [](uint64_t iterations)
+    {
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            message msg {schemas::REQUEST_TYPE, SENDER, TRANSACTION};
+            do_not_optimize(msg);
+        }
+    }};
+
+static registration json_serialization {
+    "message::get_data - JSON serialization, 256 bytes payload", 20000,
+    [](uint64_t iterations)
+    {
+        auto msg = make_request();
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            auto serialized = msg.get_data().toString();
+            do_not_optimize(serialized);
+        }
+    }};
+
+static registration binary_serialization {
+    "message::write_binary_data - 256 bytes payload", 1000,
+    [](uint64_t iterations)
+    {
+        std::string buffer {};
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            message::write_binary_data(buffer, TRANSACTION, idx, 1234567890123, PAYLOAD);
+            do_not_optimize(buffer);
+        }
+    }};
+
+static registration json_parsing {
+    "message - parsing of a JSON response", 20000,
+    [](uint64_t iterations)
+    {
+        auto parsed_chunks = make_parsed_response(false);
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            message msg {parsed_chunks};
+            do_not_optimize(msg);
+        }
+    }};
+
+static registration binary_parsing {
+    "message - parsing of a binary response", 10000,
+    [](uint64_t iterations)
+    {
+        auto parsed_chunks = make_parsed_response(true);
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            message msg {parsed_chunks};
+            do_not_optimize(msg);
+        }
+    }};
+
+static registration json_view {
+    "message_view - parsing of a JSON response", 5000,
+    [](uint64_t iterations)
+    {
+        auto parsed_chunks = make_parsed_response(false);
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            message_view view {parsed_chunks};
+            do_not_optimize(view.transaction());
+        }
+    }};
+
+static registration binary_view {
+    "message_view - parsing of a binary response", 1000,
+    [](uint64_t iterations)
+    {
+        auto parsed_chunks = make_parsed_response(true);
+
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            message_view view {parsed_chunks};
+            do_not_optimize(view.transaction());
+        }
+    }};
+
+}  // namespace benchmarks
+}  // namespace pcp_test
@@ -0,0 +1,19 @@
+#include "benchmark.hpp"
+
+#include <pcp-test/random.hpp>
+
+namespace pcp_test {
+namespace benchmarks {
+
+static registration exponential_generation {
+    "exponential_integers - generation", 500,
+    [](uint64_t iterations)
+    {
+        exponential_integers rng {100.0, 42};
+
+        for (uint64_t idx = 0; idx < iterations; idx++)
+            do_not_optimize(rng());
+    }};
+
+}  // namespace benchmarks
+}  // namespace pcp_test
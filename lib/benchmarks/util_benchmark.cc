@@ -0,0 +1,67 @@
+#include "benchmark.hpp"
+
+#include <pcp-test/util.hpp>
+
+#include <string>
+
+namespace pcp_test {
+namespace benchmarks {
+
+static registration uuid_generation {
+    "util::get_UUID - 1 thread", 10000,
+    [](uint64_t iterations)
+    {
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            auto uuid = util::get_UUID();
+            do_not_optimize(uuid);
+        }
+    }};
+
+// The generator is shared, under a mutex, by all threads
+static registration uuid_generation_contended {
+    "util::get_UUID - 4 threads", 50000,
+    [](uint64_t iterations)
+    {
+        run_concurrently(4, iterations, [](uint64_t n)
+        {
+            for (uint64_t idx = 0; idx < n; idx++) {
+                auto uuid = util::get_UUID();
+                do_not_optimize(uuid);
+            }
+        });
+    }};
+
+static registration message_id_generation {
+    "util::get_message_id - 1 thread", 1000,
+    [](uint64_t iterations)
+    {
+        for (uint64_t idx = 0; idx < iterations; idx++) {
+            auto id = util::get_message_id();
+            do_not_optimize(id);
+        }
+    }};
+
+// Each thread has its own generator
+static registration message_id_generation_contended {
+    "util::get_message_id - 4 threads", 1000,
+    [](uint64_t iterations)
+    {
+        run_concurrently(4, iterations, [](uint64_t n)
+        {
+            for (uint64_t idx = 0; idx < n; idx++) {
+                auto id = util::get_message_id();
+                do_not_optimize(id);
+            }
+        });
+    }};
+
+static registration monotonic_timestamps {
+    "util::get_monotonic_ns", 500,
+    [](uint64_t iterations)
+    {
+        for (uint64_t idx = 0; idx < iterations; idx++)
+            do_not_optimize(util::get_monotonic_ns());
+    }};
+
+}  // namespace benchmarks
+}  // namespace pcp_test
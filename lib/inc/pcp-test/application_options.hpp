@@ -27,6 +27,7 @@ struct application_options
 
     std::vector<std::string> broker_ws_uris;    // WS URIs of PCP brokers
     std::string certificates_dir;               // SSL certs dir
+    bool generate_certificates;                 // the missing test certs
     std::string results_dir;                    // results dir
 
     // hidden settings
@@ -36,6 +37,18 @@ struct application_options
     // configuration parameters for test_connection
     leatherman::json_container::JsonContainer connection_test_parameters;
 
+    // configuration parameters for test_throughput
+    leatherman::json_container::JsonContainer throughput_test_parameters;
+
+    // configuration parameters for test_fanout
+    leatherman::json_container::JsonContainer fanout_test_parameters;
+
+    // configuration parameters for test_soak
+    leatherman::json_container::JsonContainer soak_test_parameters;
+
+    // configuration parameters for test_scenario
+    leatherman::json_container::JsonContainer scenario_test_parameters;
+
     static bool is_configuration_file_option(const std::string& option_name)
     {
         static std::set<std::string> option_names {
@@ -45,8 +58,13 @@ struct application_options
                 config_par::CONFIG_FILE,
                 config_par::BROKER_WS_URIS,
                 config_par::CERTIFICATES_DIR,
+                config_par::GENERATE_CERTIFICATES,
                 config_par::RESULTS_DIR,
-                config_par::CONNECTION_TEST_PARAMETERS};
+                config_par::CONNECTION_TEST_PARAMETERS,
+                config_par::THROUGHPUT_TEST_PARAMETERS,
+                config_par::FANOUT_TEST_PARAMETERS,
+                config_par::SOAK_TEST_PARAMETERS,
+                config_par::SCENARIO_TEST_PARAMETERS};
 
         return (option_names.find(option_name) != option_names.end());
     }
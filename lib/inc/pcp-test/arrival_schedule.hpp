@@ -0,0 +1,28 @@
+/**
+ * @file
+ * Computes the arrival times of open-loop connection attempts.
+ */
+
+#pragma once
+
+#include <pcp-test/random.hpp>
+
+#include <chrono>
+#include <vector>
+
+namespace pcp_test {
+
+// Return the time offsets, relative to the beginning of the run, of
+// the specified number of arrivals with the given mean rate [Hz].
+// In case ramp_up is not zero, the rate increases linearly from 0 up
+// to rate_Hz during the ramp_up interval.
+// Arrivals follow a Poisson process in case an RNG is specified (it
+// must be an exponential_integers instance with 1 Hz lambda and a
+// microsecond time unit), otherwise they are equally spaced.
+std::vector<std::chrono::microseconds> get_arrival_offsets(
+        int num_arrivals,
+        double rate_Hz,
+        std::chrono::milliseconds ramp_up,
+        exponential_integers* unit_rng_ptr = nullptr);
+
+}  // namespace pcp_test
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * Tracks the responses to requests sent to multiple endpoints and
+ * measures the times to the first and to the last response.
+ */
+
+#pragma once
+
+#include <pcp-test/histogram.hpp>
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct broadcast_counters
+{
+    uint64_t broadcasts;
+    uint64_t expected;    // responses, i.e. broadcasts * targets
+    uint64_t delivered;   // first response of a target to a broadcast
+    uint64_t complete;    // broadcasts replied by all targets
+    uint64_t duplicates;  // further responses of a target to a broadcast
+    uint64_t late;        // responses received after closing the broadcast
+    uint64_t unknown;     // unknown transaction or responder
+
+    broadcast_counters();
+};
+
+// pcp_test::broadcast_tracker keeps the state of in-flight broadcasts,
+// keyed by transaction: the send time point and the targets that have
+// responded. Responses are identified by their sender, that must be
+// one of the targets given at construction. Once closed, a broadcast
+// is accounted: the time to its first response is recorded, if any,
+// and so is the time to its last one, if complete. Closed transactions
+// are remembered for a while (the last `history_size` of them), for
+// classifying late responses.
+// All member functions are thread safe.
+
+class broadcast_tracker
+{
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum class match_outcome { delivered, completed, duplicate, late, unknown };
+
+    static constexpr std::size_t DEFAULT_HISTORY_SIZE {1024};
+
+    explicit broadcast_tracker(const std::vector<std::string>& target_uris,
+                               std::size_t history_size = DEFAULT_HISTORY_SIZE);
+
+    broadcast_tracker(const broadcast_tracker&) = delete;
+    broadcast_tracker& operator=(const broadcast_tracker&) = delete;
+
+    std::size_t num_targets() const;
+
+    // Register a broadcast; return false, without modifying the
+    // tracker, if the transaction is already in flight.
+    bool insert(const std::string& transaction,
+                clock_type::time_point sent = clock_type::now());
+
+    // Forget an in-flight broadcast (e.g. in case it was not sent);
+    // it won't be accounted in any counter.
+    void cancel(const std::string& transaction);
+
+    // Match the response of the specified sender; `completed` is
+    // returned for the last target of a broadcast to respond.
+    match_outcome match(const std::string& transaction,
+                        const std::string& responder,
+                        clock_type::time_point received = clock_type::now());
+
+    // Stop tracking the broadcast and account for it; no effect in
+    // case the transaction is not in flight.
+    void close(const std::string& transaction);
+
+    // Close all in-flight broadcasts
+    void close_all();
+
+    bool is_complete(const std::string& transaction) const;
+
+    std::size_t size() const;
+
+    broadcast_counters get_counters() const;
+    latency_histogram get_time_to_first_us() const;
+    latency_histogram get_time_to_last_us() const;
+
+  private:
+    struct broadcast
+    {
+        clock_type::time_point sent;
+        clock_type::time_point first_response;
+        clock_type::time_point last_response;
+        std::vector<bool> responded;  // by target index
+        std::size_t num_responded;
+    };
+
+    std::unordered_map<std::string, std::size_t> target_indexes_;
+    std::size_t history_size_;
+
+    // Synchronizes access to the state below
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, broadcast> in_flight_;
+    std::deque<std::string> closed_;
+    std::unordered_set<std::string> closed_set_;
+    broadcast_counters counters_;
+    latency_histogram time_to_first_us_;
+    latency_histogram time_to_last_us_;
+
+    // Must be called by holding the lock
+    void close_locked(std::unordered_map<std::string, broadcast>::iterator itr);
+};
+
+}  // namespace pcp_test
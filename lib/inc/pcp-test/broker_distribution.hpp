@@ -0,0 +1,67 @@
+/**
+ * @file
+ * Assigns clients to the brokers of a cluster.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+enum class broker_policy { first, round_robin, weighted, hash };
+
+// The maximum sum of broker weights, once reduced by their greatest
+// common divisor; it bounds the length of the weighted round-robin
+// sequence
+extern const unsigned int MAX_BROKER_TOTAL_WEIGHT;
+
+// Return the sum of the weights reduced by their greatest common
+// divisor (0 in case of no positive weight)
+uint64_t get_reduced_total_weight(std::vector<unsigned int> weights);
+
+// pcp_test::broker_distribution determines the broker, in terms of
+// index of the broker WebSocket URIs, a given client connects to:
+//  - first: all clients connect to the first broker;
+//  - round_robin: consecutive clients connect to consecutive brokers;
+//  - weighted: as round_robin, but each broker gets a number of
+//    clients proportional to its weight; brokers are interleaved
+//    (smooth weighted round-robin), so that a subset of consecutive
+//    clients is distributed as well;
+//  - hash: the broker is given by the FNV-1a hash of the client's
+//    common name, so that a client always connects to the same
+//    broker; weights, if any, are honoured.
+// The assignments are deterministic.
+
+class broker_distribution
+{
+  public:
+    // In case of no weights, all brokers get the same weight;
+    // otherwise, a non-negative weight must be specified for each
+    // broker. Weights are reduced by their greatest common divisor, so
+    // that only their ratios matter; the reduced sum must be positive
+    // and not greater than MAX_BROKER_TOTAL_WEIGHT.
+    broker_distribution(broker_policy policy,
+                        std::size_t num_brokers,
+                        std::vector<unsigned int> weights = {});
+
+    broker_policy policy() const;
+
+    std::size_t num_brokers() const;
+
+    // Return the broker index of the idx-th client
+    std::size_t get_broker(std::size_t client_idx,
+                           const std::string& common_name) const;
+
+  private:
+    broker_policy policy_;
+    std::size_t num_brokers_;
+
+    // A period of the weighted round-robin sequence of broker indexes
+    std::vector<std::size_t> sequence_;
+};
+
+}  // namespace pcp_test
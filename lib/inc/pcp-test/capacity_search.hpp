@@ -0,0 +1,45 @@
+/**
+ * @file
+ * Searches for the highest ramp level a broker sustains.
+ */
+
+#pragma once
+
+namespace pcp_test {
+
+// pcp_test::capacity_search determines the ramp level of the next run
+// of a capacity search, given the outcome of the previous one. Levels
+// range from 0 (the initial run) to a maximum one. Levels are first
+// ramped up exponentially (0, 1, 2, 4, 8, ...), until a run fails or
+// the maximum level passes; then, the interval between the highest
+// passing level and the lowest failing one is bisected, until they
+// are adjacent. Levels are assumed to be monotonic: if a level
+// passes, all lower levels pass.
+
+class capacity_search
+{
+  public:
+    // Throw a fatal_error in case of a negative maximum level
+    explicit capacity_search(int max_level);
+
+    // Level of the run to be performed next
+    int level() const;
+
+    // Record the outcome of the run at the current level; return
+    // false once the search is over
+    bool next(bool passed);
+
+    // Once the search is over, this is the capacity; -1 if no run passed
+    int highest_passing_level() const;
+
+    // Once the search is over, -1 if the maximum level passed
+    int lowest_failing_level() const;
+
+  private:
+    int max_level_;
+    int level_;
+    int highest_passing_level_;
+    int lowest_failing_level_;
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * Provides the SSL certificates of the test endpoints by index, and
+ * generates the missing ones on demand.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+// pcp_test::cert_store addresses the certificate and key pair of an
+// endpoint by role and index, as `test/<CN>.example.com_[crt|key].pem`
+// within the certificates directory, where the common name is the
+// index, zero padded to 4 digits, followed by the role (e.g.
+// "0042agent"); see doc/certificates.md.
+// Looking up N endpoints checks the files of indexes [0, N), instead
+// of listing the whole directory, so the cost does not depend on the
+// number of certificates stored.
+// If generation is enabled, the missing pairs are created, by
+// concurrent threads, by signing new prime256v1 EC keys with the CA key
+// (`ca_key.pem`), and stored in the `test` directory, so that later
+// runs find them there.
+// All member functions are thread safe.
+
+class cert_store
+{
+  public:
+    struct error : public std::runtime_error {
+        explicit error(std::string const& msg) : std::runtime_error(msg) {}
+    };
+
+    static const std::string CA_CERT_FILE;
+    static const std::string CA_KEY_FILE;
+
+    // Throws a cert_store::error in case generation is enabled but
+    // the CA certificate or key can't be loaded.
+    cert_store(std::string certificates_dir, bool generate);
+
+    ~cert_store();
+
+    cert_store(const cert_store&) = delete;
+    cert_store& operator=(const cert_store&) = delete;
+
+    static std::string common_name(const std::string& role, std::size_t idx);
+
+    // Return the common names of the first `num_endpoints` endpoints
+    // of the specified role, in index order up to the first missing
+    // pair that can't be generated; the returned set can then be
+    // smaller than requested. Throws a cert_store::error in case a
+    // generation fails.
+    std::set<std::string> get_common_names(const std::string& role,
+                                           std::size_t num_endpoints);
+
+    // Number of pairs generated by this instance
+    std::size_t num_generated() const;
+
+  private:
+    struct signer;
+
+    std::string test_dir_;
+    std::unique_ptr<signer> signer_;  // null if generation is disabled
+
+    // Serializes generations and protects the counter
+    mutable std::mutex mtx_;
+    std::size_t num_generated_;
+
+    bool has_pair(const std::string& common_name) const;
+    void generate_pair(const std::string& common_name) const;
+    void generate_pairs(const std::vector<std::string>& common_names);
+};
+
+}  // namespace pcp_test
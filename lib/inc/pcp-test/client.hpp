@@ -7,10 +7,14 @@
 
 #include <pcp-test/client_configuration.hpp>
 #include <pcp-test/message.hpp>
+#include <pcp-test/payload_generator.hpp>
 
 #include <cpp-pcp-client/protocol/chunks.hpp>
 #include <cpp-pcp-client/connector/connector.hpp>
 
+#include <leatherman/json_container/json_container.hpp>
+
+#include <chrono>
 #include <string>
 #include <functional>
 #include <memory>
@@ -18,6 +22,24 @@
 
 namespace pcp_test {
 
+// A request that owns its header chunk (see message::write_header()),
+// so that it can be queued before being sent (see pipelined_sender.hpp).
+// The data chunk, JSON or binary as per the format, is rather shared
+// with other requests (see payload_generator); the data chunk and the
+// endpoints must outlive the request.
+// The intended send time point is not sent, but kept for the latency
+// accounting of the sender.
+struct outgoing_request
+{
+    std::string transaction;
+    const std::vector<std::string>* endpoints;
+    payload_format format;
+    const leatherman::json_container::JsonContainer* json_data;
+    const std::string* binary_data;
+    leatherman::json_container::JsonContainer header;
+    std::chrono::steady_clock::time_point intended_send;
+};
+
 // pcp_test::client provides two ways of implementing the dispatch
 // logic for handling PCP test messages (request, response, error):
 // polymorphism, by subclassing and defining process_XXX() methods,
@@ -42,14 +64,41 @@ class client : public PCPClient::Connector
     explicit client(client_configuration config);
 
     // Send the request message to the specified endpoints.
-    void send_request(const message& request,
+    // Return false in case of failure (the error is logged).
+    bool send_request(const message& request,
                       const std::vector<std::string>& endpoints);
 
+    // Send a request whose data chunk has already been built, so
+    // that senders can reuse it; return false in case of failure.
+    bool send_request(const std::vector<std::string>& endpoints,
+                      const leatherman::json_container::JsonContainer& data);
+
+    // As above, with a header chunk (see message::write_header()), so
+    // that the data chunk can be shared among requests.
+    bool send_request(const std::vector<std::string>& endpoints,
+                      const leatherman::json_container::JsonContainer& data,
+                      const leatherman::json_container::JsonContainer& header);
+
+    // As above, for binary requests; the data chunk is the payload.
+    bool send_binary_request(const std::vector<std::string>& endpoints,
+                             const std::string& data,
+                             const leatherman::json_container::JsonContainer& header);
+
+    // As above, for an outgoing request of either format.
+    bool send_request(const outgoing_request& request);
+
     // Replies to the specified request message with a
-    // response message.
+    // response message; binary requests get a binary response.
     void reply(const message& request);
 
 
+    // Replies to the specified parsed request with a response that
+    // carries the same data chunk, JSON or binary, and header chunk,
+    // if any, without building any message instance; that's the fast
+    // path for echo agents.
+    // Return false in case of failure (the error is logged).
+    bool echo(const PCPClient::ParsedChunks& parsed_chunks);
+
     // Replies to the specified request message with an
     // error message.
     void reply_with_error(const message& request,
@@ -58,10 +107,19 @@ class client : public PCPClient::Connector
     // Send a WebSocket ping
     void ping();
 
+    // Close the WebSocket connection, if open, and wait for the
+    // closing handshake to complete. Return false in case the
+    // connection is not closed within the specified timeout.
+    bool close(std::chrono::milliseconds timeout);
+
   protected:
     virtual void process_request(const PCPClient::ParsedChunks& parsed_chunks);
     virtual void process_response(const PCPClient::ParsedChunks& parsed_chunks);
     virtual void process_error(const PCPClient::ParsedChunks& parsed_chunks);
 };
 
+// Connect the specified clients by using a pool of threads; return
+// the number of clients that failed to associate
+int connect_clients(const std::vector<client*>& client_ptrs);
+
 }  // namespace pcp_test
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace pcp_test {
@@ -21,6 +22,8 @@ struct client_configuration
     std::string common_name;
     const std::string& client_type;
     const std::vector<std::string>& broker_ws_uris;
+    std::size_t broker_idx;  // of the broker_ws_uris entry to connect to
+    std::size_t client_idx;  // within the test, as per the common name
     const std::string& certificates_dir;
     long connection_timeout_ms;
     uint32_t association_timeout_s;
@@ -30,6 +33,8 @@ struct client_configuration
     std::string crt;
     std::string key;
 
+    // Set the CA, certificate, and key paths for the common name.
+    // Thread-safe.
     void update_cert_paths();
 
     client_configuration(
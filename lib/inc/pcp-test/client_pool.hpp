@@ -0,0 +1,52 @@
+/**
+ * @file
+ * Set of PCP clients that is kept across test runs.
+ */
+
+#pragma once
+
+#include <pcp-test/client.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pcp_test {
+
+// pcp_test::client_pool owns the clients of consecutive test runs, so
+// that established connections can be reused instead of being closed
+// and established again at each run. Clients are kept in the order
+// they were added, regardless of their connection state.
+// All member functions are thread safe.
+
+class client_pool
+{
+  public:
+    client_pool();
+
+    client_pool(const client_pool&) = delete;
+    client_pool& operator=(const client_pool&) = delete;
+
+    void add(const std::vector<std::shared_ptr<client>>& client_ptrs);
+
+    // Copy of the pointers of all clients
+    std::vector<std::shared_ptr<client>> get_clients() const;
+
+    // Copy of the pointers of the clients that are not associated
+    std::vector<std::shared_ptr<client>> get_unassociated_clients() const;
+
+    // Remove all clients from the pool and return them, split in the
+    // specified number of sets (e.g. to close their connections
+    // concurrently)
+    std::vector<std::vector<std::shared_ptr<client>>> release(std::size_t num_sets);
+
+    std::size_t size() const;
+
+    bool empty() const;
+
+  private:
+    mutable std::mutex mtx_;
+    std::vector<std::shared_ptr<client>> client_ptrs_;
+};
+
+}  // namespace pcp_test
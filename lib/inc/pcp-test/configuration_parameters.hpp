@@ -16,8 +16,13 @@ extern const std::string LOGFILE;
 extern const std::string CONFIG_FILE;
 extern const std::string BROKER_WS_URIS;
 extern const std::string CERTIFICATES_DIR;
+extern const std::string GENERATE_CERTIFICATES;
 extern const std::string RESULTS_DIR;
 extern const std::string CONNECTION_TEST_PARAMETERS;
+extern const std::string THROUGHPUT_TEST_PARAMETERS;
+extern const std::string FANOUT_TEST_PARAMETERS;
+extern const std::string SOAK_TEST_PARAMETERS;
+extern const std::string SCENARIO_TEST_PARAMETERS;
 
 }  // namespace connection_test_parameters
 }  // namespace pcp_test
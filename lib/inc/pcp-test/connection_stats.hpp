@@ -5,7 +5,7 @@
 
 #pragma once
 
-#include <pcp-test/connection_stats.hpp>
+#include <pcp-test/histogram.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
@@ -16,11 +16,14 @@
 
 #include <boost/nowide/fstream.hpp>
 
+#include <atomic>
 #include <ostream>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace pcp_test {
 
@@ -37,8 +40,15 @@ struct stats
     uint32_t max;
     uint32_t count;
 
+    // Percentiles; not available when obtained from a timing_accumulator_t
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t p999;
+
     stats();
     explicit stats(const timing_accumulator_t& a);
+    explicit stats(const latency_histogram& h);
 };
 
 struct connection_stats
@@ -48,6 +58,7 @@ struct connection_stats
     stats ws_close_handshake_us;
     stats association_ms;
     stats session_duration_ms;
+    stats connect_ms;
 
     friend std::ostream& operator<< (std::ostream& out_stream,
                                      const connection_stats& c_s);
@@ -56,6 +67,62 @@ struct connection_stats
                                        const connection_stats& c_s);
 };
 
+// Timings of a group of connections
+struct connection_timings
+{
+    latency_histogram tcp_us;
+    latency_histogram ws_open_handshake_us;
+    latency_histogram ws_close_handshake_us;
+    latency_histogram association_ms;
+    latency_histogram session_duration_ms;
+
+    // From the intended start of each connection attempt to the
+    // completion of connect(). In open-loop runs, the intended start is
+    // given by the arrival schedule, so the time spent waiting for a
+    // Connection Task is included. Closed-loop attempts start when
+    // made, and waiting is only accounted for by backfilling the missed
+    // attempts, with latency-correction (see accumulate_connect_ms())
+    latency_histogram connect_ms;
+
+    void merge(const connection_timings& other);
+
+    connection_stats get_connection_stats() const;
+};
+
+// Accumulates timings without any synchronization: a shard must be
+// used by a single thread at a time (e.g. by the Connection Task that
+// owns it). Its timings are merged by the parent accumulator only
+// after being sealed.
+struct connection_timings_shard
+{
+  public:
+    connection_timings_shard();
+
+    void accumulate_tcp_us(uint32_t interval);
+    void accumulate_ws_open_handshake_us(uint32_t interval);
+    void accumulate_ws_close_handshake_us(uint32_t interval);
+    void accumulate_association_ms(uint32_t interval);
+    void accumulate_session_duration_ms(uint32_t interval);
+
+    // In case of a non-zero expected interval between attempts, the
+    // attempts that should have been made while waiting are recorded
+    // as well (see latency_histogram::record_corrected)
+    void accumulate_connect_ms(uint32_t interval, uint32_t expected_interval = 0);
+
+    // Publish the accumulated timings; no accumulate() call is
+    // allowed afterwards
+    void seal();
+
+    bool is_sealed() const;
+
+    // Must be called only once sealed
+    const connection_timings& get_timings() const;
+
+  private:
+    connection_timings timings_;
+    std::atomic<bool> sealed_;
+};
+
 struct connection_timings_accumulator
 {
   public:
@@ -65,17 +132,28 @@ struct connection_timings_accumulator
     void accumulate_association_ms(uint32_t interval);
     void accumulate_session_duration_ms(uint32_t interval);
 
+    // In case of a non-zero expected interval between attempts, the
+    // attempts that should have been made while waiting are recorded
+    // as well (see latency_histogram::record_corrected)
+    void accumulate_connect_ms(uint32_t interval, uint32_t expected_interval = 0);
+
+    // Return a new shard, whose timings will be included in the
+    // stats once the shard is sealed. Shards avoid synchronizing
+    // accumulate() calls of concurrent Tasks.
+    std::shared_ptr<connection_timings_shard> get_shard();
+
+    // Timings of unsealed shards are not included
+    connection_timings get_timings() const;
     connection_stats get_connection_stats() const;
 
+    std::size_t num_unsealed_shards() const;
+
   private:
-    // Synchronizes accumulate() access to state
+    // Synchronizes access to state
     mutable std::mutex the_mutex_;
 
-    timing_accumulator_t tcp_us_acc_;
-    timing_accumulator_t ws_open_handshake_us_acc_;
-    timing_accumulator_t ws_close_handshake_us_acc_;
-    timing_accumulator_t association_ms_acc_;
-    timing_accumulator_t session_duration_ms_acc_;
+    connection_timings timings_;
+    std::vector<std::shared_ptr<connection_timings_shard>> shards_;
 };
 
 }  // namespace pcp_test
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * Matches responses to in-flight requests and measures round-trip times.
+ */
+
+#pragma once
+
+#include <pcp-test/histogram.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct correlation_counters
+{
+    uint64_t matched;
+    uint64_t expired;     // no response within the timeout (lost)
+    uint64_t late;        // response received after the expiry
+    uint64_t duplicates;  // response to an already matched request
+    uint64_t unknown;     // response with an unrecognized transaction
+
+    correlation_counters();
+};
+
+// pcp_test::correlation_table keeps the send time point of in-flight
+// requests, keyed by transaction, in a number of independently locked
+// shards, so that senders and response handlers of different threads
+// rarely contend.
+// At most `capacity` requests can be in flight at a given time.
+// Requests are expired by expire() once in flight for longer than the
+// timeout. Besides the RTT, measured from the send time point, the
+// latency is measured from the time point the request was intended to
+// be sent at, so that it accounts for the delays of the sender
+// (coordinated omission). Matched and expired transactions are remembered for a
+// while (up to `capacity` of them), for classifying late and duplicate
+// responses.
+// Send time points are expected to be non decreasing, as when obtained
+// by clock_type::now(); expiry would be otherwise delayed.
+
+class correlation_table
+{
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    enum class match_outcome { matched, late, duplicate, unknown };
+
+    static constexpr unsigned int DEFAULT_NUM_SHARDS {8};
+
+    correlation_table(std::size_t capacity,
+                      std::chrono::milliseconds timeout,
+                      unsigned int num_shards = DEFAULT_NUM_SHARDS);
+
+    correlation_table(const correlation_table&) = delete;
+    correlation_table& operator=(const correlation_table&) = delete;
+
+    // Register a request; return false, without modifying the table,
+    // if the table is full or the transaction is already in flight.
+    bool insert(const std::string& transaction,
+                clock_type::time_point sent = clock_type::now());
+
+    // As above, specifying the intended send time point
+    bool insert(const std::string& transaction,
+                clock_type::time_point sent,
+                clock_type::time_point intended);
+
+    // Forget an in-flight request (e.g. in case it was not sent);
+    // it won't be accounted in any counter.
+    void cancel(const std::string& transaction);
+
+    // Match a response; in case the related request is in flight, its
+    // RTT is recorded and, if rtt_ptr is not null, returned.
+    match_outcome match(const std::string& transaction,
+                        clock_type::time_point received = clock_type::now(),
+                        std::chrono::microseconds* rtt_ptr = nullptr);
+
+    // Expire the requests that were sent before now - timeout;
+    // return the number of expired requests.
+    std::size_t expire(clock_type::time_point now = clock_type::now());
+
+    // Expire all in-flight requests; return their number.
+    std::size_t expire_all();
+
+    // Number of in-flight requests
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+    correlation_counters get_counters() const;
+
+    // RTTs of matched requests, in microseconds
+    latency_histogram get_rtt_us() const;
+
+    // Latencies of matched requests, from their intended send time
+    // points, in microseconds
+    latency_histogram get_latency_us() const;
+
+  private:
+    enum class closed_state { matched, expired };
+
+    struct send_times
+    {
+        clock_type::time_point sent;
+        clock_type::time_point intended;
+    };
+
+    struct shard
+    {
+        std::mutex mtx;
+        std::unordered_map<std::string, send_times> in_flight;
+
+        // Expiry queue, in send order; it may contain stale entries
+        // for matched or cancelled requests
+        std::deque<std::pair<clock_type::time_point, std::string>> expiry_queue;
+
+        // Recently closed transactions, with bounded FIFO eviction
+        std::unordered_map<std::string, closed_state> closed;
+        std::deque<std::string> closed_order;
+
+        correlation_counters counters;
+        latency_histogram rtt_us;
+        latency_histogram latency_us;
+    };
+
+    std::size_t capacity_;
+    std::chrono::milliseconds timeout_;
+    std::size_t closed_capacity_per_shard_;
+    std::atomic<std::size_t> size_;
+    std::vector<std::unique_ptr<shard>> shards_;
+
+    shard& get_shard(const std::string& transaction);
+    void close(shard& s, std::string transaction, closed_state state);
+    std::size_t expire_shard(shard& s, clock_type::time_point deadline);
+};
+
+}  // namespace pcp_test
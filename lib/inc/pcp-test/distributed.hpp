@@ -0,0 +1,110 @@
+/**
+ * @file
+ * Distributed connection test - a coordinator splits each run across a
+ *                               number of worker processes, starts them
+ *                               in lockstep, and merges their results.
+ */
+
+#pragma once
+
+#include <pcp-test/application_options.hpp>
+
+#include <leatherman/json_container/json_container.hpp>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/streambuf.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+struct connection_test_run;
+struct connection_test_result;
+
+// Serve the coordinators of distributed connection tests, one at a
+// time; it never returns, unless the worker port cannot be bound
+void run_worker(const application_options& a_o);
+
+// Share of a connection test run assigned to a worker
+struct worker_assignment
+{
+    int concurrency;              // number of sets
+    int connection_rate;          // open-loop arrivals only [connections/s]
+    std::size_t first_name_idx;   // of the client common names to be used
+};
+
+// Split the sets of a run among the workers, so that their number
+// differs at most by one; the connection rate is split proportionally
+// (each worker that gets a set gets at least 1 connection/s).
+// Workers get contiguous ranges of client common names, in order.
+std::vector<worker_assignment> split_run(int num_endpoints,
+                                         int concurrency,
+                                         int connection_rate,
+                                         std::size_t num_workers);
+
+// pcp_test::worker_link exchanges newline delimited JSON messages
+// through a TCP connection, in a blocking way.
+// Failures are reported by throwing a fatal_error.
+
+class worker_link
+{
+  public:
+    // Connect to a worker, given its "<host>:<port>" address
+    worker_link(boost::asio::io_service& io_service, const std::string& address);
+
+    // Wait for a coordinator to connect
+    worker_link(boost::asio::io_service& io_service,
+                boost::asio::ip::tcp::acceptor& acceptor);
+
+    worker_link(const worker_link&) = delete;
+    worker_link& operator=(const worker_link&) = delete;
+
+    void send(const leatherman::json_container::JsonContainer& message);
+
+    leatherman::json_container::JsonContainer receive();
+
+    // Receive a message of the specified type; error messages sent by
+    // the peer are rethrown
+    leatherman::json_container::JsonContainer receive(const std::string& type);
+
+    const std::string& peer() const;
+
+  private:
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::streambuf buffer_;
+    std::string peer_;
+};
+
+// pcp_test::worker_coordinator drives the workers of a distributed
+// connection test. For each run, the workers build their clients, then
+// they are all started at once; the failure counts and the timing
+// histograms of their shares are merged into the results of the run.
+
+class worker_coordinator
+{
+  public:
+    // Connect to the workers; their results refer to the specified brokers
+    worker_coordinator(const std::vector<std::string>& addresses,
+                       std::vector<std::string> broker_ws_uris);
+
+    // Let the workers know the test is over
+    ~worker_coordinator();
+
+    worker_coordinator(const worker_coordinator&) = delete;
+    worker_coordinator& operator=(const worker_coordinator&) = delete;
+
+    std::size_t num_workers() const;
+
+    connection_test_result perform_run(const connection_test_run& run);
+
+  private:
+    std::vector<std::string> broker_ws_uris_;
+    boost::asio::io_service io_service_;
+    std::vector<std::unique_ptr<worker_link>> links_;
+};
+
+}  // namespace pcp_test
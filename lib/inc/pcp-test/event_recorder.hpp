@@ -0,0 +1,107 @@
+/**
+ * @file
+ * Records an event for each phase of each connection into a compact,
+ * append-only binary file, without slowing down the recording threads.
+ */
+
+#pragma once
+
+#include <pcp-test/mpmc_ring.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <stdint.h>
+
+namespace pcp_test {
+
+enum class connection_phase : uint8_t {
+    tcp                = 0,
+    ws_open_handshake  = 1,  // on failure, includes the TCP connection
+    association        = 2,
+    ws_close_handshake = 3
+};
+
+enum class event_outcome : uint8_t {
+    success = 0,
+    failure = 1
+};
+
+struct connection_event
+{
+    uint64_t timestamp_us;  // end of the phase, since the epoch
+    uint32_t endpoint_id;   // index of the client within the test
+    uint32_t duration_us;
+    uint16_t run_idx;
+    connection_phase phase;
+    event_outcome outcome;
+};
+
+// Bounded, lock-free queue of events; pushing never blocks
+using event_ring = mpmc_ring<connection_event>;
+
+// pcp_test::event_recorder stores the recorded events in an
+// event_ring; a writer thread drains the ring into a buffered file.
+// In case the ring is full, events are dropped and counted, so that
+// recording never blocks the connection threads.
+//
+// File format: the 8 bytes "PCPTEVT1" magic, followed by a 20 bytes
+// little endian record per event: timestamp_us (8 bytes), endpoint_id
+// (4), duration_us (4), run_idx (2), phase (1), and outcome (1).
+
+class event_recorder
+{
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY {1 << 16};
+    static constexpr std::size_t RECORD_SIZE {20};
+    static const std::string FILE_MAGIC;
+
+    // Throw a fatal_error if the file cannot be created
+    explicit event_recorder(const std::string& file_path,
+                            std::size_t capacity = DEFAULT_CAPACITY);
+
+    // Write the pending events and close the file
+    ~event_recorder();
+
+    event_recorder(const event_recorder&) = delete;
+    event_recorder& operator=(const event_recorder&) = delete;
+
+    void set_run(int run_idx);
+
+    // Thread-safe; never blocks
+    void record(uint32_t endpoint_id,
+                connection_phase phase,
+                event_outcome outcome,
+                std::chrono::microseconds duration);
+
+    uint64_t num_dropped() const;
+
+  private:
+    event_ring ring_;
+    boost::nowide::ofstream file_stream_;
+    std::atomic<int> run_idx_;
+    std::atomic<uint64_t> num_dropped_;
+    std::atomic<bool> stopping_;
+    std::thread writer_thread_;
+
+    void write_events();
+};
+
+// Throw a fatal_error in case the magic doesn't match
+void read_events_header(std::istream& in_stream);
+
+// Return false at the end of the stream; throw a fatal_error in case
+// of truncated records
+bool read_event(std::istream& in_stream, connection_event& event);
+
+// Convert an events file to CSV rows, in the record field order (the
+// phase and outcome are named); return the number of events
+uint64_t convert_events_to_csv(std::istream& in_stream, std::ostream& out_stream);
+
+}  // namespace pcp_test
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * Failure stats - connection failures broken down by the phase in which
+ *                 they occurred, with the latency at failure.
+ */
+
+#pragma once
+
+#include <pcp-test/histogram.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+namespace pcp_test {
+
+enum class failure_phase : uint8_t {
+    tcp_refused               = 0,
+    tcp_timeout               = 1,
+    tls                       = 2,
+    ws_upgrade                = 3,
+    association_timeout       = 4,  // including no Association response
+    association_rejected      = 5,
+    dropped_after_association = 6,  // not associated at the check
+    task_timeout              = 7,  // the Connection Task didn't complete
+    other                     = 8
+};
+
+static constexpr std::size_t NUM_FAILURE_PHASES {9};
+
+const std::string& failure_phase_name(failure_phase phase);
+
+// Classify a connect() failure that isn't about the Association, given
+// the error message and the timings of the WebSocket connection; zero
+// intervals mean that the phase hasn't completed. The TLS handshake
+// happens in between the TCP connection and the WebSocket upgrade,
+// but its timings are not available: TLS failures are identified by
+// the error message. Attempts that didn't establish the TCP connection
+// are deemed timed out if they lasted at least `timeout`, refused
+// otherwise.
+failure_phase classify_connect_error(const std::string& error,
+                                     std::chrono::microseconds tcp_interval,
+                                     std::chrono::microseconds ws_open_interval,
+                                     std::chrono::milliseconds duration,
+                                     std::chrono::milliseconds timeout);
+
+struct failure_breakdown
+{
+    std::array<uint64_t, NUM_FAILURE_PHASES> counts;
+
+    // Time from the start of the attempt to the failure; for dropped
+    // connections, the duration of the session. Task timeouts have no
+    // latency.
+    std::array<latency_histogram, NUM_FAILURE_PHASES> latency_ms;
+
+    failure_breakdown();
+
+    void record(failure_phase phase, uint32_t latency_ms);
+
+    // Without latency
+    void add(failure_phase phase, uint64_t count);
+
+    void merge(const failure_breakdown& other);
+
+    uint64_t count(failure_phase phase) const;
+    uint64_t total() const;
+
+    // To stdout (human readable); only the phases with failures
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const failure_breakdown& breakdown);
+
+    // To file (csv); for each phase, the count and the 50th and 99th
+    // percentiles of the latency
+    friend std::ofstream & operator<< (boost::nowide::ofstream& out_stream,
+                                       const failure_breakdown& breakdown);
+};
+
+// pcp_test::failure_recorder collects the failures classified by the
+// concurrent Connection Tasks of a run. Thread safe.
+
+class failure_recorder
+{
+  public:
+    failure_recorder();
+
+    failure_recorder(const failure_recorder&) = delete;
+    failure_recorder& operator=(const failure_recorder&) = delete;
+
+    void record(failure_phase phase, std::chrono::milliseconds latency);
+
+    failure_breakdown get_breakdown() const;
+
+  private:
+    mutable std::mutex mtx_;
+    failure_breakdown breakdown_;
+};
+
+}  // namespace pcp_test
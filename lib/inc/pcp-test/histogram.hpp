@@ -0,0 +1,85 @@
+/**
+ * @file
+ * Log-bucketed histogram for computing percentiles of timing values.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <stdint.h>
+
+namespace pcp_test {
+
+// pcp_test::latency_histogram stores uint32_t values in a fixed
+// number of buckets, with the same layout of an HDR histogram: values
+// below 2^SUB_BUCKET_BITS are counted exactly, whereas bigger values
+// are grouped in logarithmic ranges, each split in 2^(SUB_BUCKET_BITS - 1)
+// linear sub-buckets, for a relative error below 1/64.
+// Histograms can be merged without any loss of precision.
+// Count, min, max, mean and variance are tracked exactly.
+// Histograms can be serialized to a compact string, e.g. for merging
+// the histograms of different processes; deserialization restores the
+// exact same state.
+
+class latency_histogram
+{
+  public:
+    static constexpr unsigned int SUB_BUCKET_BITS {7};
+    static constexpr std::size_t NUM_BUCKETS {
+        (32 - SUB_BUCKET_BITS + 2) << (SUB_BUCKET_BITS - 1)};
+
+    latency_histogram();
+
+    void record(uint32_t value);
+
+    // Record the same value multiple times
+    void record(uint32_t value, uint64_t count);
+
+    // Correct for coordinated omission, as HdrHistogram does: in case
+    // the value exceeds the expected interval between samples, also
+    // record the values of the samples that would have been taken
+    // meanwhile (value - interval, value - 2 * interval, ...); no
+    // correction is done for a null interval
+    void record_corrected(uint32_t value, uint32_t expected_interval);
+
+    void merge(const latency_histogram& other);
+
+    void reset();
+
+    uint64_t count() const;
+    uint32_t min() const;
+    uint32_t max() const;
+    double mean() const;
+    double variance() const;
+
+    // Return the smallest recorded value (within the histogram
+    // precision) that is greater or equal than the specified
+    // percentage of all recorded values; 0 if no value was recorded.
+    uint32_t percentile(double percentage) const;
+
+    // Bucket access, for serializing the histogram
+    static std::size_t bucket_index(uint32_t value);
+    static uint32_t bucket_lowest_value(std::size_t idx);
+    static uint32_t bucket_highest_value(std::size_t idx);
+    uint64_t bucket_count(std::size_t idx) const;
+
+    // Only non-empty buckets are included
+    std::string serialize() const;
+
+    // Throw a fatal_error in case of invalid string
+    static latency_histogram deserialize(const std::string& s);
+
+  private:
+    std::array<uint64_t, NUM_BUCKETS> counts_;
+    uint64_t count_;
+    uint32_t min_;
+    uint32_t max_;
+
+    // Welford's running mean and sum of squared differences
+    double mean_;
+    double m2_;
+};
+
+}  // namespace pcp_test
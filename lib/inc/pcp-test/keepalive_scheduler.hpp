@@ -0,0 +1,98 @@
+/**
+ * @file
+ * Periodically pings a set of connections with evenly spread deadlines.
+ */
+
+#pragma once
+
+#include <pcp-test/histogram.hpp>
+#include <pcp-test/task_scheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct keepalive_stats
+{
+    uint64_t num_pings;
+    uint64_t num_not_associated;  // e.g. not connected yet, or dropped
+    uint64_t num_failures;        // pings that failed to be sent
+    uint64_t num_missed;          // slots skipped as the ping was late
+    latency_histogram lag_us;     // delay of each ping after its slot
+
+    keepalive_stats();
+
+    void merge(const keepalive_stats& other);
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const keepalive_stats& k_s);
+};
+
+// pcp_test::keepalive_scheduler executes the ping function of each
+// connection once per period, by means of a task_scheduler. The first
+// ping of the connections added at once are evenly spread over a
+// period, so that pings are executed at a constant rate; each ping is
+// then due one period after the previous slot. In case a ping is more
+// than one period late, the missed slots are counted and skipped.
+// Counters are accumulated in per-worker shards.
+
+class keepalive_scheduler
+{
+  public:
+    using clock_type = task_scheduler::clock_type;
+
+    // Ping a connection; return false, without pinging, if the
+    // connection is not associated; throw in case of failure.
+    using ping_type = std::function<bool()>;
+
+    keepalive_scheduler(std::chrono::milliseconds period,
+                        unsigned int num_threads);
+
+    // Stop pinging and join the workers
+    ~keepalive_scheduler();
+
+    keepalive_scheduler(const keepalive_scheduler&) = delete;
+    keepalive_scheduler& operator=(const keepalive_scheduler&) = delete;
+
+    void add(std::vector<ping_type> pings);
+
+    // Stop pinging; the ping functions of pending pings are destroyed
+    // once their slot elapses, or by the dtor. Calling add() afterwards
+    // has no effect.
+    void stop();
+
+    std::size_t num_connections() const;
+
+    keepalive_stats get_stats() const;
+
+  private:
+    struct shard
+    {
+        std::mutex mtx;
+        keepalive_stats stats;
+    };
+
+    std::chrono::microseconds period_;
+    std::atomic<bool> stopping_;
+    std::atomic<std::size_t> num_connections_;
+    std::vector<std::unique_ptr<shard>> shards_;
+
+    // NB: must be the last member, so that its workers are joined
+    // before destroying the shards
+    task_scheduler scheduler_;
+
+    void schedule_ping(std::shared_ptr<ping_type> ping_ptr,
+                       clock_type::time_point slot);
+    void ping(std::shared_ptr<ping_type> ping_ptr,
+              clock_type::time_point slot);
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * Live metrics - connection counters and latencies sampled every second
+ *                while a test run is in progress.
+ */
+
+#pragma once
+
+#include <pcp-test/histogram.hpp>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct live_metrics_counters
+{
+    uint64_t num_attempts;
+    uint64_t num_associated;   // the client got associated by connect()
+    uint64_t num_failures;     // not associated after the pause, as in the results
+
+    live_metrics_counters();
+};
+
+struct live_metrics_sample
+{
+    std::chrono::system_clock::time_point time;
+    int run_idx;
+    live_metrics_counters counters;  // during the sampling interval
+    int64_t num_in_flight;           // connect() calls in progress
+    latency_histogram connect_ms;    // of the connect() calls completed
+                                     // during the sampling interval
+    live_metrics_sample();
+};
+
+// pcp_test::live_metrics counts the connection attempts of a test and
+// records the duration of each connect() call (TCP connection,
+// WebSocket handshake, and Association). Counters and durations are
+// recorded by concurrent Connection Tasks; sample() returns what
+// happened since the previous sample.
+
+class live_metrics
+{
+  public:
+    live_metrics();
+
+    live_metrics(const live_metrics&) = delete;
+    live_metrics& operator=(const live_metrics&) = delete;
+
+    void set_run(int run_idx);
+
+    void attempt_started();
+    void attempt_completed(bool associated, std::chrono::milliseconds duration);
+    void attempt_failed();
+
+    // Since the previous call; the sample is also kept as the last one
+    live_metrics_sample sample();
+
+    live_metrics_sample get_last_sample() const;
+
+    // Since the start of the test
+    live_metrics_counters get_totals() const;
+
+    int64_t num_in_flight() const;
+
+  private:
+    std::atomic<int> run_idx_;
+    std::atomic<uint64_t> num_attempts_;
+    std::atomic<uint64_t> num_associated_;
+    std::atomic<uint64_t> num_failures_;
+    std::atomic<uint64_t> num_completed_;
+
+    // Synchronizes access to the interval histogram and to the samples
+    mutable std::mutex the_mutex_;
+    latency_histogram interval_connect_ms_;
+    live_metrics_counters sampled_totals_;
+    live_metrics_sample last_sample_;
+};
+
+// pcp_test::live_metrics_reporter samples the metrics once per second
+// and appends a CSV row for each sample to the specified file. If a
+// port is specified, the cumulative counters and the last sample are
+// also served over HTTP in the Prometheus text format, on the loopback
+// interface unless another bind address is specified.
+
+class live_metrics_reporter
+{
+  public:
+    static const std::chrono::milliseconds SAMPLING_INTERVAL;
+    static const std::string DEFAULT_BIND_ADDRESS;
+
+    // Throw a fatal_error if the file cannot be opened or the port
+    // cannot be bound; port 0 means no HTTP endpoint
+    live_metrics_reporter(live_metrics& metrics,
+                          const std::string& file_path,
+                          unsigned short port,
+                          const std::string& bind_address = DEFAULT_BIND_ADDRESS);
+
+    // Write the last sample and stop
+    ~live_metrics_reporter();
+
+    live_metrics_reporter(const live_metrics_reporter&) = delete;
+    live_metrics_reporter& operator=(const live_metrics_reporter&) = delete;
+
+  private:
+    live_metrics& metrics_;
+    boost::nowide::ofstream file_stream_;
+    std::chrono::steady_clock::time_point start_;
+    std::mutex stop_mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_;
+    boost::asio::io_service io_service_;
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_ptr_;
+    std::thread http_thread_;
+    std::thread sampling_thread_;
+
+    void write_sample(const live_metrics_sample& s);
+    void sample_periodically();
+    void accept_next();
+    std::string get_exposition() const;
+};
+
+}  // namespace pcp_test
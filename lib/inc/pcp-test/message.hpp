@@ -9,9 +9,12 @@
 
 #include <leatherman/json_container/json_container.hpp>
 
+#include <boost/utility/string_ref.hpp>
+
 #include <stdexcept>
 #include <string>
 #include <map>
+#include <stdint.h>
 
 namespace pcp_test {
 
@@ -24,7 +27,7 @@ class message {
     /// Instantiate a message out of a parsed message.
     /// Throws an message::error in case it fails to retrieve
     /// the data chunk from the specified ParsedChunks or in case
-    /// of binary data (currently not supported).
+    /// its content type doesn't match the message type.
     message(const PCPClient::ParsedChunks& parsed_chunks);
 
     /// Instantiate a request of given type.
@@ -42,8 +45,57 @@ class message {
     const std::string& transaction() const;
     const std::string& timestamp() const;
     const std::string& error_msg() const;
+    const std::string& payload() const;
+    void set_payload(std::string payload);
+
+    // Sender sequence number and send time (see util::get_monotonic_ns());
+    // 0 means not set. The timestamp is taken by set_send_info().
+    uint64_t sequence() const;
+    int64_t sent_ns() const;
+    void set_send_info(uint64_t sequence);
+
+    // Whether the data chunk is binary (binary request or response)
+    bool is_binary() const;
+
+    // JSON data chunk; the payload is included, if not empty
     leatherman::json_container::JsonContainer get_data() const;
 
+    // Binary data chunk: a header with the transaction, optionally
+    // followed by the sequence number and the send time, separated
+    // by spaces and terminated by a newline, followed by the payload;
+    // the formatted timestamp is not included
+    std::string get_binary_data() const;
+
+    /// Write the binary data chunk in the specified buffer, by
+    /// reusing its capacity.
+    static void write_binary_data(std::string& buffer,
+                                  const std::string& transaction,
+                                  const std::string& payload);
+
+    /// As above, including the sequence number and the send time
+    static void write_binary_data(std::string& buffer,
+                                  const std::string& transaction,
+                                  uint64_t sequence,
+                                  int64_t sent_ns,
+                                  const std::string& payload);
+
+    // Header chunk: the transaction, sequence number, and send time of
+    // a request or response can be carried by a debug chunk, rather
+    // than by its data chunk; senders can then share read-only data
+    // chunks among requests. In that case, the data chunk carries
+    // only the payload: the JSON one has no transaction entry and the
+    // binary one has no header. Agents echo the header chunk.
+
+    /// Set the header chunk entries in the specified container.
+    static void write_header(leatherman::json_container::JsonContainer& header,
+                             const std::string& transaction,
+                             uint64_t sequence,
+                             int64_t sent_ns);
+
+    /// Return the header chunk of the parsed message or nullptr.
+    static const leatherman::json_container::JsonContainer* find_header(
+            const PCPClient::ParsedChunks& parsed_chunks);
+
   private:
     // envelope
     std::string id_;
@@ -54,9 +106,62 @@ class message {
     std::string transaction_;
     std::string timestamp_;
     std::string error_msg_;
+    std::string payload_;
+    uint64_t sequence_;
+    int64_t sent_ns_;
 
     void init(const PCPClient::ParsedChunks &parsed_chunks);
     void validateFormat(const PCPClient::ParsedChunks &parsed_chunks);
 };
 
+// pcp_test::message_view gives access to the entries of a parsed
+// message that the receive path needs, without copying all of them out
+// of the parsed chunks, as a message instance does; it's meant for
+// matching responses at high rates.
+// For binary data, the transaction and the payload reference the data
+// chunk; for JSON data, only the transaction is retrieved, once. In
+// case of a header chunk, the transaction is retrieved from it, once,
+// and the binary payload references the whole data chunk.
+// Envelope entries are retrieved on demand.
+// The view must not outlive the parsed chunks.
+
+class message_view {
+  public:
+    /// Throws a message::error in case the specified ParsedChunks
+    /// has no valid data or no transaction, i.e. no header chunk and,
+    /// for binary data, no header.
+    /// NB: the consistency of the content type and the message type
+    /// is already checked by the schema validation of the Connector.
+    explicit message_view(const PCPClient::ParsedChunks& parsed_chunks);
+
+    message_view(const message_view&) = delete;
+    message_view& operator=(const message_view&) = delete;
+
+    bool is_binary() const;
+
+    boost::string_ref transaction() const;
+
+    // Empty for JSON data
+    boost::string_ref binary_payload() const;
+
+    // 0 if not set; retrieved on each call for JSON data and header
+    // chunks
+    uint64_t sequence() const;
+    int64_t sent_ns() const;
+
+    // Envelope
+    std::string id() const;
+    std::string sender() const;
+
+  private:
+    const PCPClient::ParsedChunks& parsed_chunks_;
+    bool binary_;
+    const leatherman::json_container::JsonContainer* header_;
+    std::string json_transaction_;  // also of the header chunk
+    boost::string_ref binary_transaction_;
+    boost::string_ref binary_payload_;
+    uint64_t binary_sequence_;
+    int64_t binary_sent_ns_;
+};
+
 }  // namespace pcp_test
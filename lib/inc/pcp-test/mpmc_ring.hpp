@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Bounded, lock-free, multi-producer multi-consumer queue.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>  // std::forward
+
+namespace pcp_test {
+
+// pcp_test::mpmc_ring is a bounded, lock-free queue, with a sequence
+// number per slot (as in D. Vyukov's MPMC queue). Pushing and popping
+// never block: they fail if the queue is, respectively, full or empty.
+// A slot can be written once its sequence equals the push position,
+// and read once it equals the pop position + 1.
+// T must be default constructible; popped values are moved out of
+// their slot.
+
+template <typename T>
+class mpmc_ring
+{
+  public:
+    // The capacity is rounded up to a power of 2
+    explicit mpmc_ring(std::size_t capacity)
+            : mask_ {round_up_to_power_of_2(std::max<std::size_t>(2, capacity)) - 1},
+              slots_ {new slot[mask_ + 1]},
+              push_pos_ {0},
+              pop_pos_ {0}
+    {
+        for (std::size_t idx = 0; idx <= mask_; idx++)
+            slots_[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+
+    mpmc_ring(const mpmc_ring&) = delete;
+    mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+    // The value is neither copied nor moved in case the queue is full
+    bool try_push(const T& value) { return push(value); }
+    bool try_push(T&& value) { return push(std::move(value)); }
+
+    bool try_pop(T& value)
+    {
+        auto pos = pop_pos_.load(std::memory_order_relaxed);
+        slot* slot_ptr;
+
+        while (true) {
+            slot_ptr = &slots_[pos & mask_];
+            auto sequence = slot_ptr->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence)
+                        - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0) {
+                if (pop_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = pop_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(slot_ptr->value);
+        slot_ptr->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+  private:
+    struct slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<slot[]> slots_;
+
+    // Padding avoids false sharing between producers and consumers
+    char padding_0_[64];
+    std::atomic<std::size_t> push_pos_;
+    char padding_1_[64];
+    std::atomic<std::size_t> pop_pos_;
+
+    static std::size_t round_up_to_power_of_2(std::size_t value)
+    {
+        std::size_t result {1};
+
+        while (result < value)
+            result <<= 1;
+
+        return result;
+    }
+
+    template <typename U>
+    bool push(U&& value)
+    {
+        auto pos = push_pos_.load(std::memory_order_relaxed);
+        slot* slot_ptr;
+
+        while (true) {
+            slot_ptr = &slots_[pos & mask_];
+            auto sequence = slot_ptr->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = push_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot_ptr->value = std::forward<U>(value);
+        slot_ptr->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * Paced traffic - echo agents and controllers that send requests at a
+ *                 constant rate and measure their round trip; used by
+ *                 the soak and scenario tests.
+ */
+
+#pragma once
+
+#include <pcp-test/client.hpp>
+#include <pcp-test/histogram.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+// Connect (or reconnect) the client; return true if associated
+bool try_connect(client& c);
+
+// The traffic events of a controller since the previous interval
+struct traffic_interval
+{
+    uint64_t num_sent;
+    uint64_t num_failed_sends;
+    uint64_t num_late_sends;     // more than a request interval late
+    uint64_t num_skipped_sends;  // scheduled while failing to reconnect
+    uint64_t num_responses;
+    uint64_t num_errors;         // PCP errors, e.g. undeliverable requests
+    uint64_t num_reconnected;
+    uint64_t num_reconnect_failures;
+    latency_histogram latency_us;  // request round trip
+
+    traffic_interval();
+};
+
+// Replies to each request with a response that carries the same data
+
+class echo_agent : public client
+{
+  public:
+    explicit echo_agent(client_configuration config);
+
+  private:
+    virtual void process_request(const PCPClient::ParsedChunks& parsed_chunks);
+};
+
+// pcp_test::paced_controller sends requests at a constant rate, round
+// robin to the given agents, until the specified time point or until
+// stopped; send times are scheduled, so that slow sends do not lower
+// the rate: a sender that falls behind catches up, counting the sends
+// that were more than an interval late. Requests carry their scheduled
+// send time, echoed by the agents, so that the round trip is measured
+// without keeping any state per request, and includes the delay of
+// late sends.
+// A lost connection is reestablished before the following send; the
+// sends scheduled while failing to reconnect are skipped and counted.
+// Requests are sent by send_requests(), that blocks, whereas responses
+// and errors are processed by the WebSocket event loop thread of the
+// client.
+
+class paced_controller
+{
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    explicit paced_controller(client_configuration config);
+
+    paced_controller(const paced_controller&) = delete;
+    paced_controller& operator=(const paced_controller&) = delete;
+
+    client& get_client();
+
+    // Start from the agent with the specified index, so that multiple
+    // controllers spread the load evenly; return immediately in case
+    // of no agents or a null rate [requests/s]
+    void send_requests(const std::vector<std::string>& agent_uris,
+                       std::size_t first_agent_idx,
+                       unsigned int request_rate,
+                       clock_type::time_point until);
+
+    // Stop sending, for good
+    void stop();
+
+    // Add the events since the previous call to the interval
+    void take_interval(traffic_interval& t_i);
+
+  private:
+    std::mutex stop_mtx_;
+    std::condition_variable stop_cv_;
+    bool stopping_;
+
+    std::atomic<uint64_t> num_sent_;
+    std::atomic<uint64_t> num_failed_sends_;
+    std::atomic<uint64_t> num_late_sends_;
+    std::atomic<uint64_t> num_skipped_sends_;
+    std::atomic<uint64_t> num_responses_;
+    std::atomic<uint64_t> num_errors_;
+    std::atomic<uint64_t> num_reconnected_;
+    std::atomic<uint64_t> num_reconnect_failures_;
+
+    // Synchronizes access to the latencies of the interval
+    std::mutex mtx_;
+    latency_histogram latency_us_;
+
+    // NB: declared last, so that it's destroyed first, with its event
+    // loop thread, before the state accessed by the callbacks
+    client client_;
+
+    bool reconnect();
+    void process_response(const PCPClient::ParsedChunks& parsed_chunks);
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * Pre-builds message payloads of configurable size.
+ */
+
+#pragma once
+
+#include <leatherman/json_container/json_container.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+enum class payload_format { json, binary };
+
+enum class payload_size_distribution { fixed, uniform, exponential };
+
+// pcp_test::payload_generator builds a number of payloads once, so
+// that senders can reuse them instead of creating a new payload for
+// each message.
+// Payload sizes, in bytes, are:
+//  - fixed: always equal to `size`;
+//  - uniform: uniformly distributed in [size, max_size];
+//  - exponential: exponentially distributed with mean `size`, capped
+//    to max_size.
+// JSON payloads contain alphanumeric characters, so that they can be
+// stored as JSON strings without escaping; binary payloads contain
+// arbitrary bytes.
+// For JSON payloads, the data chunks carrying them are built as well;
+// payloads and data chunks are read-only, so that concurrent senders
+// can share them.
+
+class payload_generator
+{
+  public:
+    payload_generator(payload_format format,
+                      payload_size_distribution distribution,
+                      std::size_t num_payloads,
+                      std::size_t size,
+                      std::size_t max_size = 0,
+                      int seed = 0);
+
+    payload_format format() const;
+
+    std::size_t num_payloads() const;
+
+    // Return the payload with index idx modulo the number of payloads
+    const std::string& get(std::size_t idx) const;
+
+    // As above, for the JSON data chunk that has the payload as its
+    // payload entry (none, if empty); JSON payloads only
+    const leatherman::json_container::JsonContainer& get_data(std::size_t idx) const;
+
+    // Mean size of the generated payloads
+    double mean_size() const;
+
+  private:
+    payload_format format_;
+    std::vector<std::string> payloads_;
+    std::vector<leatherman::json_container::JsonContainer> data_;
+};
+
+}  // namespace pcp_test
@@ -15,7 +15,12 @@ namespace pcp_test {
 enum class test_type {
     none,
     connection,
-    trivial
+    throughput,
+    fanout,
+    soak,
+    scenario,
+    trivial,
+    worker
 };
 
 extern const std::unordered_map<std::string, test_type> to_test_type;
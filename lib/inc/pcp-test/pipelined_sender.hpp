@@ -0,0 +1,118 @@
+/**
+ * @file
+ * Sends the requests of a client from a queue, in batches, by keeping
+ * a bounded window of unacknowledged requests in flight.
+ */
+
+#pragma once
+
+#include <pcp-test/client.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct pipeline_counters
+{
+    uint64_t batches;
+    uint64_t sent;
+    uint64_t failed;  // send attempts that failed
+
+    pipeline_counters();
+};
+
+// pcp_test::pipelined_sender decouples the submission of requests
+// from their sending: submit() queues a request, whereas a dedicated
+// thread sends the queued requests back to back, taking at most
+// `max_batch_size` of them from the queue at a time, without holding
+// the queue lock.
+// A request takes a slot of the window from its submission until it
+// is acknowledged by acknowledge(), i.e. once replied or deemed lost;
+// the slot of a request that fails to be sent is released right away.
+// In case all `window` slots are taken, submit() blocks (backpressure).
+// The optional callbacks are executed by the sender thread, before and
+// after each send attempt; e.g. for registering the request in a
+// correlation table and for accounting failures.
+// All member functions are thread safe.
+
+class pipelined_sender
+{
+  public:
+    using clock_type       = std::chrono::steady_clock;
+    using send_function    = std::function<bool(const outgoing_request& request)>;
+    using request_callback = std::function<void(const outgoing_request& request)>;
+    using sent_callback    = std::function<void(const outgoing_request& request,
+                                                bool sent)>;
+
+    // Start the sender thread; requests are sent by the specified client
+    pipelined_sender(client& c,
+                     std::size_t window,
+                     std::size_t max_batch_size,
+                     request_callback before_send = nullptr,
+                     sent_callback after_send = nullptr);
+
+    // As above, by using the specified function for sending
+    pipelined_sender(send_function send,
+                     std::size_t window,
+                     std::size_t max_batch_size,
+                     request_callback before_send = nullptr,
+                     sent_callback after_send = nullptr);
+
+    // Stop the sender (see stop())
+    ~pipelined_sender();
+
+    pipelined_sender(const pipelined_sender&) = delete;
+    pipelined_sender& operator=(const pipelined_sender&) = delete;
+
+    // Queue the request, by waiting for a free slot until the specified
+    // time point; return false, without moving the request, in case the
+    // deadline is reached first or the sender is stopped.
+    bool submit(outgoing_request& request, clock_type::time_point deadline);
+
+    // Release the slots of the specified number of requests
+    void acknowledge(std::size_t num_requests = 1);
+
+    // Stop accepting requests, send the queued ones, and join the
+    // sender thread; acknowledge() can still be called afterwards.
+    void stop();
+
+    std::size_t window() const;
+
+    // Number of requests that are either queued or sent and not
+    // acknowledged yet
+    std::size_t in_flight() const;
+
+    // Number of requests that are queued and not sent yet
+    std::size_t num_queued() const;
+
+    pipeline_counters get_counters() const;
+
+  private:
+    send_function send_;
+    std::size_t window_;
+    std::size_t max_batch_size_;
+    request_callback before_send_;
+    sent_callback after_send_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable not_full_cv_;
+    std::condition_variable not_empty_cv_;
+    std::deque<outgoing_request> queue_;
+    std::size_t in_flight_;
+    bool stopping_;
+    pipeline_counters counters_;
+
+    // Serializes stop() calls
+    std::mutex stop_mtx_;
+    std::thread sender_;
+
+    void send_batches();
+};
+
+}  // namespace pcp_test
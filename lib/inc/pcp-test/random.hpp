@@ -14,9 +14,11 @@ class exponential_integers {
   public:
     using engine_type = std::default_random_engine;
 
-    exponential_integers(double lambda, int seed_val = 0)
+    exponential_integers(double lambda, int seed_val = 0,
+                         uint32_t units_per_second = 1000)
             : engine_ {},
-              distribution_ {lambda}
+              distribution_ {lambda},
+              units_per_second_ {units_per_second}
     {
         if (seed_val)
             engine_.seed(static_cast<engine_type::result_type>(seed_val));
@@ -27,14 +29,17 @@ class exponential_integers {
     //       order to model interarrivals in [ms], as we define the
     //       engine by specifying lambda which, in turn, is a
     //       frequency [Hz].
+    //       A different time unit can be obtained by specifying
+    //       units_per_second (e.g. 10^6 for interarrivals in [us]).
     uint32_t operator()()
     {
-        return static_cast<uint32_t >(1000 * distribution_(engine_));
+        return static_cast<uint32_t >(units_per_second_ * distribution_(engine_));
     }
 
   private:
     engine_type engine_;
     std::exponential_distribution<double> distribution_;
+    uint32_t units_per_second_;
 };
 
 }  // namespace pcp_test
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * Reconnect storm - holds a set of connections, detects the ones that
+ *                   are dropped (e.g. by a broker restart), and
+ *                   reconnects them with a given backoff policy.
+ */
+
+#pragma once
+
+#include <pcp-test/client.hpp>
+#include <pcp-test/task_scheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+enum class backoff_policy { constant, exponential };
+
+enum class jitter_policy { none, full, equal, decorrelated };
+
+struct reconnect_policy
+{
+    backoff_policy backoff;
+    jitter_policy jitter;
+    std::chrono::milliseconds base_delay;
+    std::chrono::milliseconds max_delay;
+};
+
+// pcp_test::reconnect_backoff determines the pause before each
+// reconnection attempt of an endpoint. Attempts are counted from 0.
+// The constant backoff pauses for the base delay; the exponential
+// one doubles it at each attempt, up to the maximum delay. Jitter is
+// then applied to the pause d:
+//  - none: d;
+//  - full: a random value in [0, d];
+//  - equal: d / 2 plus a random value in [0, d / 2];
+//  - decorrelated: a random value in [base delay, 3 * previous
+//    pause], up to the maximum delay; the backoff is ignored.
+// Not thread-safe.
+
+class reconnect_backoff
+{
+  public:
+    // Throw a fatal_error in case of a non-positive base delay, or
+    // if the maximum delay is less than the base one
+    reconnect_backoff(reconnect_policy policy, int seed = 0);
+
+    // The previous pause is only used by the decorrelated jitter;
+    // the base delay is used for the first attempt
+    std::chrono::milliseconds delay(unsigned int attempt,
+                                    std::chrono::milliseconds previous);
+
+  private:
+    reconnect_policy policy_;
+    std::default_random_engine engine_;
+
+    int64_t uniform(int64_t min, int64_t max);
+};
+
+// Outcome of a storm, i.e. the interval between the detection of a
+// dropped connection, while all connections were associated, and the
+// re-association of all of them
+struct reconnect_storm_result
+{
+    int num_dropped;
+    int num_attempts;          // reconnection attempts started
+    int num_failed_attempts;
+    int64_t reassociation_ms;  // time to full re-association; -1 if ongoing
+    int peak_attempt_rate;     // attempts started within a second, max
+
+    reconnect_storm_result();
+};
+
+struct reconnect_stats
+{
+    int num_connections;       // held
+    int num_not_associated;    // at the end of the holding period
+    std::vector<reconnect_storm_result> storms;
+
+    reconnect_stats();
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const reconnect_stats& r_s);
+};
+
+// pcp_test::reconnect_storm_tracker accounts for drops and
+// reconnection attempts, given the time they happen at. The attempt
+// rate is measured over the 1 s intervals following the start of a
+// storm. Not thread-safe.
+
+class reconnect_storm_tracker
+{
+  public:
+    using clock_type = std::chrono::steady_clock;
+
+    explicit reconnect_storm_tracker(std::size_t num_connections);
+
+    void dropped(clock_type::time_point t);
+    void attempt_started(clock_type::time_point t);
+    void attempt_failed();
+    void reassociated(clock_type::time_point t);
+
+    std::size_t num_disconnected() const;
+
+    // Includes the ongoing storm, if any
+    reconnect_stats get_stats() const;
+
+  private:
+    std::size_t num_connections_;
+    std::size_t num_disconnected_;
+    clock_type::time_point storm_start_;
+    int64_t rate_interval_idx_;
+    int num_interval_attempts_;
+    reconnect_storm_result current_storm_;
+    std::vector<reconnect_storm_result> storms_;
+};
+
+// pcp_test::reconnect_monitor checks the association of each client
+// once per check interval; the checks of all clients are evenly spread
+// over an interval. Dropped clients are reconnected by the workers of
+// a task_scheduler, after a pause given by the reconnect_backoff.
+// Connections that are not associated when holding starts are not
+// monitored.
+
+class reconnect_monitor
+{
+  public:
+    using clock_type = task_scheduler::clock_type;
+
+    reconnect_monitor(std::vector<std::shared_ptr<client>> client_ptrs,
+                      reconnect_policy policy,
+                      std::chrono::milliseconds check_interval,
+                      unsigned int num_threads,
+                      int seed = 0);
+
+    // Stop monitoring and join the workers; that may take up to a
+    // connection timeout, in case of ongoing attempts
+    ~reconnect_monitor();
+
+    reconnect_monitor(const reconnect_monitor&) = delete;
+    reconnect_monitor& operator=(const reconnect_monitor&) = delete;
+
+    std::size_t num_connections() const;
+
+    // Monitor the connections for the specified interval, then stop
+    reconnect_stats hold(std::chrono::seconds duration);
+
+  private:
+    // Accessed by one task at a time
+    struct endpoint
+    {
+        std::shared_ptr<client> client_ptr;
+        unsigned int attempt;
+        std::chrono::milliseconds previous_delay;
+    };
+
+    std::vector<std::shared_ptr<endpoint>> endpoints_;
+    std::chrono::microseconds check_interval_;
+    std::atomic<bool> stopping_;
+
+    // Synchronizes the access to the backoff and to the tracker
+    std::mutex mtx_;
+    reconnect_backoff backoff_;
+    reconnect_storm_tracker tracker_;
+
+    // NB: must be the last member, so that its workers are joined
+    // before destroying the endpoints
+    task_scheduler scheduler_;
+
+    static std::vector<std::shared_ptr<endpoint>> make_endpoints(
+            std::vector<std::shared_ptr<client>> client_ptrs);
+
+    void check(std::shared_ptr<endpoint> ep_ptr);
+    void schedule_reconnection(std::shared_ptr<endpoint> ep_ptr);
+    void reconnect(std::shared_ptr<endpoint> ep_ptr);
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,129 @@
+/**
+ * @file
+ * Resource monitor - samples the CPU, memory, threads, file descriptors,
+ *                    and scheduler lag of the pcp-test process itself, so
+ *                    that a saturated load generator can be told apart
+ *                    from a saturated broker.
+ */
+
+#pragma once
+
+#include <pcp-test/histogram.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct resource_sample
+{
+    std::chrono::system_clock::time_point time;
+    int run_idx;
+    double cpu_percent;        // user + system, 100 per busy core
+    uint64_t rss_kb;
+    int num_threads;
+    int num_fds;
+    latency_histogram lag_us;  // of the probe wakeups, during the interval
+
+    resource_sample();
+};
+
+struct resource_usage
+{
+    unsigned int num_samples;
+    double mean_cpu_percent;
+    double max_cpu_percent;
+    uint64_t max_rss_kb;
+    int max_threads;
+    int max_fds;
+    latency_histogram lag_us;
+    bool saturated;            // CPU or scheduler lag above the thresholds
+
+    resource_usage();
+
+    // Include the usage of another process (e.g. a worker), that is
+    // saturated if either is
+    void merge(const resource_usage& other);
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const resource_usage& usage);
+
+    // To file (csv)
+    friend std::ofstream & operator<< (boost::nowide::ofstream& out_stream,
+                                       const resource_usage& usage);
+};
+
+// pcp_test::resource_monitor runs a probe thread that sleeps for
+// PROBE_INTERVAL and measures how late each wakeup is; that lag is
+// what any sleeping thread of the process (e.g. a Connection Task
+// pausing between connections) suffers. Every SAMPLING_INTERVAL, the
+// process stats are read from /proc (on other platforms, only the CPU
+// time is available) and, if a file path is specified, a CSV row is
+// appended for each sample. Samples are accumulated into the usage of
+// the current run, as delimited by start_run() and end_run().
+// The process is deemed saturated when its mean CPU usage exceeds
+// SATURATION_CPU_RATIO of the available cores, or when the 99th
+// percentile of the lag exceeds SATURATION_LAG_US.
+
+class resource_monitor
+{
+  public:
+    static const std::chrono::milliseconds PROBE_INTERVAL;
+    static const std::chrono::milliseconds SAMPLING_INTERVAL;
+    static const double SATURATION_CPU_RATIO;
+    static const uint32_t SATURATION_LAG_US;
+
+    // Throw a fatal_error if the file cannot be opened; an empty path
+    // means no file
+    explicit resource_monitor(const std::string& file_path,
+                              unsigned int num_cores = std::thread::hardware_concurrency());
+
+    // Write the last sample and stop
+    ~resource_monitor();
+
+    resource_monitor(const resource_monitor&) = delete;
+    resource_monitor& operator=(const resource_monitor&) = delete;
+
+    void start_run(int run_idx);
+
+    // Include the current, partial interval and return the usage since
+    // the last start_run()
+    resource_usage end_run();
+
+    resource_sample get_last_sample() const;
+
+  private:
+    unsigned int num_cores_;
+    boost::nowide::ofstream file_stream_;
+    std::chrono::steady_clock::time_point start_;
+
+    // Synchronizes access to the state below
+    mutable std::mutex mtx_;
+    std::condition_variable stop_cv_;
+    bool stopping_;
+    int run_idx_;
+    std::chrono::steady_clock::time_point last_sample_time_;
+    int64_t last_cpu_time_us_;
+    latency_histogram interval_lag_us_;
+    resource_sample last_sample_;
+    resource_usage run_usage_;
+
+    std::thread probe_thread_;
+
+    // Must be called with the lock held
+    resource_sample take_sample();
+    void accumulate(const resource_sample& s);
+    void write_sample(const resource_sample& s);
+
+    void probe();
+};
+
+}  // namespace pcp_test
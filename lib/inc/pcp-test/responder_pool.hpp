@@ -0,0 +1,111 @@
+/**
+ * @file
+ * Pool of worker threads that process the requests received by agents,
+ * outside of the WebSocket event loop threads.
+ */
+
+#pragma once
+
+#include <pcp-test/client.hpp>
+#include <pcp-test/mpmc_ring.hpp>
+
+#include <cpp-pcp-client/protocol/chunks.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+enum class delay_distribution { fixed, uniform, exponential };
+
+struct responder_counters
+{
+    uint64_t processed;
+    uint64_t dropped;  // the queue was full
+
+    responder_counters();
+};
+
+// pcp_test::responder_pool lets agents process requests without
+// stalling the read loop of their connection: the message callback
+// enqueues a copy of the parsed request into a lock-free mpmc_ring,
+// shared by all agents, and returns; requests are dropped (and
+// counted) in case the ring is full, so that enqueuing never blocks.
+// Each worker waits for the simulated processing delay of a request
+// before executing the handler, so that a pool of N workers models a
+// service with N servers. Processing delays, in microseconds, are:
+//  - fixed: always equal to `delay_us`;
+//  - uniform: uniformly distributed in [delay_us, max_delay_us];
+//  - exponential: exponentially distributed with mean `delay_us`,
+//    capped to max_delay_us.
+// Idle workers wait on a condition variable; producers notify only in
+// case some worker is idle.
+
+class responder_pool
+{
+  public:
+    using handler_type = client::msg_callback;
+
+    static constexpr std::size_t DEFAULT_QUEUE_CAPACITY {1 << 16};
+
+    // Start the workers
+    responder_pool(handler_type handler,
+                   unsigned int num_threads,
+                   std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY,
+                   delay_distribution distribution = delay_distribution::fixed,
+                   unsigned int delay_us = 0,
+                   unsigned int max_delay_us = 0,
+                   int seed = 0);
+
+    // Stop the workers (see stop())
+    ~responder_pool();
+
+    responder_pool(const responder_pool&) = delete;
+    responder_pool& operator=(const responder_pool&) = delete;
+
+    // Thread-safe; never blocks. Return false in case the request was
+    // dropped, as the queue is full or the pool is stopped.
+    bool enqueue(const PCPClient::ParsedChunks& parsed_chunks, client* client_ptr);
+
+    // Stop and join the workers; queued requests are discarded.
+    // Must be called before destroying the clients of queued requests.
+    void stop();
+
+    unsigned int num_threads() const;
+
+    responder_counters get_counters() const;
+
+  private:
+    struct request
+    {
+        PCPClient::ParsedChunks parsed_chunks;
+        client* client_ptr;
+    };
+
+    handler_type handler_;
+    delay_distribution distribution_;
+    unsigned int delay_us_;
+    unsigned int max_delay_us_;
+    int seed_;
+    mpmc_ring<request> ring_;
+    std::atomic<uint64_t> num_processed_;
+    std::atomic<uint64_t> num_dropped_;
+    std::atomic<bool> stopping_;
+
+    // Used only for parking idle workers
+    std::atomic<unsigned int> num_idle_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+
+    // Serializes stop() calls
+    std::mutex stop_mtx_;
+    std::vector<std::thread> workers_;
+
+    void work(unsigned int worker_idx);
+};
+
+}  // namespace pcp_test
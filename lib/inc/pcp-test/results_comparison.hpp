@@ -0,0 +1,59 @@
+/**
+ * @file
+ * Results comparison - compares the runs of two results documents and
+ *                      flags throughput, latency, and failure rate
+ *                      regressions beyond given thresholds.
+ */
+
+#pragma once
+
+#include <pcp-test/results_document.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+struct comparison_thresholds
+{
+    double max_throughput_drop_pct;
+    double max_latency_increase_pct;
+    double min_latency_increase_ms;  // smaller increases are noise
+    double max_failure_rate_increase_pct;  // in percentage points
+
+    // 10% throughput drop, 20% (and 1 ms) latency increase, 1 point
+    // failure rate increase
+    comparison_thresholds();
+};
+
+struct metric_change
+{
+    std::string run_key;
+    std::string metric;
+    double baseline;
+    double candidate;
+    double change_pct;  // relative; 0 if the baseline is 0
+    bool regression;
+};
+
+struct results_comparison
+{
+    std::vector<metric_change> changes;
+    std::vector<std::string> unmatched_runs;  // of either set
+
+    bool has_regressions() const;
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const results_comparison& comparison);
+};
+
+// Runs are matched by key, in order: the n-th baseline run with a given
+// key is compared with the n-th candidate run with the same key. Only
+// the latencies present in both runs are compared.
+results_comparison compare_results(const std::vector<run_summary>& baseline,
+                                   const std::vector<run_summary>& candidate,
+                                   const comparison_thresholds& thresholds);
+
+}  // namespace pcp_test
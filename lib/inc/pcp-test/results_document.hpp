@@ -0,0 +1,83 @@
+/**
+ * @file
+ * Results document - machine readable results, in JSON format, with the
+ *                    metadata needed to reproduce and compare the runs.
+ */
+
+#pragma once
+
+#include <pcp-test/application_options.hpp>
+
+#include <leatherman/json_container/json_container.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+// The key metrics of a run, by which runs of different tests are
+// compared (see results_comparison.hpp). Runs are matched by key,
+// that identifies the load (e.g. "40x4" for 4 sets of 40 endpoints).
+struct run_summary
+{
+    std::string key;
+    double throughput;        // e.g. connections/s
+    double failure_rate_pct;
+    std::map<std::string, double> latencies_ms;  // e.g. "connect_p99"
+
+    run_summary();
+};
+
+// A results document, as loaded from file
+struct results_set
+{
+    std::string pcp_test_version;
+    std::string test;
+    std::string start;
+    std::vector<std::string> broker_ws_uris;
+    std::vector<run_summary> runs;
+};
+
+// pcp_test::results_document writes a JSON object with:
+//  - pcp-test-version, test, start (UTC, ISO 8601), and hostname;
+//  - broker-ws-uris and parameters (the test parameters object of the
+//    configuration file, as is);
+//  - runs: an array with an entry per run, that includes the summary
+//    of the run.
+// The file is rewritten (atomically, by renaming a temporary file)
+// each time a run is added, so that it is valid in case the test is
+// interrupted. Not thread safe.
+
+class results_document
+{
+  public:
+    // Throw a fatal_error in case the file cannot be written
+    results_document(std::string file_path,
+                     const std::string& test,
+                     const application_options& a_o,
+                     const leatherman::json_container::JsonContainer& parameters);
+
+    results_document(const results_document&) = delete;
+    results_document& operator=(const results_document&) = delete;
+
+    // Add the summary to the entry, append it, and rewrite the file;
+    // throw a fatal_error in case of failure
+    void add_run(leatherman::json_container::JsonContainer run,
+                 const run_summary& summary);
+
+    const std::string& file_path() const;
+
+  private:
+    std::string file_path_;
+    leatherman::json_container::JsonContainer document_;
+    std::vector<leatherman::json_container::JsonContainer> runs_;
+
+    void write();
+};
+
+// Throw a fatal_error in case the file cannot be read or is not a
+// valid results document
+results_set load_results(const std::string& file_path);
+
+}  // namespace pcp_test
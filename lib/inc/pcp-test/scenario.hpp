@@ -0,0 +1,75 @@
+/**
+ * @file
+ * Scenario - a workload described as a sequence of phases (connection
+ *            ramps, holds, message load, reconnect storms, teardowns),
+ *            as executed by the scenario test.
+ */
+
+#pragma once
+
+#include <pcp-test/reconnect_storm.hpp>
+
+#include <leatherman/json_container/json_container.hpp>
+
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+enum class phase_type { connect, hold, messages, reconnect_storm, teardown };
+
+// As in the scenario, e.g. "reconnect-storm"
+std::string phase_type_name(phase_type type);
+
+// The population of a scenario consists of the clients connected by
+// its connect phases; teardown phases close the oldest clients first.
+// Which parameters apply depends on the type:
+//  - connect: num_agents and num_controllers new clients, at the given
+//    rate [connections/s];
+//  - hold: keeps the clients associated for duration_s, reconnecting
+//    the dropped ones with the reconnect policy;
+//  - messages: as hold, while the controllers send request_rate
+//    requests/s in total, round robin to the agents;
+//  - reconnect_storm: drops fraction_pct of the clients and reconnects
+//    them with the reconnect policy, for up to duration_s;
+//  - teardown: closes num_agents and num_controllers clients (all, if
+//    -1), at the given rate [closes/s].
+// A null rate means no limit.
+struct scenario_phase
+{
+    phase_type type;
+    std::string name;            // defaults to the type name
+    int num_agents;
+    int num_controllers;
+    unsigned int rate;
+    unsigned int duration_s;
+    unsigned int request_rate;
+    unsigned int fraction_pct;
+    reconnect_policy policy;
+
+    explicit scenario_phase(phase_type type = phase_type::hold);
+};
+
+// The number of clients connected over a scenario, i.e. of the needed
+// certificates
+struct scenario_population
+{
+    int num_agents;
+    int num_controllers;
+};
+
+// Parse the phases array of the scenario test parameters or, in case
+// the scenario-file parameter is given, of the JSON object in that
+// file, and validate them; throw a configuration_error in case of
+// failure
+std::vector<scenario_phase> parse_scenario(
+        const leatherman::json_container::JsonContainer& parameters);
+
+// Throw a configuration_error in case a phase has invalid parameters
+// or cannot be executed with the clients connected by the previous
+// ones (e.g. message load without agents)
+void validate_scenario(const std::vector<scenario_phase>& phases);
+
+scenario_population get_scenario_population(const std::vector<scenario_phase>& phases);
+
+}  // namespace pcp_test
@@ -15,12 +15,23 @@ namespace schemas {
 extern const std::string REQUEST_TYPE;
 extern const std::string RESPONSE_TYPE;
 extern const std::string ERROR_TYPE;
+extern const std::string BINARY_REQUEST_TYPE;
+extern const std::string BINARY_RESPONSE_TYPE;
 
-PCPClient::Schema request();
-PCPClient::Schema response();
-PCPClient::Schema error();
+// Message schemas are built once and cached
+const PCPClient::Schema& request();
+const PCPClient::Schema& response();
+const PCPClient::Schema& error();
+
+// Binary data: see message::get_binary_data()
+const PCPClient::Schema& binary_request();
+const PCPClient::Schema& binary_response();
 
 PCPClient::Schema connection_test_parameters();
+PCPClient::Schema throughput_test_parameters();
+PCPClient::Schema fanout_test_parameters();
+PCPClient::Schema soak_test_parameters();
+PCPClient::Schema scenario_test_parameters();
 
 }  // namespace schemas
 }  // namespace pcp-test
@@ -0,0 +1,68 @@
+/**
+ * @file
+ * Detects reordered, duplicate, and missing messages by tracking the
+ * sequence numbers of each sender.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace pcp_test {
+
+struct sequence_counters
+{
+    uint64_t received;
+    uint64_t reordered;   // received after a higher sequence number
+    uint64_t duplicates;
+    uint64_t missing;     // skipped sequence numbers, not received (yet)
+
+    sequence_counters();
+};
+
+// pcp_test::sequence_tracker expects each sender to number its
+// messages from 1, by increments of 1. A sequence number higher than
+// the next expected one opens a gap; the skipped numbers are missing
+// until they are received, as reordered messages. For each sender, the
+// last `max_gaps` missing numbers are remembered, so that older ones
+// are deemed lost and later arrivals are counted as duplicates.
+// Messages lost after the last one received cannot be detected.
+// Sequence number 0 means not set: such messages are ignored.
+// All member functions are thread safe.
+
+class sequence_tracker
+{
+  public:
+    static constexpr std::size_t DEFAULT_MAX_GAPS {4096};
+
+    explicit sequence_tracker(std::size_t max_gaps = DEFAULT_MAX_GAPS);
+
+    sequence_tracker(const sequence_tracker&) = delete;
+    sequence_tracker& operator=(const sequence_tracker&) = delete;
+
+    void record(const std::string& sender, uint64_t sequence);
+
+    std::size_t num_senders() const;
+
+    sequence_counters get_counters() const;
+
+  private:
+    struct sender_state
+    {
+        uint64_t next_expected;
+        std::set<uint64_t> gaps;  // missing sequence numbers
+    };
+
+    std::size_t max_gaps_;
+
+    // Synchronizes access to the state below
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, sender_state> senders_;
+    sequence_counters counters_;
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,87 @@
+/**
+ * @file
+ * Fixed pool of worker threads that execute tasks at given time points.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+// pcp_test::task_scheduler keeps a deadline-ordered queue of tasks;
+// a task is executed by the first available worker once its time
+// point is reached. Tasks scheduled for the same time point are
+// executed in FIFO order.
+// Tasks should not block for long periods, as they would prevent
+// the worker from executing other due tasks; pauses should rather
+// be modeled by scheduling a follow-up task.
+
+class task_scheduler
+{
+  public:
+    using clock_type = std::chrono::steady_clock;
+    using task_type  = std::function<void()>;
+
+    // Start the specified number of workers; in case num_threads
+    // is 0, start one worker per hardware thread.
+    explicit task_scheduler(unsigned int num_threads = 0);
+
+    // Stop and join the workers; pending tasks are discarded.
+    ~task_scheduler();
+
+    task_scheduler(const task_scheduler&) = delete;
+    task_scheduler& operator=(const task_scheduler&) = delete;
+
+    // Execute the task as soon as a worker is available.
+    void schedule(task_type task);
+
+    // Execute the task not before the specified time point.
+    void schedule_at(clock_type::time_point due, task_type task);
+
+    // Execute the task once the specified interval has elapsed.
+    void schedule_after(std::chrono::microseconds delay, task_type task);
+
+    unsigned int num_threads() const;
+
+    // Number of tasks that have been scheduled but not yet started.
+    std::size_t num_pending() const;
+
+    // Index, in [0, num_threads), of the worker executing the
+    // calling task; -1 if not called by a worker.
+    static int worker_index();
+
+  private:
+    struct entry
+    {
+        clock_type::time_point due;
+        uint64_t seq;
+        task_type task;
+    };
+
+    // Heap comparator; the earliest entry is kept on top
+    struct later
+    {
+        bool operator()(const entry& a, const entry& b) const
+        {
+            return a.due > b.due || (a.due == b.due && a.seq > b.seq);
+        }
+    };
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<entry> queue_;
+    uint64_t seq_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+
+    void work(int worker_idx);
+};
+
+}  // namespace pcp_test
@@ -7,17 +7,29 @@
 #pragma once
 
 #include <pcp-test/application_options.hpp>
+#include <pcp-test/broker_distribution.hpp>
+#include <pcp-test/capacity_search.hpp>
 #include <pcp-test/connection_stats.hpp>
 #include <pcp-test/client.hpp>
+#include <pcp-test/client_pool.hpp>
+#include <pcp-test/distributed.hpp>
+#include <pcp-test/event_recorder.hpp>
+#include <pcp-test/failure_stats.hpp>
+#include <pcp-test/keepalive_scheduler.hpp>
+#include <pcp-test/live_metrics.hpp>
+#include <pcp-test/reconnect_storm.hpp>
+#include <pcp-test/resource_monitor.hpp>
+#include <pcp-test/results_document.hpp>
+#include <pcp-test/task_scheduler.hpp>
 
 #include <boost/nowide/fstream.hpp>
 
 #include <ostream>
 #include <chrono>
+#include <functional>
 #include <thread>
-#include <condition_variable>
-#include <mutex>
 #include <memory>
+#include <string>
 #include <vector>
 #include <chrono>
 
@@ -30,12 +42,15 @@ struct connection_test_run
   private:
     int endpoints_increment_;
     int concurrency_increment_;
+    int connection_rate_increment_;
     int endpoint_timeout_ms_;
 
   public:
     int idx;
+    int level;            // of the ramp; the initial run is at level 0
     int num_endpoints;
     int concurrency;
+    int connection_rate;  // open-loop arrivals only [connections/s]
     int rng_seed;
     int total_endpoint_timeout_ms;
 
@@ -43,16 +58,54 @@ struct connection_test_run
 
     connection_test_run& operator++();
 
+    // Move to the next run, at the specified level of the ramp
+    connection_test_run& set_level(int new_level);
+
     std::string to_string() const;
+
+    // WebSocket connection plus Association timeout of a single endpoint
+    int endpoint_timeout_ms() const;
+
+    // In case of open-loop arrivals, includes the connection rate
+    std::string to_string(bool open_loop) const;
+};
+
+struct teardown_result
+{
+    int num_connections;  // connections that were open
+    int num_failures;     // closing handshakes not completed in time
+    int duration_ms;
+
+    teardown_result();
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const teardown_result& t_r);
+};
+
+struct broker_result
+{
+    std::string broker_ws_uri;
+    int num_attempts;
+    int num_failures;  // not associated at the end of the run
 };
 
 struct connection_test_result
 {
     int num_endpoints;
     int concurrency;
+    int num_attempts;
+    int num_reused;     // incremental ramp only: connections of previous runs
     int num_failures;
     int duration_ms;
+    connection_timings timings;  // if show-stats is flagged
     connection_stats conn_stats;
+    keepalive_stats keepalive;  // if connections are persisted
+    reconnect_stats reconnect;  // reconnect storm only
+    teardown_result teardown;   // not in incremental ramp mode
+    resource_usage resources;   // of pcp-test, if resource-stats is flagged
+    failure_breakdown failures;
+    std::vector<broker_result> brokers;
     std::chrono::high_resolution_clock::time_point start;
     std::chrono::high_resolution_clock::time_point completion;
 
@@ -61,6 +114,10 @@ struct connection_test_result
     // Sets the completion time point
     void set_completion();
 
+    // Include the results of another share of the same run (e.g.
+    // performed by a different worker), as if they were concurrent
+    void merge(const connection_test_result& other);
+
     // To stdout (human readable)
     friend std::ostream& operator<< (std::ostream& out_stream,
                                      const connection_test_result& results);
@@ -77,6 +134,13 @@ class connection_test
 
     void start();
 
+    // Perform a share of a distributed run, starting from the
+    // specified client name; wait_start is called once the clients
+    // are built, right before connecting them
+    connection_test_result perform_run(const connection_test_run& run,
+                                       std::size_t first_name_idx,
+                                       const std::function<void()>& wait_start);
+
   private:
     const application_options& app_opt_;
     int num_runs_;
@@ -86,25 +150,57 @@ class connection_test
     double mean_connection_rate_Hz_;
     unsigned int ws_connection_timeout_ms_;
     unsigned int ws_connection_check_interval_s_;
+    unsigned int keepalive_threads_;
     unsigned int association_timeout_s_;
     unsigned int association_request_ttl_s_;
     bool persist_connections_;
     bool show_stats_;
+    bool latency_correction_;           // closed-loop connect latency
+    bool open_loop_;
+    unsigned int ramp_up_ms_;
+    bool incremental_ramp_;
+    unsigned int teardown_parallelism_;  // 0 means one thread per set
+    unsigned int teardown_rate_;         // 0 means no limit [closes/s]
+    bool capacity_search_;
+    int max_failures_;                   // of a passing capacity search run
+    unsigned int latency_slo_ms_;        // 0 means no latency SLO
+    bool reconnect_storm_;
+    unsigned int hold_duration_s_;
+    unsigned int reconnect_check_interval_ms_;
+    reconnect_policy reconnect_policy_;
+    broker_distribution broker_distribution_;
+    std::vector<std::string> workers_;  // distributed test only
+    std::string connection_engine_;
+    unsigned int engine_threads_;
+    std::unique_ptr<task_scheduler> scheduler_;
     connection_test_run current_run_;
     std::string results_file_name_;
     boost::nowide::ofstream results_file_stream_;
-    std::thread keepalive_thread_;
-    std::mutex keepalive_mtx_;
-    std::condition_variable keepalive_cv_;
-    bool stop_keepalive_task_;
+    results_document results_document_;
+    client_pool client_pool_;
+    std::unique_ptr<keepalive_scheduler> keepalive_ptr_;
+    std::unique_ptr<worker_coordinator> coordinator_ptr_;
+    std::shared_ptr<live_metrics> live_metrics_ptr_;
+    std::unique_ptr<live_metrics_reporter> live_metrics_reporter_ptr_;
+    std::shared_ptr<event_recorder> event_recorder_ptr_;
+    std::unique_ptr<resource_monitor> resource_monitor_ptr_;
 
     void display_setup();
+    void display_brokers(const connection_test_result& results);
     void display_execution_time(std::chrono::system_clock::time_point start_time);
-    connection_test_result perform_current_run();
-    void keepalive_task(
-            std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs);
-    void close_connections_concurrently(
-            std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs);
+    void record_results(const connection_test_result& results);
+    bool passes_capacity_criteria(const connection_test_result& results) const;
+    void display_capacity(const connection_test_run* passing_run_ptr,
+                          const connection_test_run* failing_run_ptr);
+    connection_test_result perform_current_run(std::size_t first_name_idx,
+                                               const std::function<void()>& wait_start);
+    reconnect_stats hold_connections(
+            const std::vector<std::vector<std::shared_ptr<client>>>& all_clients_ptrs);
+    void keep_alive(const std::vector<std::shared_ptr<client>>& client_ptrs);
+    keepalive_stats stop_keepalive();
+    teardown_result close_connections(
+            std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs,
+            connection_timings_accumulator* timings_acc_ptr);
 };
 
 }  // namespace pcp_test
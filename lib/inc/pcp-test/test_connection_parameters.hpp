@@ -21,10 +21,65 @@ extern const std::string RANDOMIZE_INTER_ENDPOINT_PAUSE;
 extern const std::string INTER_ENDPOINT_PAUSE_RNG_SEED;
 extern const std::string WS_CONNECTION_TIMEOUT_MS;
 extern const std::string WS_CONNECTION_CHECK_INTERVAL_S;
+extern const std::string KEEPALIVE_THREADS;
 extern const std::string ASSOCIATION_TIMEOUT_S;
 extern const std::string ASSOCIATION_REQUEST_TTL_S;
 extern const std::string PERSIST_CONNECTIONS;
 extern const std::string SHOW_STATS;
+extern const std::string CONNECTION_ENGINE;
+extern const std::string ENGINE_THREADS;
+extern const std::string ARRIVAL_MODE;
+extern const std::string CONNECTION_RATE;
+extern const std::string CONNECTION_RATE_INCREMENT;
+extern const std::string RAMP_UP_MS;
+extern const std::string INCREMENTAL_RAMP;
+extern const std::string TEARDOWN_PARALLELISM;
+extern const std::string TEARDOWN_RATE;
+extern const std::string BROKER_DISTRIBUTION;
+extern const std::string BROKER_WEIGHTS;
+extern const std::string WORKERS;
+extern const std::string WORKER_PORT;
+extern const std::string WORKER_BIND_ADDRESS;
+extern const std::string LIVE_METRICS;
+extern const std::string LIVE_METRICS_PORT;
+extern const std::string LIVE_METRICS_BIND_ADDRESS;
+extern const std::string EVENT_LOG;
+extern const std::string RESOURCE_STATS;
+extern const std::string CAPACITY_SEARCH;
+extern const std::string MAX_FAILURES;
+extern const std::string LATENCY_SLO_MS;
+extern const std::string RECONNECT_STORM;
+extern const std::string HOLD_DURATION_S;
+extern const std::string RECONNECT_CHECK_INTERVAL_MS;
+extern const std::string RECONNECT_BACKOFF;
+extern const std::string RECONNECT_BACKOFF_MS;
+extern const std::string RECONNECT_BACKOFF_MAX_MS;
+extern const std::string RECONNECT_JITTER;
+extern const std::string LATENCY_CORRECTION;
+
+// connection-engine values
+extern const std::string THREADED_ENGINE;
+extern const std::string POOLED_ENGINE;
+
+// arrival-mode values
+extern const std::string CLOSED_LOOP_ARRIVALS;
+extern const std::string OPEN_LOOP_ARRIVALS;
+
+// broker-distribution values
+extern const std::string FIRST_BROKER;
+extern const std::string ROUND_ROBIN_BROKERS;
+extern const std::string WEIGHTED_BROKERS;
+extern const std::string HASHED_BROKERS;
+
+// reconnect-backoff values
+extern const std::string CONSTANT_BACKOFF;
+extern const std::string EXPONENTIAL_BACKOFF;
+
+// reconnect-jitter values
+extern const std::string NO_JITTER;
+extern const std::string FULL_JITTER;
+extern const std::string EQUAL_JITTER;
+extern const std::string DECORRELATED_JITTER;
 
 }  // namespace connection_test_parameters
 }  // namespace pcp_test
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * Fan-out test - determines how fast a given PCP broker delivers requests
+ *                sent to many agents at once, by wildcard or explicit
+ *                endpoints.
+ */
+
+#pragma once
+
+#include <pcp-test/application_options.hpp>
+#include <pcp-test/histogram.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <ostream>
+#include <chrono>
+#include <string>
+#include <stdint.h>
+
+namespace pcp_test {
+
+void run_fanout_test(const application_options& a_o);
+
+struct fanout_test_run
+{
+  private:
+    int agents_increment_;
+    int controllers_increment_;
+
+  public:
+    int idx;
+    int num_agents;
+    int num_controllers;
+
+    explicit fanout_test_run(const application_options& a_o);
+
+    fanout_test_run& operator++();
+
+    std::string to_string() const;
+};
+
+struct fanout_test_result
+{
+    int num_agents;
+    int num_controllers;
+    int num_association_failures;
+    uint64_t num_broadcasts;
+    uint64_t num_failed_sends;
+    uint64_t num_complete;    // broadcasts replied by all agents in time
+    uint64_t num_expected;    // responses
+    uint64_t num_delivered;   // responses of distinct agents, in time
+    uint64_t num_duplicates;
+    uint64_t num_late;        // responses received after the timeout
+    uint64_t num_unknown;     // invalid responses, unknown transactions or agents
+    int duration_ms;          // from the first send to the last response
+    latency_histogram time_to_first_us;
+    latency_histogram time_to_last_us;  // of complete broadcasts
+
+    explicit fanout_test_result(const fanout_test_run& run);
+
+    // Delivered over expected responses
+    double completeness() const;
+
+    // Delivered responses per second
+    double delivery_rate() const;
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const fanout_test_result& results);
+
+    // To file (csv)
+    friend std::ofstream & operator<< (boost::nowide::ofstream& out_stream,
+                                       const fanout_test_result& results);
+};
+
+class fanout_test
+{
+  public:
+    explicit fanout_test(const application_options& a_o);
+
+    void start();
+
+  private:
+    const application_options& app_opt_;
+    int num_runs_;
+    unsigned int inter_run_pause_ms_;
+    int num_broadcasts_;
+    bool wildcard_;
+    unsigned int broadcast_pause_ms_;
+    unsigned int response_timeout_ms_;
+    unsigned int message_ttl_s_;
+    unsigned int ws_connection_timeout_ms_;
+    unsigned int association_timeout_s_;
+    fanout_test_run current_run_;
+    std::string results_file_name_;
+    boost::nowide::ofstream results_file_stream_;
+
+    void display_setup();
+    void display_execution_time(std::chrono::system_clock::time_point start_time);
+    fanout_test_result perform_current_run();
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,32 @@
+/**
+ * @file
+ * Fan-out test parameters.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace pcp_test{
+namespace fanout_test_parameters {
+
+extern const std::string NUM_RUNS;
+extern const std::string INTER_RUN_PAUSE_MS;
+extern const std::string NUM_AGENTS;
+extern const std::string NUM_CONTROLLERS;
+extern const std::string NUM_BROADCASTS;
+extern const std::string AGENTS_INCREMENT;
+extern const std::string CONTROLLERS_INCREMENT;
+extern const std::string TARGETING;
+extern const std::string BROADCAST_PAUSE_MS;
+extern const std::string RESPONSE_TIMEOUT_MS;
+extern const std::string MESSAGE_TTL_S;
+extern const std::string WS_CONNECTION_TIMEOUT_MS;
+extern const std::string ASSOCIATION_TIMEOUT_S;
+
+// targeting values
+extern const std::string WILDCARD_TARGETING;
+extern const std::string EXPLICIT_TARGETING;
+
+}  // namespace fanout_test_parameters
+}  // namespace pcp_test
@@ -0,0 +1,127 @@
+/**
+ * @file
+ * Scenario test - executes a workload described by a scenario (see
+ *                 scenario.hpp), phase after phase, on a population of
+ *                 agents and controllers, and reports the metrics of
+ *                 each phase.
+ */
+
+#pragma once
+
+#include <pcp-test/application_options.hpp>
+#include <pcp-test/client_configuration.hpp>
+#include <pcp-test/histogram.hpp>
+#include <pcp-test/reconnect_storm.hpp>
+#include <pcp-test/resource_monitor.hpp>
+#include <pcp-test/scenario.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+void run_scenario_test(const application_options& a_o);
+
+// What attempts, failures, and latencies refer to depends on the type:
+//  - connect: connections, the ones not associated, connect times;
+//  - messages: requests sent, failed sends, round trip times;
+//  - reconnect storm: dropped clients, the ones not re-associated;
+//  - teardown: closes, close timeouts, WebSocket Close Handshake times.
+struct phase_result
+{
+    int idx;
+    std::string name;
+    phase_type type;
+    int duration_ms;
+    int num_clients;             // connected and not torn down, at the end
+    int num_associated;          // at the end
+    int num_attempts;
+    int num_failures;
+    uint64_t num_responses;      // messages only
+    uint64_t num_errors;         // PCP errors, messages only
+    uint64_t num_late_sends;     // messages only
+    uint64_t num_skipped_sends;  // messages only
+    int traffic_ms;              // messages only: the sending interval
+    latency_histogram latency_us;
+    reconnect_stats reconnect;   // hold, messages (agents), reconnect storm
+    resource_usage resources;    // of pcp-test
+
+    phase_result();
+
+    // Responses per second
+    double throughput() const;
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const phase_result& result);
+
+    // To file (csv)
+    friend std::ofstream & operator<< (boost::nowide::ofstream& out_stream,
+                                       const phase_result& result);
+};
+
+class echo_agent;
+class paced_controller;
+class keepalive_scheduler;
+
+class scenario_test
+{
+  public:
+    explicit scenario_test(const application_options& a_o);
+
+    ~scenario_test();
+
+    scenario_test(const scenario_test&) = delete;
+    scenario_test& operator=(const scenario_test&) = delete;
+
+    void start();
+
+  private:
+    const application_options& app_opt_;
+    std::vector<scenario_phase> phases_;
+    unsigned int ws_connection_check_interval_s_;
+    unsigned int reconnect_check_interval_ms_;
+    unsigned int message_ttl_s_;
+    unsigned int ws_connection_timeout_ms_;
+    unsigned int association_timeout_s_;
+    std::string results_file_name_;
+    boost::nowide::ofstream results_file_stream_;
+    std::set<std::string>::const_iterator next_agent_name_;
+    std::set<std::string>::const_iterator next_controller_name_;
+
+    // All the clients connected so far; teardowns close the oldest
+    // ones, so those in [first_active, size) are the active ones
+    std::vector<std::shared_ptr<echo_agent>> agents_;
+    std::vector<std::shared_ptr<paced_controller>> controllers_;
+    std::size_t first_active_agent_;
+    std::size_t first_active_controller_;
+
+    // NB: declared after the clients, so that it's stopped before
+    // they are destroyed
+    std::unique_ptr<keepalive_scheduler> keepalive_ptr_;
+
+    void display_setup();
+
+    client_configuration get_configuration(const std::string& common_name,
+                                           const std::string& client_type) const;
+
+    std::vector<std::shared_ptr<client>> get_active_agents() const;
+    std::vector<std::shared_ptr<client>> get_active_controllers() const;
+    std::vector<std::shared_ptr<client>> get_active_clients() const;
+
+    void connect(const scenario_phase& phase, phase_result& result);
+    void hold(const scenario_phase& phase, phase_result& result);
+    void send_messages(const scenario_phase& phase, phase_result& result);
+    void reconnect_storm(const scenario_phase& phase, phase_result& result);
+    void teardown(const scenario_phase& phase, phase_result& result);
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,43 @@
+/**
+ * @file
+ * Scenario test parameters, including the ones of the phases.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace pcp_test{
+namespace scenario_test_parameters {
+
+extern const std::string SCENARIO_FILE;
+extern const std::string PHASES;
+extern const std::string WS_CONNECTION_CHECK_INTERVAL_S;
+extern const std::string RECONNECT_CHECK_INTERVAL_MS;
+extern const std::string MESSAGE_TTL_S;
+extern const std::string WS_CONNECTION_TIMEOUT_MS;
+extern const std::string ASSOCIATION_TIMEOUT_S;
+
+// Phases
+extern const std::string TYPE;
+extern const std::string NAME;
+extern const std::string NUM_AGENTS;
+extern const std::string NUM_CONTROLLERS;
+extern const std::string RATE;
+extern const std::string DURATION_S;
+extern const std::string REQUEST_RATE;
+extern const std::string FRACTION_PCT;
+extern const std::string RECONNECT_BACKOFF;
+extern const std::string RECONNECT_BACKOFF_MS;
+extern const std::string RECONNECT_BACKOFF_MAX_MS;
+extern const std::string RECONNECT_JITTER;
+
+// Phase types
+extern const std::string CONNECT_PHASE;
+extern const std::string HOLD_PHASE;
+extern const std::string MESSAGES_PHASE;
+extern const std::string RECONNECT_STORM_PHASE;
+extern const std::string TEARDOWN_PHASE;
+
+}  // namespace scenario_test_parameters
+}  // namespace pcp_test
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Soak test - keeps a population of agents and controllers associated
+ *             with a given PCP broker for hours, with steady request
+ *             traffic and connection churn, so that leaks and drifts of
+ *             the broker's latency show up.
+ */
+
+#pragma once
+
+#include <pcp-test/application_options.hpp>
+#include <pcp-test/histogram.hpp>
+#include <pcp-test/resource_monitor.hpp>
+#include <pcp-test/trend.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace pcp_test {
+
+void run_soak_test(const application_options& a_o);
+
+// The traffic and connection events of a snapshot interval or, once
+// accumulated, of the whole test
+struct soak_snapshot
+{
+    int idx;
+    int elapsed_s;               // since the start of the traffic
+    int interval_ms;
+    uint64_t num_sent;
+    uint64_t num_failed_sends;
+    uint64_t num_late_sends;     // more than a request interval late
+    uint64_t num_skipped_sends;  // scheduled while failing to reconnect
+    uint64_t num_responses;
+    uint64_t num_errors;         // PCP errors, e.g. undeliverable requests
+    uint64_t num_churned;        // agents disconnected on purpose
+    uint64_t num_reconnected;    // churned or dropped clients
+    uint64_t num_reconnect_failures;
+    int num_clients;
+    int num_associated;          // at the end of the interval
+    latency_histogram latency_us;  // request round trip
+    resource_usage resources;    // of pcp-test
+
+    soak_snapshot();
+
+    // Responses per second
+    double throughput() const;
+
+    // Include the following interval
+    void accumulate(const soak_snapshot& other);
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const soak_snapshot& snapshot);
+
+    // To file (csv)
+    friend std::ofstream & operator<< (boost::nowide::ofstream& out_stream,
+                                       const soak_snapshot& snapshot);
+};
+
+class echo_agent;
+class paced_controller;
+
+class soak_test
+{
+  public:
+    explicit soak_test(const application_options& a_o);
+
+    ~soak_test();
+
+    soak_test(const soak_test&) = delete;
+    soak_test& operator=(const soak_test&) = delete;
+
+    void start();
+
+  private:
+    const application_options& app_opt_;
+    unsigned int duration_s_;
+    int num_agents_;
+    int num_controllers_;
+    unsigned int request_rate_;
+    unsigned int churn_per_min_;
+    unsigned int snapshot_interval_s_;
+    unsigned int ws_connection_check_interval_s_;
+    unsigned int message_ttl_s_;
+    unsigned int ws_connection_timeout_ms_;
+    unsigned int association_timeout_s_;
+    std::string results_file_name_;
+    boost::nowide::ofstream results_file_stream_;
+
+    std::vector<std::unique_ptr<echo_agent>> agents_;
+    std::vector<std::unique_ptr<paced_controller>> controllers_;
+
+    // Agent events, updated by the maintenance thread
+    std::atomic<uint64_t> num_churned_;
+    std::atomic<uint64_t> num_reconnected_;
+    std::atomic<uint64_t> num_reconnect_failures_;
+
+    // Synchronizes the stop of the maintenance thread
+    std::mutex mtx_;
+    std::condition_variable stop_cv_;
+    bool stopping_;
+
+    // Latency p99 (ms) and pcp-test RSS (MB) over the elapsed hours
+    linear_trend latency_trend_;
+    linear_trend rss_trend_;
+
+    void display_setup();
+    void display_summary(const soak_snapshot& total);
+
+    // Disconnect and reconnect an agent every 1 / churn-per-min
+    // minutes, round robin, and reconnect the dropped ones
+    void maintain_agents();
+    void reconnect(echo_agent& agent);
+
+    soak_snapshot take_snapshot(int idx,
+                                std::chrono::steady_clock::time_point start,
+                                std::chrono::steady_clock::time_point previous);
+};
+
+}  // namespace pcp_test
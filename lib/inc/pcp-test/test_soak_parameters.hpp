@@ -0,0 +1,25 @@
+/**
+ * @file
+ * Soak test parameters.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace pcp_test{
+namespace soak_test_parameters {
+
+extern const std::string DURATION_S;
+extern const std::string NUM_AGENTS;
+extern const std::string NUM_CONTROLLERS;
+extern const std::string REQUEST_RATE;
+extern const std::string CHURN_PER_MIN;
+extern const std::string SNAPSHOT_INTERVAL_S;
+extern const std::string WS_CONNECTION_CHECK_INTERVAL_S;
+extern const std::string MESSAGE_TTL_S;
+extern const std::string WS_CONNECTION_TIMEOUT_MS;
+extern const std::string ASSOCIATION_TIMEOUT_S;
+
+}  // namespace soak_test_parameters
+}  // namespace pcp_test
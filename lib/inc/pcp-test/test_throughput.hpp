@@ -0,0 +1,116 @@
+/**
+ * @file
+ * Throughput test - determines the rate of request/response messages a given
+ *                   PCP broker can route between controllers and agents.
+ */
+
+#pragma once
+
+#include <pcp-test/application_options.hpp>
+#include <pcp-test/histogram.hpp>
+#include <pcp-test/payload_generator.hpp>
+#include <pcp-test/responder_pool.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <ostream>
+#include <chrono>
+#include <string>
+#include <stdint.h>
+
+namespace pcp_test {
+
+void run_throughput_test(const application_options& a_o);
+
+struct throughput_test_run
+{
+  private:
+    int agents_increment_;
+    int controllers_increment_;
+    int request_rate_increment_;
+
+  public:
+    int idx;
+    int num_agents;
+    int num_controllers;
+    int request_rate;     // per controller [requests/s]; 0 means no limit
+    int inflight_window;  // per controller; 0 means no limit
+    int send_batch_size;  // 0 means synchronous sends
+
+    explicit throughput_test_run(const application_options& a_o);
+
+    throughput_test_run& operator++();
+
+    std::string to_string() const;
+};
+
+struct throughput_test_result
+{
+    int num_agents;
+    int num_controllers;
+    int num_association_failures;
+    uint64_t num_requests;
+    uint64_t num_responses;
+    uint64_t num_failed_sends;
+    uint64_t num_lost;        // no response within the response timeout
+    uint64_t num_late;        // responses received after the timeout
+    uint64_t num_duplicates;
+    uint64_t num_unknown;     // invalid responses or unknown transactions
+    uint64_t num_dropped;     // requests dropped by the agents' responder pool
+    uint64_t num_reordered;   // requests received by agents out of sequence
+    uint64_t num_missing;     // skipped by the sequence of received requests
+    int duration_ms;          // from the first send to the last response
+    latency_histogram rtt_us;
+    latency_histogram latency_us;  // from the intended send time
+    latency_histogram one_way_us;  // from controllers to agents
+
+    explicit throughput_test_result(const throughput_test_run& run);
+
+    // Responses per second
+    double throughput() const;
+
+    // To stdout (human readable)
+    friend std::ostream& operator<< (std::ostream& out_stream,
+                                     const throughput_test_result& results);
+
+    // To file (csv)
+    friend std::ofstream & operator<< (boost::nowide::ofstream& out_stream,
+                                       const throughput_test_result& results);
+};
+
+class throughput_test
+{
+  public:
+    explicit throughput_test(const application_options& a_o);
+
+    void start();
+
+  private:
+    const application_options& app_opt_;
+    int num_runs_;
+    unsigned int inter_run_pause_ms_;
+    unsigned int run_duration_s_;
+    unsigned int response_timeout_ms_;
+    unsigned int message_ttl_s_;
+    unsigned int ws_connection_timeout_ms_;
+    unsigned int association_timeout_s_;
+    payload_format payload_format_;
+    payload_size_distribution payload_size_distribution_;
+    std::size_t payload_size_;
+    std::size_t payload_max_size_;
+    std::size_t num_payloads_;
+    unsigned int responder_threads_;  // 0 means replying in the callback
+    std::size_t responder_queue_size_;
+    delay_distribution processing_delay_distribution_;
+    unsigned int processing_delay_us_;
+    unsigned int processing_delay_max_us_;
+    throughput_test_run current_run_;
+    std::string results_file_name_;
+    boost::nowide::ofstream results_file_stream_;
+
+    void display_setup();
+    void display_execution_time(std::chrono::system_clock::time_point start_time);
+    throughput_test_result perform_current_run();
+};
+
+}  // namespace pcp_test
@@ -0,0 +1,49 @@
+/**
+ * @file
+ * Throughput test parameters.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace pcp_test{
+namespace throughput_test_parameters {
+
+extern const std::string NUM_RUNS;
+extern const std::string INTER_RUN_PAUSE_MS;
+extern const std::string NUM_AGENTS;
+extern const std::string NUM_CONTROLLERS;
+extern const std::string RUN_DURATION_S;
+extern const std::string AGENTS_INCREMENT;
+extern const std::string CONTROLLERS_INCREMENT;
+extern const std::string REQUEST_RATE;
+extern const std::string REQUEST_RATE_INCREMENT;
+extern const std::string INFLIGHT_WINDOW;
+extern const std::string SEND_BATCH_SIZE;
+extern const std::string RESPONSE_TIMEOUT_MS;
+extern const std::string MESSAGE_TTL_S;
+extern const std::string WS_CONNECTION_TIMEOUT_MS;
+extern const std::string ASSOCIATION_TIMEOUT_S;
+extern const std::string PAYLOAD_SIZE;
+extern const std::string PAYLOAD_MAX_SIZE;
+extern const std::string PAYLOAD_SIZE_DISTRIBUTION;
+extern const std::string PAYLOAD_FORMAT;
+extern const std::string NUM_PAYLOADS;
+extern const std::string RESPONDER_THREADS;
+extern const std::string RESPONDER_QUEUE_SIZE;
+extern const std::string PROCESSING_DELAY_US;
+extern const std::string PROCESSING_DELAY_MAX_US;
+extern const std::string PROCESSING_DELAY_DISTRIBUTION;
+
+// payload-size-distribution and processing-delay-distribution values
+extern const std::string FIXED_SIZE;
+extern const std::string UNIFORM_SIZE;
+extern const std::string EXPONENTIAL_SIZE;
+
+// payload-format values
+extern const std::string JSON_PAYLOAD;
+extern const std::string BINARY_PAYLOAD;
+
+}  // namespace throughput_test_parameters
+}  // namespace pcp_test
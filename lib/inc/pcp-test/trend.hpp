@@ -0,0 +1,40 @@
+/**
+ * @file
+ * Linear trend - least squares fit of a series of samples, to estimate
+ *                how a metric drifts over a long test.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace pcp_test {
+
+// pcp_test::linear_trend fits y = intercept + slope * x to the samples
+// added so far, in constant space. Means and co-moments are updated
+// incrementally (Welford), so that large offsets (e.g. a memory usage
+// in KB) do not cause loss of precision.
+
+class linear_trend
+{
+  public:
+    linear_trend();
+
+    void add(double x, double y);
+
+    std::size_t count() const;
+
+    // 0 with less than 2 samples, or if all x values are equal
+    double slope() const;
+
+    double intercept() const;
+
+  private:
+    std::size_t n_;
+    double mean_x_;
+    double mean_y_;
+    double m2_x_;   // sum of squared deviations of x
+    double c_xy_;   // sum of co-deviations of x and y
+};
+
+}  // namespace pcp_test
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <string>
+#include <stdint.h>
 
 namespace pcp_test {
 namespace util {
@@ -13,6 +14,14 @@ namespace util {
 // Return the current datetime (no seconds) as a string.
 std::string get_short_datetime();
 
+// Return the current UTC time in ISO 8601 format (e.g.
+// "2017-03-01T14:21:05Z").
+std::string get_ISO8601_time();
+
+// Return a human readable representation of the specified interval
+// (e.g. "1 min 3 s", "4.250 s", "12 ms").
+std::string normalize_time_interval(uint32_t duration_ms);
+
 // Wrap message with the POSIX cyan display code
 std::string cyan(std::string const& message);
 
@@ -28,5 +37,16 @@ std::string red(std::string const& message);
 // Return a new UUID
 std::string get_UUID();
 
+// Return a new random (version 4) UUID, for identifying messages.
+// Unlike get_UUID(), that goes through a shared, synchronized
+// generator seeded from the OS entropy source, each thread uses its own
+// PRNG, seeded once; the IDs are unique but not cryptographically
+// strong. Thread safe and lock free.
+std::string get_message_id();
+
+// Return the current time of the steady clock, in nanoseconds; the
+// epoch is arbitrary, but shared by all threads of the process.
+int64_t get_monotonic_ns();
+
 }  // namespace util
 }  // namespace pcp-test
@@ -0,0 +1,46 @@
+#include <pcp-test/arrival_schedule.hpp>
+
+#include <cassert>
+#include <cmath>
+
+namespace pcp_test {
+
+// NOTE(ale): arrivals are first obtained for an homogeneous process
+// with unit rate (operational time); the ramp is then applied by
+// inverting the cumulative rate function:
+//     L(t) = rate * t^2 / (2 * R)    for t < R
+//     L(t) = rate * (t - R / 2)      for t >= R
+
+std::vector<std::chrono::microseconds> get_arrival_offsets(
+        int num_arrivals,
+        double rate_Hz,
+        std::chrono::milliseconds ramp_up,
+        exponential_integers* unit_rng_ptr)
+{
+    assert(rate_Hz > 0);
+    std::vector<std::chrono::microseconds> offsets {};
+
+    if (num_arrivals <= 0)
+        return offsets;
+
+    offsets.reserve(num_arrivals);
+    double ramp_s = ramp_up.count() / 1000.0;
+    double op_time_s {0.0};
+
+    for (int idx = 0; idx < num_arrivals; idx++) {
+        op_time_s += unit_rng_ptr ? (*unit_rng_ptr)() / 1000000.0 : 1.0;
+
+        // Expected number of arrivals up to now, divided by the rate
+        double tau_s = op_time_s / rate_Hz;
+        double t_s = tau_s < ramp_s / 2
+                     ? std::sqrt(2 * ramp_s * tau_s)
+                     : tau_s + ramp_s / 2;
+
+        offsets.push_back(std::chrono::microseconds(
+            static_cast<std::chrono::microseconds::rep>(t_s * 1000000)));
+    }
+
+    return offsets;
+}
+
+}  // namespace pcp_test
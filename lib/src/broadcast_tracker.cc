@@ -0,0 +1,192 @@
+#include <pcp-test/broadcast_tracker.hpp>
+
+#include <algorithm>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+broadcast_counters::broadcast_counters()
+        : broadcasts {0},
+          expected   {0},
+          delivered  {0},
+          complete   {0},
+          duplicates {0},
+          late       {0},
+          unknown    {0}
+{
+}
+
+constexpr std::size_t broadcast_tracker::DEFAULT_HISTORY_SIZE;
+
+static uint32_t to_us(broadcast_tracker::clock_type::duration d)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    return static_cast<uint32_t>(std::max<int64_t>(0, std::min<int64_t>(us, UINT32_MAX)));
+}
+
+broadcast_tracker::broadcast_tracker(const std::vector<std::string>& target_uris,
+                                     std::size_t history_size)
+        : target_indexes_ {},
+          history_size_ {std::max<std::size_t>(1, history_size)},
+          mtx_ {},
+          in_flight_ {},
+          closed_ {},
+          closed_set_ {},
+          counters_ {},
+          time_to_first_us_ {},
+          time_to_last_us_ {}
+{
+    for (const auto& uri : target_uris)
+        target_indexes_.emplace(uri, target_indexes_.size());
+}
+
+std::size_t broadcast_tracker::num_targets() const
+{
+    return target_indexes_.size();
+}
+
+bool broadcast_tracker::insert(const std::string& transaction,
+                               clock_type::time_point sent)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    broadcast b {sent, {}, {}, std::vector<bool>(target_indexes_.size(), false), 0};
+
+    if (!in_flight_.emplace(transaction, std::move(b)).second)
+        return false;
+
+    closed_set_.erase(transaction);
+    counters_.broadcasts++;
+    counters_.expected += target_indexes_.size();
+    return true;
+}
+
+void broadcast_tracker::cancel(const std::string& transaction)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+
+    if (in_flight_.erase(transaction)) {
+        counters_.broadcasts--;
+        counters_.expected -= target_indexes_.size();
+    }
+}
+
+broadcast_tracker::match_outcome
+broadcast_tracker::match(const std::string& transaction,
+                         const std::string& responder,
+                         clock_type::time_point received)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    auto itr = in_flight_.find(transaction);
+
+    if (itr == in_flight_.end()) {
+        if (closed_set_.count(transaction)) {
+            counters_.late++;
+            return match_outcome::late;
+        }
+
+        counters_.unknown++;
+        return match_outcome::unknown;
+    }
+
+    auto target_itr = target_indexes_.find(responder);
+
+    if (target_itr == target_indexes_.end()) {
+        counters_.unknown++;
+        return match_outcome::unknown;
+    }
+
+    auto& b = itr->second;
+
+    if (b.responded[target_itr->second]) {
+        counters_.duplicates++;
+        return match_outcome::duplicate;
+    }
+
+    if (b.num_responded == 0)
+        b.first_response = received;
+
+    b.responded[target_itr->second] = true;
+    b.num_responded++;
+    b.last_response = std::max(b.last_response, received);
+    counters_.delivered++;
+
+    return b.num_responded == b.responded.size() ? match_outcome::completed
+                                                 : match_outcome::delivered;
+}
+
+void broadcast_tracker::close(const std::string& transaction)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    auto itr = in_flight_.find(transaction);
+
+    if (itr != in_flight_.end())
+        close_locked(itr);
+}
+
+void broadcast_tracker::close_all()
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+
+    while (!in_flight_.empty())
+        close_locked(in_flight_.begin());
+}
+
+bool broadcast_tracker::is_complete(const std::string& transaction) const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    auto itr = in_flight_.find(transaction);
+
+    return itr != in_flight_.end()
+           && itr->second.num_responded == itr->second.responded.size();
+}
+
+std::size_t broadcast_tracker::size() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return in_flight_.size();
+}
+
+broadcast_counters broadcast_tracker::get_counters() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return counters_;
+}
+
+latency_histogram broadcast_tracker::get_time_to_first_us() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return time_to_first_us_;
+}
+
+latency_histogram broadcast_tracker::get_time_to_last_us() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return time_to_last_us_;
+}
+
+// Private
+
+void broadcast_tracker::close_locked(
+        std::unordered_map<std::string, broadcast>::iterator itr)
+{
+    const auto& b = itr->second;
+
+    if (b.num_responded)
+        time_to_first_us_.record(to_us(b.first_response - b.sent));
+
+    if (b.num_responded && b.num_responded == b.responded.size()) {
+        time_to_last_us_.record(to_us(b.last_response - b.sent));
+        counters_.complete++;
+    }
+
+    if (closed_.size() >= history_size_) {
+        closed_set_.erase(closed_.front());
+        closed_.pop_front();
+    }
+
+    closed_set_.insert(itr->first);
+    closed_.push_back(itr->first);
+    in_flight_.erase(itr);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,130 @@
+#include <pcp-test/broker_distribution.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>  // std::move
+#include <stdint.h>
+
+namespace pcp_test {
+
+const unsigned int MAX_BROKER_TOTAL_WEIGHT {10000};
+
+static unsigned int get_gcd(unsigned int a, unsigned int b)
+{
+    while (b) {
+        auto r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+// Divide the weights by their gcd, so that the weighted round-robin
+// sequence is as short as possible (e.g. 1, 2 for 1000, 2000)
+static void reduce_weights(std::vector<unsigned int>& weights)
+{
+    auto gcd = std::accumulate(weights.begin(), weights.end(), 0U, get_gcd);
+
+    if (gcd == 0)
+        return;
+
+    for (auto& w : weights)
+        w /= gcd;
+}
+
+uint64_t get_reduced_total_weight(std::vector<unsigned int> weights)
+{
+    reduce_weights(weights);
+    return std::accumulate(weights.begin(), weights.end(), uint64_t {0});
+}
+
+// Smooth weighted round-robin: at each step, each broker's current
+// weight is increased by its weight, the broker with the largest
+// current weight is picked and its current weight is decreased by the
+// total weight. The weights are reduced first.
+static std::vector<std::size_t> get_sequence(std::vector<unsigned int> weights)
+{
+    reduce_weights(weights);
+
+    std::vector<std::size_t> sequence {};
+    std::vector<int64_t> current(weights.size(), 0);
+    auto tot_weight = std::accumulate(weights.begin(), weights.end(), int64_t {0});
+
+    for (int64_t step = 0; step < tot_weight; step++) {
+        std::size_t picked {0};
+
+        for (std::size_t idx = 0; idx < weights.size(); idx++) {
+            current[idx] += weights[idx];
+            if (current[idx] > current[picked])
+                picked = idx;
+        }
+
+        current[picked] -= tot_weight;
+        sequence.push_back(picked);
+    }
+
+    return sequence;
+}
+
+// 64-bit FNV-1a
+static uint64_t get_hash(const std::string& s)
+{
+    uint64_t h {14695981039346656037ULL};
+
+    for (auto c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+
+    return h;
+}
+
+broker_distribution::broker_distribution(broker_policy policy,
+                                         std::size_t num_brokers,
+                                         std::vector<unsigned int> weights)
+        : policy_ {policy},
+          num_brokers_ {num_brokers},
+          sequence_ {}
+{
+    if (num_brokers_ == 0)
+        throw fatal_error {"no broker to distribute clients to"};
+
+    if (weights.empty())
+        weights.assign(num_brokers_, 1);
+
+    auto tot_weight = get_reduced_total_weight(weights);
+
+    if (weights.size() != num_brokers_
+            || tot_weight == 0
+            || tot_weight > MAX_BROKER_TOTAL_WEIGHT)
+        throw fatal_error {"invalid broker weights"};
+
+    sequence_ = get_sequence(std::move(weights));
+}
+
+broker_policy broker_distribution::policy() const
+{
+    return policy_;
+}
+
+std::size_t broker_distribution::num_brokers() const
+{
+    return num_brokers_;
+}
+
+std::size_t broker_distribution::get_broker(std::size_t client_idx,
+                                            const std::string& common_name) const
+{
+    switch (policy_) {
+        case broker_policy::first:
+            return 0;
+        case broker_policy::hash:
+            return sequence_[get_hash(common_name) % sequence_.size()];
+        default:
+            return sequence_[client_idx % sequence_.size()];
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,59 @@
+#include <pcp-test/capacity_search.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <algorithm>
+
+namespace pcp_test {
+
+capacity_search::capacity_search(int max_level)
+        : max_level_ {max_level},
+          level_ {0},
+          highest_passing_level_ {-1},
+          lowest_failing_level_ {-1}
+{
+    if (max_level_ < 0)
+        throw fatal_error {"the maximum level of a capacity search cannot be negative"};
+}
+
+int capacity_search::level() const
+{
+    return level_;
+}
+
+bool capacity_search::next(bool passed)
+{
+    if (passed)
+        highest_passing_level_ = level_;
+    else
+        lowest_failing_level_ = level_;
+
+    if (lowest_failing_level_ < 0) {
+        // Exponential ramp
+        if (highest_passing_level_ == max_level_)
+            return false;
+
+        level_ = std::min(max_level_,
+                          highest_passing_level_ == 0 ? 1 : 2 * highest_passing_level_);
+        return true;
+    }
+
+    // Bisection
+    if (lowest_failing_level_ - highest_passing_level_ <= 1)
+        return false;
+
+    level_ = highest_passing_level_
+             + (lowest_failing_level_ - highest_passing_level_) / 2;
+    return true;
+}
+
+int capacity_search::highest_passing_level() const
+{
+    return highest_passing_level_;
+}
+
+int capacity_search::lowest_failing_level() const
+{
+    return lowest_failing_level_;
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,328 @@
+#include <pcp-test/cert_store.hpp>
+
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/format.hpp>
+
+#include <openssl/bio.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>  // std::move
+#include <vector>
+
+namespace pcp_test {
+
+namespace fs = boost::filesystem;
+
+const std::string cert_store::CA_CERT_FILE {"ca_crt.pem"};
+const std::string cert_store::CA_KEY_FILE  {"ca_key.pem"};
+
+static const long CERT_VALIDITY_S {10L * 365 * 24 * 3600};
+static const long CERT_BACKDATE_S {24L * 3600};  // to tolerate clock skew
+
+using bio_ptr    = std::unique_ptr<BIO, decltype(&BIO_free_all)>;
+using bn_ptr     = std::unique_ptr<BIGNUM, decltype(&BN_free)>;
+using x509_ptr   = std::unique_ptr<X509, decltype(&X509_free)>;
+using pkey_ptr   = std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)>;
+using pctx_ptr   = std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)>;
+using ext_ptr    = std::unique_ptr<X509_EXTENSION, decltype(&X509_EXTENSION_free)>;
+
+// Throws a cert_store::error with the message and the last OpenSSL
+// error, if any
+static void fail(const std::string& what)
+{
+    char buf[256] {};
+    auto err = ERR_get_error();
+    ERR_clear_error();
+
+    if (err == 0)
+        throw cert_store::error(what);
+
+    ERR_error_string_n(err, buf, sizeof(buf));
+    throw cert_store::error((boost::format("%1% (%2%)") % what % buf).str());
+}
+
+static bio_ptr open_file(const std::string& path, const char* mode)
+{
+    bio_ptr bio {BIO_new_file(path.c_str(), mode), BIO_free_all};
+
+    if (!bio)
+        fail((boost::format("failed to open %1%") % path).str());
+
+    return bio;
+}
+
+static pkey_ptr generate_key()
+{
+    pctx_ptr ctx {EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), EVP_PKEY_CTX_free};
+    EVP_PKEY* raw_key {nullptr};
+
+    if (!ctx
+            || EVP_PKEY_keygen_init(ctx.get()) <= 0
+            || EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), NID_X9_62_prime256v1) <= 0
+            || EVP_PKEY_CTX_set_ec_param_enc(ctx.get(), OPENSSL_EC_NAMED_CURVE) <= 0
+            || EVP_PKEY_keygen(ctx.get(), &raw_key) <= 0)
+        fail("failed to generate a key");
+
+    return pkey_ptr {raw_key, EVP_PKEY_free};
+}
+
+static void add_extension(X509* cert, X509* issuer, int nid, const char* value)
+{
+    X509V3_CTX ctx;
+    X509V3_set_ctx_nodb(&ctx);
+    X509V3_set_ctx(&ctx, issuer, cert, nullptr, nullptr, 0);
+    ext_ptr ext {X509V3_EXT_conf_nid(nullptr, &ctx, nid, const_cast<char*>(value)),
+                 X509_EXTENSION_free};
+
+    if (!ext || !X509_add_ext(cert, ext.get(), -1))
+        fail("failed to add a certificate extension");
+}
+
+// Write to a temporary file, with a unique name, that is then renamed,
+// so that an interrupted generation doesn't leave a truncated file
+// behind and concurrent processes don't collide. In case of owner_only,
+// permissions are restricted before writing anything, so that private
+// keys are never readable by others.
+template <typename Writer>
+static void write_pem(const fs::path& path, Writer write, bool owner_only)
+{
+    auto tmp_path = path;
+    tmp_path += fs::unique_path(".%%%%-%%%%-%%%%.tmp");
+
+    try {
+        {
+            auto bio = open_file(tmp_path.string(), "w");
+
+            if (owner_only)
+                fs::permissions(tmp_path, fs::owner_read | fs::owner_write);
+
+            if (!write(bio.get()))
+                fail((boost::format("failed to write %1%") % tmp_path.string()).str());
+        }
+
+        fs::rename(tmp_path, path);
+    } catch (...) {
+        boost::system::error_code ec {};
+        fs::remove(tmp_path, ec);
+        throw;
+    }
+}
+
+static fs::path crt_path(const fs::path& dir, const std::string& common_name)
+{
+    return dir / (common_name + ".example.com_crt.pem");
+}
+
+static fs::path key_path(const fs::path& dir, const std::string& common_name)
+{
+    return dir / (common_name + ".example.com_key.pem");
+}
+
+struct cert_store::signer
+{
+    x509_ptr ca_cert;
+    pkey_ptr ca_key;
+
+    explicit signer(const fs::path& certificates_dir)
+            : ca_cert {nullptr, X509_free},
+              ca_key {nullptr, EVP_PKEY_free}
+    {
+        auto cert_file = (certificates_dir / CA_CERT_FILE).string();
+        auto key_file  = (certificates_dir / CA_KEY_FILE).string();
+
+        ca_cert.reset(PEM_read_bio_X509(open_file(cert_file, "r").get(),
+                                        nullptr, nullptr, nullptr));
+        if (!ca_cert)
+            fail((boost::format("failed to load the CA certificate %1%") % cert_file).str());
+
+        ca_key.reset(PEM_read_bio_PrivateKey(open_file(key_file, "r").get(),
+                                             nullptr, nullptr, nullptr));
+        if (!ca_key)
+            fail((boost::format("failed to load the CA key %1%") % key_file).str());
+
+        if (X509_check_private_key(ca_cert.get(), ca_key.get()) != 1)
+            fail("the CA key does not match the CA certificate");
+    }
+
+    x509_ptr sign(const std::string& common_name, EVP_PKEY* key) const
+    {
+        x509_ptr cert {X509_new(), X509_free};
+        bn_ptr serial {BN_new(), BN_free};
+
+        if (!cert || !serial
+                || !X509_set_version(cert.get(), 2)
+                || !BN_rand(serial.get(), 63, 0, 0)
+                || !BN_to_ASN1_INTEGER(serial.get(), X509_get_serialNumber(cert.get()))
+                || !X509_gmtime_adj(X509_get_notBefore(cert.get()), -CERT_BACKDATE_S)
+                || !X509_gmtime_adj(X509_get_notAfter(cert.get()), CERT_VALIDITY_S)
+                || !X509_set_pubkey(cert.get(), key)
+                || !X509_NAME_add_entry_by_txt(
+                        X509_get_subject_name(cert.get()), "CN", MBSTRING_ASC,
+                        reinterpret_cast<const unsigned char*>(
+                            (common_name + ".example.com").c_str()),
+                        -1, -1, 0)
+                || !X509_set_issuer_name(cert.get(), X509_get_subject_name(ca_cert.get())))
+            fail("failed to create a certificate");
+
+        // Same usages as the certificates issued by the Puppet CA, with
+        // the key usages that fit an EC key
+        add_extension(cert.get(), ca_cert.get(), NID_basic_constraints, "critical,CA:FALSE");
+        add_extension(cert.get(), ca_cert.get(), NID_key_usage,
+                      "critical,digitalSignature,keyAgreement");
+        add_extension(cert.get(), ca_cert.get(), NID_ext_key_usage,
+                      "critical,serverAuth,clientAuth");
+        add_extension(cert.get(), ca_cert.get(), NID_subject_key_identifier, "hash");
+
+        if (!X509_sign(cert.get(), ca_key.get(), EVP_sha256()))
+            fail("failed to sign a certificate");
+
+        return cert;
+    }
+};
+
+//
+// cert_store
+//
+
+cert_store::cert_store(std::string certificates_dir, bool generate)
+        : test_dir_ {(fs::path(certificates_dir) / "test").string()},
+          signer_ {generate ? new signer(fs::path(certificates_dir)) : nullptr},
+          mtx_ {},
+          num_generated_ {0}
+{
+}
+
+cert_store::~cert_store() = default;
+
+std::string cert_store::common_name(const std::string& role, std::size_t idx)
+{
+    return (boost::format("%04d%s") % idx % role).str();
+}
+
+std::set<std::string> cert_store::get_common_names(const std::string& role,
+                                                   std::size_t num_endpoints)
+{
+    std::set<std::string> names {};
+    std::vector<std::string> missing_names {};
+
+    for (std::size_t idx = 0; idx < num_endpoints; idx++) {
+        auto name = common_name(role, idx);
+
+        if (!has_pair(name)) {
+            if (!signer_)
+                break;
+
+            missing_names.push_back(name);
+        }
+
+        names.insert(std::move(name));
+    }
+
+    if (!missing_names.empty())
+        generate_pairs(missing_names);
+
+    return names;
+}
+
+std::size_t cert_store::num_generated() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return num_generated_;
+}
+
+//
+// Private
+//
+
+bool cert_store::has_pair(const std::string& common_name) const
+{
+    boost::system::error_code ec {};
+    return fs::exists(crt_path(test_dir_, common_name), ec)
+           && fs::exists(key_path(test_dir_, common_name), ec);
+}
+
+void cert_store::generate_pair(const std::string& common_name) const
+{
+    auto key  = generate_key();
+    auto cert = signer_->sign(common_name, key.get());
+
+    try {
+        // NB: the key first; a pair is complete once its certificate
+        // is in place
+        write_pem(key_path(test_dir_, common_name),
+                  [&key](BIO* bio)
+                  {
+                      return PEM_write_bio_PrivateKey(bio, key.get(), nullptr, nullptr,
+                                                      0, nullptr, nullptr) == 1;
+                  },
+                  true);
+        write_pem(crt_path(test_dir_, common_name),
+                  [&cert](BIO* bio)
+                  {
+                      return PEM_write_bio_X509(bio, cert.get()) == 1;
+                  },
+                  false);
+    } catch (const fs::filesystem_error& e) {
+        throw cert_store::error((boost::format("failed to store the %1% pair (%2%)")
+                                 % common_name % e.what()).str());
+    }
+}
+
+// Signing with the CA key dominates the cost, so the pairs are
+// generated by concurrent threads; the first error is rethrown once
+// all threads are done
+void cert_store::generate_pairs(const std::vector<std::string>& common_names)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    std::atomic<std::size_t> next_idx {0};
+    std::exception_ptr first_error {};
+    std::mutex error_mtx {};
+    std::vector<std::thread> threads {};
+    auto num_threads = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), common_names.size());
+
+    try {
+        fs::create_directories(test_dir_);
+    } catch (const fs::filesystem_error& e) {
+        throw cert_store::error((boost::format("failed to create %1% (%2%)")
+                                 % test_dir_ % e.what()).str());
+    }
+
+    for (std::size_t t_idx = 0; t_idx < num_threads; t_idx++) {
+        threads.push_back(std::thread([&]() {
+            for (auto idx = next_idx++; idx < common_names.size(); idx = next_idx++) {
+                try {
+                    generate_pair(common_names[idx]);
+                } catch (...) {
+                    std::lock_guard<std::mutex> error_lock {error_mtx};
+                    if (!first_error)
+                        first_error = std::current_exception();
+                    next_idx = common_names.size();
+                }
+            }
+        }));
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    if (first_error)
+        std::rethrow_exception(first_error);
+
+    num_generated_ += common_names.size();
+}
+
+}  // namespace pcp_test
@@ -1,16 +1,22 @@
 #include <pcp-test/schemas.hpp>
 #include <pcp-test/client.hpp>
+#include <pcp-test/task_scheduler.hpp>
 
 #include <leatherman/logging/logging.hpp>
 
 #include <cpp-pcp-client/connector/errors.hpp>
 
+#include <algorithm>  // std::min
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <utility>  // std::move
 
 namespace pcp_test {
 
 client::client(client_configuration cfg)
-    : PCPClient::Connector {cfg.broker_ws_uris[0],
+    : PCPClient::Connector {cfg.broker_ws_uris.at(cfg.broker_idx),
                             cfg.client_type,
                             cfg.ca,
                             cfg.crt,
@@ -28,13 +34,21 @@ client::client(client_configuration cfg)
             schemas::response(),
             std::bind(&client::process_response, this, std::placeholders::_1));
 
+    registerMessageCallback(
+            schemas::binary_request(),
+            std::bind(&client::process_request, this, std::placeholders::_1));
+
+    registerMessageCallback(
+            schemas::binary_response(),
+            std::bind(&client::process_response, this, std::placeholders::_1));
+
     registerMessageCallback(
             schemas::error(),
             std::bind(&client::process_error, this, std::placeholders::_1));
 }
 
-void client::send_request(const message& request,
-                  const std::vector<std::string>& endpoints)
+bool client::send_request(const message& request,
+                          const std::vector<std::string>& endpoints)
 {
     try {
         send(endpoints,
@@ -42,19 +56,84 @@ void client::send_request(const message& request,
              configuration.message_ttl_s,
              request.get_data());
         LOG_DEBUG("Sent request %1%", request.transaction());
+        return true;
     } catch (PCPClient::connection_error& e) {
         LOG_ERROR("Failed to send request request %1%: %2%",
                   request.transaction(), e.what());
+        return false;
     }
 }
 
-void client::reply(const message& request)
+bool client::send_request(const std::vector<std::string>& endpoints,
+                          const leatherman::json_container::JsonContainer& data)
 {
     try {
-        send({request.sender()},
-             schemas::RESPONSE_TYPE,
+        send(endpoints,
+             schemas::REQUEST_TYPE,
              configuration.message_ttl_s,
-             request.get_data());
+             data);
+        return true;
+    } catch (PCPClient::connection_error& e) {
+        LOG_ERROR("Failed to send request: %1%", e.what());
+        return false;
+    }
+}
+
+bool client::send_request(const std::vector<std::string>& endpoints,
+                          const leatherman::json_container::JsonContainer& data,
+                          const leatherman::json_container::JsonContainer& header)
+{
+    try {
+        send(endpoints,
+             schemas::REQUEST_TYPE,
+             configuration.message_ttl_s,
+             data,
+             {header});
+        return true;
+    } catch (PCPClient::connection_error& e) {
+        LOG_ERROR("Failed to send request: %1%", e.what());
+        return false;
+    }
+}
+
+bool client::send_binary_request(const std::vector<std::string>& endpoints,
+                                 const std::string& data,
+                                 const leatherman::json_container::JsonContainer& header)
+{
+    try {
+        send(endpoints,
+             schemas::BINARY_REQUEST_TYPE,
+             configuration.message_ttl_s,
+             data,
+             {header});
+        return true;
+    } catch (PCPClient::connection_error& e) {
+        LOG_ERROR("Failed to send binary request: %1%", e.what());
+        return false;
+    }
+}
+
+bool client::send_request(const outgoing_request& request)
+{
+    return request.format == payload_format::json
+           ? send_request(*request.endpoints, *request.json_data, request.header)
+           : send_binary_request(*request.endpoints, *request.binary_data, request.header);
+}
+
+void client::reply(const message& request)
+{
+    try {
+        if (request.is_binary()) {
+            send({request.sender()},
+                 schemas::BINARY_RESPONSE_TYPE,
+                 configuration.message_ttl_s,
+                 request.get_binary_data());
+        } else {
+            send({request.sender()},
+                 schemas::RESPONSE_TYPE,
+                 configuration.message_ttl_s,
+                 request.get_data());
+        }
         LOG_DEBUG("Replied to request %1%", request.transaction());
     } catch (PCPClient::connection_error& e) {
         LOG_ERROR("Failed to reply to request %1%: %2%",
@@ -62,11 +141,49 @@ void client::reply(const message& request)
     }
 }
 
+bool client::echo(const PCPClient::ParsedChunks& parsed_chunks)
+{
+    if (!parsed_chunks.has_data || parsed_chunks.invalid_data) {
+        LOG_WARNING("Cannot echo request %1%: no valid data",
+                    parsed_chunks.envelope.get<std::string>("id"));
+        return false;
+    }
+
+    // NB: other debug chunks, if any, are not echoed
+    std::vector<leatherman::json_container::JsonContainer> debug {};
+
+    if (auto header = message::find_header(parsed_chunks))
+        debug.push_back(*header);
+
+    try {
+        // NB: the data chunk was already validated against the
+        // request schema, so it satisfies the response one as well
+        if (parsed_chunks.data_type == PCPClient::ContentType::Binary) {
+            send({parsed_chunks.envelope.get<std::string>("sender")},
+                 schemas::BINARY_RESPONSE_TYPE,
+                 configuration.message_ttl_s,
+                 parsed_chunks.binary_data,
+                 debug);
+        } else {
+            send({parsed_chunks.envelope.get<std::string>("sender")},
+                 schemas::RESPONSE_TYPE,
+                 configuration.message_ttl_s,
+                 parsed_chunks.data,
+                 debug);
+        }
+        return true;
+    } catch (PCPClient::connection_error& e) {
+        LOG_ERROR("Failed to echo request %1%: %2%",
+                  parsed_chunks.envelope.get<std::string>("id"), e.what());
+        return false;
+    }
+}
+
 void client::reply_with_error(const message& request,
                               const std::string& err_msg)
 {
     auto data = request.get_data();
-    data.set<std::string>("err_msg", err_msg);
+    data.set<std::string>("error_msg", err_msg);
 
     try {
         send({request.sender()},
@@ -86,6 +203,39 @@ void client::ping()
         connection_ptr_->ping();
 }
 
+// The connector offers no close notification, as it owns the
+// connection callbacks; the state is polled with an exponential
+// backoff, so that closing many clients in parallel does not spin
+static constexpr uint32_t CLOSE_CHECK_MIN_INTERVAL_MS {1};
+static constexpr uint32_t CLOSE_CHECK_MAX_INTERVAL_MS {100};
+
+bool client::close(std::chrono::milliseconds timeout)
+{
+    if (!connection_ptr_
+            || connection_ptr_->getConnectionState() != PCPClient::ConnectionState::open)
+        return true;
+
+    connection_ptr_->close();
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds interval {CLOSE_CHECK_MIN_INTERVAL_MS};
+
+    while (connection_ptr_->getConnectionState() != PCPClient::ConnectionState::closed) {
+        auto now = std::chrono::steady_clock::now();
+
+        if (now > deadline)
+            return false;
+
+        std::this_thread::sleep_for(
+            std::min(interval,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)
+                         + std::chrono::milliseconds(1)));
+        interval = std::min(interval * 2,
+                            std::chrono::milliseconds(CLOSE_CHECK_MAX_INTERVAL_MS));
+    }
+
+    return true;
+}
+
 // Protected virtual callbacks
 
 void client::process_request(const PCPClient::ParsedChunks& parsed_chunks)
@@ -106,4 +256,82 @@ void client::process_error(const PCPClient::ParsedChunks& parsed_chunks)
         error_callback(parsed_chunks, this);
 }
 
+// Marks a connection task as done when going out of scope, so that
+// connect_clients() accounts for the tasks that throw
+class connection_task_guard
+{
+  public:
+    connection_task_guard(std::mutex& mtx,
+                          std::condition_variable& cv,
+                          std::size_t& num_done)
+        : mtx_ {mtx},
+          cv_ {cv},
+          num_done_ {num_done}
+    {
+    }
+
+    ~connection_task_guard()
+    {
+        {
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            num_done_++;
+        }
+        cv_.notify_one();
+    }
+
+    connection_task_guard(const connection_task_guard&) = delete;
+    connection_task_guard& operator=(const connection_task_guard&) = delete;
+
+  private:
+    std::mutex& mtx_;
+    std::condition_variable& cv_;
+    std::size_t& num_done_;
+};
+
+// Connect the specified clients by using a pool of threads; return
+// the number of clients that failed to associate.
+// NB: there's no overall timeout; each attempt is bounded by the
+// connection and association timeouts of its client, which the
+// Connector enforces
+int connect_clients(const std::vector<client*>& client_ptrs)
+{
+    std::atomic<int> num_failures {0};
+    std::mutex mtx {};
+    std::condition_variable cv {};
+    std::size_t num_done {0};
+
+    // NB: the pool is destroyed, by joining its workers, before
+    // the above synchronization objects
+    task_scheduler pool {};
+
+    for (auto c_ptr : client_ptrs) {
+        pool.schedule(
+            [&num_failures, &mtx, &cv, &num_done, c_ptr]()
+            {
+                connection_task_guard guard {mtx, cv, num_done};
+
+                try {
+                    c_ptr->connect(1);
+                } catch (const PCPClient::connection_error& e) {
+                    LOG_WARNING("Client %1% failed to connect: %2%",
+                                c_ptr->configuration.common_name, e.what());
+                } catch (const std::exception& e) {
+                    LOG_WARNING("Unexpected error while connecting client %1%: %2%",
+                                c_ptr->configuration.common_name, e.what());
+                } catch (...) {
+                    LOG_WARNING("Unexpected error while connecting client %1%",
+                                c_ptr->configuration.common_name);
+                }
+
+                if (!c_ptr->isAssociated())
+                    num_failures++;
+            });
+    }
+
+    std::unique_lock<std::mutex> lck {mtx};
+    cv.wait(lck, [&]() { return num_done == client_ptrs.size(); });
+
+    return num_failures.load();
+}
+
 }  // namespace pcp_test
@@ -18,8 +18,6 @@ const uint32_t DEFAULT_ASSOCIATION_TIMEOUT_S {15};
 const uint32_t DEFAULT_ASSOCIATION_REQUEST_TTL_S {10};
 const uint32_t DEFAULT_MESSAGE_TTL_S {5};
 
-static boost::format CERT_FILE_FORMAT {"%1%.example.com_%2%.pem"};
-
 client_configuration::client_configuration(
         std::string common_name_,
         const std::string& client_type_,
@@ -32,6 +30,8 @@ client_configuration::client_configuration(
     : common_name {std::move(common_name_)},
       client_type(client_type_),
       broker_ws_uris(broker_ws_uris_),
+      broker_idx {0},
+      client_idx {0},
       certificates_dir(certificates_dir_),
       connection_timeout_ms {std::move(connection_tmeout_ms_)},
       association_timeout_s {std::move(association_timeout_s_)},
@@ -43,10 +43,13 @@ client_configuration::client_configuration(
 
 void client_configuration::update_cert_paths()
 {
+    // NB: a local format, as update_cert_paths() may be called by
+    // concurrent threads
+    boost::format cert_file_format {"%1%.example.com_%2%.pem"};
     fs::path c_p {certificates_dir};
     ca  = (c_p / "ca_crt.pem").string();
-    crt = (c_p / "test" / (CERT_FILE_FORMAT % common_name % "crt").str()).string();
-    key = (c_p / "test" / (CERT_FILE_FORMAT % common_name % "key").str()).string();
+    crt = (c_p / "test" / (cert_file_format % common_name % "crt").str()).string();
+    key = (c_p / "test" / (cert_file_format % common_name % "key").str()).string();
 }
 
 }  // namespace pcp_test
@@ -0,0 +1,67 @@
+#include <pcp-test/client_pool.hpp>
+
+#include <algorithm>
+
+namespace pcp_test {
+
+client_pool::client_pool()
+        : mtx_ {},
+          client_ptrs_ {}
+{
+}
+
+void client_pool::add(const std::vector<std::shared_ptr<client>>& client_ptrs)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    client_ptrs_.insert(client_ptrs_.end(), client_ptrs.begin(), client_ptrs.end());
+}
+
+std::vector<std::shared_ptr<client>> client_pool::get_clients() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return client_ptrs_;
+}
+
+std::vector<std::shared_ptr<client>> client_pool::get_unassociated_clients() const
+{
+    std::vector<std::shared_ptr<client>> unassociated_ptrs {};
+    std::lock_guard<std::mutex> the_lock {mtx_};
+
+    for (const auto& c_ptr : client_ptrs_)
+        if (!c_ptr->isAssociated())
+            unassociated_ptrs.push_back(c_ptr);
+
+    return unassociated_ptrs;
+}
+
+std::vector<std::vector<std::shared_ptr<client>>>
+client_pool::release(std::size_t num_sets)
+{
+    std::vector<std::shared_ptr<client>> client_ptrs {};
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        client_ptrs.swap(client_ptrs_);
+    }
+
+    num_sets = std::max<std::size_t>(1, std::min(num_sets, client_ptrs.size()));
+    std::vector<std::vector<std::shared_ptr<client>>> sets(num_sets);
+
+    for (std::size_t idx = 0; idx < client_ptrs.size(); idx++)
+        sets[idx % num_sets].push_back(std::move(client_ptrs[idx]));
+
+    return sets;
+}
+
+std::size_t client_pool::size() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return client_ptrs_.size();
+}
+
+bool client_pool::empty() const
+{
+    return size() == 0;
+}
+
+}  // namespace pcp_test
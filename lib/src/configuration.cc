@@ -1,8 +1,15 @@
 #include <pcp-test/configuration.hpp>
+#include <pcp-test/broker_distribution.hpp>
+#include <pcp-test/cert_store.hpp>
 #include <pcp-test/pcp-test.hpp>
 #include <pcp-test/errors.hpp>
 #include <pcp-test/schemas.hpp>
 #include <pcp-test/test_connection_parameters.hpp>
+#include <pcp-test/test_throughput_parameters.hpp>
+#include <pcp-test/test_fanout_parameters.hpp>
+#include <pcp-test/test_soak_parameters.hpp>
+#include <pcp-test/test_scenario_parameters.hpp>
+#include <pcp-test/scenario.hpp>
 #include <pcp-test/configuration_parameters.hpp>
 
 #include <pcp-test/root_path.h>
@@ -22,6 +29,8 @@
 
 #include <boost/format.hpp>
 
+#include <boost/asio/ip/address.hpp>
+
 // boost includes are not always warning-clean. Disable warnings that
 // cause problems before including the headers, then re-enable the warnings.
 #pragma GCC diagnostic push
@@ -29,7 +38,9 @@
 #include <boost/program_options.hpp>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <vector>
 #include <set>
 
@@ -43,6 +54,10 @@ namespace lth_jc     = leatherman::json_container;
 namespace po         = boost::program_options;
 namespace fs         = boost::filesystem;
 namespace conn_par   = pcp_test::connection_test_parameters;
+namespace thr_par    = pcp_test::throughput_test_parameters;
+namespace fan_par    = pcp_test::fanout_test_parameters;
+namespace soak_par   = pcp_test::soak_test_parameters;
+namespace scen_par   = pcp_test::scenario_test_parameters;
 namespace config_par = pcp_test::configuration_parameters;
 
 const std::string DEFAULT_CONFIGFILE  {"/etc/puppetlabs/pcp-test/pcp-test.conf"};
@@ -56,69 +71,34 @@ const std::string DEFAULT_CLIENT_LOGLEVEL_TEXT {"warning"};
 const std::string DEFAULT_BROKER_WS_URI {"wss://localhost:8142/pcp/"};
 
 const std::string URL_REGEX             {"^wss:\\/\\/\\S+:\\d+\\/\\S+"};
-const std::string AGENT_CERT_REGEX      {"(\\d+)agent.example.com_.*"};
-const std::string CONTROLLER_CERT_REGEX {"(\\d+)controller.example.com_.*"};
+const std::string WORKER_ADDRESS_REGEX  {"^[^:\\s]+:\\d+$"};
 
 //
 // utility functions
 //
 
-std::set<std::string> get_endpoint_names(const std::vector<std::string>& names,
-                                         std::string role,
-                                         std::string endpoint_regex,
-                                         int num_endpoints) {
-    boost::regex re { endpoint_regex };
-    boost::cmatch matches;
-    std::set<std::string> unique_names;
-    auto num_names = static_cast<unsigned int>(num_endpoints);  // NOLINT(runtime/int)
-
-    for (const auto& name : names) {
-        if (boost::regex_match(name.c_str(), matches, re)) {
-            unique_names.insert(
-                    std::string(matches[1].first, matches[1].second) + role);
-
-            if (unique_names.size() >= num_names)
-                break;
-        }
-    }
-
-    return unique_names;
-}
-
-std::set<std::string> get_agent_names(const std::vector<std::string>& names,
-                                      int num_agents) {
-    return get_endpoint_names(names, "agent", AGENT_CERT_REGEX, num_agents);
-}
-
-std::set<std::string> get_controller_names(const std::vector<std::string>& names,
-                                           int num_controllers) {
-    return get_endpoint_names(names, "controller", CONTROLLER_CERT_REGEX,
-                              num_controllers);
-}
-
-bool has_cert_suffix(const std::string& s)
+// Set the agent and controller common names, from index 0; throw a
+// configuration_error in case there are not enough certificates
+static void set_endpoint_names(application_options& a_o,
+                               cert_store& store,
+                               int num_agents,
+                               int num_controllers)
 {
-    static const std::string suffix {"_crt.pem"};
-    static auto suffix_size = suffix.size();
-
-    return (s.size() > suffix_size
-            && s.compare(s.size() - suffix_size, suffix_size, suffix) == 0);
-}
-
-std::vector<std::string> get_crt_files_from_dir(fs::path dir_path) {
-    std::vector<std::string> names {};
-    fs::directory_iterator end_iter {};
-    fs::directory_iterator dir_iter {dir_path};
-
-    for (; dir_iter != end_iter; ++dir_iter) {
-        if (fs::is_regular_file(dir_iter->status())) {
-            auto name = dir_iter->path().filename().string();
-            if (has_cert_suffix(name))
-                names.push_back(std::move(name));
-        }
+    try {
+        a_o.agents      = store.get_common_names("agent", num_agents);
+        a_o.controllers = store.get_common_names("controller", num_controllers);
+    } catch (const cert_store::error& e) {
+        throw configuration_error(
+            (boost::format("failed to generate the certificates: %1%") % e.what()).str());
     }
 
-    return names;
+    if (static_cast<int>(a_o.agents.size()) < num_agents
+            || static_cast<int>(a_o.controllers.size()) < num_controllers)
+        throw configuration_error(
+            (boost::format("%1% agent and %2% controller certificates "
+                           "requested, but only %3% and %4% are available")
+             % num_agents % num_controllers
+             % a_o.agents.size() % a_o.controllers.size()).str());
 }
 
 //
@@ -143,6 +123,11 @@ void help(po::options_description &desc)
         "\n"
         "  trivial    - just a proof of concept\n"
         "  connection - determines how many PCP connections the broker can handle\n"
+        "  throughput - determines the request/response message rate the broker can route\n"
+        "  fanout     - determines how fast the broker delivers requests to many agents\n"
+        "  soak       - keeps connections and traffic up for hours, to expose leaks and drifts\n"
+        "  scenario   - executes the phases of a workload described in the configuration\n"
+        "  worker     - runs its share of a distributed connection test\n"
         "\n"
         "Options\n"
         "=======\n\n" << desc <<
@@ -206,6 +191,9 @@ application_options get_application_options(int argc, char** argv)
              po::value<std::string>()->default_value(DEFAULT_CERTIFICATES_DIR),
              "SSL certificates path (see doc for the expected directory tree "
              "structure)")
+            (config_par::GENERATE_CERTIFICATES.c_str(),
+             po::bool_switch()->default_value(false),
+             "generate the missing test certificates, by using the CA key")
             (config_par::RESULTS_DIR.c_str(),
              po::value<std::string>()->default_value(DEFAULT_RESULTS_DIR),
              "results directory");
@@ -262,8 +250,9 @@ application_options get_application_options(int argc, char** argv)
         a_o.broker_ws_uris = std::vector<std::string>();
     }
 
-    a_o.certificates_dir = vm[config_par::CERTIFICATES_DIR].as<std::string>();
-    a_o.results_dir      = vm[config_par::RESULTS_DIR].as<std::string>();
+    a_o.certificates_dir      = vm[config_par::CERTIFICATES_DIR].as<std::string>();
+    a_o.generate_certificates = vm[config_par::GENERATE_CERTIFICATES].as<bool>();
+    a_o.results_dir           = vm[config_par::RESULTS_DIR].as<std::string>();
 
     return a_o;
 }
@@ -347,6 +336,9 @@ void parse_configfile_and_process_options(application_options& a_o) {
         }
     }
 
+    if (!a_o.generate_certificates && config_json.includes(config_par::GENERATE_CERTIFICATES))
+        a_o.generate_certificates = config_json.get<bool>(config_par::GENERATE_CERTIFICATES);
+
     a_o.certificates_dir = lth_file::tilde_expand(a_o.certificates_dir);
     a_o.results_dir      = lth_file::tilde_expand(a_o.results_dir);
 
@@ -361,6 +353,53 @@ void parse_configfile_and_process_options(application_options& a_o) {
                                        % e.what()).str());
         }
     }
+
+    if (config_json.includes(config_par::THROUGHPUT_TEST_PARAMETERS)) {
+        try {
+            a_o.throughput_test_parameters =
+                config_json.get<lth_jc::JsonContainer>(config_par::THROUGHPUT_TEST_PARAMETERS);
+        } catch (const lth_jc::data_error& e) {
+            throw configuration_error((boost::format("invalid configuration file (%1%)")
+                                       % e.what()).str());
+        }
+    }
+
+    if (config_json.includes(config_par::FANOUT_TEST_PARAMETERS)) {
+        try {
+            a_o.fanout_test_parameters =
+                config_json.get<lth_jc::JsonContainer>(config_par::FANOUT_TEST_PARAMETERS);
+        } catch (const lth_jc::data_error& e) {
+            throw configuration_error((boost::format("invalid configuration file (%1%)")
+                                       % e.what()).str());
+        }
+    }
+
+    if (config_json.includes(config_par::SOAK_TEST_PARAMETERS)) {
+        try {
+            a_o.soak_test_parameters =
+                config_json.get<lth_jc::JsonContainer>(config_par::SOAK_TEST_PARAMETERS);
+        } catch (const lth_jc::data_error& e) {
+            throw configuration_error((boost::format("invalid configuration file (%1%)")
+                                       % e.what()).str());
+        }
+    }
+
+    if (config_json.includes(config_par::SCENARIO_TEST_PARAMETERS)) {
+        try {
+            a_o.scenario_test_parameters =
+                config_json.get<lth_jc::JsonContainer>(config_par::SCENARIO_TEST_PARAMETERS);
+        } catch (const lth_jc::data_error& e) {
+            throw configuration_error((boost::format("invalid configuration file (%1%)")
+                                       % e.what()).str());
+        }
+    }
+}
+
+// Workers run the connection test on behalf of a coordinator
+static bool runs_connection_test(const application_options& a_o)
+{
+    auto t_type = to_test_type.at(a_o.test);
+    return t_type == test_type::connection || t_type == test_type::worker;
 }
 
 void validate_application_options(application_options& a_o)
@@ -392,12 +431,18 @@ void validate_application_options(application_options& a_o)
     fs::path cert_root_dir {a_o.certificates_dir};
     auto cert_test_dir = cert_root_dir / "test";
 
-    if (!fs::exists(cert_root_dir) || !fs::exists(cert_test_dir))
+    // NB: with generation enabled, the test directory is created as
+    // needed
+    if (!fs::is_directory(cert_root_dir)
+            || (!a_o.generate_certificates && !fs::is_directory(cert_test_dir)))
         throw configuration_error("invalid certificate directory");
 
-    if (!fs::exists(cert_root_dir / "ca_crt.pem"))
+    if (!fs::exists(cert_root_dir / cert_store::CA_CERT_FILE))
         throw configuration_error("CA certificate does not exist");
 
+    if (a_o.generate_certificates && !fs::exists(cert_root_dir / cert_store::CA_KEY_FILE))
+        throw configuration_error("the CA key is required to generate certificates");
+
     // results directory
     if (!fs::exists(a_o.results_dir) || !fs::is_directory(a_o.results_dir))
         throw configuration_error((boost::format("invalid results directory '%1%'")
@@ -418,14 +463,490 @@ void validate_application_options(application_options& a_o)
                                                      "parameters (%1%)")
                                        % e.what()).str());
         }
-    } else if (to_test_type.at(a_o.test) == test_type::connection) {
+    } else if (runs_connection_test(a_o)) {
         throw configuration_error("connection test settings are missing in "
                                   "the configuration file");
     }
 
+    if (!a_o.throughput_test_parameters.empty()) {
+        parameters_validator.registerSchema(schemas::throughput_test_parameters());
+
+        try {
+            parameters_validator.validate(a_o.throughput_test_parameters,
+                                          config_par::THROUGHPUT_TEST_PARAMETERS);
+        } catch (const PCPClient::validation_error& e) {
+            throw configuration_error((boost::format("invalid throughput test "
+                                                     "parameters (%1%)")
+                                       % e.what()).str());
+        }
+    } else if (to_test_type.at(a_o.test) == test_type::throughput) {
+        throw configuration_error("throughput test settings are missing in "
+                                  "the configuration file");
+    }
+
+    if (!a_o.fanout_test_parameters.empty()) {
+        parameters_validator.registerSchema(schemas::fanout_test_parameters());
+
+        try {
+            parameters_validator.validate(a_o.fanout_test_parameters,
+                                          config_par::FANOUT_TEST_PARAMETERS);
+        } catch (const PCPClient::validation_error& e) {
+            throw configuration_error((boost::format("invalid fan-out test "
+                                                     "parameters (%1%)")
+                                       % e.what()).str());
+        }
+    } else if (to_test_type.at(a_o.test) == test_type::fanout) {
+        throw configuration_error("fan-out test settings are missing in "
+                                  "the configuration file");
+    }
+
+    if (!a_o.soak_test_parameters.empty()) {
+        parameters_validator.registerSchema(schemas::soak_test_parameters());
+
+        try {
+            parameters_validator.validate(a_o.soak_test_parameters,
+                                          config_par::SOAK_TEST_PARAMETERS);
+        } catch (const PCPClient::validation_error& e) {
+            throw configuration_error((boost::format("invalid soak test "
+                                                     "parameters (%1%)")
+                                       % e.what()).str());
+        }
+    } else if (to_test_type.at(a_o.test) == test_type::soak) {
+        throw configuration_error("soak test settings are missing in "
+                                  "the configuration file");
+    }
+
+    if (!a_o.scenario_test_parameters.empty()) {
+        parameters_validator.registerSchema(schemas::scenario_test_parameters());
+
+        try {
+            parameters_validator.validate(a_o.scenario_test_parameters,
+                                          config_par::SCENARIO_TEST_PARAMETERS);
+        } catch (const PCPClient::validation_error& e) {
+            throw configuration_error((boost::format("invalid scenario test "
+                                                     "parameters (%1%)")
+                                       % e.what()).str());
+        }
+    } else if (to_test_type.at(a_o.test) == test_type::scenario) {
+        throw configuration_error("scenario test settings are missing in "
+                                  "the configuration file");
+    }
+
+    // throughput load
+
+    if (to_test_type.at(a_o.test) == test_type::throughput) {
+        const auto& p = a_o.throughput_test_parameters;
+        auto get_optional_int =
+            [&p](const std::string& parameter) -> int
+            {
+                return p.includes(parameter) ? p.get<int>(parameter) : 0;
+            };
+
+        if (p.get<int>(thr_par::NUM_AGENTS) < 1 || p.get<int>(thr_par::NUM_CONTROLLERS) < 1)
+            throw configuration_error("at least one agent and one controller "
+                                      "are required");
+
+        if (p.get<int>(thr_par::RUN_DURATION_S) < 1)
+            throw configuration_error("the run duration must be positive");
+
+        for (const auto& parameter : {thr_par::AGENTS_INCREMENT,
+                                      thr_par::CONTROLLERS_INCREMENT,
+                                      thr_par::REQUEST_RATE,
+                                      thr_par::REQUEST_RATE_INCREMENT,
+                                      thr_par::INFLIGHT_WINDOW,
+                                      thr_par::SEND_BATCH_SIZE,
+                                      thr_par::RESPONSE_TIMEOUT_MS,
+                                      thr_par::PAYLOAD_SIZE,
+                                      thr_par::PAYLOAD_MAX_SIZE,
+                                      thr_par::RESPONDER_THREADS,
+                                      thr_par::PROCESSING_DELAY_US,
+                                      thr_par::PROCESSING_DELAY_MAX_US})
+            if (get_optional_int(parameter) < 0)
+                throw configuration_error(
+                    (boost::format("%1% cannot be negative") % parameter).str());
+
+        if (get_optional_int(thr_par::REQUEST_RATE) == 0
+                && get_optional_int(thr_par::INFLIGHT_WINDOW) == 0)
+            throw configuration_error("either a request rate or an in-flight "
+                                      "window must be specified");
+
+        if (get_optional_int(thr_par::SEND_BATCH_SIZE) > 0
+                && get_optional_int(thr_par::INFLIGHT_WINDOW) == 0)
+            throw configuration_error("pipelined sends (send-batch-size) require "
+                                      "an in-flight window");
+
+        if (p.includes(thr_par::PAYLOAD_SIZE_DISTRIBUTION)) {
+            auto distribution = p.get<std::string>(thr_par::PAYLOAD_SIZE_DISTRIBUTION);
+
+            if (distribution != thr_par::FIXED_SIZE
+                    && distribution != thr_par::UNIFORM_SIZE
+                    && distribution != thr_par::EXPONENTIAL_SIZE)
+                throw configuration_error(
+                    (boost::format("invalid payload size distribution (%1%)")
+                     % distribution).str());
+
+            if (distribution != thr_par::FIXED_SIZE
+                    && get_optional_int(thr_par::PAYLOAD_MAX_SIZE)
+                       <= get_optional_int(thr_par::PAYLOAD_SIZE))
+                throw configuration_error(
+                    (boost::format("the %1% payload size distribution requires "
+                                   "a maximum payload size greater than the "
+                                   "payload size") % distribution).str());
+        }
+
+        if (p.includes(thr_par::PAYLOAD_FORMAT)) {
+            auto format = p.get<std::string>(thr_par::PAYLOAD_FORMAT);
+            if (format != thr_par::JSON_PAYLOAD && format != thr_par::BINARY_PAYLOAD)
+                throw configuration_error(
+                    (boost::format("invalid payload format (%1%)") % format).str());
+        }
+
+        if (p.includes(thr_par::NUM_PAYLOADS) && p.get<int>(thr_par::NUM_PAYLOADS) < 1)
+            throw configuration_error("the number of payloads must be positive");
+
+        if (p.includes(thr_par::RESPONDER_QUEUE_SIZE)
+                && p.get<int>(thr_par::RESPONDER_QUEUE_SIZE) < 1)
+            throw configuration_error("the responder queue size must be positive");
+
+        if ((get_optional_int(thr_par::PROCESSING_DELAY_US) > 0
+                    || p.includes(thr_par::PROCESSING_DELAY_DISTRIBUTION))
+                && get_optional_int(thr_par::RESPONDER_THREADS) == 0)
+            throw configuration_error("simulated processing delays require "
+                                      "responder threads");
+
+        if (p.includes(thr_par::PROCESSING_DELAY_DISTRIBUTION)) {
+            auto distribution = p.get<std::string>(thr_par::PROCESSING_DELAY_DISTRIBUTION);
+
+            if (distribution != thr_par::FIXED_SIZE
+                    && distribution != thr_par::UNIFORM_SIZE
+                    && distribution != thr_par::EXPONENTIAL_SIZE)
+                throw configuration_error(
+                    (boost::format("invalid processing delay distribution (%1%)")
+                     % distribution).str());
+
+            if (distribution != thr_par::FIXED_SIZE
+                    && get_optional_int(thr_par::PROCESSING_DELAY_MAX_US)
+                       <= get_optional_int(thr_par::PROCESSING_DELAY_US))
+                throw configuration_error(
+                    (boost::format("the %1% processing delay distribution "
+                                   "requires a maximum processing delay greater "
+                                   "than the processing delay") % distribution).str());
+        }
+    }
+
+    // fan-out load
+
+    if (to_test_type.at(a_o.test) == test_type::fanout) {
+        const auto& p = a_o.fanout_test_parameters;
+
+        if (p.get<int>(fan_par::NUM_AGENTS) < 1 || p.get<int>(fan_par::NUM_CONTROLLERS) < 1)
+            throw configuration_error("at least one agent and one controller "
+                                      "are required");
+
+        if (p.get<int>(fan_par::NUM_BROADCASTS) < 1)
+            throw configuration_error("the number of broadcasts must be positive");
+
+        for (const auto& parameter : {fan_par::AGENTS_INCREMENT,
+                                      fan_par::CONTROLLERS_INCREMENT,
+                                      fan_par::BROADCAST_PAUSE_MS,
+                                      fan_par::RESPONSE_TIMEOUT_MS})
+            if (p.includes(parameter) && p.get<int>(parameter) < 0)
+                throw configuration_error(
+                    (boost::format("%1% cannot be negative") % parameter).str());
+
+        if (p.includes(fan_par::TARGETING)) {
+            auto targeting = p.get<std::string>(fan_par::TARGETING);
+            if (targeting != fan_par::WILDCARD_TARGETING
+                    && targeting != fan_par::EXPLICIT_TARGETING)
+                throw configuration_error(
+                    (boost::format("invalid targeting (%1%)") % targeting).str());
+        }
+    }
+
+    // soak load
+
+    if (to_test_type.at(a_o.test) == test_type::soak) {
+        const auto& p = a_o.soak_test_parameters;
+
+        if (p.get<int>(soak_par::NUM_AGENTS) < 1 || p.get<int>(soak_par::NUM_CONTROLLERS) < 1)
+            throw configuration_error("at least one agent and one controller "
+                                      "are required");
+
+        if (p.get<int>(soak_par::DURATION_S) < 1)
+            throw configuration_error("the duration must be positive");
+
+        if (p.get<int>(soak_par::REQUEST_RATE) < 0)
+            throw configuration_error("the request rate cannot be negative");
+
+        if (p.includes(soak_par::CHURN_PER_MIN) && p.get<int>(soak_par::CHURN_PER_MIN) < 0)
+            throw configuration_error("the churn cannot be negative");
+
+        for (const auto& parameter : {soak_par::SNAPSHOT_INTERVAL_S,
+                                      soak_par::WS_CONNECTION_CHECK_INTERVAL_S})
+            if (p.includes(parameter) && p.get<int>(parameter) < 1)
+                throw configuration_error(
+                    (boost::format("%1% must be positive") % parameter).str());
+    }
+
+    // scenario load; the phases are validated when parsed
+
+    if (to_test_type.at(a_o.test) == test_type::scenario) {
+        const auto& p = a_o.scenario_test_parameters;
+
+        for (const auto& parameter : {scen_par::WS_CONNECTION_CHECK_INTERVAL_S,
+                                      scen_par::RECONNECT_CHECK_INTERVAL_MS})
+            if (p.includes(parameter) && p.get<int>(parameter) < 1)
+                throw configuration_error(
+                    (boost::format("%1% must be positive") % parameter).str());
+
+        parse_scenario(p);
+    }
+
+    // connection engine and arrivals
+
+    if (runs_connection_test(a_o)) {
+        const auto& p = a_o.connection_test_parameters;
+
+        if (p.includes(conn_par::CONNECTION_ENGINE)) {
+            auto engine = p.get<std::string>(conn_par::CONNECTION_ENGINE);
+            if (engine != conn_par::THREADED_ENGINE && engine != conn_par::POOLED_ENGINE)
+                throw configuration_error(
+                    (boost::format("invalid connection engine (%1%)") % engine).str());
+        }
+
+        if (p.includes(conn_par::ENGINE_THREADS) && p.get<int>(conn_par::ENGINE_THREADS) < 1)
+            throw configuration_error("the number of engine threads must be positive");
+
+        if (p.includes(conn_par::KEEPALIVE_THREADS)
+                && p.get<int>(conn_par::KEEPALIVE_THREADS) < 1)
+            throw configuration_error("the number of keepalive threads must be positive");
+
+        if (p.includes(conn_par::WS_CONNECTION_CHECK_INTERVAL_S)
+                && p.get<int>(conn_par::WS_CONNECTION_CHECK_INTERVAL_S) < 1)
+            throw configuration_error("the WebSocket connection check interval "
+                                      "must be positive");
+
+        if (p.includes(conn_par::ARRIVAL_MODE)) {
+            auto mode = p.get<std::string>(conn_par::ARRIVAL_MODE);
+            if (mode != conn_par::CLOSED_LOOP_ARRIVALS && mode != conn_par::OPEN_LOOP_ARRIVALS)
+                throw configuration_error(
+                    (boost::format("invalid arrival mode (%1%)") % mode).str());
+
+            if (mode == conn_par::OPEN_LOOP_ARRIVALS
+                    && (!p.includes(conn_par::CONNECTION_RATE)
+                        || p.get<int>(conn_par::CONNECTION_RATE) < 1))
+                throw configuration_error("open-loop arrivals require a positive "
+                                          "connection rate");
+        }
+
+        if (p.includes(conn_par::RAMP_UP_MS) && p.get<int>(conn_par::RAMP_UP_MS) < 0)
+            throw configuration_error("the ramp-up interval cannot be negative");
+
+        if (p.includes(conn_par::INCREMENTAL_RAMP)
+                && p.get<bool>(conn_par::INCREMENTAL_RAMP)
+                && (p.get<int>(conn_par::ENDPOINTS_INCREMENT) < 0
+                    || p.get<int>(conn_par::CONCURRENCY_INCREMENT) < 0))
+            throw configuration_error("the incremental ramp requires non-negative "
+                                      "endpoints and concurrency increments");
+
+        if (p.includes(conn_par::TEARDOWN_PARALLELISM)
+                && p.get<int>(conn_par::TEARDOWN_PARALLELISM) < 1)
+            throw configuration_error("the teardown parallelism must be positive");
+
+        if (p.includes(conn_par::TEARDOWN_RATE) && p.get<int>(conn_par::TEARDOWN_RATE) < 0)
+            throw configuration_error("the teardown rate cannot be negative");
+
+        if (p.includes(conn_par::BROKER_DISTRIBUTION)) {
+            auto policy = p.get<std::string>(conn_par::BROKER_DISTRIBUTION);
+            if (policy != conn_par::FIRST_BROKER
+                    && policy != conn_par::ROUND_ROBIN_BROKERS
+                    && policy != conn_par::WEIGHTED_BROKERS
+                    && policy != conn_par::HASHED_BROKERS)
+                throw configuration_error(
+                    (boost::format("invalid broker distribution (%1%)") % policy).str());
+
+            if (policy == conn_par::WEIGHTED_BROKERS
+                    && !p.includes(conn_par::BROKER_WEIGHTS))
+                throw configuration_error("the weighted broker distribution "
+                                          "requires broker weights");
+        }
+
+        if (p.includes(conn_par::BROKER_WEIGHTS)) {
+            auto weights = p.get<std::vector<int>>(conn_par::BROKER_WEIGHTS);
+
+            if (weights.size() != a_o.broker_ws_uris.size())
+                throw configuration_error(
+                    (boost::format("%1% broker weights specified for %2% brokers")
+                     % weights.size() % a_o.broker_ws_uris.size()).str());
+
+            if (std::any_of(weights.begin(), weights.end(), [](int w) { return w < 0; })
+                    || std::none_of(weights.begin(), weights.end(), [](int w) { return w > 0; }))
+                throw configuration_error("broker weights must be non-negative, "
+                                          "with at least a positive one");
+
+            if (get_reduced_total_weight({weights.begin(), weights.end()})
+                    > MAX_BROKER_TOTAL_WEIGHT)
+                throw configuration_error(
+                    (boost::format("the sum of broker weights, reduced by their "
+                                   "greatest common divisor, cannot exceed %1%")
+                     % MAX_BROKER_TOTAL_WEIGHT).str());
+        }
+
+        // distributed test
+
+        if (p.includes(conn_par::WORKERS)) {
+            boost::regex worker_re {WORKER_ADDRESS_REGEX};
+
+            for (const auto& address : p.get<std::vector<std::string>>(conn_par::WORKERS))
+                if (!boost::regex_match(address, worker_re))
+                    throw configuration_error(
+                        (boost::format("invalid worker address (%1%); the "
+                                       "<host>:<port> format is expected")
+                         % address).str());
+
+            if (p.includes(conn_par::INCREMENTAL_RAMP)
+                    && p.get<bool>(conn_par::INCREMENTAL_RAMP))
+                throw configuration_error("the incremental ramp is not supported "
+                                          "by distributed tests");
+        }
+
+        if (p.includes(conn_par::WORKER_PORT)
+                && (p.get<int>(conn_par::WORKER_PORT) < 1
+                    || p.get<int>(conn_par::WORKER_PORT) > 65535))
+            throw configuration_error("invalid worker port");
+
+        if (p.includes(conn_par::WORKER_BIND_ADDRESS)) {
+            boost::system::error_code ec {};
+            boost::asio::ip::address::from_string(
+                p.get<std::string>(conn_par::WORKER_BIND_ADDRESS), ec);
+
+            if (ec)
+                throw configuration_error(
+                    (boost::format("invalid worker bind address (%1%); an IP "
+                                   "address is expected")
+                     % p.get<std::string>(conn_par::WORKER_BIND_ADDRESS)).str());
+        }
+
+        if (p.includes(conn_par::LIVE_METRICS_PORT)
+                && (p.get<int>(conn_par::LIVE_METRICS_PORT) < 1
+                    || p.get<int>(conn_par::LIVE_METRICS_PORT) > 65535))
+            throw configuration_error("invalid live metrics port");
+
+        if (p.includes(conn_par::LIVE_METRICS_BIND_ADDRESS)) {
+            boost::system::error_code ec {};
+            boost::asio::ip::address::from_string(
+                p.get<std::string>(conn_par::LIVE_METRICS_BIND_ADDRESS), ec);
+
+            if (ec)
+                throw configuration_error(
+                    (boost::format("invalid live metrics bind address (%1%); an IP "
+                                   "address is expected")
+                     % p.get<std::string>(conn_par::LIVE_METRICS_BIND_ADDRESS)).str());
+        }
+
+        // capacity search
+
+        if (p.includes(conn_par::CAPACITY_SEARCH) && p.get<bool>(conn_par::CAPACITY_SEARCH)) {
+            if (p.get<int>(conn_par::NUM_RUNS) < 1)
+                throw configuration_error("the capacity search requires a positive "
+                                          "number of runs");
+
+            if (p.includes(conn_par::INCREMENTAL_RAMP)
+                    && p.get<bool>(conn_par::INCREMENTAL_RAMP))
+                throw configuration_error("the incremental ramp is not supported "
+                                          "by capacity searches");
+        }
+
+        if (p.includes(conn_par::MAX_FAILURES) && p.get<int>(conn_par::MAX_FAILURES) < 0)
+            throw configuration_error("the maximum number of failures cannot be negative");
+
+        if (p.includes(conn_par::LATENCY_SLO_MS)) {
+            if (p.get<int>(conn_par::LATENCY_SLO_MS) < 1)
+                throw configuration_error("the latency SLO must be positive");
+
+            if (!p.includes(conn_par::SHOW_STATS) || !p.get<bool>(conn_par::SHOW_STATS))
+                throw configuration_error("the latency SLO requires show-stats");
+        }
+
+        // coordinated omission correction
+
+        if (p.includes(conn_par::LATENCY_CORRECTION)
+                && p.get<bool>(conn_par::LATENCY_CORRECTION)) {
+            if (!p.includes(conn_par::SHOW_STATS) || !p.get<bool>(conn_par::SHOW_STATS))
+                throw configuration_error("the latency correction requires show-stats");
+
+            if (p.includes(conn_par::ARRIVAL_MODE)
+                    && p.get<std::string>(conn_par::ARRIVAL_MODE) == conn_par::OPEN_LOOP_ARRIVALS)
+                throw configuration_error("the latency correction is not needed by "
+                                          "open-loop arrivals, whose latency is measured "
+                                          "from the arrival time");
+        }
+
+        // reconnect storm
+
+        if (p.includes(conn_par::RECONNECT_STORM) && p.get<bool>(conn_par::RECONNECT_STORM)) {
+            if (!p.includes(conn_par::PERSIST_CONNECTIONS)
+                    || !p.get<bool>(conn_par::PERSIST_CONNECTIONS))
+                throw configuration_error("the reconnect storm requires "
+                                          "persist-connections");
+
+            if (p.includes(conn_par::INCREMENTAL_RAMP)
+                    && p.get<bool>(conn_par::INCREMENTAL_RAMP))
+                throw configuration_error("the incremental ramp is not supported "
+                                          "by reconnect storms");
+        }
+
+        if (p.includes(conn_par::HOLD_DURATION_S) && p.get<int>(conn_par::HOLD_DURATION_S) < 1)
+            throw configuration_error("the hold duration must be positive");
+
+        if (p.includes(conn_par::RECONNECT_CHECK_INTERVAL_MS)
+                && p.get<int>(conn_par::RECONNECT_CHECK_INTERVAL_MS) < 1)
+            throw configuration_error("the reconnect check interval must be positive");
+
+        if (p.includes(conn_par::RECONNECT_BACKOFF)) {
+            auto backoff = p.get<std::string>(conn_par::RECONNECT_BACKOFF);
+            if (backoff != conn_par::CONSTANT_BACKOFF
+                    && backoff != conn_par::EXPONENTIAL_BACKOFF)
+                throw configuration_error(
+                    (boost::format("invalid reconnect backoff (%1%)") % backoff).str());
+        }
+
+        if (p.includes(conn_par::RECONNECT_JITTER)) {
+            auto jitter = p.get<std::string>(conn_par::RECONNECT_JITTER);
+            if (jitter != conn_par::NO_JITTER
+                    && jitter != conn_par::FULL_JITTER
+                    && jitter != conn_par::EQUAL_JITTER
+                    && jitter != conn_par::DECORRELATED_JITTER)
+                throw configuration_error(
+                    (boost::format("invalid reconnect jitter (%1%)") % jitter).str());
+        }
+
+        {
+            auto base_ms = p.includes(conn_par::RECONNECT_BACKOFF_MS)
+                           ? p.get<int>(conn_par::RECONNECT_BACKOFF_MS) : 1000;
+            auto max_ms  = p.includes(conn_par::RECONNECT_BACKOFF_MAX_MS)
+                           ? p.get<int>(conn_par::RECONNECT_BACKOFF_MAX_MS) : 60000;
+
+            if (base_ms < 1)
+                throw configuration_error("the reconnect backoff must be positive");
+
+            if (max_ms < base_ms)
+                throw configuration_error("the maximum reconnect backoff cannot be "
+                                          "less than the reconnect backoff");
+        }
+    }
+
     // client common names
 
-    if (to_test_type.at(a_o.test) == test_type::connection) {
+    std::unique_ptr<cert_store> store {};
+
+    try {
+        store.reset(new cert_store(a_o.certificates_dir, a_o.generate_certificates));
+    } catch (const cert_store::error& e) {
+        throw configuration_error(e.what());
+    }
+
+    if (runs_connection_test(a_o)) {
         // We need certs...
         const auto& p = a_o.connection_test_parameters;
         auto max_num_clients_per_task =
@@ -436,21 +957,69 @@ void validate_application_options(application_options& a_o)
             + (p.get<int>(conn_par::NUM_RUNS) * p.get<int>(conn_par::CONCURRENCY_INCREMENT));
         auto num_clients = max_num_clients_per_task * max_concurrency;
 
-        auto file_names = get_crt_files_from_dir(cert_test_dir);
-        a_o.agents = get_agent_names(file_names, num_clients);
+        // Agents' certs first, then controllers'
+        try {
+            a_o.agents = store->get_common_names("agent", num_clients);
+            auto num_a_certs = static_cast<int>(a_o.agents.size());
+
+            if (num_a_certs < num_clients)
+                a_o.controllers = store->get_common_names("controller",
+                                                          num_clients - num_a_certs);
+        } catch (const cert_store::error& e) {
+            throw configuration_error(
+                (boost::format("failed to generate the certificates: %1%") % e.what()).str());
+        }
 
-        auto num_a_certs = static_cast<int>(a_o.agents.size());
-        if (num_a_certs < num_clients) {
-            a_o.controllers = get_controller_names(file_names,
-                                                   num_clients - num_a_certs);
+        auto num_certs = static_cast<int>(a_o.agents.size() + a_o.controllers.size());
+        if (num_certs < num_clients)
+            throw configuration_error(
+                (boost::format("%1% certificates requested, but only %2% "
+                               "are available")
+                 % num_clients % num_certs).str());
+    }
 
-            auto num_c_certs = static_cast<int>(a_o.controllers.size());
-            if (num_a_certs + num_c_certs < num_clients)
-                throw configuration_error(
-                    (boost::format("%1% certificates requested, but only %2% "
-                                   "are available")
-                     % num_clients % (num_a_certs + num_c_certs)).str());
-        }
+    if (to_test_type.at(a_o.test) == test_type::throughput) {
+        // Agents and controllers use their own certs
+        const auto& p = a_o.throughput_test_parameters;
+        auto num_runs = p.get<int>(thr_par::NUM_RUNS);
+        auto max_num_agents =
+            p.get<int>(thr_par::NUM_AGENTS)
+            + num_runs * (p.includes(thr_par::AGENTS_INCREMENT)
+                          ? p.get<int>(thr_par::AGENTS_INCREMENT) : 0);
+        auto max_num_controllers =
+            p.get<int>(thr_par::NUM_CONTROLLERS)
+            + num_runs * (p.includes(thr_par::CONTROLLERS_INCREMENT)
+                          ? p.get<int>(thr_par::CONTROLLERS_INCREMENT) : 0);
+
+        set_endpoint_names(a_o, *store, max_num_agents, max_num_controllers);
+    }
+
+    if (to_test_type.at(a_o.test) == test_type::fanout) {
+        const auto& p = a_o.fanout_test_parameters;
+        auto num_runs = p.get<int>(fan_par::NUM_RUNS);
+        auto max_num_agents =
+            p.get<int>(fan_par::NUM_AGENTS)
+            + num_runs * (p.includes(fan_par::AGENTS_INCREMENT)
+                          ? p.get<int>(fan_par::AGENTS_INCREMENT) : 0);
+        auto max_num_controllers =
+            p.get<int>(fan_par::NUM_CONTROLLERS)
+            + num_runs * (p.includes(fan_par::CONTROLLERS_INCREMENT)
+                          ? p.get<int>(fan_par::CONTROLLERS_INCREMENT) : 0);
+
+        set_endpoint_names(a_o, *store, max_num_agents, max_num_controllers);
+    }
+
+    if (to_test_type.at(a_o.test) == test_type::soak) {
+        const auto& p = a_o.soak_test_parameters;
+        set_endpoint_names(a_o, *store,
+                           p.get<int>(soak_par::NUM_AGENTS),
+                           p.get<int>(soak_par::NUM_CONTROLLERS));
+    }
+
+    if (to_test_type.at(a_o.test) == test_type::scenario) {
+        auto population =
+            get_scenario_population(parse_scenario(a_o.scenario_test_parameters));
+        set_endpoint_names(a_o, *store, population.num_agents, population.num_controllers);
     }
 }
 
@@ -9,8 +9,13 @@ const std::string LOGFILE {"logfile"};
 const std::string CONFIG_FILE {"config-file"};
 const std::string BROKER_WS_URIS {"broker-ws-uris"};
 const std::string CERTIFICATES_DIR {"certificates-dir"};
+const std::string GENERATE_CERTIFICATES {"generate-certificates"};
 const std::string RESULTS_DIR {"results-dir"};
 const std::string CONNECTION_TEST_PARAMETERS {"connection-test-parameters"};
+const std::string THROUGHPUT_TEST_PARAMETERS {"throughput-test-parameters"};
+const std::string FANOUT_TEST_PARAMETERS {"fanout-test-parameters"};
+const std::string SOAK_TEST_PARAMETERS {"soak-test-parameters"};
+const std::string SCENARIO_TEST_PARAMETERS {"scenario-test-parameters"};
 
 }  // namespace connection_test_parameters
 }  // namespace pcp_test
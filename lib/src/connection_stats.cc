@@ -1,7 +1,9 @@
 #include <pcp-test/connection_stats.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <string>
 
 namespace pcp_test {
 
@@ -9,14 +11,39 @@ namespace pcp_test {
 // stats
 //
 
-stats::stats() {
+stats::stats()
+        : mean   {0.0},
+          stddev {0.0},
+          max    {0},
+          count  {0},
+          p50    {0},
+          p90    {0},
+          p99    {0},
+          p999   {0}
+{
 }
 
 stats::stats(const timing_accumulator_t &a)
         : mean   {boost::accumulators::mean(a)},
           stddev {std::sqrt(boost::accumulators::variance(a))},
           max    {boost::accumulators::max(a)},
-          count  {static_cast<uint32_t>(boost::accumulators::count(a)) }
+          count  {static_cast<uint32_t>(boost::accumulators::count(a)) },
+          p50    {0},
+          p90    {0},
+          p99    {0},
+          p999   {0}
+{
+}
+
+stats::stats(const latency_histogram &h)
+        : mean   {h.mean()},
+          stddev {std::sqrt(h.variance())},
+          max    {h.max()},
+          count  {static_cast<uint32_t>(h.count())},
+          p50    {h.percentile(50)},
+          p90    {h.percentile(90)},
+          p99    {h.percentile(99)},
+          p999   {h.percentile(99.9)}
 {
 }
 
@@ -24,30 +51,74 @@ stats::stats(const timing_accumulator_t &a)
 // connection_stats
 //
 
+// Percentiles line to be displayed under the mean/stddev/max one;
+// values are divided by the given factor
+static void display_percentiles(std::ostream& out,
+                                const stats& s,
+                                float divisor,
+                                const std::string& unit)
+{
+    out << "                        p50 "
+        << static_cast<float>(s.p50) / divisor << " " << unit << ", p90 "
+        << static_cast<float>(s.p90) / divisor << " " << unit << ", p99 "
+        << static_cast<float>(s.p99) / divisor << " " << unit << ", p99.9 "
+        << static_cast<float>(s.p999) / divisor << " " << unit << "\n";
+}
+
 std::ostream &operator<<(std::ostream& out, const connection_stats& c_s)
 {
     out << "; timing stats:\n"
         << "  TCP Connection: ..... mean "
         << c_s.tcp_us.mean / 1000 << " ms, std dev "
         << c_s.tcp_us.stddev / 1000 << " ms, max "
-        << static_cast<float>(c_s.tcp_us.max) / 1000 << " ms\n"
-        << "  WS Open Handshake: .. mean "
+        << static_cast<float>(c_s.tcp_us.max) / 1000 << " ms\n";
+    display_percentiles(out, c_s.tcp_us, 1000, "ms");
+    out << "  WS Open Handshake: .. mean "
         << c_s.ws_open_handshake_us.mean / 1000 << " ms, std dev "
         << c_s.ws_open_handshake_us.stddev / 1000 << " ms, max "
-        << static_cast<float>(c_s.ws_open_handshake_us.max) / 1000 << " ms\n"
-        << "  PCP Association: .... mean "
+        << static_cast<float>(c_s.ws_open_handshake_us.max) / 1000 << " ms\n";
+    display_percentiles(out, c_s.ws_open_handshake_us, 1000, "ms");
+    out << "  PCP Association: .... mean "
         << c_s.association_ms.mean << " ms, std dev "
         << c_s.association_ms.stddev << " ms, max "
-        << c_s.association_ms.max << " ms\n"
-        << "  PCP Session: ........ mean "
+        << c_s.association_ms.max << " ms\n";
+    display_percentiles(out, c_s.association_ms, 1, "ms");
+
+    if (c_s.ws_close_handshake_us.count) {
+        out << "  WS Close Handshake: . mean "
+            << c_s.ws_close_handshake_us.mean / 1000 << " ms, std dev "
+            << c_s.ws_close_handshake_us.stddev / 1000 << " ms, max "
+            << static_cast<float>(c_s.ws_close_handshake_us.max) / 1000 << " ms\n";
+        display_percentiles(out, c_s.ws_close_handshake_us, 1000, "ms");
+    }
+
+    out << "  PCP Session: ........ mean "
         << c_s.session_duration_ms.mean / 1000 << " s, std dev "
         << c_s.session_duration_ms.stddev / 1000 << " s, max "
         << static_cast<float>(c_s.session_duration_ms.max) / 1000 << " s ("
         << c_s.session_duration_ms.count << " sessions)\n";
 
+    if (c_s.connect_ms.count) {
+        out << "  Connect Latency: .... mean "
+            << c_s.connect_ms.mean << " ms, std dev "
+            << c_s.connect_ms.stddev << " ms, max "
+            << c_s.connect_ms.max << " ms\n";
+        display_percentiles(out, c_s.connect_ms, 1, "ms");
+    }
+
     return out;
 }
 
+static void write_percentiles(boost::nowide::ofstream& out,
+                              const stats& s,
+                              float divisor)
+{
+    out << static_cast<float>(s.p50) / divisor << ","
+        << static_cast<float>(s.p90) / divisor << ","
+        << static_cast<float>(s.p99) / divisor << ","
+        << static_cast<float>(s.p999) / divisor;
+}
+
 std::ofstream& operator<<(boost::nowide::ofstream& out, const connection_stats& c_s)
 {
     out << c_s.tcp_us.mean / 1000 << ","
@@ -61,11 +132,102 @@ std::ofstream& operator<<(boost::nowide::ofstream& out, const connection_stats&
         << c_s.association_ms.max << ","
         << c_s.session_duration_ms.mean / 1000 << ","
         << c_s.session_duration_ms.stddev / 1000 << ","
-        << static_cast<float>(c_s.session_duration_ms.max) / 1000;
+        << static_cast<float>(c_s.session_duration_ms.max) / 1000 << ",";
+
+    // Percentiles are appended, to keep the previous columns layout
+    write_percentiles(out, c_s.tcp_us, 1000);
+    out << ",";
+    write_percentiles(out, c_s.ws_open_handshake_us, 1000);
+    out << ",";
+    write_percentiles(out, c_s.association_ms, 1);
+    out << ",";
+    write_percentiles(out, c_s.ws_close_handshake_us, 1000);
+    out << ",";
+    write_percentiles(out, c_s.connect_ms, 1);
 
     return out;
 }
 
+//
+// connection_timings
+//
+
+void connection_timings::merge(const connection_timings& other)
+{
+    tcp_us.merge(other.tcp_us);
+    ws_open_handshake_us.merge(other.ws_open_handshake_us);
+    ws_close_handshake_us.merge(other.ws_close_handshake_us);
+    association_ms.merge(other.association_ms);
+    session_duration_ms.merge(other.session_duration_ms);
+    connect_ms.merge(other.connect_ms);
+}
+
+connection_stats connection_timings::get_connection_stats() const
+{
+    return connection_stats {stats(tcp_us),
+                             stats(ws_open_handshake_us),
+                             stats(ws_close_handshake_us),
+                             stats(association_ms),
+                             stats(session_duration_ms),
+                             stats(connect_ms)};
+}
+
+//
+// connection_timings_shard
+//
+
+connection_timings_shard::connection_timings_shard()
+    : timings_ {},
+      sealed_ {false}
+{
+}
+
+void connection_timings_shard::accumulate_tcp_us(uint32_t interval)
+{
+    timings_.tcp_us.record(interval);
+}
+
+void connection_timings_shard::accumulate_ws_open_handshake_us(uint32_t interval)
+{
+    timings_.ws_open_handshake_us.record(interval);
+}
+
+void connection_timings_shard::accumulate_ws_close_handshake_us(uint32_t interval)
+{
+    timings_.ws_close_handshake_us.record(interval);
+}
+
+void connection_timings_shard::accumulate_association_ms(uint32_t interval)
+{
+    timings_.association_ms.record(interval);
+}
+
+void connection_timings_shard::accumulate_session_duration_ms(uint32_t interval)
+{
+    timings_.session_duration_ms.record(interval);
+}
+
+void connection_timings_shard::accumulate_connect_ms(uint32_t interval,
+                                                     uint32_t expected_interval)
+{
+    timings_.connect_ms.record_corrected(interval, expected_interval);
+}
+
+void connection_timings_shard::seal()
+{
+    sealed_.store(true, std::memory_order_release);
+}
+
+bool connection_timings_shard::is_sealed() const
+{
+    return sealed_.load(std::memory_order_acquire);
+}
+
+const connection_timings& connection_timings_shard::get_timings() const
+{
+    return timings_;
+}
+
 //
 // connection_timings_accumulator
 //
@@ -73,41 +235,72 @@ std::ofstream& operator<<(boost::nowide::ofstream& out, const connection_stats&
 void connection_timings_accumulator::accumulate_tcp_us(uint32_t interval)
 {
     std::lock_guard<std::mutex> the_lock {the_mutex_};
-    tcp_us_acc_(interval);
+    timings_.tcp_us.record(interval);
 }
 
 void connection_timings_accumulator::accumulate_ws_open_handshake_us(uint32_t interval)
 {
     std::lock_guard<std::mutex> the_lock {the_mutex_};
-    ws_open_handshake_us_acc_(interval);
+    timings_.ws_open_handshake_us.record(interval);
 }
 
 void connection_timings_accumulator::accumulate_ws_close_handshake_us(uint32_t interval)
 {
     std::lock_guard<std::mutex> the_lock {the_mutex_};
-    ws_close_handshake_us_acc_(interval);
+    timings_.ws_close_handshake_us.record(interval);
 }
 
 void connection_timings_accumulator::accumulate_association_ms(uint32_t interval)
 {
     std::lock_guard<std::mutex> the_lock {the_mutex_};
-    association_ms_acc_(interval);
+    timings_.association_ms.record(interval);
 }
 
 void connection_timings_accumulator::accumulate_session_duration_ms(uint32_t interval)
 {
     std::lock_guard<std::mutex> the_lock {the_mutex_};
-    session_duration_ms_acc_(interval);
+    timings_.session_duration_ms.record(interval);
+}
+
+void connection_timings_accumulator::accumulate_connect_ms(uint32_t interval,
+                                                           uint32_t expected_interval)
+{
+    std::lock_guard<std::mutex> the_lock {the_mutex_};
+    timings_.connect_ms.record_corrected(interval, expected_interval);
+}
+
+std::shared_ptr<connection_timings_shard> connection_timings_accumulator::get_shard()
+{
+    auto shard_ptr = std::make_shared<connection_timings_shard>();
+    std::lock_guard<std::mutex> the_lock {the_mutex_};
+    shards_.push_back(shard_ptr);
+    return shard_ptr;
+}
+
+connection_timings connection_timings_accumulator::get_timings() const
+{
+    std::lock_guard<std::mutex> the_lock {the_mutex_};
+    auto merged = timings_;
+
+    for (const auto& shard_ptr : shards_)
+        if (shard_ptr->is_sealed())
+            merged.merge(shard_ptr->get_timings());
+
+    return merged;
 }
 
 connection_stats connection_timings_accumulator::get_connection_stats() const
+{
+    return get_timings().get_connection_stats();
+}
+
+std::size_t connection_timings_accumulator::num_unsealed_shards() const
 {
     std::lock_guard<std::mutex> the_lock {the_mutex_};
-    return connection_stats {stats(tcp_us_acc_),
-                             stats(ws_open_handshake_us_acc_),
-                             stats(ws_close_handshake_us_acc_),
-                             stats(association_ms_acc_),
-                             stats(session_duration_ms_acc_)};
+    return std::count_if(shards_.begin(), shards_.end(),
+                         [](const std::shared_ptr<connection_timings_shard>& s_p) {
+                             return !s_p->is_sealed();
+                         });
 }
 
 }  // namespace pcp_test
@@ -0,0 +1,226 @@
+#include <pcp-test/correlation_table.hpp>
+
+#include <algorithm>
+#include <functional>  // std::hash
+
+namespace pcp_test {
+
+correlation_counters::correlation_counters()
+        : matched    {0},
+          expired    {0},
+          late       {0},
+          duplicates {0},
+          unknown    {0}
+{
+}
+
+correlation_table::correlation_table(std::size_t capacity,
+                                     std::chrono::milliseconds timeout,
+                                     unsigned int num_shards)
+        : capacity_ {capacity},
+          timeout_ {timeout},
+          closed_capacity_per_shard_ {capacity / std::max(1u, num_shards) + 1},
+          size_ {0},
+          shards_ {}
+{
+    for (unsigned int idx = 0; idx < std::max(1u, num_shards); idx++)
+        shards_.push_back(std::unique_ptr<shard>(new shard()));
+}
+
+bool correlation_table::insert(const std::string& transaction,
+                               clock_type::time_point sent)
+{
+    return insert(transaction, sent, sent);
+}
+
+bool correlation_table::insert(const std::string& transaction,
+                               clock_type::time_point sent,
+                               clock_type::time_point intended)
+{
+    if (size_.fetch_add(1) >= capacity_) {
+        size_--;
+        return false;
+    }
+
+    auto& s = get_shard(transaction);
+    std::lock_guard<std::mutex> the_lock {s.mtx};
+
+    if (!s.in_flight.emplace(transaction, send_times {sent, intended}).second) {
+        size_--;
+        return false;
+    }
+
+    s.closed.erase(transaction);
+    s.expiry_queue.emplace_back(sent, transaction);
+    return true;
+}
+
+void correlation_table::cancel(const std::string& transaction)
+{
+    auto& s = get_shard(transaction);
+    std::lock_guard<std::mutex> the_lock {s.mtx};
+
+    if (s.in_flight.erase(transaction))
+        size_--;
+}
+
+correlation_table::match_outcome
+correlation_table::match(const std::string& transaction,
+                         clock_type::time_point received,
+                         std::chrono::microseconds* rtt_ptr)
+{
+    auto& s = get_shard(transaction);
+    std::lock_guard<std::mutex> the_lock {s.mtx};
+    auto it = s.in_flight.find(transaction);
+
+    if (it == s.in_flight.end()) {
+        auto closed_it = s.closed.find(transaction);
+
+        if (closed_it == s.closed.end()) {
+            s.counters.unknown++;
+            return match_outcome::unknown;
+        }
+
+        if (closed_it->second == closed_state::expired) {
+            s.counters.late++;
+            return match_outcome::late;
+        }
+
+        s.counters.duplicates++;
+        return match_outcome::duplicate;
+    }
+
+    auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+            received - it->second.sent);
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            received - it->second.intended);
+    s.rtt_us.record(static_cast<uint32_t>(
+            std::max<int64_t>(0, std::min<int64_t>(rtt.count(), UINT32_MAX))));
+    s.latency_us.record(static_cast<uint32_t>(
+            std::max<int64_t>(0, std::min<int64_t>(latency.count(), UINT32_MAX))));
+    s.counters.matched++;
+    s.in_flight.erase(it);
+    size_--;
+    close(s, transaction, closed_state::matched);
+
+    if (rtt_ptr)
+        *rtt_ptr = rtt;
+
+    return match_outcome::matched;
+}
+
+std::size_t correlation_table::expire(clock_type::time_point now)
+{
+    std::size_t num_expired {0};
+
+    for (auto& s_ptr : shards_)
+        num_expired += expire_shard(*s_ptr, now - timeout_);
+
+    return num_expired;
+}
+
+std::size_t correlation_table::expire_all()
+{
+    std::size_t num_expired {0};
+
+    for (auto& s_ptr : shards_)
+        num_expired += expire_shard(*s_ptr, clock_type::time_point::max());
+
+    return num_expired;
+}
+
+std::size_t correlation_table::size() const
+{
+    return size_.load();
+}
+
+std::size_t correlation_table::capacity() const
+{
+    return capacity_;
+}
+
+correlation_counters correlation_table::get_counters() const
+{
+    correlation_counters total {};
+
+    for (auto& s_ptr : shards_) {
+        std::lock_guard<std::mutex> the_lock {s_ptr->mtx};
+        total.matched    += s_ptr->counters.matched;
+        total.expired    += s_ptr->counters.expired;
+        total.late       += s_ptr->counters.late;
+        total.duplicates += s_ptr->counters.duplicates;
+        total.unknown    += s_ptr->counters.unknown;
+    }
+
+    return total;
+}
+
+latency_histogram correlation_table::get_rtt_us() const
+{
+    latency_histogram total {};
+
+    for (auto& s_ptr : shards_) {
+        std::lock_guard<std::mutex> the_lock {s_ptr->mtx};
+        total.merge(s_ptr->rtt_us);
+    }
+
+    return total;
+}
+
+latency_histogram correlation_table::get_latency_us() const
+{
+    latency_histogram total {};
+
+    for (auto& s_ptr : shards_) {
+        std::lock_guard<std::mutex> the_lock {s_ptr->mtx};
+        total.merge(s_ptr->latency_us);
+    }
+
+    return total;
+}
+
+// Private
+
+correlation_table::shard& correlation_table::get_shard(const std::string& transaction)
+{
+    return *shards_[std::hash<std::string>{}(transaction) % shards_.size()];
+}
+
+// Must be called with the shard lock held
+void correlation_table::close(shard& s, std::string transaction, closed_state state)
+{
+    if (s.closed_order.size() >= closed_capacity_per_shard_) {
+        s.closed.erase(s.closed_order.front());
+        s.closed_order.pop_front();
+    }
+
+    s.closed[transaction] = state;
+    s.closed_order.push_back(std::move(transaction));
+}
+
+std::size_t correlation_table::expire_shard(shard& s,
+                                            clock_type::time_point deadline)
+{
+    std::size_t num_expired {0};
+    std::lock_guard<std::mutex> the_lock {s.mtx};
+
+    while (!s.expiry_queue.empty() && s.expiry_queue.front().first < deadline) {
+        auto& entry = s.expiry_queue.front();
+        auto it = s.in_flight.find(entry.second);
+
+        // Skip stale entries (already matched, cancelled, or re-inserted)
+        if (it != s.in_flight.end() && it->second.sent == entry.first) {
+            s.in_flight.erase(it);
+            size_--;
+            s.counters.expired++;
+            num_expired++;
+            close(s, std::move(entry.second), closed_state::expired);
+        }
+
+        s.expiry_queue.pop_front();
+    }
+
+    return num_expired;
+}
+
+}  // namespace pcp_test
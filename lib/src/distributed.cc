@@ -0,0 +1,591 @@
+#include <pcp-test/distributed.hpp>
+#include <pcp-test/test_connection.hpp>
+#include <pcp-test/test_connection_parameters.hpp>
+#include <pcp-test/util.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/write.hpp>
+
+#include <boost/format.hpp>
+
+#include <boost/nowide/iostream.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+namespace lth_jc   = leatherman::json_container;
+namespace conn_par = pcp_test::connection_test_parameters;
+namespace asio     = boost::asio;
+using tcp          = boost::asio::ip::tcp;
+
+static constexpr int DEFAULT_WORKER_PORT {8150};
+// NB: the protocol is not authenticated, so workers are not reachable
+// from other hosts unless explicitly configured
+static const std::string DEFAULT_WORKER_BIND_ADDRESS {"127.0.0.1"};
+
+// Message types and entries
+
+static const std::string TYPE {"type"};
+static const std::string RUN_MESSAGE {"run"};
+static const std::string READY_MESSAGE {"ready"};
+static const std::string START_MESSAGE {"start"};
+static const std::string RESULT_MESSAGE {"result"};
+static const std::string DONE_MESSAGE {"done"};
+static const std::string ERROR_MESSAGE {"error"};
+static const std::string ERROR_DESCRIPTION {"description"};
+
+static lth_jc::JsonContainer make_message(const std::string& type)
+{
+    lth_jc::JsonContainer message {};
+    message.set<std::string>(TYPE, type);
+    return message;
+}
+
+//
+// Results (de)serialization; histograms are exchanged in their
+// serialized form so that they can be merged without loss
+//
+
+static lth_jc::JsonContainer to_json(const connection_timings& t)
+{
+    lth_jc::JsonContainer data {};
+    data.set<std::string>("tcp_us", t.tcp_us.serialize());
+    data.set<std::string>("ws_open_handshake_us", t.ws_open_handshake_us.serialize());
+    data.set<std::string>("ws_close_handshake_us", t.ws_close_handshake_us.serialize());
+    data.set<std::string>("association_ms", t.association_ms.serialize());
+    data.set<std::string>("session_duration_ms", t.session_duration_ms.serialize());
+    data.set<std::string>("connect_ms", t.connect_ms.serialize());
+    return data;
+}
+
+static connection_timings timings_from_json(const lth_jc::JsonContainer& data)
+{
+    connection_timings t {};
+    t.tcp_us = latency_histogram::deserialize(data.get<std::string>("tcp_us"));
+    t.ws_open_handshake_us =
+        latency_histogram::deserialize(data.get<std::string>("ws_open_handshake_us"));
+    t.ws_close_handshake_us =
+        latency_histogram::deserialize(data.get<std::string>("ws_close_handshake_us"));
+    t.association_ms =
+        latency_histogram::deserialize(data.get<std::string>("association_ms"));
+    t.session_duration_ms =
+        latency_histogram::deserialize(data.get<std::string>("session_duration_ms"));
+    t.connect_ms = latency_histogram::deserialize(data.get<std::string>("connect_ms"));
+    return t;
+}
+
+// Counters are sent as JSON numbers, which are exact up to 2^53
+static lth_jc::JsonContainer to_json(const keepalive_stats& k_s)
+{
+    lth_jc::JsonContainer data {};
+    data.set<double>("num_pings", static_cast<double>(k_s.num_pings));
+    data.set<double>("num_not_associated", static_cast<double>(k_s.num_not_associated));
+    data.set<double>("num_failures", static_cast<double>(k_s.num_failures));
+    data.set<double>("num_missed", static_cast<double>(k_s.num_missed));
+    data.set<std::string>("lag_us", k_s.lag_us.serialize());
+    return data;
+}
+
+static keepalive_stats keepalive_from_json(const lth_jc::JsonContainer& data)
+{
+    keepalive_stats k_s {};
+    k_s.num_pings = static_cast<uint64_t>(data.get<double>("num_pings"));
+    k_s.num_not_associated =
+        static_cast<uint64_t>(data.get<double>("num_not_associated"));
+    k_s.num_failures = static_cast<uint64_t>(data.get<double>("num_failures"));
+    k_s.num_missed = static_cast<uint64_t>(data.get<double>("num_missed"));
+    k_s.lag_us = latency_histogram::deserialize(data.get<std::string>("lag_us"));
+    return k_s;
+}
+
+static lth_jc::JsonContainer to_json(const resource_usage& u)
+{
+    lth_jc::JsonContainer data {};
+    data.set<int>("num_samples", static_cast<int>(u.num_samples));
+    data.set<double>("mean_cpu_percent", u.mean_cpu_percent);
+    data.set<double>("max_cpu_percent", u.max_cpu_percent);
+    data.set<double>("max_rss_kb", static_cast<double>(u.max_rss_kb));
+    data.set<int>("max_threads", u.max_threads);
+    data.set<int>("max_fds", u.max_fds);
+    data.set<std::string>("lag_us", u.lag_us.serialize());
+    data.set<bool>("saturated", u.saturated);
+    return data;
+}
+
+static resource_usage resources_from_json(const lth_jc::JsonContainer& data)
+{
+    resource_usage u {};
+    u.num_samples = static_cast<unsigned int>(data.get<int>("num_samples"));
+    u.mean_cpu_percent = data.get<double>("mean_cpu_percent");
+    u.max_cpu_percent = data.get<double>("max_cpu_percent");
+    u.max_rss_kb = static_cast<uint64_t>(data.get<double>("max_rss_kb"));
+    u.max_threads = data.get<int>("max_threads");
+    u.max_fds = data.get<int>("max_fds");
+    u.lag_us = latency_histogram::deserialize(data.get<std::string>("lag_us"));
+    u.saturated = data.get<bool>("saturated");
+    return u;
+}
+
+// Counts and histograms, by phase
+static lth_jc::JsonContainer to_json(const failure_breakdown& b)
+{
+    lth_jc::JsonContainer data {};
+    std::vector<double> counts {};
+    std::vector<std::string> latencies {};
+
+    for (std::size_t idx = 0; idx < NUM_FAILURE_PHASES; idx++) {
+        counts.push_back(static_cast<double>(b.counts[idx]));
+        latencies.push_back(b.latency_ms[idx].serialize());
+    }
+
+    data.set<std::vector<double>>("counts", counts);
+    data.set<std::vector<std::string>>("latency_ms", latencies);
+    return data;
+}
+
+static failure_breakdown failures_from_json(const lth_jc::JsonContainer& data)
+{
+    failure_breakdown b {};
+    auto counts = data.get<std::vector<double>>("counts");
+    auto latencies = data.get<std::vector<std::string>>("latency_ms");
+
+    if (counts.size() != NUM_FAILURE_PHASES || latencies.size() != NUM_FAILURE_PHASES)
+        throw fatal_error {"the results of a worker refer to a different "
+                           "number of failure phases"};
+
+    for (std::size_t idx = 0; idx < NUM_FAILURE_PHASES; idx++) {
+        b.counts[idx] = static_cast<uint64_t>(counts[idx]);
+        b.latency_ms[idx] = latency_histogram::deserialize(latencies[idx]);
+    }
+
+    return b;
+}
+
+static lth_jc::JsonContainer to_json(const connection_test_result& results)
+{
+    auto message = make_message(RESULT_MESSAGE);
+    std::vector<int> broker_attempts {};
+    std::vector<int> broker_failures {};
+
+    for (const auto& b_r : results.brokers) {
+        broker_attempts.push_back(b_r.num_attempts);
+        broker_failures.push_back(b_r.num_failures);
+    }
+
+    message.set<int>("num_attempts", results.num_attempts);
+    message.set<int>("num_failures", results.num_failures);
+    message.set<int>("duration_ms", results.duration_ms);
+    message.set<lth_jc::JsonContainer>("timings", to_json(results.timings));
+    message.set<lth_jc::JsonContainer>("keepalive", to_json(results.keepalive));
+    message.set<int>("teardown_connections", results.teardown.num_connections);
+    message.set<int>("teardown_failures", results.teardown.num_failures);
+    message.set<int>("teardown_duration_ms", results.teardown.duration_ms);
+    message.set<lth_jc::JsonContainer>("resources", to_json(results.resources));
+    message.set<lth_jc::JsonContainer>("failures", to_json(results.failures));
+    message.set<std::vector<int>>("broker_attempts", broker_attempts);
+    message.set<std::vector<int>>("broker_failures", broker_failures);
+    return message;
+}
+
+static connection_test_result result_from_json(const lth_jc::JsonContainer& message,
+                                               const connection_test_run& run,
+                                               const std::vector<std::string>& broker_ws_uris)
+{
+    connection_test_result results {run};
+
+    try {
+        results.num_attempts = message.get<int>("num_attempts");
+        results.num_failures = message.get<int>("num_failures");
+        results.duration_ms  = message.get<int>("duration_ms");
+        results.timings = timings_from_json(message.get<lth_jc::JsonContainer>("timings"));
+        results.keepalive =
+            keepalive_from_json(message.get<lth_jc::JsonContainer>("keepalive"));
+        results.teardown.num_connections = message.get<int>("teardown_connections");
+        results.teardown.num_failures = message.get<int>("teardown_failures");
+        results.teardown.duration_ms = message.get<int>("teardown_duration_ms");
+        results.resources =
+            resources_from_json(message.get<lth_jc::JsonContainer>("resources"));
+        results.failures =
+            failures_from_json(message.get<lth_jc::JsonContainer>("failures"));
+
+        auto broker_attempts = message.get<std::vector<int>>("broker_attempts");
+        auto broker_failures = message.get<std::vector<int>>("broker_failures");
+
+        // Workers are expected to use the same configuration
+        if (broker_attempts.size() != broker_ws_uris.size()
+                || broker_failures.size() != broker_ws_uris.size())
+            throw fatal_error {"the results of a worker refer to a different "
+                               "number of brokers"};
+
+        for (std::size_t idx = 0; idx < broker_ws_uris.size(); idx++)
+            results.brokers.push_back(broker_result {broker_ws_uris[idx],
+                                                     broker_attempts[idx],
+                                                     broker_failures[idx]});
+    } catch (const lth_jc::data_error& e) {
+        throw fatal_error {(boost::format("invalid results received from a "
+                                          "worker: %1%") % e.what()).str()};
+    }
+
+    results.conn_stats = results.timings.get_connection_stats();
+    return results;
+}
+
+//
+// split_run
+//
+
+std::vector<worker_assignment> split_run(int num_endpoints,
+                                         int concurrency,
+                                         int connection_rate,
+                                         std::size_t num_workers)
+{
+    std::vector<worker_assignment> assignments {};
+    auto n_w = static_cast<int>(num_workers);
+    int num_previous_sets {0};
+
+    for (auto idx = 0; idx < n_w; idx++) {
+        auto num_sets = concurrency / n_w + (idx < concurrency % n_w ? 1 : 0);
+
+        // Rounding the cumulative rate keeps the total unchanged
+        auto rate = 0;
+
+        if (num_sets > 0 && connection_rate > 0) {
+            auto cumulative_rate = [connection_rate, concurrency](int n) {
+                return static_cast<int>(
+                    static_cast<int64_t>(connection_rate) * n / concurrency);
+            };
+            rate = std::max(1, cumulative_rate(num_previous_sets + num_sets)
+                               - cumulative_rate(num_previous_sets));
+        }
+
+        assignments.push_back(worker_assignment {
+            num_sets,
+            rate,
+            static_cast<std::size_t>(num_previous_sets * num_endpoints)});
+        num_previous_sets += num_sets;
+    }
+
+    return assignments;
+}
+
+//
+// worker_link
+//
+
+worker_link::worker_link(asio::io_service& io_service, const std::string& address)
+    : socket_ {io_service},
+      buffer_ {},
+      peer_ {address}
+{
+    auto separator_pos = address.rfind(':');
+
+    if (separator_pos == std::string::npos)
+        throw fatal_error {(boost::format("invalid worker address (%1%)")
+                            % address).str()};
+
+    boost::system::error_code ec {};
+    tcp::resolver resolver {io_service};
+    tcp::resolver::query query {address.substr(0, separator_pos),
+                                address.substr(separator_pos + 1)};
+    auto endpoint_it = resolver.resolve(query, ec);
+
+    if (!ec)
+        asio::connect(socket_, endpoint_it, ec);
+
+    if (ec)
+        throw fatal_error {(boost::format("failed to connect to worker %1%: %2%")
+                            % address % ec.message()).str()};
+
+    socket_.set_option(tcp::no_delay(true));
+}
+
+worker_link::worker_link(asio::io_service& io_service, tcp::acceptor& acceptor)
+    : socket_ {io_service},
+      buffer_ {},
+      peer_ {}
+{
+    boost::system::error_code ec {};
+    acceptor.accept(socket_, ec);
+
+    if (ec)
+        throw fatal_error {(boost::format("failed to accept a coordinator "
+                                          "connection: %1%") % ec.message()).str()};
+
+    auto remote = socket_.remote_endpoint(ec);
+    peer_ = ec
+            ? std::string {"unknown coordinator"}
+            : remote.address().to_string() + ":" + std::to_string(remote.port());
+    socket_.set_option(tcp::no_delay(true));
+}
+
+void worker_link::send(const lth_jc::JsonContainer& message)
+{
+    boost::system::error_code ec {};
+    auto data = message.toString() + "\n";
+    asio::write(socket_, asio::buffer(data), ec);
+
+    if (ec)
+        throw fatal_error {(boost::format("failed to send a message to %1%: %2%")
+                            % peer_ % ec.message()).str()};
+}
+
+lth_jc::JsonContainer worker_link::receive()
+{
+    boost::system::error_code ec {};
+    asio::read_until(socket_, buffer_, '\n', ec);
+
+    if (ec)
+        throw fatal_error {(boost::format("lost the connection with %1%: %2%")
+                            % peer_ % ec.message()).str()};
+
+    std::istream in_stream {&buffer_};
+    std::string line {};
+    std::getline(in_stream, line);
+
+    try {
+        lth_jc::JsonContainer message {line};
+
+        if (!message.includes(TYPE))
+            throw fatal_error {(boost::format("received a message without type "
+                                              "from %1%") % peer_).str()};
+
+        return message;
+    } catch (const lth_jc::data_error& e) {
+        throw fatal_error {(boost::format("received an invalid message from "
+                                          "%1%: %2%") % peer_ % e.what()).str()};
+    }
+}
+
+lth_jc::JsonContainer worker_link::receive(const std::string& type)
+{
+    auto message = receive();
+    auto message_type = message.get<std::string>(TYPE);
+
+    if (message_type == ERROR_MESSAGE)
+        throw fatal_error {(boost::format("%1% failed: %2%")
+                            % peer_
+                            % message.get<std::string>(ERROR_DESCRIPTION)).str()};
+
+    if (message_type != type)
+        throw fatal_error {(boost::format("expected a %1% message from %2%, "
+                                          "got %3%")
+                            % type % peer_ % message_type).str()};
+
+    return message;
+}
+
+const std::string& worker_link::peer() const
+{
+    return peer_;
+}
+
+//
+// worker_coordinator
+//
+
+worker_coordinator::worker_coordinator(const std::vector<std::string>& addresses,
+                                       std::vector<std::string> broker_ws_uris)
+    : broker_ws_uris_ {std::move(broker_ws_uris)},
+      io_service_ {},
+      links_ {}
+{
+    for (const auto& address : addresses) {
+        links_.push_back(std::unique_ptr<worker_link>(
+            new worker_link(io_service_, address)));
+        LOG_INFO("Connected to worker %1%", address);
+    }
+}
+
+worker_coordinator::~worker_coordinator()
+{
+    for (auto& link_ptr : links_) {
+        try {
+            link_ptr->send(make_message(DONE_MESSAGE));
+        } catch (const fatal_error& e) {
+            LOG_WARNING("Failed to stop worker %1%: %2%", link_ptr->peer(), e.what());
+        }
+    }
+}
+
+std::size_t worker_coordinator::num_workers() const
+{
+    return links_.size();
+}
+
+connection_test_result worker_coordinator::perform_run(const connection_test_run& run)
+{
+    auto assignments = split_run(run.num_endpoints,
+                                 run.concurrency,
+                                 run.connection_rate,
+                                 links_.size());
+    std::vector<worker_link*> active_links {};
+
+    // Assign the shares; workers reply once their clients are built
+
+    for (std::size_t idx = 0; idx < links_.size(); idx++) {
+        const auto& a = assignments[idx];
+
+        if (a.concurrency == 0)
+            continue;
+
+        auto message = make_message(RUN_MESSAGE);
+        message.set<int>("idx", run.idx);
+        message.set<int>("num_endpoints", run.num_endpoints);
+        message.set<int>("concurrency", a.concurrency);
+        message.set<int>("connection_rate", a.connection_rate);
+        // Distinct pauses for each worker; NB: unsigned, so that the
+        // arithmetic wraps around instead of overflowing
+        auto rng_seed = static_cast<uint32_t>(run.rng_seed)
+                        * static_cast<uint32_t>(links_.size())
+                        + static_cast<uint32_t>(idx);
+        message.set<int>("rng_seed", static_cast<int>(rng_seed));
+        message.set<int>("first_name_idx", static_cast<int>(a.first_name_idx));
+        links_[idx]->send(message);
+        active_links.push_back(links_[idx].get());
+    }
+
+    for (auto link_ptr : active_links)
+        link_ptr->receive(READY_MESSAGE);
+
+    // Start in lockstep and merge the results
+
+    connection_test_result results {run};
+    results.num_attempts = 0;
+    results.start = std::chrono::high_resolution_clock::now();
+
+    for (auto link_ptr : active_links)
+        link_ptr->send(make_message(START_MESSAGE));
+
+    LOG_INFO("Run #%1% - started %2% workers", run.idx, active_links.size());
+
+    for (auto link_ptr : active_links) {
+        auto worker_results = result_from_json(link_ptr->receive(RESULT_MESSAGE),
+                                               run,
+                                               broker_ws_uris_);
+        results.merge(worker_results);
+    }
+
+    // The time to establish all connections is the one of the slowest worker
+    auto duration_ms = results.duration_ms;
+    results.set_completion();
+    results.duration_ms = duration_ms;
+
+    return results;
+}
+
+//
+// run_worker
+//
+
+// Perform the runs assigned by a coordinator, until it's done
+static void serve_coordinator(const application_options& a_o, worker_link& link)
+{
+    connection_test test {a_o};
+
+    while (true) {
+        auto message = link.receive();
+        auto type = message.get<std::string>(TYPE);
+
+        if (type == DONE_MESSAGE)
+            return;
+
+        if (type != RUN_MESSAGE)
+            throw fatal_error {(boost::format("unexpected %1% message from the "
+                                              "coordinator") % type).str()};
+
+        connection_test_run run {a_o};
+        run.idx             = message.get<int>("idx");
+        run.num_endpoints   = message.get<int>("num_endpoints");
+        run.concurrency     = message.get<int>("concurrency");
+        run.connection_rate = message.get<int>("connection_rate");
+        run.rng_seed        = message.get<int>("rng_seed");
+        run.total_endpoint_timeout_ms = run.endpoint_timeout_ms() * run.num_endpoints;
+        auto first_name_idx =
+            static_cast<std::size_t>(message.get<int>("first_name_idx"));
+
+        try {
+            auto results = test.perform_run(
+                run,
+                first_name_idx,
+                [&link]()
+                {
+                    link.send(make_message(READY_MESSAGE));
+                    link.receive(START_MESSAGE);
+                });
+            link.send(to_json(results));
+        } catch (const std::exception& e) {
+            // Let the coordinator know, if still connected
+            auto error_message = make_message(ERROR_MESSAGE);
+            error_message.set<std::string>(ERROR_DESCRIPTION, e.what());
+
+            try {
+                link.send(error_message);
+            } catch (const fatal_error&) {
+            }
+
+            throw;
+        }
+    }
+}
+
+void run_worker(const application_options& a_o)
+{
+    const auto& p = a_o.connection_test_parameters;
+    auto port = p.includes(conn_par::WORKER_PORT)
+                ? p.get<int>(conn_par::WORKER_PORT)
+                : DEFAULT_WORKER_PORT;
+    auto bind_address = p.includes(conn_par::WORKER_BIND_ADDRESS)
+                        ? p.get<std::string>(conn_par::WORKER_BIND_ADDRESS)
+                        : DEFAULT_WORKER_BIND_ADDRESS;
+    asio::io_service io_service {};
+    tcp::acceptor acceptor {io_service};
+    boost::system::error_code ec {};
+    auto address = asio::ip::address::from_string(bind_address, ec);
+    tcp::endpoint endpoint {address, static_cast<unsigned short>(port)};
+
+    if (!ec)
+        acceptor.open(endpoint.protocol(), ec);
+
+    if (!ec)
+        acceptor.set_option(tcp::acceptor::reuse_address(true), ec);
+
+    if (!ec)
+        acceptor.bind(endpoint, ec);
+
+    if (!ec)
+        acceptor.listen(asio::socket_base::max_connections, ec);
+
+    if (ec)
+        throw fatal_error {(boost::format("failed to listen on %1%:%2%: %3%")
+                            % bind_address % port % ec.message()).str()};
+
+    boost::nowide::cout << "\nWorker listening on " << bind_address << ":" << port
+                        << std::endl;
+
+    while (true) {
+        worker_link link {io_service, acceptor};
+        boost::nowide::cout << "Coordinator " << link.peer() << " connected"
+                            << std::endl;
+
+        try {
+            serve_coordinator(a_o, link);
+            boost::nowide::cout << "Coordinator " << link.peer() << " is done\n"
+                                << std::endl;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Session with coordinator %1% aborted: %2%", link.peer(), e.what());
+            boost::nowide::cout << util::red("   [ERROR]   ")
+                                << "session with coordinator " << link.peer()
+                                << " aborted: " << e.what() << "\n" << std::endl;
+        }
+    }
+}
+
+}  // namespace pcp_test
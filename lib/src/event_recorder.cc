@@ -0,0 +1,213 @@
+#include <pcp-test/event_recorder.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace pcp_test {
+
+//
+// encoding
+//
+
+static void encode(uint64_t value, std::size_t num_bytes, char* out)
+{
+    for (std::size_t idx = 0; idx < num_bytes; idx++)
+        out[idx] = static_cast<char>((value >> (8 * idx)) & 0xff);
+}
+
+static uint64_t decode(const char* in, std::size_t num_bytes)
+{
+    uint64_t value {0};
+
+    for (std::size_t idx = 0; idx < num_bytes; idx++)
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[idx])) << (8 * idx);
+
+    return value;
+}
+
+static void encode(const connection_event& event, char* out)
+{
+    encode(event.timestamp_us, 8, out);
+    encode(event.endpoint_id, 4, out + 8);
+    encode(event.duration_us, 4, out + 12);
+    encode(event.run_idx, 2, out + 16);
+    encode(static_cast<uint8_t>(event.phase), 1, out + 18);
+    encode(static_cast<uint8_t>(event.outcome), 1, out + 19);
+}
+
+//
+// event_recorder
+//
+
+constexpr std::size_t event_recorder::DEFAULT_CAPACITY;
+constexpr std::size_t event_recorder::RECORD_SIZE;
+const std::string event_recorder::FILE_MAGIC {"PCPTEVT1"};
+
+// Events are written in batches of up to this size
+static constexpr std::size_t WRITE_BATCH_SIZE {4096};
+
+// Pause of the writer once the ring is drained
+static constexpr std::chrono::milliseconds WRITER_PAUSE {1};
+
+event_recorder::event_recorder(const std::string& file_path, std::size_t capacity)
+        : ring_ {capacity},
+          file_stream_ {file_path, std::ios::binary},
+          run_idx_ {0},
+          num_dropped_ {0},
+          stopping_ {false},
+          writer_thread_ {}
+{
+    if (!file_stream_.is_open())
+        throw fatal_error {(boost::format("failed to open %1%") % file_path).str()};
+
+    file_stream_.write(FILE_MAGIC.data(), FILE_MAGIC.size());
+    writer_thread_ = std::thread(&event_recorder::write_events, this);
+}
+
+event_recorder::~event_recorder()
+{
+    stopping_ = true;
+
+    if (writer_thread_.joinable())
+        writer_thread_.join();
+
+    if (num_dropped_.load())
+        LOG_WARNING("%1% connection events were dropped, as the recorder "
+                    "could not keep up", num_dropped_.load());
+}
+
+void event_recorder::set_run(int run_idx)
+{
+    run_idx_ = run_idx;
+}
+
+void event_recorder::record(uint32_t endpoint_id,
+                            connection_phase phase,
+                            event_outcome outcome,
+                            std::chrono::microseconds duration)
+{
+    connection_event event {
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()),
+        endpoint_id,
+        static_cast<uint32_t>(std::max<int64_t>(
+            0, std::min<int64_t>(duration.count(), UINT32_MAX))),
+        static_cast<uint16_t>(run_idx_.load(std::memory_order_relaxed)),
+        phase,
+        outcome};
+
+    if (!ring_.try_push(event))
+        num_dropped_++;
+}
+
+uint64_t event_recorder::num_dropped() const
+{
+    return num_dropped_.load();
+}
+
+// Private
+
+void event_recorder::write_events()
+{
+    std::vector<char> batch(WRITE_BATCH_SIZE * RECORD_SIZE);
+    connection_event event {};
+
+    while (true) {
+        // Check before draining, so that no event is left behind
+        auto stopping = stopping_.load();
+        std::size_t num_events {0};
+
+        while (num_events < WRITE_BATCH_SIZE && ring_.try_pop(event))
+            encode(event, &batch[RECORD_SIZE * num_events++]);
+
+        if (num_events) {
+            file_stream_.write(batch.data(), RECORD_SIZE * num_events);
+            continue;
+        }
+
+        if (stopping)
+            break;
+
+        std::this_thread::sleep_for(WRITER_PAUSE);
+    }
+
+    file_stream_.flush();
+
+    if (!file_stream_)
+        LOG_ERROR("Failed to write the connection events file");
+}
+
+//
+// reading
+//
+
+void read_events_header(std::istream& in_stream)
+{
+    std::string magic(event_recorder::FILE_MAGIC.size(), '\0');
+
+    if (!in_stream.read(&magic[0], magic.size()) || magic != event_recorder::FILE_MAGIC)
+        throw fatal_error {"not a connection events file"};
+}
+
+bool read_event(std::istream& in_stream, connection_event& event)
+{
+    char record[event_recorder::RECORD_SIZE];
+    in_stream.read(record, event_recorder::RECORD_SIZE);
+
+    if (in_stream.gcount() == 0)
+        return false;
+
+    if (static_cast<std::size_t>(in_stream.gcount()) != event_recorder::RECORD_SIZE)
+        throw fatal_error {"truncated connection event record"};
+
+    event.timestamp_us = decode(record, 8);
+    event.endpoint_id  = static_cast<uint32_t>(decode(record + 8, 4));
+    event.duration_us  = static_cast<uint32_t>(decode(record + 12, 4));
+    event.run_idx      = static_cast<uint16_t>(decode(record + 16, 2));
+    event.phase        = static_cast<connection_phase>(decode(record + 18, 1));
+    event.outcome      = static_cast<event_outcome>(decode(record + 19, 1));
+    return true;
+}
+
+static const char* to_string(connection_phase phase)
+{
+    switch (phase) {
+        case connection_phase::tcp:
+            return "tcp";
+        case connection_phase::ws_open_handshake:
+            return "ws_open_handshake";
+        case connection_phase::association:
+            return "association";
+        case connection_phase::ws_close_handshake:
+            return "ws_close_handshake";
+    }
+
+    return "unknown";
+}
+
+uint64_t convert_events_to_csv(std::istream& in_stream, std::ostream& out_stream)
+{
+    read_events_header(in_stream);
+    connection_event event {};
+    uint64_t num_events {0};
+
+    while (read_event(in_stream, event)) {
+        out_stream << event.timestamp_us << ","
+                   << event.endpoint_id << ","
+                   << event.duration_us << ","
+                   << event.run_idx << ","
+                   << to_string(event.phase) << ","
+                   << (event.outcome == event_outcome::success ? "success" : "failure")
+                   << "\n";
+        num_events++;
+    }
+
+    return num_events;
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,160 @@
+#include <pcp-test/failure_stats.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <algorithm>
+
+namespace pcp_test {
+
+const std::string& failure_phase_name(failure_phase phase)
+{
+    static const std::array<std::string, NUM_FAILURE_PHASES> names {{
+        "TCP refused",
+        "TCP timeout",
+        "TLS",
+        "WebSocket upgrade",
+        "Association timeout",
+        "Association rejected",
+        "dropped after Association",
+        "Task timeout",
+        "other"}};
+
+    return names[static_cast<std::size_t>(phase)];
+}
+
+failure_phase classify_connect_error(const std::string& error,
+                                     std::chrono::microseconds tcp_interval,
+                                     std::chrono::microseconds ws_open_interval,
+                                     std::chrono::milliseconds duration,
+                                     std::chrono::milliseconds timeout)
+{
+    using boost::algorithm::icontains;
+
+    if (icontains(error, "refused"))
+        return failure_phase::tcp_refused;
+
+    if (icontains(error, "ssl") || icontains(error, "tls")
+            || icontains(error, "certificate"))
+        return failure_phase::tls;
+
+    if (icontains(error, "upgrade") || icontains(error, "http"))
+        return failure_phase::ws_upgrade;
+
+    if (tcp_interval.count() > 0)
+        return ws_open_interval.count() > 0 ? failure_phase::other
+                                            : failure_phase::ws_upgrade;
+
+    if (duration >= timeout || icontains(error, "timed out")
+            || icontains(error, "timeout"))
+        return failure_phase::tcp_timeout;
+
+    return failure_phase::tcp_refused;
+}
+
+//
+// failure_breakdown
+//
+
+failure_breakdown::failure_breakdown()
+        : counts {},
+          latency_ms {}
+{
+}
+
+void failure_breakdown::record(failure_phase phase, uint32_t latency)
+{
+    auto idx = static_cast<std::size_t>(phase);
+    counts[idx]++;
+    latency_ms[idx].record(latency);
+}
+
+void failure_breakdown::add(failure_phase phase, uint64_t count)
+{
+    counts[static_cast<std::size_t>(phase)] += count;
+}
+
+void failure_breakdown::merge(const failure_breakdown& other)
+{
+    for (std::size_t idx = 0; idx < NUM_FAILURE_PHASES; idx++) {
+        counts[idx] += other.counts[idx];
+        latency_ms[idx].merge(other.latency_ms[idx]);
+    }
+}
+
+uint64_t failure_breakdown::count(failure_phase phase) const
+{
+    return counts[static_cast<std::size_t>(phase)];
+}
+
+uint64_t failure_breakdown::total() const
+{
+    uint64_t n {0};
+
+    for (auto c : counts)
+        n += c;
+
+    return n;
+}
+
+std::ostream& operator<< (std::ostream& out, const failure_breakdown& b)
+{
+    if (!b.total())
+        return out;
+
+    out << "  Failures by phase:\n";
+
+    for (std::size_t idx = 0; idx < NUM_FAILURE_PHASES; idx++) {
+        if (!b.counts[idx])
+            continue;
+
+        out << "    " << failure_phase_name(static_cast<failure_phase>(idx))
+            << ": " << b.counts[idx];
+
+        if (b.latency_ms[idx].count())
+            out << " (after p50 " << b.latency_ms[idx].percentile(50)
+                << " ms, p99 " << b.latency_ms[idx].percentile(99) << " ms)";
+
+        out << "\n";
+    }
+
+    return out;
+}
+
+std::ofstream & operator<< (boost::nowide::ofstream& out, const failure_breakdown& b)
+{
+    for (std::size_t idx = 0; idx < NUM_FAILURE_PHASES; idx++) {
+        if (idx)
+            out << ",";
+
+        out << b.counts[idx] << ","
+            << b.latency_ms[idx].percentile(50) << ","
+            << b.latency_ms[idx].percentile(99);
+    }
+
+    return out;
+}
+
+//
+// failure_recorder
+//
+
+failure_recorder::failure_recorder()
+        : mtx_ {},
+          breakdown_ {}
+{
+}
+
+void failure_recorder::record(failure_phase phase, std::chrono::milliseconds latency)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    breakdown_.record(phase, static_cast<uint32_t>(
+        std::max<int64_t>(0, std::min<int64_t>(latency.count(), UINT32_MAX))));
+}
+
+failure_breakdown failure_recorder::get_breakdown() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return breakdown_;
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,229 @@
+#include <pcp-test/histogram.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace pcp_test {
+
+static constexpr uint32_t SUB_BUCKET_COUNT {1u << latency_histogram::SUB_BUCKET_BITS};
+static constexpr uint32_t SUB_BUCKET_HALF_COUNT {SUB_BUCKET_COUNT >> 1};
+
+constexpr unsigned int latency_histogram::SUB_BUCKET_BITS;
+constexpr std::size_t latency_histogram::NUM_BUCKETS;
+
+static unsigned int most_significant_bit(uint32_t value)
+{
+    unsigned int msb {0};
+
+    while (value >>= 1)
+        msb++;
+
+    return msb;
+}
+
+latency_histogram::latency_histogram()
+    : counts_ {},
+      count_ {0},
+      min_ {std::numeric_limits<uint32_t>::max()},
+      max_ {0},
+      mean_ {0.0},
+      m2_ {0.0}
+{
+    counts_.fill(0);
+}
+
+std::size_t latency_histogram::bucket_index(uint32_t value)
+{
+    if (value < SUB_BUCKET_COUNT)
+        return value;
+
+    // The value of the top SUB_BUCKET_BITS bits, within
+    // [SUB_BUCKET_HALF_COUNT, SUB_BUCKET_COUNT), gives the sub-bucket
+    auto shift = most_significant_bit(value) - SUB_BUCKET_BITS + 1;
+    return shift * SUB_BUCKET_HALF_COUNT + (value >> shift);
+}
+
+uint32_t latency_histogram::bucket_lowest_value(std::size_t idx)
+{
+    assert(idx < NUM_BUCKETS);
+
+    if (idx < SUB_BUCKET_COUNT)
+        return static_cast<uint32_t>(idx);
+
+    auto shift = static_cast<unsigned int>(idx / SUB_BUCKET_HALF_COUNT) - 1;
+    auto sub_bucket = static_cast<uint32_t>(idx - shift * SUB_BUCKET_HALF_COUNT);
+    return sub_bucket << shift;
+}
+
+uint32_t latency_histogram::bucket_highest_value(std::size_t idx)
+{
+    if (idx < SUB_BUCKET_COUNT)
+        return static_cast<uint32_t>(idx);
+
+    auto shift = static_cast<unsigned int>(idx / SUB_BUCKET_HALF_COUNT) - 1;
+    return bucket_lowest_value(idx) + ((1u << shift) - 1);
+}
+
+uint64_t latency_histogram::bucket_count(std::size_t idx) const
+{
+    return counts_[idx];
+}
+
+void latency_histogram::record(uint32_t value)
+{
+    record(value, 1);
+}
+
+void latency_histogram::record(uint32_t value, uint64_t count)
+{
+    if (count == 0)
+        return;
+
+    counts_[bucket_index(value)] += count;
+
+    // Chan's update, treating the samples as a group with null variance
+    auto new_count = count_ + count;
+    double delta = value - mean_;
+    mean_ += delta * count / new_count;
+    m2_   += delta * delta * (static_cast<double>(count_) * count / new_count);
+    count_ = new_count;
+
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void latency_histogram::record_corrected(uint32_t value, uint32_t expected_interval)
+{
+    record(value);
+
+    if (expected_interval == 0)
+        return;
+
+    for (auto missing = static_cast<int64_t>(value) - expected_interval;
+         missing >= expected_interval;
+         missing -= expected_interval)
+        record(static_cast<uint32_t>(missing));
+}
+
+void latency_histogram::merge(const latency_histogram& other)
+{
+    if (other.count_ == 0)
+        return;
+
+    for (std::size_t idx = 0; idx < NUM_BUCKETS; idx++)
+        counts_[idx] += other.counts_[idx];
+
+    auto new_count = count_ + other.count_;
+    double delta = other.mean_ - mean_;
+    mean_ += delta * other.count_ / new_count;
+    m2_   += other.m2_
+             + delta * delta * (static_cast<double>(count_) * other.count_ / new_count);
+    count_ = new_count;
+
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void latency_histogram::reset()
+{
+    *this = latency_histogram();
+}
+
+uint64_t latency_histogram::count() const
+{
+    return count_;
+}
+
+uint32_t latency_histogram::min() const
+{
+    return count_ ? min_ : 0;
+}
+
+uint32_t latency_histogram::max() const
+{
+    return max_;
+}
+
+double latency_histogram::mean() const
+{
+    return mean_;
+}
+
+double latency_histogram::variance() const
+{
+    // Population variance, as in boost::accumulators
+    return count_ ? m2_ / count_ : 0.0;
+}
+
+uint32_t latency_histogram::percentile(double percentage) const
+{
+    if (count_ == 0)
+        return 0;
+
+    percentage = std::min(std::max(percentage, 0.0), 100.0);
+    auto target = static_cast<uint64_t>(std::ceil(percentage / 100 * count_));
+
+    if (target == 0)
+        return min_;
+
+    uint64_t cumulative {0};
+
+    for (std::size_t idx = 0; idx < NUM_BUCKETS; idx++) {
+        cumulative += counts_[idx];
+
+        if (cumulative >= target)
+            return std::max(min_, std::min(max_, bucket_highest_value(idx)));
+    }
+
+    return max_;
+}
+
+// Format: "<count> <min> <max> <mean> <m2>" followed by an
+// " <bucket index>:<bucket count>" entry for each non-empty bucket;
+// 17 significant digits are enough to restore any double exactly
+std::string latency_histogram::serialize() const
+{
+    std::ostringstream out {};
+    out << std::setprecision(17)
+        << count_ << " " << min_ << " " << max_ << " " << mean_ << " " << m2_;
+
+    for (std::size_t idx = 0; idx < NUM_BUCKETS; idx++)
+        if (counts_[idx])
+            out << " " << idx << ":" << counts_[idx];
+
+    return out.str();
+}
+
+latency_histogram latency_histogram::deserialize(const std::string& s)
+{
+    latency_histogram h {};
+    std::istringstream in {s};
+
+    if (!(in >> h.count_ >> h.min_ >> h.max_ >> h.mean_ >> h.m2_))
+        throw fatal_error {"invalid serialized histogram"};
+
+    uint64_t tot_count {0};
+    std::size_t idx;
+    char separator;
+    uint64_t count;
+
+    while (in >> idx >> separator >> count) {
+        if (idx >= NUM_BUCKETS || separator != ':')
+            throw fatal_error {"invalid serialized histogram bucket"};
+
+        h.counts_[idx] = count;
+        tot_count += count;
+    }
+
+    if (!in.eof() || tot_count != h.count_)
+        throw fatal_error {"inconsistent serialized histogram"};
+
+    return h;
+}
+
+}  // namespace pcp_test
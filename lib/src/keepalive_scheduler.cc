@@ -0,0 +1,167 @@
+#include <pcp-test/keepalive_scheduler.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <algorithm>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+//
+// keepalive_stats
+//
+
+keepalive_stats::keepalive_stats()
+        : num_pings          {0},
+          num_not_associated {0},
+          num_failures       {0},
+          num_missed         {0},
+          lag_us             {}
+{
+}
+
+void keepalive_stats::merge(const keepalive_stats& other)
+{
+    num_pings          += other.num_pings;
+    num_not_associated += other.num_not_associated;
+    num_failures       += other.num_failures;
+    num_missed         += other.num_missed;
+    lag_us.merge(other.lag_us);
+}
+
+std::ostream& operator<<(std::ostream& out, const keepalive_stats& k_s)
+{
+    out << "  Keep Alive: ......... " << k_s.num_pings << " pings, "
+        << k_s.num_missed << " missed, "
+        << k_s.num_failures << " failed, "
+        << k_s.num_not_associated << " skipped (not associated)\n"
+        << "                        lag p50 "
+        << static_cast<float>(k_s.lag_us.percentile(50)) / 1000 << " ms, p99 "
+        << static_cast<float>(k_s.lag_us.percentile(99)) / 1000 << " ms, max "
+        << static_cast<float>(k_s.lag_us.max()) / 1000 << " ms\n";
+
+    return out;
+}
+
+//
+// keepalive_scheduler
+//
+
+keepalive_scheduler::keepalive_scheduler(std::chrono::milliseconds period,
+                                         unsigned int num_threads)
+        : period_ {std::max(std::chrono::microseconds(1),
+                            std::chrono::microseconds(period))},
+          stopping_ {false},
+          num_connections_ {0},
+          shards_ {},
+          scheduler_ {std::max(1u, num_threads)}
+{
+    for (unsigned int idx = 0; idx < scheduler_.num_threads(); idx++)
+        shards_.push_back(std::unique_ptr<shard>(new shard()));
+}
+
+keepalive_scheduler::~keepalive_scheduler()
+{
+    stop();
+}
+
+void keepalive_scheduler::add(std::vector<ping_type> pings)
+{
+    if (stopping_ || pings.empty())
+        return;
+
+    auto now = clock_type::now();
+    auto num_pings = static_cast<int64_t>(pings.size());
+
+    for (int64_t idx = 0; idx < num_pings; idx++) {
+        auto offset = std::chrono::microseconds(period_.count() * (idx + 1) / num_pings);
+        schedule_ping(std::make_shared<ping_type>(std::move(pings[idx])),
+                      now + offset);
+    }
+
+    num_connections_ += pings.size();
+}
+
+void keepalive_scheduler::stop()
+{
+    stopping_ = true;
+}
+
+std::size_t keepalive_scheduler::num_connections() const
+{
+    return num_connections_.load();
+}
+
+keepalive_stats keepalive_scheduler::get_stats() const
+{
+    keepalive_stats total {};
+
+    for (auto& s_ptr : shards_) {
+        std::lock_guard<std::mutex> the_lock {s_ptr->mtx};
+        total.merge(s_ptr->stats);
+    }
+
+    return total;
+}
+
+// Private
+
+void keepalive_scheduler::schedule_ping(std::shared_ptr<ping_type> ping_ptr,
+                                        clock_type::time_point slot)
+{
+    scheduler_.schedule_at(slot,
+                           [this, ping_ptr, slot]() { ping(ping_ptr, slot); });
+}
+
+// Executed by a worker of the scheduler
+void keepalive_scheduler::ping(std::shared_ptr<ping_type> ping_ptr,
+                               clock_type::time_point slot)
+{
+    if (stopping_)
+        return;
+
+    auto now = clock_type::now();
+    auto lag = std::chrono::duration_cast<std::chrono::microseconds>(now - slot);
+    bool pinged {false};
+    bool associated {true};
+
+    try {
+        associated = (*ping_ptr)();
+        pinged = associated;
+    } catch (const std::exception& e) {
+        LOG_DEBUG("Keep Alive: failed to ping (%1%)", e.what());
+    }
+
+    // Skip the slots that have already elapsed
+    auto next_slot = slot + period_;
+    uint64_t num_missed {0};
+
+    if (next_slot <= now) {
+        auto num_elapsed = (now - next_slot) / period_ + 1;
+        num_missed = static_cast<uint64_t>(num_elapsed);
+        next_slot += num_elapsed * period_;
+    }
+
+    auto s_idx = static_cast<std::size_t>(std::max(0, task_scheduler::worker_index()));
+    auto& s = *shards_[s_idx % shards_.size()];
+
+    {
+        std::lock_guard<std::mutex> the_lock {s.mtx};
+
+        if (pinged) {
+            s.stats.num_pings++;
+            s.stats.lag_us.record(static_cast<uint32_t>(
+                std::max<int64_t>(0, std::min<int64_t>(lag.count(), UINT32_MAX))));
+        } else if (associated) {
+            s.stats.num_failures++;
+        } else {
+            s.stats.num_not_associated++;
+        }
+
+        s.stats.num_missed += num_missed;
+    }
+
+    schedule_ping(std::move(ping_ptr), next_slot);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,315 @@
+#include <pcp-test/live_metrics.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace pcp_test {
+
+namespace asio = boost::asio;
+using tcp      = boost::asio::ip::tcp;
+
+live_metrics_counters::live_metrics_counters()
+        : num_attempts   {0},
+          num_associated {0},
+          num_failures   {0}
+{
+}
+
+live_metrics_sample::live_metrics_sample()
+        : time {},
+          run_idx {0},
+          counters {},
+          num_in_flight {0},
+          connect_ms {}
+{
+}
+
+//
+// live_metrics
+//
+
+live_metrics::live_metrics()
+        : run_idx_ {0},
+          num_attempts_ {0},
+          num_associated_ {0},
+          num_failures_ {0},
+          num_completed_ {0},
+          the_mutex_ {},
+          interval_connect_ms_ {},
+          sampled_totals_ {},
+          last_sample_ {}
+{
+}
+
+void live_metrics::set_run(int run_idx)
+{
+    run_idx_ = run_idx;
+}
+
+void live_metrics::attempt_started()
+{
+    num_attempts_++;
+}
+
+void live_metrics::attempt_completed(bool associated,
+                                     std::chrono::milliseconds duration)
+{
+    if (associated)
+        num_associated_++;
+
+    {
+        std::lock_guard<std::mutex> the_lock {the_mutex_};
+        interval_connect_ms_.record(static_cast<uint32_t>(
+            std::max<int64_t>(0, std::min<int64_t>(duration.count(), UINT32_MAX))));
+    }
+
+    num_completed_++;
+}
+
+void live_metrics::attempt_failed()
+{
+    num_failures_++;
+}
+
+live_metrics_sample live_metrics::sample()
+{
+    std::lock_guard<std::mutex> the_lock {the_mutex_};
+    auto totals = get_totals();
+    live_metrics_sample s {};
+
+    s.time = std::chrono::system_clock::now();
+    s.run_idx = run_idx_.load();
+    s.counters.num_attempts   = totals.num_attempts - sampled_totals_.num_attempts;
+    s.counters.num_associated = totals.num_associated - sampled_totals_.num_associated;
+    s.counters.num_failures   = totals.num_failures - sampled_totals_.num_failures;
+    s.num_in_flight = num_in_flight();
+    s.connect_ms = interval_connect_ms_;
+
+    interval_connect_ms_.reset();
+    sampled_totals_ = totals;
+    last_sample_ = s;
+
+    return s;
+}
+
+live_metrics_sample live_metrics::get_last_sample() const
+{
+    std::lock_guard<std::mutex> the_lock {the_mutex_};
+    return last_sample_;
+}
+
+live_metrics_counters live_metrics::get_totals() const
+{
+    live_metrics_counters totals {};
+    totals.num_attempts   = num_attempts_.load();
+    totals.num_associated = num_associated_.load();
+    totals.num_failures   = num_failures_.load();
+    return totals;
+}
+
+int64_t live_metrics::num_in_flight() const
+{
+    // Read the completions first, so that the difference isn't negative
+    auto num_completed = num_completed_.load();
+    return static_cast<int64_t>(num_attempts_.load() - num_completed);
+}
+
+//
+// live_metrics_reporter
+//
+
+const std::chrono::milliseconds live_metrics_reporter::SAMPLING_INTERVAL {1000};
+const std::string live_metrics_reporter::DEFAULT_BIND_ADDRESS {"127.0.0.1"};
+
+// Bounds the size of the HTTP requests that are read
+static constexpr std::size_t MAX_HTTP_REQUEST_SIZE {8192};
+
+live_metrics_reporter::live_metrics_reporter(live_metrics& metrics,
+                                             const std::string& file_path,
+                                             unsigned short port,
+                                             const std::string& bind_address)
+        : metrics_(metrics),
+          file_stream_ {file_path},
+          start_ {std::chrono::steady_clock::now()},
+          stop_mutex_ {},
+          stop_cv_ {},
+          stopping_ {false},
+          io_service_ {},
+          acceptor_ptr_ {},
+          http_thread_ {},
+          sampling_thread_ {}
+{
+    if (!file_stream_.is_open())
+        throw fatal_error {(boost::format("failed to open %1%") % file_path).str()};
+
+    if (port) {
+        boost::system::error_code ec {};
+        auto address = asio::ip::address::from_string(bind_address, ec);
+        tcp::endpoint endpoint {address, port};
+        acceptor_ptr_.reset(new tcp::acceptor(io_service_));
+
+        if (!ec)
+            acceptor_ptr_->open(endpoint.protocol(), ec);
+
+        if (!ec)
+            acceptor_ptr_->set_option(tcp::acceptor::reuse_address(true), ec);
+
+        if (!ec)
+            acceptor_ptr_->bind(endpoint, ec);
+
+        if (!ec)
+            acceptor_ptr_->listen(asio::socket_base::max_connections, ec);
+
+        if (ec)
+            throw fatal_error {(boost::format("failed to serve the live metrics "
+                                              "on %1%:%2%: %3%")
+                                % bind_address % port % ec.message()).str()};
+
+        accept_next();
+        http_thread_ = std::thread([this]() { io_service_.run(); });
+    }
+
+    sampling_thread_ = std::thread(&live_metrics_reporter::sample_periodically, this);
+}
+
+live_metrics_reporter::~live_metrics_reporter()
+{
+    {
+        std::lock_guard<std::mutex> the_lock {stop_mutex_};
+        stopping_ = true;
+    }
+
+    stop_cv_.notify_one();
+
+    if (sampling_thread_.joinable())
+        sampling_thread_.join();
+
+    io_service_.stop();
+
+    if (http_thread_.joinable())
+        http_thread_.join();
+}
+
+// Private
+
+// CSV row: time (ms since epoch), time since the start (ms), run,
+// attempts, associated, failures, in-flight connect() calls, and the
+// 50th, 90th, 99th percentiles and maximum connect() duration (ms)
+void live_metrics_reporter::write_sample(const live_metrics_sample& s)
+{
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+    auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        s.time.time_since_epoch()).count();
+
+    file_stream_ << time_ms << ","
+                 << elapsed_ms << ","
+                 << s.run_idx << ","
+                 << s.counters.num_attempts << ","
+                 << s.counters.num_associated << ","
+                 << s.counters.num_failures << ","
+                 << s.num_in_flight << ","
+                 << s.connect_ms.percentile(50) << ","
+                 << s.connect_ms.percentile(90) << ","
+                 << s.connect_ms.percentile(99) << ","
+                 << s.connect_ms.max() << std::endl;
+}
+
+void live_metrics_reporter::sample_periodically()
+{
+    std::unique_lock<std::mutex> the_lock {stop_mutex_};
+    auto next_sample = start_ + SAMPLING_INTERVAL;
+
+    while (!stop_cv_.wait_until(the_lock, next_sample, [this]() { return stopping_; })) {
+        write_sample(metrics_.sample());
+
+        // Skip the samples that are overdue, e.g. after a suspension
+        auto now = std::chrono::steady_clock::now();
+
+        do {
+            next_sample += SAMPLING_INTERVAL;
+        } while (next_sample <= now);
+    }
+
+    // The last, partial interval
+    write_sample(metrics_.sample());
+}
+
+// Reply to any request with the metrics, then close the connection
+void live_metrics_reporter::accept_next()
+{
+    auto socket_ptr = std::make_shared<tcp::socket>(io_service_);
+
+    acceptor_ptr_->async_accept(
+        *socket_ptr,
+        [this, socket_ptr](const boost::system::error_code& ec)
+        {
+            if (ec)
+                return;
+
+            auto request_ptr = std::make_shared<asio::streambuf>(MAX_HTTP_REQUEST_SIZE);
+            asio::async_read_until(
+                *socket_ptr, *request_ptr, "\r\n\r\n",
+                [this, socket_ptr, request_ptr](const boost::system::error_code& ec,
+                                                std::size_t)
+                {
+                    if (ec)
+                        return;
+
+                    auto response_ptr = std::make_shared<std::string>(
+                        "HTTP/1.0 200 OK\r\n"
+                        "Content-Type: text/plain; version=0.0.4\r\n"
+                        "Connection: close\r\n\r\n" + get_exposition());
+                    asio::async_write(
+                        *socket_ptr, asio::buffer(*response_ptr),
+                        [socket_ptr, response_ptr](const boost::system::error_code&,
+                                                   std::size_t)
+                        {
+                            boost::system::error_code ignored {};
+                            socket_ptr->shutdown(tcp::socket::shutdown_both, ignored);
+                        });
+                });
+
+            accept_next();
+        });
+}
+
+std::string live_metrics_reporter::get_exposition() const
+{
+    auto totals = metrics_.get_totals();
+    auto s = metrics_.get_last_sample();
+    std::ostringstream out {};
+
+    out << "# TYPE pcp_test_connection_attempts_total counter\n"
+        << "pcp_test_connection_attempts_total " << totals.num_attempts << "\n"
+        << "# TYPE pcp_test_connections_associated_total counter\n"
+        << "pcp_test_connections_associated_total " << totals.num_associated << "\n"
+        << "# TYPE pcp_test_connection_failures_total counter\n"
+        << "pcp_test_connection_failures_total " << totals.num_failures << "\n"
+        << "# TYPE pcp_test_connections_in_flight gauge\n"
+        << "pcp_test_connections_in_flight " << metrics_.num_in_flight() << "\n"
+        << "# TYPE pcp_test_run gauge\n"
+        << "pcp_test_run " << s.run_idx << "\n"
+        << "# HELP pcp_test_connect_duration_ms connect() duration over the "
+           "last sampling interval\n"
+        << "# TYPE pcp_test_connect_duration_ms gauge\n";
+
+    for (auto q : {50.0, 90.0, 99.0})
+        out << "pcp_test_connect_duration_ms{quantile=\"" << q / 100 << "\"} "
+            << s.connect_ms.percentile(q) << "\n";
+
+    out << "pcp_test_connect_duration_ms{quantile=\"1\"} " << s.connect_ms.max() << "\n";
+
+    return out.str();
+}
+
+}  // namespace pcp_test
@@ -9,11 +9,111 @@ namespace pcp_test {
 namespace lth_util = leatherman::util;
 namespace lth_jc   = leatherman::json_container;
 
+// Binary header fields; the header is terminated by a newline
+static const char HEADER_SEPARATOR {' '};
+
+static void append_decimal(std::string& buffer, uint64_t value)
+{
+    char digits[20];
+    std::size_t num_digits {0};
+
+    do {
+        digits[num_digits++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    while (num_digits)
+        buffer.push_back(digits[--num_digits]);
+}
+
+// Return false in case of invalid or out of range numbers
+static bool parse_decimal(boost::string_ref text, uint64_t& value)
+{
+    if (text.empty() || text.size() > 20)
+        return false;
+
+    value = 0;
+
+    for (auto c : text) {
+        if (c < '0' || c > '9')
+            return false;
+
+        auto digit = static_cast<uint64_t>(c - '0');
+
+        if (value > (UINT64_MAX - digit) / 10)
+            return false;
+
+        value = 10 * value + digit;
+    }
+
+    return true;
+}
+
+// Split the binary data chunk; throws a message::error in case the
+// header is missing or invalid
+static void parse_binary_data(boost::string_ref data,
+                              boost::string_ref& transaction,
+                              uint64_t& sequence,
+                              int64_t& sent_ns,
+                              boost::string_ref& payload)
+{
+    auto header_end = data.find('\n');
+
+    if (header_end == boost::string_ref::npos)
+        throw message::error("binary data without header");
+
+    auto header = data.substr(0, header_end);
+    payload = data.substr(header_end + 1);
+    sequence = 0;
+    sent_ns  = 0;
+    auto transaction_end = header.find(HEADER_SEPARATOR);
+
+    if (transaction_end == boost::string_ref::npos) {
+        transaction = header;
+        return;
+    }
+
+    transaction = header.substr(0, transaction_end);
+    auto fields = header.substr(transaction_end + 1);
+    auto sequence_end = fields.find(HEADER_SEPARATOR);
+    uint64_t ns {0};
+
+    if (sequence_end == boost::string_ref::npos
+            || !parse_decimal(fields.substr(0, sequence_end), sequence)
+            || !parse_decimal(fields.substr(sequence_end + 1), ns)
+            || ns > static_cast<uint64_t>(INT64_MAX))
+        throw message::error("invalid binary data header");
+
+    sent_ns = static_cast<int64_t>(ns);
+}
+
+static uint64_t get_sequence(const lth_jc::JsonContainer& data)
+{
+    return data.includes("seq") ? static_cast<uint64_t>(data.get<int64_t>("seq")) : 0;
+}
+
+static int64_t get_sent_ns(const lth_jc::JsonContainer& data)
+{
+    return data.includes("sent_ns") ? data.get<int64_t>("sent_ns") : 0;
+}
+
+// NB: the transaction is optional in the JSON data chunk, in case of
+// a header chunk
+static std::string get_transaction(const lth_jc::JsonContainer& data)
+{
+    if (!data.includes("transaction"))
+        throw message::error("no transaction");
+
+    return data.get<std::string>("transaction");
+}
+
 
 message::message(const PCPClient::ParsedChunks &parsed_chunks)
         : id_ {parsed_chunks.envelope.get<std::string>("id")},
           message_type_ {parsed_chunks.envelope.get<std::string>("message_type")},
-          sender_ {parsed_chunks.envelope.get<std::string>("sender")}
+          sender_ {parsed_chunks.envelope.get<std::string>("sender")},
+          sequence_ {0},
+          sent_ns_ {0}
 {
     init(parsed_chunks);
 }
@@ -22,12 +122,14 @@ message::message(const std::string &message_type,
                  const std::string &sender,
                  const std::string &transaction,
                  std::string error_msg)
-        : id_ {util::get_UUID()},
+        : id_ {util::get_message_id()},
           message_type_ {message_type},
           sender_ {sender},
           transaction_ {transaction},
           timestamp_ {lth_util::get_date_time()},
-          error_msg_ {std::move(error_msg)}
+          error_msg_ {std::move(error_msg)},
+          sequence_ {0},
+          sent_ns_ {0}
 {
 }
 
@@ -37,6 +139,27 @@ const std::string& message::sender() const       { return sender_; }
 const std::string& message::transaction() const  { return transaction_; }
 const std::string& message::timestamp() const    { return timestamp_; }
 const std::string& message::error_msg() const    { return error_msg_; }
+const std::string& message::payload() const      { return payload_; }
+
+void message::set_payload(std::string payload)
+{
+    payload_ = std::move(payload);
+}
+
+uint64_t message::sequence() const { return sequence_; }
+int64_t message::sent_ns() const   { return sent_ns_; }
+
+void message::set_send_info(uint64_t sequence)
+{
+    sequence_ = sequence;
+    sent_ns_  = util::get_monotonic_ns();
+}
+
+bool message::is_binary() const
+{
+    return message_type_ == schemas::BINARY_REQUEST_TYPE
+           || message_type_ == schemas::BINARY_RESPONSE_TYPE;
+}
 
 lth_jc::JsonContainer message::get_data() const
 {
@@ -47,17 +170,115 @@ lth_jc::JsonContainer message::get_data() const
     if (message_type_ == schemas::ERROR_TYPE)
         data.set<std::string>("error_msg", error_msg_);
 
+    if (!payload_.empty())
+        data.set<std::string>("payload", payload_);
+
+    if (sent_ns_) {
+        data.set<int64_t>("seq", static_cast<int64_t>(sequence_));
+        data.set<int64_t>("sent_ns", sent_ns_);
+    }
+
     return data;
 }
 
+std::string message::get_binary_data() const
+{
+    std::string data {};
+
+    if (sent_ns_) {
+        write_binary_data(data, transaction_, sequence_, sent_ns_, payload_);
+    } else {
+        write_binary_data(data, transaction_, payload_);
+    }
+
+    return data;
+}
+
+void message::write_binary_data(std::string& buffer,
+                                const std::string& transaction,
+                                const std::string& payload)
+{
+    buffer.assign(transaction);
+    buffer.push_back('\n');
+    buffer.append(payload);
+}
+
+void message::write_binary_data(std::string& buffer,
+                                const std::string& transaction,
+                                uint64_t sequence,
+                                int64_t sent_ns,
+                                const std::string& payload)
+{
+    buffer.assign(transaction);
+    buffer.push_back(HEADER_SEPARATOR);
+    append_decimal(buffer, sequence);
+    buffer.push_back(HEADER_SEPARATOR);
+    append_decimal(buffer, static_cast<uint64_t>(sent_ns));
+    buffer.push_back('\n');
+    buffer.append(payload);
+}
+
+void message::write_header(lth_jc::JsonContainer& header,
+                           const std::string& transaction,
+                           uint64_t sequence,
+                           int64_t sent_ns)
+{
+    header.set<std::string>("transaction", transaction);
+    header.set<int64_t>("seq", static_cast<int64_t>(sequence));
+    header.set<int64_t>("sent_ns", sent_ns);
+}
+
+const lth_jc::JsonContainer* message::find_header(
+        const PCPClient::ParsedChunks& parsed_chunks)
+{
+    for (const auto& debug : parsed_chunks.debug)
+        if (debug.includes("transaction"))
+            return &debug;
+
+    return nullptr;
+}
+
 void message::init(const PCPClient::ParsedChunks &parsed_chunks)
 {
     validateFormat(parsed_chunks);
-    transaction_ = parsed_chunks.data.get<std::string>("transaction");
-    timestamp_   = parsed_chunks.data.get<std::string>("timestamp");
+    auto header = find_header(parsed_chunks);
+
+    if (header) {
+        transaction_ = get_transaction(*header);
+        sequence_    = get_sequence(*header);
+        sent_ns_     = get_sent_ns(*header);
+    }
+
+    if (is_binary()) {
+        if (header) {
+            payload_ = parsed_chunks.binary_data;
+            return;
+        }
+
+        boost::string_ref transaction {};
+        boost::string_ref payload {};
+        parse_binary_data(parsed_chunks.binary_data,
+                          transaction, sequence_, sent_ns_, payload);
+        transaction_ = transaction.to_string();
+        payload_     = payload.to_string();
+        return;
+    }
+
+    if (!header) {
+        transaction_ = get_transaction(parsed_chunks.data);
+        sequence_    = get_sequence(parsed_chunks.data);
+        sent_ns_     = get_sent_ns(parsed_chunks.data);
+    }
+
+    // NB: the formatted timestamp is optional
+    if (parsed_chunks.data.includes("timestamp"))
+        timestamp_ = parsed_chunks.data.get<std::string>("timestamp");
 
     if (message_type_ == schemas::ERROR_TYPE)
         error_msg_ = parsed_chunks.data.get<std::string>("error_msg");
+
+    if (parsed_chunks.data.includes("payload"))
+        payload_ = parsed_chunks.data.get<std::string>("payload");
 }
 
 void message::validateFormat(const PCPClient::ParsedChunks &parsed_chunks)
@@ -66,8 +287,90 @@ void message::validateFormat(const PCPClient::ParsedChunks &parsed_chunks)
         throw message::error("no data");
     if (parsed_chunks.invalid_data)
         throw message::error("invalid data");
-    if (parsed_chunks.data_type != PCPClient::ContentType::Json)
+    if (is_binary()) {
+        if (parsed_chunks.data_type != PCPClient::ContentType::Binary)
+            throw message::error("data is not in binary format");
+    } else if (parsed_chunks.data_type != PCPClient::ContentType::Json) {
         throw message::error("data is not in JSON format");
+    }
+}
+
+//
+// message_view
+//
+
+message_view::message_view(const PCPClient::ParsedChunks& parsed_chunks)
+        : parsed_chunks_(parsed_chunks),
+          binary_ {parsed_chunks.data_type == PCPClient::ContentType::Binary},
+          header_ {message::find_header(parsed_chunks)},
+          json_transaction_ {},
+          binary_transaction_ {},
+          binary_payload_ {},
+          binary_sequence_ {0},
+          binary_sent_ns_ {0}
+{
+    if (!parsed_chunks_.has_data)
+        throw message::error("no data");
+    if (parsed_chunks_.invalid_data)
+        throw message::error("invalid data");
+
+    if (header_) {
+        json_transaction_ = get_transaction(*header_);
+
+        if (binary_)
+            binary_payload_ = parsed_chunks_.binary_data;
+
+        return;
+    }
+
+    if (!binary_) {
+        json_transaction_ = get_transaction(parsed_chunks_.data);
+        return;
+    }
+
+    parse_binary_data(parsed_chunks_.binary_data, binary_transaction_,
+                      binary_sequence_, binary_sent_ns_, binary_payload_);
+}
+
+bool message_view::is_binary() const
+{
+    return binary_;
+}
+
+boost::string_ref message_view::transaction() const
+{
+    return binary_ && !header_ ? binary_transaction_ : boost::string_ref {json_transaction_};
+}
+
+boost::string_ref message_view::binary_payload() const
+{
+    return binary_payload_;
+}
+
+uint64_t message_view::sequence() const
+{
+    if (header_)
+        return get_sequence(*header_);
+
+    return binary_ ? binary_sequence_ : get_sequence(parsed_chunks_.data);
+}
+
+int64_t message_view::sent_ns() const
+{
+    if (header_)
+        return get_sent_ns(*header_);
+
+    return binary_ ? binary_sent_ns_ : get_sent_ns(parsed_chunks_.data);
+}
+
+std::string message_view::id() const
+{
+    return parsed_chunks_.envelope.get<std::string>("id");
+}
+
+std::string message_view::sender() const
+{
+    return parsed_chunks_.envelope.get<std::string>("sender");
 }
 
 }  // namespace pcp_test
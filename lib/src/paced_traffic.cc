@@ -0,0 +1,226 @@
+#include <pcp-test/paced_traffic.hpp>
+#include <pcp-test/message.hpp>
+#include <pcp-test/util.hpp>
+
+#include <leatherman/logging/logging.hpp>
+#include <leatherman/json_container/json_container.hpp>
+
+#include <algorithm>
+
+namespace pcp_test {
+
+namespace lth_jc = leatherman::json_container;
+
+bool try_connect(client& c)
+{
+    try {
+        c.connect(1);
+    } catch (const std::exception& e) {
+        LOG_WARNING("%1%: failed to connect (%2%)",
+                    c.configuration.common_name, e.what());
+    }
+
+    return c.isAssociated();
+}
+
+//
+// traffic_interval
+//
+
+traffic_interval::traffic_interval()
+    : num_sent {0},
+      num_failed_sends {0},
+      num_late_sends {0},
+      num_skipped_sends {0},
+      num_responses {0},
+      num_errors {0},
+      num_reconnected {0},
+      num_reconnect_failures {0},
+      latency_us {}
+{
+}
+
+//
+// echo_agent
+//
+
+echo_agent::echo_agent(client_configuration config)
+    : client(std::move(config))
+{
+}
+
+void echo_agent::process_request(const PCPClient::ParsedChunks& parsed_chunks)
+{
+    echo(parsed_chunks);
+}
+
+//
+// paced_controller
+//
+
+paced_controller::paced_controller(client_configuration config)
+    : stop_mtx_ {},
+      stop_cv_ {},
+      stopping_ {false},
+      num_sent_ {0},
+      num_failed_sends_ {0},
+      num_late_sends_ {0},
+      num_skipped_sends_ {0},
+      num_responses_ {0},
+      num_errors_ {0},
+      num_reconnected_ {0},
+      num_reconnect_failures_ {0},
+      mtx_ {},
+      latency_us_ {},
+      client_ {std::move(config)}
+{
+    client_.response_callback =
+        [this](const PCPClient::ParsedChunks& parsed_chunks, client*)
+        {
+            process_response(parsed_chunks);
+        };
+
+    client_.error_callback =
+        [this](const PCPClient::ParsedChunks&, client*)
+        {
+            num_errors_++;
+        };
+}
+
+client& paced_controller::get_client()
+{
+    return client_;
+}
+
+void paced_controller::send_requests(const std::vector<std::string>& agent_uris,
+                                     std::size_t first_agent_idx,
+                                     unsigned int request_rate,
+                                     clock_type::time_point until)
+{
+    if (request_rate == 0 || agent_uris.empty())
+        return;
+
+    std::vector<std::vector<std::string>> endpoints {};
+
+    for (const auto& uri : agent_uris)
+        endpoints.push_back(std::vector<std::string> {uri});
+
+    const auto& cn = client_.configuration.common_name;
+    std::chrono::nanoseconds send_interval {1000000000 / request_rate};
+    auto next_agent_idx = first_agent_idx;
+    lth_jc::JsonContainer data {};
+    uint64_t seq {0};
+    auto next_send = clock_type::now();
+    std::unique_lock<std::mutex> lck {stop_mtx_};
+
+    while (next_send < until
+           && !stop_cv_.wait_until(lck, next_send, [this]() { return stopping_; })) {
+        lck.unlock();
+
+        if (client_.isAssociated() || reconnect()) {
+            seq++;
+            data.set<std::string>("transaction", cn + "_" + std::to_string(seq));
+            data.set<int64_t>("seq", static_cast<int64_t>(seq));
+            // NB: stamp the scheduled send time, so that the delay of a
+            // late send is part of its round trip (see util::get_monotonic_ns())
+            data.set<int64_t>("sent_ns",
+                              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  next_send.time_since_epoch()).count());
+
+            if (clock_type::now() - next_send > send_interval)
+                num_late_sends_++;
+
+            if (client_.send_request(endpoints[next_agent_idx++ % endpoints.size()],
+                                     data)) {
+                num_sent_++;
+            } else {
+                num_failed_sends_++;
+            }
+
+            next_send += send_interval;
+        } else {
+            num_failed_sends_++;
+            next_send += send_interval;
+
+            // Skip the sends scheduled during the failed reconnection,
+            // rather than attempting a reconnection for each of them
+            auto skip_to = std::min(clock_type::now(), until);
+
+            if (next_send < skip_to) {
+                auto num_skipped = (skip_to - next_send - std::chrono::nanoseconds {1})
+                                   / send_interval + 1;
+                num_skipped_sends_ += static_cast<uint64_t>(num_skipped);
+                next_send += num_skipped * send_interval;
+            }
+        }
+
+        lck.lock();
+    }
+}
+
+void paced_controller::stop()
+{
+    {
+        std::lock_guard<std::mutex> the_lock {stop_mtx_};
+        stopping_ = true;
+    }
+
+    stop_cv_.notify_all();
+}
+
+void paced_controller::take_interval(traffic_interval& t_i)
+{
+    t_i.num_sent               += num_sent_.exchange(0);
+    t_i.num_failed_sends       += num_failed_sends_.exchange(0);
+    t_i.num_late_sends         += num_late_sends_.exchange(0);
+    t_i.num_skipped_sends      += num_skipped_sends_.exchange(0);
+    t_i.num_responses          += num_responses_.exchange(0);
+    t_i.num_errors             += num_errors_.exchange(0);
+    t_i.num_reconnected        += num_reconnected_.exchange(0);
+    t_i.num_reconnect_failures += num_reconnect_failures_.exchange(0);
+
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    t_i.latency_us.merge(latency_us_);
+    latency_us_.reset();
+}
+
+// Private
+
+bool paced_controller::reconnect()
+{
+    if (try_connect(client_)) {
+        num_reconnected_++;
+        return true;
+    }
+
+    num_reconnect_failures_++;
+    return false;
+}
+
+void paced_controller::process_response(const PCPClient::ParsedChunks& parsed_chunks)
+{
+    auto now_ns = util::get_monotonic_ns();
+    int64_t sent_ns {0};
+
+    try {
+        message_view resp {parsed_chunks};
+        sent_ns = resp.sent_ns();
+    } catch (const message::error& e) {
+        LOG_WARNING("%1%: invalid response (%2%)",
+                    client_.configuration.common_name, e.what());
+        num_errors_++;
+        return;
+    }
+
+    num_responses_++;
+
+    if (sent_ns <= 0)
+        return;
+
+    auto latency_us = std::max<int64_t>(0, (now_ns - sent_ns) / 1000);
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    latency_us_.record(static_cast<uint32_t>(
+        std::min<int64_t>(latency_us, UINT32_MAX)));
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,101 @@
+#include <pcp-test/payload_generator.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace pcp_test {
+
+static const std::string ALPHANUMERICS {
+    "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+
+payload_generator::payload_generator(payload_format format,
+                                     payload_size_distribution distribution,
+                                     std::size_t num_payloads,
+                                     std::size_t size,
+                                     std::size_t max_size,
+                                     int seed)
+        : format_ {format},
+          payloads_ {},
+          data_ {}
+{
+    std::default_random_engine engine {};
+    if (seed)
+        engine.seed(static_cast<std::default_random_engine::result_type>(seed));
+
+    max_size = std::max(size, max_size);
+    std::uniform_int_distribution<std::size_t> uniform_sizes {size, max_size};
+    std::exponential_distribution<double> exponential_sizes {
+        size ? 1.0 / size : 1.0};
+    std::uniform_int_distribution<int> bytes {0, 255};
+    std::uniform_int_distribution<std::size_t> chars {0, ALPHANUMERICS.size() - 1};
+
+    for (std::size_t idx = 0; idx < std::max<std::size_t>(1, num_payloads); idx++) {
+        std::size_t payload_size {size};
+
+        switch (distribution) {
+            case (payload_size_distribution::uniform):
+                payload_size = uniform_sizes(engine);
+                break;
+            case (payload_size_distribution::exponential):
+                payload_size = std::min(
+                    max_size, static_cast<std::size_t>(exponential_sizes(engine)));
+                break;
+            default:
+                break;
+        }
+
+        std::string payload(payload_size, '\0');
+
+        for (auto& c : payload)
+            c = (format_ == payload_format::json)
+                ? ALPHANUMERICS[chars(engine)]
+                : static_cast<char>(bytes(engine));
+
+        payloads_.push_back(std::move(payload));
+    }
+
+    if (format_ != payload_format::json)
+        return;
+
+    for (const auto& payload : payloads_) {
+        leatherman::json_container::JsonContainer data {};
+
+        if (!payload.empty())
+            data.set<std::string>("payload", payload);
+
+        data_.push_back(std::move(data));
+    }
+}
+
+payload_format payload_generator::format() const
+{
+    return format_;
+}
+
+std::size_t payload_generator::num_payloads() const
+{
+    return payloads_.size();
+}
+
+const std::string& payload_generator::get(std::size_t idx) const
+{
+    return payloads_[idx % payloads_.size()];
+}
+
+const leatherman::json_container::JsonContainer&
+payload_generator::get_data(std::size_t idx) const
+{
+    return data_[idx % data_.size()];
+}
+
+double payload_generator::mean_size() const
+{
+    double total {0.0};
+
+    for (const auto& p : payloads_)
+        total += p.size();
+
+    return total / payloads_.size();
+}
+
+}  // namespace pcp_test
@@ -7,7 +7,12 @@ namespace pcp_test {
 
 const std::unordered_map<std::string, test_type> to_test_type {
         {{"connection", test_type::connection},
+         {"throughput", test_type::throughput},
+         {"fanout",     test_type::fanout},
+         {"soak",       test_type::soak},
+         {"scenario",   test_type::scenario},
          {"trivial",    test_type::trivial},
+         {"worker",     test_type::worker},
          {"none",       test_type::none}}
 };
 
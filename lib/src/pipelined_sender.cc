@@ -0,0 +1,189 @@
+#include <pcp-test/pipelined_sender.hpp>
+
+#include <algorithm>
+#include <utility>  // std::move
+#include <vector>
+
+namespace pcp_test {
+
+pipeline_counters::pipeline_counters()
+        : batches {0},
+          sent    {0},
+          failed  {0}
+{
+}
+
+pipelined_sender::pipelined_sender(client& c,
+                                   std::size_t window,
+                                   std::size_t max_batch_size,
+                                   request_callback before_send,
+                                   sent_callback after_send)
+        : pipelined_sender([&c](const outgoing_request& request)
+                           {
+                               return c.send_request(request);
+                           },
+                           window,
+                           max_batch_size,
+                           std::move(before_send),
+                           std::move(after_send))
+{
+}
+
+pipelined_sender::pipelined_sender(send_function send,
+                                   std::size_t window,
+                                   std::size_t max_batch_size,
+                                   request_callback before_send,
+                                   sent_callback after_send)
+        : send_ {std::move(send)},
+          window_ {std::max<std::size_t>(1, window)},
+          max_batch_size_ {std::max<std::size_t>(1, max_batch_size)},
+          before_send_ {std::move(before_send)},
+          after_send_ {std::move(after_send)},
+          mtx_ {},
+          not_full_cv_ {},
+          not_empty_cv_ {},
+          queue_ {},
+          in_flight_ {0},
+          stopping_ {false},
+          counters_ {},
+          stop_mtx_ {},
+          sender_ {}
+{
+    sender_ = std::thread(&pipelined_sender::send_batches, this);
+}
+
+pipelined_sender::~pipelined_sender()
+{
+    stop();
+}
+
+bool pipelined_sender::submit(outgoing_request& request,
+                              clock_type::time_point deadline)
+{
+    bool was_empty {false};
+
+    {
+        std::unique_lock<std::mutex> lck {mtx_};
+
+        if (!not_full_cv_.wait_until(lck, deadline,
+                                     [this]() {
+                                         return stopping_ || in_flight_ < window_;
+                                     })
+                || stopping_)
+            return false;
+
+        in_flight_++;
+        was_empty = queue_.empty();
+        queue_.push_back(std::move(request));
+    }
+
+    // NB: the sender checks the queue before waiting, so it needs to
+    // be woken up only when the queue was empty
+    if (was_empty)
+        not_empty_cv_.notify_one();
+
+    return true;
+}
+
+void pipelined_sender::acknowledge(std::size_t num_requests)
+{
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        in_flight_ -= std::min(num_requests, in_flight_);
+    }
+
+    not_full_cv_.notify_all();
+}
+
+void pipelined_sender::stop()
+{
+    std::lock_guard<std::mutex> stop_lock {stop_mtx_};
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        stopping_ = true;
+    }
+
+    not_empty_cv_.notify_all();
+    not_full_cv_.notify_all();
+
+    if (sender_.joinable())
+        sender_.join();
+}
+
+std::size_t pipelined_sender::window() const
+{
+    return window_;
+}
+
+std::size_t pipelined_sender::in_flight() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return in_flight_;
+}
+
+std::size_t pipelined_sender::num_queued() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return queue_.size();
+}
+
+pipeline_counters pipelined_sender::get_counters() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return counters_;
+}
+
+// Private
+
+void pipelined_sender::send_batches()
+{
+    std::vector<outgoing_request> batch {};
+    batch.reserve(max_batch_size_);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lck {mtx_};
+            not_empty_cv_.wait(lck, [this]() { return stopping_ || !queue_.empty(); });
+
+            // Stopping and drained
+            if (queue_.empty())
+                return;
+
+            while (!queue_.empty() && batch.size() < max_batch_size_) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        std::size_t num_failed {0};
+
+        for (const auto& request : batch) {
+            if (before_send_)
+                before_send_(request);
+
+            auto sent = send_(request);
+
+            if (!sent)
+                num_failed++;
+
+            if (after_send_)
+                after_send_(request, sent);
+        }
+
+        {
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            counters_.batches++;
+            counters_.sent   += batch.size() - num_failed;
+            counters_.failed += num_failed;
+            in_flight_ -= std::min(num_failed, in_flight_);
+        }
+
+        if (num_failed)
+            not_full_cv_.notify_all();
+
+        batch.clear();
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,346 @@
+#include <pcp-test/reconnect_storm.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+//
+// reconnect_backoff
+//
+
+reconnect_backoff::reconnect_backoff(reconnect_policy policy, int seed)
+        : policy_ {policy},
+          engine_ {}
+{
+    if (policy_.base_delay.count() < 1)
+        throw fatal_error {"the base reconnection delay must be positive"};
+
+    if (policy_.max_delay < policy_.base_delay)
+        throw fatal_error {"the maximum reconnection delay cannot be less "
+                           "than the base one"};
+
+    if (seed)
+        engine_.seed(static_cast<std::default_random_engine::result_type>(seed));
+}
+
+std::chrono::milliseconds reconnect_backoff::delay(unsigned int attempt,
+                                                   std::chrono::milliseconds previous)
+{
+    auto base_ms = policy_.base_delay.count();
+    auto max_ms  = policy_.max_delay.count();
+
+    if (policy_.jitter == jitter_policy::decorrelated) {
+        auto upper_ms = std::max<int64_t>(base_ms, 3 * std::max<int64_t>(base_ms,
+                                                                         previous.count()));
+        return std::chrono::milliseconds(std::min<int64_t>(max_ms,
+                                                           uniform(base_ms, upper_ms)));
+    }
+
+    int64_t delay_ms {base_ms};
+
+    if (policy_.backoff == backoff_policy::exponential)
+        for (unsigned int idx = 0; idx < attempt && delay_ms < max_ms; idx++)
+            delay_ms *= 2;
+
+    delay_ms = std::min<int64_t>(max_ms, delay_ms);
+
+    switch (policy_.jitter) {
+        case jitter_policy::full:
+            delay_ms = uniform(0, delay_ms);
+            break;
+        case jitter_policy::equal:
+            delay_ms = delay_ms / 2 + uniform(0, delay_ms - delay_ms / 2);
+            break;
+        default:
+            break;
+    }
+
+    return std::chrono::milliseconds(delay_ms);
+}
+
+int64_t reconnect_backoff::uniform(int64_t min, int64_t max)
+{
+    return std::uniform_int_distribution<int64_t> {min, max}(engine_);
+}
+
+//
+// reconnect_stats
+//
+
+reconnect_storm_result::reconnect_storm_result()
+        : num_dropped         {0},
+          num_attempts        {0},
+          num_failed_attempts {0},
+          reassociation_ms    {-1},
+          peak_attempt_rate   {0}
+{
+}
+
+reconnect_stats::reconnect_stats()
+        : num_connections    {0},
+          num_not_associated {0},
+          storms             {}
+{
+}
+
+std::ostream& operator<<(std::ostream& out, const reconnect_stats& r_s)
+{
+    out << "  Reconnect Storms: ... " << r_s.storms.size() << " storms; "
+        << r_s.num_connections << " connections held, ";
+
+    if (r_s.num_not_associated) {
+        out << util::red(std::to_string(r_s.num_not_associated));
+    } else {
+        out << r_s.num_not_associated;
+    }
+
+    out << " not associated at the end\n";
+
+    for (std::size_t idx = 0; idx < r_s.storms.size(); idx++) {
+        const auto& s = r_s.storms[idx];
+        out << "                        storm " << idx + 1 << ": "
+            << s.num_dropped << " dropped, "
+            << s.num_attempts << " attempts ("
+            << s.num_failed_attempts << " failed), ";
+
+        if (s.reassociation_ms < 0) {
+            out << util::red("not re-associated");
+        } else {
+            out << "re-associated in "
+                << util::normalize_time_interval(static_cast<uint32_t>(s.reassociation_ms));
+        }
+
+        out << ", peak " << s.peak_attempt_rate << " attempts/s\n";
+    }
+
+    return out;
+}
+
+//
+// reconnect_storm_tracker
+//
+
+reconnect_storm_tracker::reconnect_storm_tracker(std::size_t num_connections)
+        : num_connections_ {num_connections},
+          num_disconnected_ {0},
+          storm_start_ {},
+          rate_interval_idx_ {0},
+          num_interval_attempts_ {0},
+          current_storm_ {},
+          storms_ {}
+{
+}
+
+void reconnect_storm_tracker::dropped(clock_type::time_point t)
+{
+    if (num_disconnected_ == num_connections_)
+        return;
+
+    if (num_disconnected_ == 0) {
+        storm_start_ = t;
+        rate_interval_idx_ = 0;
+        num_interval_attempts_ = 0;
+        current_storm_ = reconnect_storm_result {};
+    }
+
+    num_disconnected_++;
+    current_storm_.num_dropped++;
+}
+
+void reconnect_storm_tracker::attempt_started(clock_type::time_point t)
+{
+    auto interval_idx = static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(t - storm_start_).count());
+
+    // Attempts of concurrent workers may be reported slightly out of
+    // order; they are counted in the current interval
+    if (interval_idx > rate_interval_idx_) {
+        rate_interval_idx_ = interval_idx;
+        num_interval_attempts_ = 0;
+    }
+
+    num_interval_attempts_++;
+    current_storm_.num_attempts++;
+    current_storm_.peak_attempt_rate = std::max(current_storm_.peak_attempt_rate,
+                                                num_interval_attempts_);
+}
+
+void reconnect_storm_tracker::attempt_failed()
+{
+    current_storm_.num_failed_attempts++;
+}
+
+void reconnect_storm_tracker::reassociated(clock_type::time_point t)
+{
+    if (num_disconnected_ == 0)
+        return;
+
+    if (--num_disconnected_ == 0) {
+        current_storm_.reassociation_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(t - storm_start_).count();
+        storms_.push_back(current_storm_);
+    }
+}
+
+std::size_t reconnect_storm_tracker::num_disconnected() const
+{
+    return num_disconnected_;
+}
+
+reconnect_stats reconnect_storm_tracker::get_stats() const
+{
+    reconnect_stats r_s {};
+    r_s.num_connections    = static_cast<int>(num_connections_);
+    r_s.num_not_associated = static_cast<int>(num_disconnected_);
+    r_s.storms = storms_;
+
+    if (num_disconnected_)
+        r_s.storms.push_back(current_storm_);
+
+    return r_s;
+}
+
+//
+// reconnect_monitor
+//
+
+reconnect_monitor::reconnect_monitor(std::vector<std::shared_ptr<client>> client_ptrs,
+                                     reconnect_policy policy,
+                                     std::chrono::milliseconds check_interval,
+                                     unsigned int num_threads,
+                                     int seed)
+        : endpoints_ {make_endpoints(std::move(client_ptrs))},
+          check_interval_ {std::max(std::chrono::microseconds(1),
+                                    std::chrono::microseconds(check_interval))},
+          stopping_ {false},
+          mtx_ {},
+          backoff_ {policy, seed},
+          tracker_ {endpoints_.size()},
+          scheduler_ {std::max(1u, num_threads)}
+{
+}
+
+reconnect_monitor::~reconnect_monitor()
+{
+    stopping_ = true;
+}
+
+std::size_t reconnect_monitor::num_connections() const
+{
+    return endpoints_.size();
+}
+
+reconnect_stats reconnect_monitor::hold(std::chrono::seconds duration)
+{
+    auto now = clock_type::now();
+    auto num_endpoints = static_cast<int64_t>(endpoints_.size());
+
+    for (int64_t idx = 0; idx < num_endpoints; idx++) {
+        auto offset = std::chrono::microseconds(
+            check_interval_.count() * (idx + 1) / num_endpoints);
+        auto ep_ptr = endpoints_[idx];
+        scheduler_.schedule_at(now + offset, [this, ep_ptr]() { check(ep_ptr); });
+    }
+
+    std::this_thread::sleep_until(now + duration);
+    stopping_ = true;
+
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return tracker_.get_stats();
+}
+
+// Private
+
+std::vector<std::shared_ptr<reconnect_monitor::endpoint>>
+reconnect_monitor::make_endpoints(std::vector<std::shared_ptr<client>> client_ptrs)
+{
+    std::vector<std::shared_ptr<endpoint>> endpoints {};
+
+    for (auto& c_ptr : client_ptrs)
+        if (c_ptr && c_ptr->isAssociated())
+            endpoints.push_back(std::make_shared<endpoint>(
+                endpoint {std::move(c_ptr), 0, std::chrono::milliseconds::zero()}));
+
+    return endpoints;
+}
+
+void reconnect_monitor::check(std::shared_ptr<endpoint> ep_ptr)
+{
+    if (stopping_)
+        return;
+
+    if (ep_ptr->client_ptr->isAssociated()) {
+        scheduler_.schedule_after(check_interval_, [this, ep_ptr]() { check(ep_ptr); });
+        return;
+    }
+
+    LOG_DEBUG("Client %1% was dropped", ep_ptr->client_ptr->configuration.common_name);
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        tracker_.dropped(clock_type::now());
+    }
+
+    ep_ptr->attempt = 0;
+    ep_ptr->previous_delay = std::chrono::milliseconds::zero();
+    schedule_reconnection(std::move(ep_ptr));
+}
+
+void reconnect_monitor::schedule_reconnection(std::shared_ptr<endpoint> ep_ptr)
+{
+    std::chrono::milliseconds delay {};
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        delay = backoff_.delay(ep_ptr->attempt, ep_ptr->previous_delay);
+    }
+
+    ep_ptr->previous_delay = delay;
+    scheduler_.schedule_after(delay, [this, ep_ptr]() { reconnect(ep_ptr); });
+}
+
+void reconnect_monitor::reconnect(std::shared_ptr<endpoint> ep_ptr)
+{
+    if (stopping_)
+        return;
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        tracker_.attempt_started(clock_type::now());
+    }
+
+    auto& c = *ep_ptr->client_ptr;
+
+    try {
+        c.connect(1);
+    } catch (const std::exception& e) {
+        LOG_DEBUG("Client %1% failed to reconnect (attempt %2%): %3%",
+                  c.configuration.common_name, ep_ptr->attempt + 1, e.what());
+    }
+
+    if (c.isAssociated()) {
+        {
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            tracker_.reassociated(clock_type::now());
+        }
+
+        scheduler_.schedule_after(check_interval_, [this, ep_ptr]() { check(ep_ptr); });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        tracker_.attempt_failed();
+    }
+
+    ep_ptr->attempt++;
+    schedule_reconnection(std::move(ep_ptr));
+}
+
+}  // namespace pcp_test
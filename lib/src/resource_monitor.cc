@@ -0,0 +1,315 @@
+#include <pcp-test/resource_monitor.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace pcp_test {
+
+namespace fs = boost::filesystem;
+
+resource_sample::resource_sample()
+        : time {},
+          run_idx {0},
+          cpu_percent {0.0},
+          rss_kb {0},
+          num_threads {0},
+          num_fds {0},
+          lag_us {}
+{
+}
+
+resource_usage::resource_usage()
+        : num_samples {0},
+          mean_cpu_percent {0.0},
+          max_cpu_percent {0.0},
+          max_rss_kb {0},
+          max_threads {0},
+          max_fds {0},
+          lag_us {},
+          saturated {false}
+{
+}
+
+void resource_usage::merge(const resource_usage& other)
+{
+    num_samples      = std::max(num_samples, other.num_samples);
+    mean_cpu_percent = std::max(mean_cpu_percent, other.mean_cpu_percent);
+    max_cpu_percent  = std::max(max_cpu_percent, other.max_cpu_percent);
+    max_rss_kb       = std::max(max_rss_kb, other.max_rss_kb);
+    max_threads      = std::max(max_threads, other.max_threads);
+    max_fds          = std::max(max_fds, other.max_fds);
+    lag_us.merge(other.lag_us);
+    saturated = saturated || other.saturated;
+}
+
+std::ostream& operator<< (std::ostream& out, const resource_usage& u)
+{
+    out << "  Generator: .......... CPU mean "
+        << (boost::format("%.1f%% (max %.1f%%), ") % u.mean_cpu_percent % u.max_cpu_percent)
+        << "RSS " << u.max_rss_kb / 1024 << " MB, "
+        << u.max_threads << " threads, "
+        << u.max_fds << " fds, scheduler lag p99 "
+        << (boost::format("%.1f ms (max %.1f ms)")
+            % (u.lag_us.percentile(99) / 1000.0) % (u.lag_us.max() / 1000.0))
+        << "\n";
+
+    if (u.saturated)
+        out << util::yellow("  [WARNING]  ")
+            << "pcp-test itself was saturated; results may reflect the "
+               "load generator rather than the broker\n";
+
+    return out;
+}
+
+// CSV: mean and max CPU (%), max RSS (KB), max threads, max file
+// descriptors, 99th percentile and max scheduler lag (us), saturated
+std::ofstream & operator<< (boost::nowide::ofstream& out, const resource_usage& u)
+{
+    out << (boost::format("%.1f,%.1f") % u.mean_cpu_percent % u.max_cpu_percent) << ","
+        << u.max_rss_kb << ","
+        << u.max_threads << ","
+        << u.max_fds << ","
+        << u.lag_us.percentile(99) << ","
+        << u.lag_us.max() << ","
+        << (u.saturated ? 1 : 0);
+
+    return out;
+}
+
+//
+// resource_monitor
+//
+
+const std::chrono::milliseconds resource_monitor::PROBE_INTERVAL {10};
+const std::chrono::milliseconds resource_monitor::SAMPLING_INTERVAL {1000};
+const double resource_monitor::SATURATION_CPU_RATIO {0.9};
+const uint32_t resource_monitor::SATURATION_LAG_US {10000};
+
+static int64_t get_cpu_time_us()
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    return (static_cast<int64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000)
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+// The resident set is the second field of statm, in pages
+static uint64_t get_rss_kb()
+{
+    boost::nowide::ifstream statm {"/proc/self/statm"};
+    uint64_t size_pages {0};
+    uint64_t resident_pages {0};
+
+    if (!(statm >> size_pages >> resident_pages))
+        return 0;
+
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+static int get_num_threads()
+{
+    boost::nowide::ifstream status {"/proc/self/status"};
+    std::string line {};
+    static const std::string prefix {"Threads:"};
+
+    while (std::getline(status, line))
+        if (line.compare(0, prefix.size(), prefix) == 0)
+            return std::stoi(line.substr(prefix.size()));
+
+    return 0;
+}
+
+static int get_num_fds()
+{
+    boost::system::error_code ec {};
+    fs::directory_iterator dir_iter {"/proc/self/fd", ec};
+    int num_fds {0};
+
+    // NB: includes the descriptor of the listing itself
+    for (; !ec && dir_iter != fs::directory_iterator {}; dir_iter.increment(ec))
+        num_fds++;
+
+    return num_fds;
+}
+
+resource_monitor::resource_monitor(const std::string& file_path,
+                                   unsigned int num_cores)
+        : num_cores_ {std::max(1u, num_cores)},
+          file_stream_ {},
+          start_ {std::chrono::steady_clock::now()},
+          mtx_ {},
+          stop_cv_ {},
+          stopping_ {false},
+          run_idx_ {0},
+          last_sample_time_ {start_},
+          last_cpu_time_us_ {get_cpu_time_us()},
+          interval_lag_us_ {},
+          last_sample_ {},
+          run_usage_ {},
+          probe_thread_ {}
+{
+    if (!file_path.empty()) {
+        file_stream_.open(file_path);
+
+        if (!file_stream_.is_open())
+            throw fatal_error {(boost::format("failed to open %1%") % file_path).str()};
+    }
+
+    probe_thread_ = std::thread(&resource_monitor::probe, this);
+}
+
+resource_monitor::~resource_monitor()
+{
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        stopping_ = true;
+    }
+
+    stop_cv_.notify_one();
+
+    if (probe_thread_.joinable())
+        probe_thread_.join();
+}
+
+void resource_monitor::start_run(int run_idx)
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    run_idx_ = run_idx;
+    run_usage_ = resource_usage {};
+}
+
+resource_usage resource_monitor::end_run()
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    auto s = take_sample();
+    accumulate(s);
+    write_sample(s);
+
+    auto usage = run_usage_;
+    usage.saturated =
+        usage.mean_cpu_percent >= SATURATION_CPU_RATIO * 100.0 * num_cores_
+        || usage.lag_us.percentile(99) >= SATURATION_LAG_US;
+    run_usage_ = resource_usage {};
+
+    return usage;
+}
+
+resource_sample resource_monitor::get_last_sample() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return last_sample_;
+}
+
+// Private
+
+resource_sample resource_monitor::take_sample()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto cpu_time_us = get_cpu_time_us();
+    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        now - last_sample_time_).count();
+    resource_sample s {};
+
+    s.time = std::chrono::system_clock::now();
+    s.run_idx = run_idx_;
+    s.cpu_percent = elapsed_us > 0
+                    ? 100.0 * static_cast<double>(cpu_time_us - last_cpu_time_us_) / elapsed_us
+                    : 0.0;
+    s.rss_kb = get_rss_kb();
+    s.num_threads = get_num_threads();
+    s.num_fds = get_num_fds();
+    s.lag_us = interval_lag_us_;
+
+    interval_lag_us_.reset();
+    last_sample_time_ = now;
+    last_cpu_time_us_ = cpu_time_us;
+    last_sample_ = s;
+
+    return s;
+}
+
+void resource_monitor::accumulate(const resource_sample& s)
+{
+    auto& u = run_usage_;
+    u.mean_cpu_percent = (u.mean_cpu_percent * u.num_samples + s.cpu_percent)
+                         / (u.num_samples + 1);
+    u.num_samples++;
+    u.max_cpu_percent = std::max(u.max_cpu_percent, s.cpu_percent);
+    u.max_rss_kb      = std::max(u.max_rss_kb, s.rss_kb);
+    u.max_threads     = std::max(u.max_threads, s.num_threads);
+    u.max_fds         = std::max(u.max_fds, s.num_fds);
+    u.lag_us.merge(s.lag_us);
+}
+
+// CSV row: time (ms since epoch), time since the start (ms), run, CPU
+// (%), RSS (KB), threads, file descriptors, and the 99th percentile and
+// maximum scheduler lag (us)
+void resource_monitor::write_sample(const resource_sample& s)
+{
+    if (!file_stream_.is_open())
+        return;
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+    auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        s.time.time_since_epoch()).count();
+
+    file_stream_ << time_ms << ","
+                 << elapsed_ms << ","
+                 << s.run_idx << ","
+                 << (boost::format("%.1f") % s.cpu_percent) << ","
+                 << s.rss_kb << ","
+                 << s.num_threads << ","
+                 << s.num_fds << ","
+                 << s.lag_us.percentile(99) << ","
+                 << s.lag_us.max() << std::endl;
+}
+
+void resource_monitor::probe()
+{
+    std::unique_lock<std::mutex> the_lock {mtx_};
+    auto next_probe = std::chrono::steady_clock::now() + PROBE_INTERVAL;
+    auto next_sample = start_ + SAMPLING_INTERVAL;
+
+    while (!stop_cv_.wait_until(the_lock, next_probe, [this]() { return stopping_; })) {
+        auto now = std::chrono::steady_clock::now();
+        auto lag_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            now - next_probe).count();
+        interval_lag_us_.record(static_cast<uint32_t>(
+            std::max<int64_t>(0, std::min<int64_t>(lag_us, UINT32_MAX))));
+
+        if (now >= next_sample) {
+            auto s = take_sample();
+            accumulate(s);
+            write_sample(s);
+
+            do {
+                next_sample += SAMPLING_INTERVAL;
+            } while (next_sample <= now);
+
+            // NB: schedule from the end of the sample, so that the time
+            // spent sampling is not measured as scheduler lag
+            now = std::chrono::steady_clock::now();
+        }
+
+        next_probe = now + PROBE_INTERVAL;
+    }
+
+    // The last, partial interval
+    write_sample(take_sample());
+}
+
+}  // namespace pcp_test
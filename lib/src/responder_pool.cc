@@ -0,0 +1,155 @@
+#include <pcp-test/responder_pool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+responder_counters::responder_counters()
+        : processed {0},
+          dropped   {0}
+{
+}
+
+constexpr std::size_t responder_pool::DEFAULT_QUEUE_CAPACITY;
+
+responder_pool::responder_pool(handler_type handler,
+                               unsigned int num_threads,
+                               std::size_t queue_capacity,
+                               delay_distribution distribution,
+                               unsigned int delay_us,
+                               unsigned int max_delay_us,
+                               int seed)
+        : handler_ {std::move(handler)},
+          distribution_ {distribution},
+          delay_us_ {delay_us},
+          max_delay_us_ {std::max(delay_us, max_delay_us)},
+          seed_ {seed},
+          ring_ {queue_capacity},
+          num_processed_ {0},
+          num_dropped_ {0},
+          stopping_ {false},
+          num_idle_ {0},
+          mtx_ {},
+          cv_ {},
+          stop_mtx_ {},
+          workers_ {}
+{
+    for (unsigned int idx = 0; idx < std::max(1u, num_threads); idx++)
+        workers_.push_back(std::thread(&responder_pool::work, this, idx));
+}
+
+responder_pool::~responder_pool()
+{
+    stop();
+}
+
+bool responder_pool::enqueue(const PCPClient::ParsedChunks& parsed_chunks,
+                             client* client_ptr)
+{
+    if (stopping_.load(std::memory_order_relaxed))
+        return false;
+
+    if (!ring_.try_push(request {parsed_chunks, client_ptr})) {
+        num_dropped_++;
+        return false;
+    }
+
+    // NB: pairs with the fence of an idle worker, so that either the
+    // worker finds the request or it is seen as idle here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (num_idle_.load(std::memory_order_relaxed)) {
+        { std::lock_guard<std::mutex> the_lock {mtx_}; }
+        cv_.notify_one();
+    }
+
+    return true;
+}
+
+void responder_pool::stop()
+{
+    std::lock_guard<std::mutex> stop_lock {stop_mtx_};
+    stopping_ = true;
+
+    { std::lock_guard<std::mutex> the_lock {mtx_}; }
+    cv_.notify_all();
+
+    for (auto& w : workers_)
+        if (w.joinable())
+            w.join();
+}
+
+unsigned int responder_pool::num_threads() const
+{
+    return static_cast<unsigned int>(workers_.size());
+}
+
+responder_counters responder_pool::get_counters() const
+{
+    responder_counters counters {};
+    counters.processed = num_processed_.load();
+    counters.dropped   = num_dropped_.load();
+    return counters;
+}
+
+// Private
+
+void responder_pool::work(unsigned int worker_idx)
+{
+    std::default_random_engine engine {};
+    if (seed_)
+        engine.seed(static_cast<std::default_random_engine::result_type>(
+            static_cast<uint32_t>(seed_) + static_cast<uint32_t>(worker_idx)));
+
+    std::uniform_int_distribution<unsigned int> uniform_delays {delay_us_, max_delay_us_};
+    std::exponential_distribution<double> exponential_delays {
+        delay_us_ ? 1.0 / delay_us_ : 1.0};
+    request r {};
+
+    while (!stopping_) {
+        auto found = ring_.try_pop(r);
+
+        if (!found) {
+            std::unique_lock<std::mutex> lck {mtx_};
+            num_idle_++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Check again, as the request may have been pushed before
+            // this worker was counted as idle
+            found = ring_.try_pop(r);
+
+            if (!found && !stopping_)
+                cv_.wait(lck);
+
+            num_idle_--;
+        }
+
+        if (!found)
+            continue;
+
+        unsigned int delay {delay_us_};
+
+        switch (distribution_) {
+            case (delay_distribution::uniform):
+                delay = uniform_delays(engine);
+                break;
+            case (delay_distribution::exponential):
+                delay = static_cast<unsigned int>(
+                    std::min<double>(max_delay_us_, exponential_delays(engine)));
+                break;
+            default:
+                break;
+        }
+
+        if (delay)
+            std::this_thread::sleep_for(std::chrono::microseconds(delay));
+
+        handler_(r.parsed_chunks, r.client_ptr);
+        num_processed_++;
+    }
+}
+
+}  // namespace pcp_test
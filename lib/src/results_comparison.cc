@@ -0,0 +1,110 @@
+#include <pcp-test/results_comparison.hpp>
+#include <pcp-test/util.hpp>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace pcp_test {
+
+comparison_thresholds::comparison_thresholds()
+        : max_throughput_drop_pct {10.0},
+          max_latency_increase_pct {20.0},
+          min_latency_increase_ms {1.0},
+          max_failure_rate_increase_pct {1.0}
+{
+}
+
+bool results_comparison::has_regressions() const
+{
+    return std::any_of(changes.begin(), changes.end(),
+                       [](const metric_change& c) { return c.regression; });
+}
+
+std::ostream& operator<< (std::ostream& out, const results_comparison& c)
+{
+    for (const auto& m_c : c.changes)
+        out << (boost::format("  %-12s %-28s %12.3f -> %12.3f  %+8.1f%%  ")
+                % m_c.run_key % m_c.metric % m_c.baseline % m_c.candidate
+                % m_c.change_pct)
+            << (m_c.regression ? util::red("REGRESSION") : "ok") << "\n";
+
+    for (const auto& key : c.unmatched_runs)
+        out << util::yellow("  [WARNING]  ") << "run " << key
+            << " is not in both results\n";
+
+    return out;
+}
+
+static double get_change_pct(double baseline, double candidate)
+{
+    return baseline != 0.0 ? 100.0 * (candidate - baseline) / baseline : 0.0;
+}
+
+static void compare_runs(const run_summary& b,
+                         const run_summary& c,
+                         const comparison_thresholds& t,
+                         std::vector<metric_change>& changes)
+{
+    auto change_pct = get_change_pct(b.throughput, c.throughput);
+    changes.push_back(metric_change {
+        b.key, "throughput", b.throughput, c.throughput, change_pct,
+        -change_pct > t.max_throughput_drop_pct});
+
+    changes.push_back(metric_change {
+        b.key, "failure_rate_pct", b.failure_rate_pct, c.failure_rate_pct,
+        get_change_pct(b.failure_rate_pct, c.failure_rate_pct),
+        c.failure_rate_pct - b.failure_rate_pct > t.max_failure_rate_increase_pct});
+
+    for (const auto& b_l : b.latencies_ms) {
+        auto c_l = c.latencies_ms.find(b_l.first);
+
+        if (c_l == c.latencies_ms.end())
+            continue;
+
+        change_pct = get_change_pct(b_l.second, c_l->second);
+        changes.push_back(metric_change {
+            b.key, b_l.first + "_ms", b_l.second, c_l->second, change_pct,
+            change_pct > t.max_latency_increase_pct
+            && c_l->second - b_l.second > t.min_latency_increase_ms});
+    }
+}
+
+results_comparison compare_results(const std::vector<run_summary>& baseline,
+                                   const std::vector<run_summary>& candidate,
+                                   const comparison_thresholds& thresholds)
+{
+    results_comparison comparison {};
+
+    // Candidate runs by key, in order; matched ones are consumed
+    std::map<std::string, std::vector<const run_summary*>> candidates {};
+
+    for (auto it = candidate.rbegin(); it != candidate.rend(); ++it)
+        candidates[it->key].push_back(&*it);
+
+    for (const auto& b : baseline) {
+        auto& matching = candidates[b.key];
+
+        if (matching.empty()) {
+            comparison.unmatched_runs.push_back(b.key);
+            continue;
+        }
+
+        compare_runs(b, *matching.back(), thresholds, comparison.changes);
+        matching.pop_back();
+    }
+
+    for (const auto& c : candidate) {
+        auto& remaining = candidates[c.key];
+
+        if (!remaining.empty()) {
+            comparison.unmatched_runs.push_back(c.key);
+            remaining.pop_back();
+        }
+    }
+
+    return comparison;
+}
+
+}  // namespace pcp_test
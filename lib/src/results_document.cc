@@ -0,0 +1,150 @@
+#include <pcp-test/results_document.hpp>
+#include <pcp-test/pcp-test.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <boost/asio/ip/host_name.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <iterator>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+namespace fs     = boost::filesystem;
+namespace lth_jc = leatherman::json_container;
+
+run_summary::run_summary()
+        : key {},
+          throughput {0.0},
+          failure_rate_pct {0.0},
+          latencies_ms {}
+{
+}
+
+static lth_jc::JsonContainer to_json(const run_summary& s)
+{
+    lth_jc::JsonContainer latencies {};
+
+    for (const auto& l : s.latencies_ms)
+        latencies.set<double>(l.first, l.second);
+
+    lth_jc::JsonContainer data {};
+    data.set<std::string>("key", s.key);
+    data.set<double>("throughput", s.throughput);
+    data.set<double>("failure_rate_pct", s.failure_rate_pct);
+    data.set<lth_jc::JsonContainer>("latency_ms", latencies);
+    return data;
+}
+
+static run_summary summary_from_json(const lth_jc::JsonContainer& data)
+{
+    run_summary s {};
+    s.key = data.get<std::string>("key");
+    s.throughput = data.get<double>("throughput");
+    s.failure_rate_pct = data.get<double>("failure_rate_pct");
+    auto latencies = data.get<lth_jc::JsonContainer>("latency_ms");
+
+    for (const auto& name : latencies.keys())
+        s.latencies_ms[name] = latencies.get<double>(name);
+
+    return s;
+}
+
+//
+// results_document
+//
+
+results_document::results_document(std::string file_path,
+                                   const std::string& test,
+                                   const application_options& a_o,
+                                   const lth_jc::JsonContainer& parameters)
+        : file_path_ {std::move(file_path)},
+          document_ {},
+          runs_ {}
+{
+    boost::system::error_code ec {};
+    auto hostname = boost::asio::ip::host_name(ec);
+
+    document_.set<std::string>("pcp-test-version", version());
+    document_.set<std::string>("test", test);
+    document_.set<std::string>("start", util::get_ISO8601_time());
+    document_.set<std::string>("hostname", ec ? "" : hostname);
+    document_.set<std::vector<std::string>>("broker-ws-uris", a_o.broker_ws_uris);
+    document_.set<lth_jc::JsonContainer>("parameters", parameters);
+    document_.set<std::vector<lth_jc::JsonContainer>>("runs", runs_);
+    write();
+}
+
+void results_document::add_run(lth_jc::JsonContainer run, const run_summary& summary)
+{
+    run.set<lth_jc::JsonContainer>("summary", to_json(summary));
+    runs_.push_back(std::move(run));
+    document_.set<std::vector<lth_jc::JsonContainer>>("runs", runs_);
+    write();
+}
+
+const std::string& results_document::file_path() const
+{
+    return file_path_;
+}
+
+// Private
+
+void results_document::write()
+{
+    auto tmp_path = file_path_ + ".tmp";
+
+    {
+        boost::nowide::ofstream out {tmp_path};
+        out << document_.toPrettyString() << "\n";
+
+        if (!out)
+            throw fatal_error {(boost::format("failed to write %1%") % tmp_path).str()};
+    }
+
+    boost::system::error_code ec {};
+    fs::rename(tmp_path, file_path_, ec);
+
+    if (ec)
+        throw fatal_error {(boost::format("failed to write %1%: %2%")
+                            % file_path_ % ec.message()).str()};
+}
+
+//
+// load_results
+//
+
+results_set load_results(const std::string& file_path)
+{
+    boost::nowide::ifstream in {file_path};
+
+    if (!in.is_open())
+        throw fatal_error {(boost::format("failed to open %1%") % file_path).str()};
+
+    std::string content {std::istreambuf_iterator<char>(in),
+                         std::istreambuf_iterator<char>()};
+    results_set r_s {};
+
+    try {
+        lth_jc::JsonContainer document {content};
+        r_s.pcp_test_version = document.get<std::string>("pcp-test-version");
+        r_s.test = document.get<std::string>("test");
+        r_s.start = document.get<std::string>("start");
+        r_s.broker_ws_uris = document.get<std::vector<std::string>>("broker-ws-uris");
+
+        for (const auto& run : document.get<std::vector<lth_jc::JsonContainer>>("runs"))
+            r_s.runs.push_back(
+                summary_from_json(run.get<lth_jc::JsonContainer>("summary")));
+    } catch (const lth_jc::data_error& e) {
+        throw fatal_error {(boost::format("invalid results file %1% (%2%)")
+                            % file_path % e.what()).str()};
+    }
+
+    return r_s;
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,360 @@
+#include <pcp-test/scenario.hpp>
+#include <pcp-test/test_scenario_parameters.hpp>
+#include <pcp-test/test_connection_parameters.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <boost/format.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+namespace pcp_test {
+
+namespace scen_par = pcp_test::scenario_test_parameters;
+namespace conn_par = pcp_test::connection_test_parameters;
+namespace lth_jc   = leatherman::json_container;
+
+// NB: built on first use, as the names are defined in another
+// translation unit
+static const std::map<std::string, phase_type>& get_phase_types()
+{
+    static const std::map<std::string, phase_type> phase_types {
+            {{scen_par::CONNECT_PHASE,         phase_type::connect},
+             {scen_par::HOLD_PHASE,            phase_type::hold},
+             {scen_par::MESSAGES_PHASE,        phase_type::messages},
+             {scen_par::RECONNECT_STORM_PHASE, phase_type::reconnect_storm},
+             {scen_par::TEARDOWN_PHASE,        phase_type::teardown}}
+    };
+
+    return phase_types;
+}
+
+std::string phase_type_name(phase_type type)
+{
+    for (const auto& t : get_phase_types())
+        if (t.second == type)
+            return t.first;
+
+    return "unknown";
+}
+
+static constexpr int DEFAULT_RECONNECT_BACKOFF_MS {1000};
+static constexpr int DEFAULT_RECONNECT_BACKOFF_MAX_MS {60000};
+static constexpr int DEFAULT_FRACTION_PCT {100};
+
+scenario_phase::scenario_phase(phase_type t)
+    : type {t},
+      name {phase_type_name(t)},
+      num_agents {0},
+      num_controllers {0},
+      rate {0},
+      duration_s {0},
+      request_rate {0},
+      fraction_pct {DEFAULT_FRACTION_PCT},
+      policy {backoff_policy::exponential,
+              jitter_policy::full,
+              std::chrono::milliseconds(DEFAULT_RECONNECT_BACKOFF_MS),
+              std::chrono::milliseconds(DEFAULT_RECONNECT_BACKOFF_MAX_MS)}
+{
+}
+
+//
+// Parsing
+//
+
+static std::string get_prefix(std::size_t idx, const std::string& name)
+{
+    return (boost::format("phase %1% (%2%): ") % idx % name).str();
+}
+
+static std::vector<std::string> get_phase_keys(phase_type type)
+{
+    std::vector<std::string> keys {scen_par::TYPE, scen_par::NAME};
+    std::vector<std::string> reconnect_keys {scen_par::RECONNECT_BACKOFF,
+                                             scen_par::RECONNECT_BACKOFF_MS,
+                                             scen_par::RECONNECT_BACKOFF_MAX_MS,
+                                             scen_par::RECONNECT_JITTER};
+
+    switch (type) {
+        case phase_type::connect:
+        case phase_type::teardown:
+            keys.insert(keys.end(), {scen_par::NUM_AGENTS,
+                                     scen_par::NUM_CONTROLLERS,
+                                     scen_par::RATE});
+            break;
+        case phase_type::messages:
+            keys.push_back(scen_par::REQUEST_RATE);
+            keys.push_back(scen_par::DURATION_S);
+            keys.insert(keys.end(), reconnect_keys.begin(), reconnect_keys.end());
+            break;
+        case phase_type::reconnect_storm:
+            keys.push_back(scen_par::FRACTION_PCT);
+            keys.push_back(scen_par::DURATION_S);
+            keys.insert(keys.end(), reconnect_keys.begin(), reconnect_keys.end());
+            break;
+        case phase_type::hold:
+            keys.push_back(scen_par::DURATION_S);
+            keys.insert(keys.end(), reconnect_keys.begin(), reconnect_keys.end());
+            break;
+    }
+
+    return keys;
+}
+
+static int get_int(const lth_jc::JsonContainer& data,
+                   const std::string& key,
+                   int default_value,
+                   const std::string& prefix)
+{
+    if (!data.includes(key))
+        return default_value;
+
+    auto value = data.get<int>(key);
+
+    if (value < 0)
+        throw configuration_error(
+            (boost::format("%1%%2% cannot be negative") % prefix % key).str());
+
+    return value;
+}
+
+static reconnect_policy get_policy(const lth_jc::JsonContainer& data,
+                                   reconnect_policy policy,
+                                   const std::string& prefix)
+{
+    policy.base_delay = std::chrono::milliseconds(
+        get_int(data, scen_par::RECONNECT_BACKOFF_MS,
+                static_cast<int>(policy.base_delay.count()), prefix));
+    policy.max_delay = std::chrono::milliseconds(
+        get_int(data, scen_par::RECONNECT_BACKOFF_MAX_MS,
+                static_cast<int>(policy.max_delay.count()), prefix));
+
+    if (data.includes(scen_par::RECONNECT_BACKOFF)) {
+        auto name = data.get<std::string>(scen_par::RECONNECT_BACKOFF);
+
+        if (name == conn_par::CONSTANT_BACKOFF) {
+            policy.backoff = backoff_policy::constant;
+        } else if (name == conn_par::EXPONENTIAL_BACKOFF) {
+            policy.backoff = backoff_policy::exponential;
+        } else {
+            throw configuration_error(
+                (boost::format("%1%invalid %2% (%3%)")
+                 % prefix % scen_par::RECONNECT_BACKOFF % name).str());
+        }
+    }
+
+    if (data.includes(scen_par::RECONNECT_JITTER)) {
+        auto name = data.get<std::string>(scen_par::RECONNECT_JITTER);
+
+        if (name == conn_par::NO_JITTER) {
+            policy.jitter = jitter_policy::none;
+        } else if (name == conn_par::FULL_JITTER) {
+            policy.jitter = jitter_policy::full;
+        } else if (name == conn_par::EQUAL_JITTER) {
+            policy.jitter = jitter_policy::equal;
+        } else if (name == conn_par::DECORRELATED_JITTER) {
+            policy.jitter = jitter_policy::decorrelated;
+        } else {
+            throw configuration_error(
+                (boost::format("%1%invalid %2% (%3%)")
+                 % prefix % scen_par::RECONNECT_JITTER % name).str());
+        }
+    }
+
+    return policy;
+}
+
+static scenario_phase parse_phase(const lth_jc::JsonContainer& data, std::size_t idx)
+{
+    if (!data.includes(scen_par::TYPE))
+        throw configuration_error(
+            (boost::format("phase %1%: the type is missing") % idx).str());
+
+    auto t_name = data.get<std::string>(scen_par::TYPE);
+    auto t_itr  = get_phase_types().find(t_name);
+
+    if (t_itr == get_phase_types().end())
+        throw configuration_error(
+            (boost::format("phase %1%: unknown type (%2%)") % idx % t_name).str());
+
+    scenario_phase phase {t_itr->second};
+
+    if (data.includes(scen_par::NAME))
+        phase.name = data.get<std::string>(scen_par::NAME);
+
+    auto prefix = get_prefix(idx, phase.name);
+    auto keys = get_phase_keys(phase.type);
+
+    for (const auto& key : data.keys())
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+            throw configuration_error(
+                (boost::format("%1%unexpected parameter for a %2% phase (%3%)")
+                 % prefix % t_name % key).str());
+
+    // NB: teardown phases close all clients unless counts are given
+    auto all_clients = phase.type == phase_type::teardown
+                       && !data.includes(scen_par::NUM_AGENTS)
+                       && !data.includes(scen_par::NUM_CONTROLLERS);
+
+    phase.num_agents      = all_clients ? -1 : get_int(data, scen_par::NUM_AGENTS, 0, prefix);
+    phase.num_controllers = all_clients ? -1 : get_int(data, scen_par::NUM_CONTROLLERS, 0, prefix);
+    phase.rate            = get_int(data, scen_par::RATE, 0, prefix);
+    phase.duration_s      = get_int(data, scen_par::DURATION_S, 0, prefix);
+    phase.request_rate    = get_int(data, scen_par::REQUEST_RATE, 0, prefix);
+    phase.fraction_pct    = get_int(data, scen_par::FRACTION_PCT,
+                                    DEFAULT_FRACTION_PCT, prefix);
+    phase.policy          = get_policy(data, phase.policy, prefix);
+
+    return phase;
+}
+
+static lth_jc::JsonContainer load_scenario_file(const std::string& file_path)
+{
+    boost::nowide::ifstream in {file_path};
+
+    if (!in.is_open())
+        throw configuration_error(
+            (boost::format("failed to open the scenario file %1%") % file_path).str());
+
+    std::string content {std::istreambuf_iterator<char>(in),
+                         std::istreambuf_iterator<char>()};
+
+    try {
+        return lth_jc::JsonContainer {content};
+    } catch (const lth_jc::data_error& e) {
+        throw configuration_error((boost::format("invalid scenario file %1% (%2%)")
+                                   % file_path % e.what()).str());
+    }
+}
+
+std::vector<scenario_phase> parse_scenario(const lth_jc::JsonContainer& parameters)
+{
+    if (parameters.includes(scen_par::SCENARIO_FILE)
+            == parameters.includes(scen_par::PHASES))
+        throw configuration_error(
+            (boost::format("either %1% or %2% must be specified")
+             % scen_par::SCENARIO_FILE % scen_par::PHASES).str());
+
+    std::vector<scenario_phase> phases {};
+
+    try {
+        auto data = parameters.includes(scen_par::SCENARIO_FILE)
+                    ? load_scenario_file(parameters.get<std::string>(scen_par::SCENARIO_FILE))
+                    : parameters;
+        std::size_t idx {1};
+
+        for (const auto& p_data : data.get<std::vector<lth_jc::JsonContainer>>(scen_par::PHASES))
+            phases.push_back(parse_phase(p_data, idx++));
+    } catch (const lth_jc::data_error& e) {
+        throw configuration_error(
+            (boost::format("invalid scenario (%1%)") % e.what()).str());
+    }
+
+    validate_scenario(phases);
+    return phases;
+}
+
+//
+// Validation
+//
+
+static void validate_policy(const reconnect_policy& policy, const std::string& prefix)
+{
+    if (policy.base_delay.count() < 1)
+        throw configuration_error(
+            (boost::format("%1%%2% must be positive")
+             % prefix % scen_par::RECONNECT_BACKOFF_MS).str());
+
+    if (policy.max_delay < policy.base_delay)
+        throw configuration_error(
+            (boost::format("%1%%2% cannot be less than %3%")
+             % prefix % scen_par::RECONNECT_BACKOFF_MAX_MS
+             % scen_par::RECONNECT_BACKOFF_MS).str());
+}
+
+void validate_scenario(const std::vector<scenario_phase>& phases)
+{
+    if (phases.empty())
+        throw configuration_error("the scenario has no phases");
+
+    // Clients connected by the previous phases, and not torn down
+    int num_agents {0};
+    int num_controllers {0};
+    std::size_t idx {1};
+
+    for (const auto& phase : phases) {
+        auto prefix = get_prefix(idx++, phase.name);
+
+        if (phase.type == phase_type::connect) {
+            if (phase.num_agents < 0 || phase.num_controllers < 0
+                    || phase.num_agents + phase.num_controllers < 1)
+                throw configuration_error(prefix + "no clients to connect");
+
+            num_agents      += phase.num_agents;
+            num_controllers += phase.num_controllers;
+            continue;
+        }
+
+        if (phase.type == phase_type::teardown) {
+            auto n_a = phase.num_agents < 0 ? num_agents : phase.num_agents;
+            auto n_c = phase.num_controllers < 0 ? num_controllers : phase.num_controllers;
+
+            if (n_a + n_c < 1)
+                throw configuration_error(prefix + "no clients to close");
+
+            if (n_a > num_agents || n_c > num_controllers)
+                throw configuration_error(
+                    (boost::format("%1%cannot close %2% agents and %3% controllers; "
+                                   "%4% and %5% are connected")
+                     % prefix % n_a % n_c % num_agents % num_controllers).str());
+
+            num_agents      -= n_a;
+            num_controllers -= n_c;
+            continue;
+        }
+
+        // hold, messages, and reconnect storm
+
+        if (phase.duration_s < 1)
+            throw configuration_error(prefix + "the duration must be positive");
+
+        if (num_agents + num_controllers < 1)
+            throw configuration_error(prefix + "no clients are connected");
+
+        validate_policy(phase.policy, prefix);
+
+        if (phase.type == phase_type::messages) {
+            if (num_agents < 1 || num_controllers < 1)
+                throw configuration_error(
+                    prefix + "at least one agent and one controller are required");
+
+            if (phase.request_rate < 1)
+                throw configuration_error(prefix + "the request rate must be positive");
+        }
+
+        if (phase.type == phase_type::reconnect_storm
+                && (phase.fraction_pct < 1 || phase.fraction_pct > 100))
+            throw configuration_error(
+                (boost::format("%1%%2% must be in [1, 100]")
+                 % prefix % scen_par::FRACTION_PCT).str());
+    }
+}
+
+scenario_population get_scenario_population(const std::vector<scenario_phase>& phases)
+{
+    scenario_population p {0, 0};
+
+    for (const auto& phase : phases) {
+        if (phase.type == phase_type::connect) {
+            p.num_agents      += phase.num_agents;
+            p.num_controllers += phase.num_controllers;
+        }
+    }
+
+    return p;
+}
+
+}  // namespace pcp_test
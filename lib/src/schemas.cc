@@ -1,5 +1,9 @@
 #include <pcp-test/schemas.hpp>
 #include <pcp-test/test_connection_parameters.hpp>
+#include <pcp-test/test_throughput_parameters.hpp>
+#include <pcp-test/test_fanout_parameters.hpp>
+#include <pcp-test/test_soak_parameters.hpp>
+#include <pcp-test/test_scenario_parameters.hpp>
 #include <pcp-test/configuration_parameters.hpp>
 
 namespace pcp_test {
@@ -8,36 +12,62 @@ namespace schemas {
 using C_Type       = PCPClient::ContentType;
 using T_Constraint = PCPClient::TypeConstraint;
 namespace conn_par = pcp_test::connection_test_parameters;
+namespace thr_par  = pcp_test::throughput_test_parameters;
+namespace fan_par  = pcp_test::fanout_test_parameters;
+namespace soak_par = pcp_test::soak_test_parameters;
+namespace scen_par = pcp_test::scenario_test_parameters;
 
 const std::string REQUEST_TYPE {"pcp-test-request"};
 const std::string RESPONSE_TYPE {"pcp-test-response"};
 const std::string ERROR_TYPE {"pcp-test-error"};
+const std::string BINARY_REQUEST_TYPE {"pcp-test-binary-request"};
+const std::string BINARY_RESPONSE_TYPE {"pcp-test-binary-response"};
 
-PCPClient::Schema request()
+static PCPClient::Schema build_request()
 {
     PCPClient::Schema schema {REQUEST_TYPE, C_Type::Json};
 
-    // Request-response transaction UUID
-    schema.addConstraint("transaction", T_Constraint::String, true);
+    // Request-response transaction UUID; optional, as it can rather
+    // be carried by a header chunk (see message::write_header())
+    schema.addConstraint("transaction", T_Constraint::String, false);
+
+    // Indicates the time instant of message creation; optional, as
+    // formatting it is costly for senders of high message rates
+    schema.addConstraint("timestamp", T_Constraint::String, false);
 
-    // Indicates the time instant of message creation
-    schema.addConstraint("timestamp", T_Constraint::String, true);
+    // Sender sequence number and send time, in nanoseconds of the
+    // sender's monotonic clock (see util::get_monotonic_ns())
+    schema.addConstraint("seq", T_Constraint::Int, false);
+    schema.addConstraint("sent_ns", T_Constraint::Int, false);
+
+    // Optional load
+    schema.addConstraint("payload", T_Constraint::String, false);
     return schema;
 }
 
-PCPClient::Schema response()
+static PCPClient::Schema build_response()
 {
     PCPClient::Schema schema {RESPONSE_TYPE, C_Type::Json};
 
-    // Request-response transaction UUID
-    schema.addConstraint("transaction", T_Constraint::String, true);
+    // Request-response transaction UUID; optional, as it can rather
+    // be carried by a header chunk (see message::write_header())
+    schema.addConstraint("transaction", T_Constraint::String, false);
 
-    // Indicates the time instant of message creation
-    schema.addConstraint("timestamp", T_Constraint::String, true);
+    // Indicates the time instant of message creation; optional, as
+    // formatting it is costly for senders of high message rates
+    schema.addConstraint("timestamp", T_Constraint::String, false);
+
+    // Sender sequence number and send time, in nanoseconds of the
+    // sender's monotonic clock (see util::get_monotonic_ns())
+    schema.addConstraint("seq", T_Constraint::Int, false);
+    schema.addConstraint("sent_ns", T_Constraint::Int, false);
+
+    // Optional load
+    schema.addConstraint("payload", T_Constraint::String, false);
     return schema;
 }
 
-PCPClient::Schema error()
+static PCPClient::Schema build_error()
 {
     PCPClient::Schema schema {ERROR_TYPE, C_Type::Json};
 
@@ -45,8 +75,14 @@ PCPClient::Schema error()
     // generated the error
     schema.addConstraint("transaction", T_Constraint::String, true);
 
-    // Indicates the time instant of message creation
-    schema.addConstraint("timestamp", T_Constraint::String, true);
+    // Indicates the time instant of message creation; optional, as
+    // formatting it is costly for senders of high message rates
+    schema.addConstraint("timestamp", T_Constraint::String, false);
+
+    // Sender sequence number and send time, in nanoseconds of the
+    // sender's monotonic clock (see util::get_monotonic_ns())
+    schema.addConstraint("seq", T_Constraint::Int, false);
+    schema.addConstraint("sent_ns", T_Constraint::Int, false);
 
     // Error message
     schema.addConstraint("error_msg", T_Constraint::String, true);
@@ -54,6 +90,38 @@ PCPClient::Schema error()
     return schema;
 }
 
+// NB: function-local statics are initialized once, in a thread safe way
+
+const PCPClient::Schema& request()
+{
+    static const PCPClient::Schema schema {build_request()};
+    return schema;
+}
+
+const PCPClient::Schema& response()
+{
+    static const PCPClient::Schema schema {build_response()};
+    return schema;
+}
+
+const PCPClient::Schema& error()
+{
+    static const PCPClient::Schema schema {build_error()};
+    return schema;
+}
+
+const PCPClient::Schema& binary_request()
+{
+    static const PCPClient::Schema schema {BINARY_REQUEST_TYPE, C_Type::Binary};
+    return schema;
+}
+
+const PCPClient::Schema& binary_response()
+{
+    static const PCPClient::Schema schema {BINARY_RESPONSE_TYPE, C_Type::Binary};
+    return schema;
+}
+
 PCPClient::Schema connection_test_parameters()
 {
     PCPClient::Schema schema {configuration_parameters::CONNECTION_TEST_PARAMETERS,
@@ -70,10 +138,133 @@ PCPClient::Schema connection_test_parameters()
     schema.addConstraint(conn_par::INTER_ENDPOINT_PAUSE_RNG_SEED,  T_Constraint::Int,  false);
     schema.addConstraint(conn_par::WS_CONNECTION_TIMEOUT_MS,       T_Constraint::Int,  false);
     schema.addConstraint(conn_par::WS_CONNECTION_CHECK_INTERVAL_S, T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::KEEPALIVE_THREADS,              T_Constraint::Int,  false);
     schema.addConstraint(conn_par::ASSOCIATION_TIMEOUT_S,          T_Constraint::Int,  false);
     schema.addConstraint(conn_par::ASSOCIATION_REQUEST_TTL_S,      T_Constraint::Int,  false);
     schema.addConstraint(conn_par::PERSIST_CONNECTIONS,            T_Constraint::Bool, false);
     schema.addConstraint(conn_par::SHOW_STATS,                     T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::CONNECTION_ENGINE,              T_Constraint::String, false);
+    schema.addConstraint(conn_par::ENGINE_THREADS,                 T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::ARRIVAL_MODE,                   T_Constraint::String, false);
+    schema.addConstraint(conn_par::CONNECTION_RATE,                T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::CONNECTION_RATE_INCREMENT,      T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::RAMP_UP_MS,                     T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::INCREMENTAL_RAMP,               T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::TEARDOWN_PARALLELISM,           T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::TEARDOWN_RATE,                  T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::BROKER_DISTRIBUTION,            T_Constraint::String, false);
+    schema.addConstraint(conn_par::BROKER_WEIGHTS,                 T_Constraint::Array, false);
+    schema.addConstraint(conn_par::WORKERS,                        T_Constraint::Array, false);
+    schema.addConstraint(conn_par::WORKER_PORT,                    T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::WORKER_BIND_ADDRESS,            T_Constraint::String, false);
+    schema.addConstraint(conn_par::LIVE_METRICS,                   T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::LIVE_METRICS_PORT,              T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::LIVE_METRICS_BIND_ADDRESS,      T_Constraint::String, false);
+    schema.addConstraint(conn_par::EVENT_LOG,                      T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::RESOURCE_STATS,                 T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::CAPACITY_SEARCH,                T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::MAX_FAILURES,                   T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::LATENCY_SLO_MS,                 T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::RECONNECT_STORM,                T_Constraint::Bool, false);
+    schema.addConstraint(conn_par::HOLD_DURATION_S,                T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::RECONNECT_CHECK_INTERVAL_MS,    T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::RECONNECT_BACKOFF,              T_Constraint::String, false);
+    schema.addConstraint(conn_par::RECONNECT_BACKOFF_MS,           T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::RECONNECT_BACKOFF_MAX_MS,       T_Constraint::Int,  false);
+    schema.addConstraint(conn_par::RECONNECT_JITTER,               T_Constraint::String, false);
+    schema.addConstraint(conn_par::LATENCY_CORRECTION,             T_Constraint::Bool, false);
+
+    return schema;
+}
+
+PCPClient::Schema throughput_test_parameters()
+{
+    PCPClient::Schema schema {configuration_parameters::THROUGHPUT_TEST_PARAMETERS,
+                              C_Type::Json};
+
+    schema.addConstraint(thr_par::NUM_RUNS,                 T_Constraint::Int, true);
+    schema.addConstraint(thr_par::INTER_RUN_PAUSE_MS,       T_Constraint::Int, true);
+    schema.addConstraint(thr_par::NUM_AGENTS,               T_Constraint::Int, true);
+    schema.addConstraint(thr_par::NUM_CONTROLLERS,          T_Constraint::Int, true);
+    schema.addConstraint(thr_par::RUN_DURATION_S,           T_Constraint::Int, true);
+    schema.addConstraint(thr_par::AGENTS_INCREMENT,         T_Constraint::Int, false);
+    schema.addConstraint(thr_par::CONTROLLERS_INCREMENT,    T_Constraint::Int, false);
+    schema.addConstraint(thr_par::REQUEST_RATE,             T_Constraint::Int, false);
+    schema.addConstraint(thr_par::REQUEST_RATE_INCREMENT,   T_Constraint::Int, false);
+    schema.addConstraint(thr_par::INFLIGHT_WINDOW,          T_Constraint::Int, false);
+    schema.addConstraint(thr_par::SEND_BATCH_SIZE,          T_Constraint::Int, false);
+    schema.addConstraint(thr_par::RESPONSE_TIMEOUT_MS,      T_Constraint::Int, false);
+    schema.addConstraint(thr_par::MESSAGE_TTL_S,            T_Constraint::Int, false);
+    schema.addConstraint(thr_par::WS_CONNECTION_TIMEOUT_MS, T_Constraint::Int, false);
+    schema.addConstraint(thr_par::ASSOCIATION_TIMEOUT_S,    T_Constraint::Int, false);
+    schema.addConstraint(thr_par::PAYLOAD_SIZE,             T_Constraint::Int, false);
+    schema.addConstraint(thr_par::PAYLOAD_MAX_SIZE,         T_Constraint::Int, false);
+    schema.addConstraint(thr_par::PAYLOAD_SIZE_DISTRIBUTION, T_Constraint::String, false);
+    schema.addConstraint(thr_par::PAYLOAD_FORMAT,           T_Constraint::String, false);
+    schema.addConstraint(thr_par::NUM_PAYLOADS,             T_Constraint::Int, false);
+    schema.addConstraint(thr_par::RESPONDER_THREADS,        T_Constraint::Int, false);
+    schema.addConstraint(thr_par::RESPONDER_QUEUE_SIZE,     T_Constraint::Int, false);
+    schema.addConstraint(thr_par::PROCESSING_DELAY_US,      T_Constraint::Int, false);
+    schema.addConstraint(thr_par::PROCESSING_DELAY_MAX_US,  T_Constraint::Int, false);
+    schema.addConstraint(thr_par::PROCESSING_DELAY_DISTRIBUTION, T_Constraint::String, false);
+
+    return schema;
+}
+
+PCPClient::Schema fanout_test_parameters()
+{
+    PCPClient::Schema schema {configuration_parameters::FANOUT_TEST_PARAMETERS,
+                              C_Type::Json};
+
+    schema.addConstraint(fan_par::NUM_RUNS,                 T_Constraint::Int, true);
+    schema.addConstraint(fan_par::INTER_RUN_PAUSE_MS,       T_Constraint::Int, true);
+    schema.addConstraint(fan_par::NUM_AGENTS,               T_Constraint::Int, true);
+    schema.addConstraint(fan_par::NUM_CONTROLLERS,          T_Constraint::Int, true);
+    schema.addConstraint(fan_par::NUM_BROADCASTS,           T_Constraint::Int, true);
+    schema.addConstraint(fan_par::AGENTS_INCREMENT,         T_Constraint::Int, false);
+    schema.addConstraint(fan_par::CONTROLLERS_INCREMENT,    T_Constraint::Int, false);
+    schema.addConstraint(fan_par::TARGETING,                T_Constraint::String, false);
+    schema.addConstraint(fan_par::BROADCAST_PAUSE_MS,       T_Constraint::Int, false);
+    schema.addConstraint(fan_par::RESPONSE_TIMEOUT_MS,      T_Constraint::Int, false);
+    schema.addConstraint(fan_par::MESSAGE_TTL_S,            T_Constraint::Int, false);
+    schema.addConstraint(fan_par::WS_CONNECTION_TIMEOUT_MS, T_Constraint::Int, false);
+    schema.addConstraint(fan_par::ASSOCIATION_TIMEOUT_S,    T_Constraint::Int, false);
+
+    return schema;
+}
+
+PCPClient::Schema soak_test_parameters()
+{
+    PCPClient::Schema schema {configuration_parameters::SOAK_TEST_PARAMETERS,
+                              C_Type::Json};
+
+    schema.addConstraint(soak_par::DURATION_S,                     T_Constraint::Int, true);
+    schema.addConstraint(soak_par::NUM_AGENTS,                     T_Constraint::Int, true);
+    schema.addConstraint(soak_par::NUM_CONTROLLERS,                T_Constraint::Int, true);
+    schema.addConstraint(soak_par::REQUEST_RATE,                   T_Constraint::Int, true);
+    schema.addConstraint(soak_par::CHURN_PER_MIN,                  T_Constraint::Int, false);
+    schema.addConstraint(soak_par::SNAPSHOT_INTERVAL_S,            T_Constraint::Int, false);
+    schema.addConstraint(soak_par::WS_CONNECTION_CHECK_INTERVAL_S, T_Constraint::Int, false);
+    schema.addConstraint(soak_par::MESSAGE_TTL_S,                  T_Constraint::Int, false);
+    schema.addConstraint(soak_par::WS_CONNECTION_TIMEOUT_MS,       T_Constraint::Int, false);
+    schema.addConstraint(soak_par::ASSOCIATION_TIMEOUT_S,          T_Constraint::Int, false);
+
+    return schema;
+}
+
+// NB: phases are validated by parse_scenario() (see scenario.hpp)
+PCPClient::Schema scenario_test_parameters()
+{
+    PCPClient::Schema schema {configuration_parameters::SCENARIO_TEST_PARAMETERS,
+                              C_Type::Json};
+
+    schema.addConstraint(scen_par::SCENARIO_FILE,                  T_Constraint::String, false);
+    schema.addConstraint(scen_par::PHASES,                         T_Constraint::Array, false);
+    schema.addConstraint(scen_par::WS_CONNECTION_CHECK_INTERVAL_S, T_Constraint::Int, false);
+    schema.addConstraint(scen_par::RECONNECT_CHECK_INTERVAL_MS,    T_Constraint::Int, false);
+    schema.addConstraint(scen_par::MESSAGE_TTL_S,                  T_Constraint::Int, false);
+    schema.addConstraint(scen_par::WS_CONNECTION_TIMEOUT_MS,       T_Constraint::Int, false);
+    schema.addConstraint(scen_par::ASSOCIATION_TIMEOUT_S,          T_Constraint::Int, false);
 
     return schema;
 }
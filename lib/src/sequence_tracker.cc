@@ -0,0 +1,76 @@
+#include <pcp-test/sequence_tracker.hpp>
+
+#include <algorithm>
+
+namespace pcp_test {
+
+sequence_counters::sequence_counters()
+        : received   {0},
+          reordered  {0},
+          duplicates {0},
+          missing    {0}
+{
+}
+
+constexpr std::size_t sequence_tracker::DEFAULT_MAX_GAPS;
+
+sequence_tracker::sequence_tracker(std::size_t max_gaps)
+        : max_gaps_ {std::max<std::size_t>(1, max_gaps)},
+          mtx_ {},
+          senders_ {},
+          counters_ {}
+{
+}
+
+void sequence_tracker::record(const std::string& sender, uint64_t sequence)
+{
+    if (sequence == 0)
+        return;
+
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    auto& s = senders_.emplace(sender, sender_state {1, {}}).first->second;
+    counters_.received++;
+
+    if (sequence == s.next_expected) {
+        s.next_expected++;
+        return;
+    }
+
+    if (sequence > s.next_expected) {
+        // NB: in case of a large gap, only the last max_gaps numbers
+        // are remembered; the older ones are lost anyway
+        auto first_gap = sequence - std::min<uint64_t>(sequence - s.next_expected,
+                                                       max_gaps_);
+
+        for (auto gap = first_gap; gap < sequence; gap++)
+            s.gaps.insert(gap);
+
+        while (s.gaps.size() > max_gaps_)
+            s.gaps.erase(s.gaps.begin());
+
+        counters_.missing += sequence - s.next_expected;
+        s.next_expected = sequence + 1;
+        return;
+    }
+
+    if (s.gaps.erase(sequence)) {
+        counters_.reordered++;
+        counters_.missing--;
+    } else {
+        counters_.duplicates++;
+    }
+}
+
+std::size_t sequence_tracker::num_senders() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return senders_.size();
+}
+
+sequence_counters sequence_tracker::get_counters() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return counters_;
+}
+
+}  // namespace pcp_test
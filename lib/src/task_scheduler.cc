@@ -0,0 +1,140 @@
+#include <pcp-test/task_scheduler.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <algorithm>
+#include <utility>  // std::move
+
+namespace pcp_test {
+
+static thread_local int current_worker_idx {-1};
+
+task_scheduler::task_scheduler(unsigned int num_threads)
+    : mtx_ {},
+      cv_ {},
+      queue_ {},
+      seq_ {0},
+      stopping_ {false},
+      workers_ {}
+{
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    try {
+        for (unsigned int idx = 0; idx < num_threads; idx++)
+            workers_.push_back(std::thread {&task_scheduler::work, this,
+                                            static_cast<int>(idx)});
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to start the task scheduler workers: %1%", e.what());
+        {
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            stopping_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& w : workers_)
+            w.join();
+
+        throw fatal_error { "failed to start the task scheduler threads" };
+    }
+
+    LOG_DEBUG("Started task scheduler with %1% workers", workers_.size());
+}
+
+task_scheduler::~task_scheduler()
+{
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        stopping_ = true;
+        queue_.clear();
+    }
+    cv_.notify_all();
+
+    for (auto& w : workers_) {
+        try {
+            if (w.joinable())
+                w.join();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Exception joining task scheduler worker: %1%", e.what());
+        }
+    }
+}
+
+void task_scheduler::schedule(task_type task)
+{
+    schedule_at(clock_type::now(), std::move(task));
+}
+
+void task_scheduler::schedule_at(clock_type::time_point due, task_type task)
+{
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        queue_.push_back(entry {due, seq_++, std::move(task)});
+        std::push_heap(queue_.begin(), queue_.end(), later {});
+    }
+    cv_.notify_one();
+}
+
+void task_scheduler::schedule_after(std::chrono::microseconds delay, task_type task)
+{
+    schedule_at(clock_type::now() + delay, std::move(task));
+}
+
+unsigned int task_scheduler::num_threads() const
+{
+    return static_cast<unsigned int>(workers_.size());
+}
+
+std::size_t task_scheduler::num_pending() const
+{
+    std::lock_guard<std::mutex> the_lock {mtx_};
+    return queue_.size();
+}
+
+int task_scheduler::worker_index()
+{
+    return current_worker_idx;
+}
+
+void task_scheduler::work(int worker_idx)
+{
+    current_worker_idx = worker_idx;
+    std::unique_lock<std::mutex> lck {mtx_};
+
+    while (!stopping_) {
+        if (queue_.empty()) {
+            cv_.wait(lck);
+            continue;
+        }
+
+        auto due = queue_.front().due;
+
+        if (due > clock_type::now()) {
+            // NB: an earlier task may be scheduled in the meantime;
+            // we'll be notified and re-check the top of the heap
+            cv_.wait_until(lck, due);
+            continue;
+        }
+
+        std::pop_heap(queue_.begin(), queue_.end(), later {});
+        auto task = std::move(queue_.back().task);
+        queue_.pop_back();
+
+        // Another worker may be in charge of the next due task
+        if (!queue_.empty())
+            cv_.notify_one();
+
+        lck.unlock();
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Unexpected failure of a scheduled task: %1%", e.what());
+        }
+
+        lck.lock();
+    }
+}
+
+}  // namespace pcp_test
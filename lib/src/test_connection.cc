@@ -4,6 +4,8 @@
 #include <pcp-test/errors.hpp>
 #include <pcp-test/client_configuration.hpp>
 #include <pcp-test/random.hpp>
+#include <pcp-test/arrival_schedule.hpp>
+#include <pcp-test/pcp-test.hpp>
 
 #include <cpp-pcp-client/connector/errors.hpp>
 
@@ -19,6 +21,8 @@
 #include <boost/nowide/iostream.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>  // tolower
 #include <math.h>
 #include <functional>  // std::reference_wrapper
 
@@ -38,21 +42,6 @@ void run_connection_test(const application_options& a_o)
     test.start();
 }
 
-static std::string normalizeTimeInterval(uint32_t duration_ms)
-{
-    auto min = duration_ms / 60000;
-    auto s   = (duration_ms - min * 60000) / 1000;
-    auto ms  = duration_ms % 1000;
-
-    if (min > 0)
-        return (boost::format("%1% min %2% s") % min % s).str();
-
-    if (s > 0)
-        return (boost::format("%1%.%2% s") % s % ms).str();
-
-    return (boost::format("%1% ms") % ms).str();
-}
-
 //
 // connection_test_run
 //
@@ -64,12 +53,21 @@ connection_test_run::connection_test_run(const application_options& a_o)
         a_o.connection_test_parameters.get<int>(conn_par::ENDPOINTS_INCREMENT)},
       concurrency_increment_ {
         a_o.connection_test_parameters.get<int>(conn_par::CONCURRENCY_INCREMENT)},
+      connection_rate_increment_ {
+        a_o.connection_test_parameters.includes(conn_par::CONNECTION_RATE_INCREMENT)
+        ? a_o.connection_test_parameters.get<int>(conn_par::CONNECTION_RATE_INCREMENT)
+        : 0},
       endpoint_timeout_ms_ {
         a_o.connection_test_parameters.get<int>(conn_par::WS_CONNECTION_TIMEOUT_MS)
         + 1000 * a_o.connection_test_parameters.get<int>(conn_par::ASSOCIATION_TIMEOUT_S)},
       idx {1},
+      level {0},
       num_endpoints {a_o.connection_test_parameters.get<int>(conn_par::NUM_ENDPOINTS)},
       concurrency {a_o.connection_test_parameters.get<int>(conn_par::CONCURRENCY)},
+      connection_rate {
+        a_o.connection_test_parameters.includes(conn_par::CONNECTION_RATE)
+        ? a_o.connection_test_parameters.get<int>(conn_par::CONNECTION_RATE)
+        : 0},
       rng_seed {
         a_o.connection_test_parameters.includes(conn_par::INTER_ENDPOINT_PAUSE_RNG_SEED)
         ? a_o.connection_test_parameters.get<int>(conn_par::INTER_ENDPOINT_PAUSE_RNG_SEED)
@@ -80,11 +78,20 @@ connection_test_run::connection_test_run(const application_options& a_o)
 
 connection_test_run& connection_test_run::operator++()
 {
+    return set_level(level + 1);
+}
+
+connection_test_run& connection_test_run::set_level(int new_level)
+{
+    auto delta = new_level - level;
+
     idx++;
-    num_endpoints += endpoints_increment_;
-    concurrency   += concurrency_increment_;
+    level = new_level;
+    num_endpoints += delta * endpoints_increment_;
+    concurrency   += delta * concurrency_increment_;
+    connection_rate += delta * connection_rate_increment_;
     rng_seed++;
-    total_endpoint_timeout_ms += endpoint_timeout_ms_ * endpoints_increment_;
+    total_endpoint_timeout_ms += endpoint_timeout_ms_ * delta * endpoints_increment_;
 
     return *this;
 }
@@ -95,6 +102,20 @@ std::string connection_test_run::to_string() const
             % idx % concurrency % num_endpoints).str();
 }
 
+int connection_test_run::endpoint_timeout_ms() const
+{
+    return endpoint_timeout_ms_;
+}
+
+std::string connection_test_run::to_string(bool open_loop) const
+{
+    if (!open_loop)
+        return to_string();
+
+    return (boost::format("run %1%: %2% endpoints at %3% connections/s")
+            % idx % (concurrency * num_endpoints) % connection_rate).str();
+}
+
 //
 // connection_test_result
 //
@@ -102,9 +123,13 @@ std::string connection_test_run::to_string() const
 connection_test_result::connection_test_result(const connection_test_run& run)
     : num_endpoints {run.num_endpoints},
       concurrency {run.concurrency},
+      num_attempts {run.num_endpoints * run.concurrency},
+      num_reused {0},
       num_failures {0},
       duration_ms {0},
+      timings {},
       conn_stats {},
+      failures {},
       start {std::chrono::high_resolution_clock::now()},
       completion {}
 {
@@ -117,23 +142,73 @@ void connection_test_result::set_completion()
                        completion - start).count();
 }
 
+void connection_test_result::merge(const connection_test_result& other)
+{
+    num_attempts += other.num_attempts;
+    num_reused   += other.num_reused;
+    num_failures += other.num_failures;
+    duration_ms   = std::max(duration_ms, other.duration_ms);
+    timings.merge(other.timings);
+    conn_stats = timings.get_connection_stats();
+    keepalive.merge(other.keepalive);
+
+    teardown.num_connections += other.teardown.num_connections;
+    teardown.num_failures    += other.teardown.num_failures;
+    teardown.duration_ms      = std::max(teardown.duration_ms,
+                                         other.teardown.duration_ms);
+    resources.merge(other.resources);
+    failures.merge(other.failures);
+
+    if (brokers.empty()) {
+        brokers = other.brokers;
+    } else {
+        for (std::size_t idx = 0; idx < std::min(brokers.size(), other.brokers.size()); idx++) {
+            brokers[idx].num_attempts += other.brokers[idx].num_attempts;
+            brokers[idx].num_failures += other.brokers[idx].num_failures;
+        }
+    }
+}
+
 std::ostream & operator<< (std::ostream& out, const connection_test_result& r)
 {
-    auto tot_connections = r.num_endpoints * r.concurrency;
     if (r.num_failures) {
         out << util::red("  [FAILURE]  ") << r.num_failures
             << " connection failures out of "
-            << tot_connections << " connection attempts";
+            << r.num_attempts << " connection attempts";
     } else {
-        out << util::green("  [SUCCESS]  ") << tot_connections
+        out << util::green("  [SUCCESS]  ") << r.num_attempts
             << " successful connections";
     }
 
-    out << " in " << normalizeTimeInterval(r.duration_ms);
+    if (r.num_reused)
+        out << " (" << r.num_reused << " kept from previous runs)";
+
+    out << " in " << util::normalize_time_interval(r.duration_ms);
 
     return out;
 }
 
+teardown_result::teardown_result()
+    : num_connections {0},
+      num_failures {0},
+      duration_ms {0}
+{
+}
+
+std::ostream & operator<< (std::ostream& out, const teardown_result& t_r)
+{
+    out << "  Teardown: ........... " << t_r.num_connections
+        << " connections closed in "
+        << util::normalize_time_interval(t_r.duration_ms);
+
+    if (t_r.num_failures)
+        out << "; " << util::red(std::to_string(t_r.num_failures))
+            << " failed to close";
+
+    out << "\n";
+    return out;
+}
+
 std::ofstream & operator<< (boost::nowide::ofstream& out,
                             const connection_test_result& r)
 {
@@ -151,7 +226,72 @@ std::ofstream & operator<< (boost::nowide::ofstream& out,
 
 static constexpr uint32_t DEFAULT_WS_CONNECTION_TIMEOUT_MS {1500};
 static constexpr uint32_t DEFAULT_WS_CONNECTION_CHECK_INTERVAL_S {15};
+static constexpr uint32_t DEFAULT_KEEPALIVE_THREADS {1};
 static constexpr bool DEFAULT_RANDOMIZE_PAUSE {false};
+static const std::string DEFAULT_CONNECTION_ENGINE {conn_par::THREADED_ENGINE};
+static const std::string DEFAULT_ARRIVAL_MODE {conn_par::CLOSED_LOOP_ARRIVALS};
+
+static broker_distribution get_broker_distribution(const application_options& a_o)
+{
+    const auto& p = a_o.connection_test_parameters;
+    auto policy = broker_policy::first;
+    std::vector<unsigned int> weights {};
+
+    if (p.includes(conn_par::BROKER_DISTRIBUTION)) {
+        auto name = p.get<std::string>(conn_par::BROKER_DISTRIBUTION);
+
+        if (name == conn_par::ROUND_ROBIN_BROKERS) {
+            policy = broker_policy::round_robin;
+        } else if (name == conn_par::WEIGHTED_BROKERS) {
+            policy = broker_policy::weighted;
+        } else if (name == conn_par::HASHED_BROKERS) {
+            policy = broker_policy::hash;
+        }
+    }
+
+    if (p.includes(conn_par::BROKER_WEIGHTS))
+        for (auto w : p.get<std::vector<int>>(conn_par::BROKER_WEIGHTS))
+            weights.push_back(static_cast<unsigned int>(w));
+
+    return broker_distribution {policy, a_o.broker_ws_uris.size(), std::move(weights)};
+}
+
+static constexpr unsigned int DEFAULT_HOLD_DURATION_S {300};
+static constexpr unsigned int DEFAULT_RECONNECT_CHECK_INTERVAL_MS {1000};
+static constexpr int DEFAULT_RECONNECT_BACKOFF_MS {1000};
+static constexpr int DEFAULT_RECONNECT_BACKOFF_MAX_MS {60000};
+
+static reconnect_policy get_reconnect_policy(const application_options& a_o)
+{
+    const auto& p = a_o.connection_test_parameters;
+    reconnect_policy policy {
+        backoff_policy::exponential,
+        jitter_policy::full,
+        std::chrono::milliseconds(p.includes(conn_par::RECONNECT_BACKOFF_MS)
+                                  ? p.get<int>(conn_par::RECONNECT_BACKOFF_MS)
+                                  : DEFAULT_RECONNECT_BACKOFF_MS),
+        std::chrono::milliseconds(p.includes(conn_par::RECONNECT_BACKOFF_MAX_MS)
+                                  ? p.get<int>(conn_par::RECONNECT_BACKOFF_MAX_MS)
+                                  : DEFAULT_RECONNECT_BACKOFF_MAX_MS)};
+
+    if (p.includes(conn_par::RECONNECT_BACKOFF)
+            && p.get<std::string>(conn_par::RECONNECT_BACKOFF) == conn_par::CONSTANT_BACKOFF)
+        policy.backoff = backoff_policy::constant;
+
+    if (p.includes(conn_par::RECONNECT_JITTER)) {
+        auto name = p.get<std::string>(conn_par::RECONNECT_JITTER);
+
+        if (name == conn_par::NO_JITTER) {
+            policy.jitter = jitter_policy::none;
+        } else if (name == conn_par::EQUAL_JITTER) {
+            policy.jitter = jitter_policy::equal;
+        } else if (name == conn_par::DECORRELATED_JITTER) {
+            policy.jitter = jitter_policy::decorrelated;
+        }
+    }
+
+    return policy;
+}
 
 connection_test::connection_test(const application_options& a_o)
     : app_opt_(a_o),
@@ -175,6 +315,11 @@ connection_test::connection_test(const application_options& a_o)
             ? static_cast<unsigned int>(
                 app_opt_.connection_test_parameters.get<int>(conn_par::WS_CONNECTION_CHECK_INTERVAL_S))
             : DEFAULT_WS_CONNECTION_CHECK_INTERVAL_S},
+      keepalive_threads_ {
+            app_opt_.connection_test_parameters.includes(conn_par::KEEPALIVE_THREADS)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::KEEPALIVE_THREADS))
+            : DEFAULT_KEEPALIVE_THREADS},
       association_timeout_s_ {
             app_opt_.connection_test_parameters.includes(conn_par::ASSOCIATION_TIMEOUT_S)
             ? static_cast<unsigned int>(
@@ -193,19 +338,137 @@ connection_test::connection_test(const application_options& a_o)
             app_opt_.connection_test_parameters.includes(conn_par::SHOW_STATS)
             ? app_opt_.connection_test_parameters.get<bool>(conn_par::SHOW_STATS)
             : false},
+      latency_correction_ {
+            app_opt_.connection_test_parameters.includes(conn_par::LATENCY_CORRECTION)
+            ? app_opt_.connection_test_parameters.get<bool>(conn_par::LATENCY_CORRECTION)
+            : false},
+      open_loop_ {
+            app_opt_.connection_test_parameters.includes(conn_par::ARRIVAL_MODE)
+            && app_opt_.connection_test_parameters.get<std::string>(conn_par::ARRIVAL_MODE)
+                == conn_par::OPEN_LOOP_ARRIVALS},
+      ramp_up_ms_ {
+            app_opt_.connection_test_parameters.includes(conn_par::RAMP_UP_MS)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::RAMP_UP_MS))
+            : 0},
+      incremental_ramp_ {
+            app_opt_.connection_test_parameters.includes(conn_par::INCREMENTAL_RAMP)
+            ? app_opt_.connection_test_parameters.get<bool>(conn_par::INCREMENTAL_RAMP)
+            : false},
+      teardown_parallelism_ {
+            app_opt_.connection_test_parameters.includes(conn_par::TEARDOWN_PARALLELISM)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::TEARDOWN_PARALLELISM))
+            : 0},
+      teardown_rate_ {
+            app_opt_.connection_test_parameters.includes(conn_par::TEARDOWN_RATE)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::TEARDOWN_RATE))
+            : 0},
+      capacity_search_ {
+            app_opt_.connection_test_parameters.includes(conn_par::CAPACITY_SEARCH)
+            ? app_opt_.connection_test_parameters.get<bool>(conn_par::CAPACITY_SEARCH)
+            : false},
+      max_failures_ {
+            app_opt_.connection_test_parameters.includes(conn_par::MAX_FAILURES)
+            ? app_opt_.connection_test_parameters.get<int>(conn_par::MAX_FAILURES)
+            : 0},
+      latency_slo_ms_ {
+            app_opt_.connection_test_parameters.includes(conn_par::LATENCY_SLO_MS)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::LATENCY_SLO_MS))
+            : 0},
+      reconnect_storm_ {
+            app_opt_.connection_test_parameters.includes(conn_par::RECONNECT_STORM)
+            ? app_opt_.connection_test_parameters.get<bool>(conn_par::RECONNECT_STORM)
+            : false},
+      hold_duration_s_ {
+            app_opt_.connection_test_parameters.includes(conn_par::HOLD_DURATION_S)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::HOLD_DURATION_S))
+            : DEFAULT_HOLD_DURATION_S},
+      reconnect_check_interval_ms_ {
+            app_opt_.connection_test_parameters.includes(conn_par::RECONNECT_CHECK_INTERVAL_MS)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::RECONNECT_CHECK_INTERVAL_MS))
+            : DEFAULT_RECONNECT_CHECK_INTERVAL_MS},
+      reconnect_policy_ {get_reconnect_policy(app_opt_)},
+      broker_distribution_ {get_broker_distribution(app_opt_)},
+      workers_ {
+            app_opt_.connection_test_parameters.includes(conn_par::WORKERS)
+            ? app_opt_.connection_test_parameters.get<std::vector<std::string>>(conn_par::WORKERS)
+            : std::vector<std::string> {}},
+      connection_engine_ {
+            app_opt_.connection_test_parameters.includes(conn_par::CONNECTION_ENGINE)
+            ? app_opt_.connection_test_parameters.get<std::string>(conn_par::CONNECTION_ENGINE)
+            : DEFAULT_CONNECTION_ENGINE},
+      engine_threads_ {
+            app_opt_.connection_test_parameters.includes(conn_par::ENGINE_THREADS)
+            ? static_cast<unsigned int>(
+                app_opt_.connection_test_parameters.get<int>(conn_par::ENGINE_THREADS))
+            : std::max(1u, std::thread::hardware_concurrency())},
+      scheduler_ {connection_engine_ == conn_par::POOLED_ENGINE || open_loop_
+                  ? new task_scheduler(engine_threads_)
+                  : nullptr},
       current_run_ {app_opt_},
       results_file_name_ {(boost::format("connection_test_%1%.csv")
                            % util::get_short_datetime()).str()},
       results_file_stream_ {(fs::path(app_opt_.results_dir)
                              / results_file_name_).string()},
-      keepalive_thread_ {},
-      keepalive_mtx_ {},
-      keepalive_cv_ {},
-      stop_keepalive_task_ {false}
+      results_document_ {(fs::path(app_opt_.results_dir)
+                          / (results_file_name_.substr(0, results_file_name_.size() - 4)
+                             + ".json")).string(),
+                         "connection",
+                         app_opt_,
+                         app_opt_.connection_test_parameters},
+      client_pool_ {},
+      keepalive_ptr_ {},
+      coordinator_ptr_ {},
+      live_metrics_ptr_ {},
+      live_metrics_reporter_ptr_ {},
+      event_recorder_ptr_ {},
+      resource_monitor_ptr_ {}
 {
     if (!results_file_stream_.is_open())
         throw fatal_error {((boost::format("failed to open %1%")
                              % results_file_name_).str())};
+
+    // The coordinator of a distributed test doesn't connect any client
+    const auto& p = app_opt_.connection_test_parameters;
+    auto is_coordinator = !workers_.empty()
+                          && to_test_type.at(app_opt_.test) != test_type::worker;
+
+    if (p.includes(conn_par::LIVE_METRICS) && p.get<bool>(conn_par::LIVE_METRICS)
+            && !is_coordinator) {
+        auto file_name = results_file_name_.substr(0, results_file_name_.size() - 4)
+                         + "_live.csv";
+        live_metrics_ptr_ = std::make_shared<live_metrics>();
+        live_metrics_reporter_ptr_.reset(new live_metrics_reporter(
+            *live_metrics_ptr_,
+            (fs::path(app_opt_.results_dir) / file_name).string(),
+            static_cast<unsigned short>(p.includes(conn_par::LIVE_METRICS_PORT)
+                                        ? p.get<int>(conn_par::LIVE_METRICS_PORT)
+                                        : 0),
+            p.includes(conn_par::LIVE_METRICS_BIND_ADDRESS)
+                ? p.get<std::string>(conn_par::LIVE_METRICS_BIND_ADDRESS)
+                : live_metrics_reporter::DEFAULT_BIND_ADDRESS));
+    }
+
+    if (p.includes(conn_par::EVENT_LOG) && p.get<bool>(conn_par::EVENT_LOG)
+            && !is_coordinator) {
+        auto file_name = results_file_name_.substr(0, results_file_name_.size() - 4)
+                         + "_events.bin";
+        event_recorder_ptr_ = std::make_shared<event_recorder>(
+            (fs::path(app_opt_.results_dir) / file_name).string());
+    }
+
+    if (p.includes(conn_par::RESOURCE_STATS) && p.get<bool>(conn_par::RESOURCE_STATS)
+            && !is_coordinator) {
+        auto file_name = results_file_name_.substr(0, results_file_name_.size() - 4)
+                         + "_resources.csv";
+        resource_monitor_ptr_.reset(new resource_monitor(
+            (fs::path(app_opt_.results_dir) / file_name).string()));
+    }
 }
 
 void connection_test::start()
@@ -213,37 +476,264 @@ void connection_test::start()
     auto start_time = std::chrono::system_clock::now();
     LOG_INFO("Requested %1% runs", num_runs_);
     boost::format run_msg_fmt {"Starting %1%"};
+
+    if (!workers_.empty())
+        coordinator_ptr_.reset(new worker_coordinator(workers_, app_opt_.broker_ws_uris));
+
     display_setup();
 
+    // Ramp levels go from 0 to (num runs - 1), as in a linear ramp
+    std::unique_ptr<capacity_search> search_ptr {
+        capacity_search_ ? new capacity_search(num_runs_ - 1) : nullptr};
+    std::unique_ptr<connection_test_run> passing_run_ptr {};
+    std::unique_ptr<connection_test_run> failing_run_ptr {};
+
     do {
-        boost::nowide::cout << (run_msg_fmt % current_run_.to_string()).str()
+        boost::nowide::cout << (run_msg_fmt % current_run_.to_string(open_loop_)).str()
                             << std::endl;
-        auto results = perform_current_run();
-        results_file_stream_ << results;
-        boost::nowide::cout << results;
-
-        if (show_stats_) {
-            results_file_stream_ << ",";
-            results_file_stream_ << results.conn_stats;
-            boost::nowide::cout << results.conn_stats;
+        auto results = coordinator_ptr_
+                       ? coordinator_ptr_->perform_run(current_run_)
+                       : perform_current_run(0, nullptr);
+        record_results(results);
+
+        if (search_ptr) {
+            auto passed = passes_capacity_criteria(results);
+            boost::nowide::cout << "  Capacity search: run "
+                                << (passed ? util::green("passed") : util::red("failed"))
+                                << "\n\n";
+            (passed ? passing_run_ptr : failing_run_ptr)
+                .reset(new connection_test_run(current_run_));
+
+            if (!search_ptr->next(passed))
+                break;
+
+            current_run_.set_level(search_ptr->level());
+        } else {
+            ++current_run_;
         }
 
-        results_file_stream_ << '\n';
-        boost::nowide::cout << '\n';
-        ++current_run_;
-
         if (current_run_.idx <= num_runs_) {
-            // Be nice with the broker and pause (2000 + pause * num endpoints)
-            std::this_thread::sleep_for(std::chrono::milliseconds(
-                2000 + inter_run_pause_ms_
-                       * current_run_.num_endpoints
-                       * current_run_.concurrency));
+            if (incremental_ramp_) {
+                // No connection was closed; the broker has nothing to reclaim
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(inter_run_pause_ms_));
+            } else {
+                // Be nice with the broker and pause (2000 + pause * num endpoints)
+                std::this_thread::sleep_for(std::chrono::milliseconds(
+                    2000 + inter_run_pause_ms_
+                           * current_run_.num_endpoints
+                           * current_run_.concurrency));
+            }
         }
     } while (current_run_.idx <= num_runs_);
 
+    if (incremental_ramp_) {
+        boost::nowide::cout << "Closing the connections of all runs" << std::endl;
+
+        stop_keepalive();
+
+        // Sets only matter for the default teardown parallelism
+        std::unique_ptr<connection_timings_accumulator> timings_acc_ptr {
+            show_stats_ ? new connection_timings_accumulator() : nullptr};
+        auto teardown = close_connections(
+            client_pool_.release(static_cast<std::size_t>(current_run_.concurrency)),
+            timings_acc_ptr.get());
+        boost::nowide::cout << teardown;
+
+        if (show_stats_) {
+            auto s = timings_acc_ptr->get_connection_stats().ws_close_handshake_us;
+            boost::nowide::cout
+                << "  WS Close Handshake: . mean " << s.mean / 1000
+                << " ms, std dev " << s.stddev / 1000
+                << " ms, max " << static_cast<float>(s.max) / 1000 << " ms\n";
+        }
+    }
+
+    // Workers are done
+    coordinator_ptr_.reset();
+
+    if (search_ptr)
+        display_capacity(passing_run_ptr.get(), failing_run_ptr.get());
+
     display_execution_time(start_time);
 }
 
+connection_test_result connection_test::perform_run(const connection_test_run& run,
+                                                    std::size_t first_name_idx,
+                                                    const std::function<void()>& wait_start)
+{
+    current_run_ = run;
+    boost::nowide::cout << "Starting " << current_run_.to_string(open_loop_)
+                        << " (share of a distributed run)" << std::endl;
+    auto results = perform_current_run(first_name_idx, wait_start);
+    record_results(results);
+    return results;
+}
+
+// Machine readable results; times are in ms, as for the CSV file
+
+static lth_jc::JsonContainer to_json(const stats& s, double scale)
+{
+    lth_jc::JsonContainer data {};
+    data.set<double>("mean", s.mean * scale);
+    data.set<double>("stddev", s.stddev * scale);
+    data.set<double>("max", s.max * scale);
+    data.set<double>("p50", s.p50 * scale);
+    data.set<double>("p90", s.p90 * scale);
+    data.set<double>("p99", s.p99 * scale);
+    data.set<double>("p999", s.p999 * scale);
+    return data;
+}
+
+static lth_jc::JsonContainer to_json(const connection_stats& c_s)
+{
+    lth_jc::JsonContainer data {};
+    data.set<lth_jc::JsonContainer>("tcp_ms", to_json(c_s.tcp_us, 0.001));
+    data.set<lth_jc::JsonContainer>("ws_open_handshake_ms",
+                                    to_json(c_s.ws_open_handshake_us, 0.001));
+    data.set<lth_jc::JsonContainer>("ws_close_handshake_ms",
+                                    to_json(c_s.ws_close_handshake_us, 0.001));
+    data.set<lth_jc::JsonContainer>("association_ms", to_json(c_s.association_ms, 1.0));
+    data.set<lth_jc::JsonContainer>("session_duration_ms",
+                                    to_json(c_s.session_duration_ms, 1.0));
+    data.set<lth_jc::JsonContainer>("connect_ms", to_json(c_s.connect_ms, 1.0));
+    return data;
+}
+
+// Keyed by the phase names, in snake case
+static lth_jc::JsonContainer to_json(const failure_breakdown& b)
+{
+    lth_jc::JsonContainer data {};
+
+    for (std::size_t idx = 0; idx < NUM_FAILURE_PHASES; idx++) {
+        auto key = failure_phase_name(static_cast<failure_phase>(idx));
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](char c) { return c == ' ' ? '_' : static_cast<char>(::tolower(c)); });
+        data.set<double>(key, static_cast<double>(b.counts[idx]));
+    }
+
+    return data;
+}
+
+static lth_jc::JsonContainer to_json(const connection_test_run& run,
+                                     const connection_test_result& r,
+                                     bool show_stats)
+{
+    lth_jc::JsonContainer data {};
+    data.set<int>("run", run.idx);
+    data.set<int>("num_endpoints", r.num_endpoints);
+    data.set<int>("concurrency", r.concurrency);
+    data.set<int>("connection_rate", run.connection_rate);
+    data.set<int>("rng_seed", run.rng_seed);
+    data.set<int>("num_attempts", r.num_attempts);
+    data.set<int>("num_reused", r.num_reused);
+    data.set<int>("num_failures", r.num_failures);
+    data.set<int>("duration_ms", r.duration_ms);
+    data.set<lth_jc::JsonContainer>("failures", to_json(r.failures));
+
+    if (show_stats)
+        data.set<lth_jc::JsonContainer>("stats", to_json(r.conn_stats));
+
+    std::vector<lth_jc::JsonContainer> brokers {};
+
+    for (const auto& b_r : r.brokers) {
+        lth_jc::JsonContainer broker {};
+        broker.set<std::string>("broker_ws_uri", b_r.broker_ws_uri);
+        broker.set<int>("num_attempts", b_r.num_attempts);
+        broker.set<int>("num_failures", b_r.num_failures);
+        brokers.push_back(broker);
+    }
+
+    data.set<std::vector<lth_jc::JsonContainer>>("brokers", brokers);
+
+    if (r.resources.num_samples) {
+        lth_jc::JsonContainer resources {};
+        resources.set<double>("mean_cpu_percent", r.resources.mean_cpu_percent);
+        resources.set<double>("max_cpu_percent", r.resources.max_cpu_percent);
+        resources.set<double>("max_rss_kb", static_cast<double>(r.resources.max_rss_kb));
+        resources.set<bool>("saturated", r.resources.saturated);
+        data.set<lth_jc::JsonContainer>("resources", resources);
+    }
+
+    return data;
+}
+
+// Runs are keyed by their load; throughput is in established
+// connections per second
+static run_summary get_summary(const connection_test_run& run,
+                               const connection_test_result& r,
+                               bool open_loop,
+                               bool show_stats)
+{
+    run_summary s {};
+    s.key = open_loop
+            ? (boost::format("%1%x%2%@%3%/s")
+               % r.num_endpoints % r.concurrency % run.connection_rate).str()
+            : (boost::format("%1%x%2%") % r.num_endpoints % r.concurrency).str();
+    s.throughput = r.duration_ms > 0
+                   ? (r.num_attempts - r.num_failures) * 1000.0 / r.duration_ms
+                   : 0.0;
+    s.failure_rate_pct = r.num_attempts > 0
+                         ? 100.0 * r.num_failures / r.num_attempts
+                         : 0.0;
+
+    if (show_stats) {
+        s.latencies_ms["tcp_p99"] = r.conn_stats.tcp_us.p99 / 1000.0;
+        s.latencies_ms["ws_open_handshake_p99"] =
+            r.conn_stats.ws_open_handshake_us.p99 / 1000.0;
+        s.latencies_ms["association_p50"] = r.conn_stats.association_ms.p50;
+        s.latencies_ms["association_p99"] = r.conn_stats.association_ms.p99;
+        s.latencies_ms["connect_p50"] = r.conn_stats.connect_ms.p50;
+        s.latencies_ms["connect_p99"] = r.conn_stats.connect_ms.p99;
+    }
+
+    return s;
+}
+
+void connection_test::record_results(const connection_test_result& results)
+{
+    results_document_.add_run(to_json(current_run_, results, show_stats_),
+                              get_summary(current_run_, results, open_loop_, show_stats_));
+    results_file_stream_ << results;
+    boost::nowide::cout << results;
+
+    if (show_stats_) {
+        results_file_stream_ << ",";
+        results_file_stream_ << results.conn_stats;
+        results_file_stream_ << ",";
+        results_file_stream_ << results.failures;
+        boost::nowide::cout << results.conn_stats;
+    }
+
+    if (!show_stats_)
+        boost::nowide::cout << '\n';
+
+    boost::nowide::cout << results.failures;
+
+    // NB: a monitored run has at least one sample; the results of a
+    // distributed run include the resources of the workers
+    if (results.resources.num_samples) {
+        results_file_stream_ << ",";
+        results_file_stream_ << results.resources;
+        boost::nowide::cout << results.resources;
+    }
+
+    if (broker_distribution_.policy() != broker_policy::first)
+        display_brokers(results);
+
+    if (persist_connections_)
+        boost::nowide::cout << results.keepalive;
+
+    if (reconnect_storm_)
+        boost::nowide::cout << results.reconnect;
+
+    if (!incremental_ramp_)
+        boost::nowide::cout << results.teardown;
+
+    results_file_stream_ << '\n';
+    boost::nowide::cout << '\n';
+}
+
 void connection_test::display_setup()
 {
     const auto& p = app_opt_.connection_test_parameters;
@@ -253,26 +743,218 @@ void connection_test::display_setup()
         << p.get<int>(conn_par::CONCURRENCY_INCREMENT) << " per run) of "
         << p.get<int>(conn_par::NUM_ENDPOINTS) << " endpoints (+"
         << p.get<int>(conn_par::ENDPOINTS_INCREMENT) << " per run)\n"
-        << "  " << num_runs_ << " runs, (2000 + "
-        << inter_run_pause_ms_ << " * num_endpoints) ms pause between each run\n"
-        << "  " << inter_endpoint_pause_ms_
-        << " ms pause between each set connection";
+        << "  " << num_runs_ << " runs, ";
 
-    if (randomize_pause_)
-        boost::nowide::cout << " (mean value - exp. distribution)";
+    if (capacity_search_) {
+        boost::nowide::cout
+            << "searched for the capacity (exponential ramp, then bisection), "
+            << "at most " << max_failures_ << " failures";
+
+        if (latency_slo_ms_)
+            boost::nowide::cout << " and " << latency_slo_ms_ << " ms p99 latency";
+
+        boost::nowide::cout << " per passing run\n  ";
+    }
+
+    if (incremental_ramp_) {
+        boost::nowide::cout
+            << inter_run_pause_ms_ << " ms pause between each run; connections "
+               "are kept across runs (incremental ramp)\n";
+    } else {
+        boost::nowide::cout
+            << "(2000 + " << inter_run_pause_ms_
+            << " * num_endpoints) ms pause between each run\n";
+    }
+
+    if (open_loop_) {
+        boost::nowide::cout
+            << "  open-loop arrivals at " << current_run_.connection_rate
+            << " connections/s (+"
+            << (p.includes(conn_par::CONNECTION_RATE_INCREMENT)
+                ? p.get<int>(conn_par::CONNECTION_RATE_INCREMENT)
+                : 0)
+            << " per run), " << ramp_up_ms_ << " ms ramp-up";
+
+        if (randomize_pause_)
+            boost::nowide::cout << " (Poisson process)";
+
+        boost::nowide::cout
+            << "\n  association checked " << inter_endpoint_pause_ms_
+            << " ms after each connection";
+    } else {
+        boost::nowide::cout
+            << "  " << inter_endpoint_pause_ms_
+            << " ms pause between each set connection";
+
+        if (randomize_pause_)
+            boost::nowide::cout << " (mean value - exp. distribution)";
+
+        if (latency_correction_)
+            boost::nowide::cout << "; connect latency corrected for "
+                                   "coordinated omission";
+    }
 
     boost::nowide::cout
         << "\n  WebSocket connection timeout " << ws_connection_timeout_ms_ << " ms\n"
         << "  Association timeout " << association_timeout_s_
         << " s; Association Request TTL " << association_request_ttl_s_ << " s\n"
-        << "  keep WebSocket connections alive: ";
+        << "  connection engine: ";
+
+    if (scheduler_) {
+        boost::nowide::cout << (open_loop_ ? "open-loop dispatcher, "
+                                           : "pooled, ")
+                            << scheduler_->num_threads() << " I/O threads\n";
+    } else {
+        boost::nowide::cout << "threaded, one thread per set\n";
+    }
+
+    if (coordinator_ptr_)
+        boost::nowide::cout << "  distributed: the sets of each run are split among "
+                            << coordinator_ptr_->num_workers() << " workers\n";
+
+    boost::nowide::cout << "  brokers: " << broker_distribution_.num_brokers() << " (";
+
+    switch (broker_distribution_.policy()) {
+        case broker_policy::first:
+            boost::nowide::cout << "connecting to the first one only";
+            break;
+        case broker_policy::round_robin:
+            boost::nowide::cout << "round-robin distribution";
+            break;
+        case broker_policy::weighted:
+            boost::nowide::cout << "weighted distribution";
+            break;
+        case broker_policy::hash:
+            boost::nowide::cout << "distribution by common name hash";
+            break;
+    }
+
+    boost::nowide::cout << ")\n  teardown: ";
+
+    if (teardown_parallelism_) {
+        boost::nowide::cout << teardown_parallelism_ << " concurrent closes";
+    } else {
+        boost::nowide::cout << "one thread per set";
+    }
+
+    if (teardown_rate_)
+        boost::nowide::cout << ", at most " << teardown_rate_ << " closes/s";
+
+    boost::nowide::cout
+        << "\n  keep WebSocket connections alive: ";
 
     if (persist_connections_) {
         boost::nowide::cout << "yes, by pinging every "
-                            << ws_connection_check_interval_s_ << " s\n\n";
+                            << ws_connection_check_interval_s_ << " s ("
+                            << keepalive_threads_ << " threads)\n";
+    } else {
+        boost::nowide::cout << "no\n";
+    }
+
+    if (reconnect_storm_) {
+        boost::nowide::cout
+            << "  reconnect storm: connections held for " << hold_duration_s_
+            << " s, checked every " << reconnect_check_interval_ms_ << " ms; "
+            << (reconnect_policy_.backoff == backoff_policy::constant
+                ? "constant" : "exponential")
+            << " backoff from " << reconnect_policy_.base_delay.count()
+            << " ms up to " << reconnect_policy_.max_delay.count() << " ms, ";
+
+        switch (reconnect_policy_.jitter) {
+            case jitter_policy::none:
+                boost::nowide::cout << "no jitter";
+                break;
+            case jitter_policy::full:
+                boost::nowide::cout << "full jitter";
+                break;
+            case jitter_policy::equal:
+                boost::nowide::cout << "equal jitter";
+                break;
+            case jitter_policy::decorrelated:
+                boost::nowide::cout << "decorrelated jitter";
+                break;
+        }
+
+        boost::nowide::cout << "\n";
+    }
+
+    boost::nowide::cout << "\n";
+}
+
+// Runs pass if they don't exceed the maximum number of failures and,
+// if specified, the latency SLO, both for the WebSocket opening
+// handshake and for the Association
+bool connection_test::passes_capacity_criteria(const connection_test_result& results) const
+{
+    if (results.num_failures > max_failures_)
+        return false;
+
+    if (latency_slo_ms_
+            && (results.conn_stats.ws_open_handshake_us.p99 > 1000 * latency_slo_ms_
+                || results.conn_stats.association_ms.p99 > latency_slo_ms_))
+        return false;
+
+    return true;
+}
+
+// As levels are searched, the last passing run is the highest passing
+// one, and the last failing run is the lowest failing one
+void connection_test::display_capacity(const connection_test_run* passing_run_ptr,
+                                       const connection_test_run* failing_run_ptr)
+{
+    boost::nowide::cout << "\nCapacity search: ";
+
+    if (passing_run_ptr) {
+        boost::nowide::cout
+            << util::green("highest passing level") << " with "
+            << passing_run_ptr->num_endpoints * passing_run_ptr->concurrency
+            << " connections (" << passing_run_ptr->to_string(open_loop_) << ")";
     } else {
-        boost::nowide::cout << "no\n\n";
+        boost::nowide::cout << util::red("no run passed");
     }
+
+    if (failing_run_ptr) {
+        boost::nowide::cout
+            << "\n  lowest failing level with "
+            << failing_run_ptr->num_endpoints * failing_run_ptr->concurrency
+            << " connections (" << failing_run_ptr->to_string(open_loop_) << ")";
+    } else {
+        boost::nowide::cout << "\n  the highest level of the search passed; "
+                               "increase num-runs to search further";
+    }
+
+    boost::nowide::cout << "\n";
+}
+
+// Connections and failures of each broker; the imbalance is given by
+// the ratio between the maximum and the mean number of connections
+// established by brokers with a positive share of the attempts
+void connection_test::display_brokers(const connection_test_result& results)
+{
+    int tot_connections {0};
+    int max_connections {0};
+    int num_loaded_brokers {0};
+
+    for (const auto& b_r : results.brokers) {
+        auto num_connections = b_r.num_attempts - b_r.num_failures;
+        boost::nowide::cout
+            << "  Broker " << b_r.broker_ws_uri << ": "
+            << num_connections << " connections out of "
+            << b_r.num_attempts << " attempts\n";
+
+        if (b_r.num_attempts) {
+            tot_connections += num_connections;
+            max_connections = std::max(max_connections, num_connections);
+            num_loaded_brokers++;
+        }
+    }
+
+    if (tot_connections)
+        boost::nowide::cout
+            << "  Broker imbalance (max / mean connections): "
+            << static_cast<double>(max_connections) * num_loaded_brokers
+               / tot_connections
+            << "\n";
 }
 
 void connection_test::display_execution_time(
@@ -303,10 +985,213 @@ void connection_test::display_execution_time(
 
 // Connection Task
 
+enum class connect_outcome { associated, not_associated, failed };
+
+// Connect the specified client and, if a shard is specified, accumulate
+// its WebSocket and Association timings; the attempt is also reported
+// to the live metrics and to the event recorder, if any. Failures are
+// logged and, if a recorder is specified, classified by phase.
+// The connect latency is measured from the intended start of the
+// attempt, which precedes the actual one when the attempt is late; a
+// non-zero expected interval between the attempts of the Task enables
+// the correction of the coordinated omission.
+static connect_outcome connect_client(
+        client& c,
+        connection_timings_shard* shard_ptr,
+        live_metrics* metrics_ptr,
+        event_recorder* events_ptr,
+        failure_recorder* failures_ptr,
+        const unsigned int task_id,
+        std::chrono::milliseconds pause_ms,
+        std::chrono::steady_clock::time_point intended_start,
+        uint32_t expected_interval_ms)
+{
+    auto connect_start = std::chrono::steady_clock::now();
+    auto endpoint_id = static_cast<uint32_t>(c.configuration.client_idx);
+    auto report_completion =
+        [metrics_ptr, events_ptr, &connect_start, endpoint_id](bool associated,
+                                                               bool connected)
+        {
+            auto duration = std::chrono::steady_clock::now() - connect_start;
+
+            if (metrics_ptr)
+                metrics_ptr->attempt_completed(
+                    associated,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(duration));
+
+            // Failures to connect cover both the TCP and WebSocket phases
+            if (events_ptr && !connected)
+                events_ptr->record(
+                    endpoint_id,
+                    connection_phase::ws_open_handshake,
+                    event_outcome::failure,
+                    std::chrono::duration_cast<std::chrono::microseconds>(duration));
+        };
+    auto record_failure =
+        [failures_ptr, &connect_start](failure_phase phase)
+        {
+            if (failures_ptr)
+                failures_ptr->record(
+                    phase,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - connect_start));
+        };
+
+    if (metrics_ptr)
+        metrics_ptr->attempt_started();
+
+    try {
+        c.connect(1);
+        auto connect_end = std::chrono::steady_clock::now();
+        auto associated = c.isAssociated();
+        report_completion(associated, true);
+
+        if (events_ptr) {
+            auto ws_timings = c.getConnectionTimings();
+            events_ptr->record(endpoint_id,
+                               connection_phase::tcp,
+                               event_outcome::success,
+                               std::chrono::microseconds(
+                                   ws_timings.getTCPInterval().count()));
+            events_ptr->record(endpoint_id,
+                               connection_phase::ws_open_handshake,
+                               event_outcome::success,
+                               std::chrono::microseconds(
+                                   ws_timings.getOpeningHandshakeInterval().count()));
+            events_ptr->record(endpoint_id,
+                               connection_phase::association,
+                               associated ? event_outcome::success
+                                          : event_outcome::failure,
+                               std::chrono::milliseconds(
+                                   c.getAssociationTimings()
+                                    .getAssociationInterval().count()));
+        }
+
+        if (shard_ptr) {
+            auto ws_timings = c.getConnectionTimings();
+            shard_ptr->accumulate_tcp_us(
+                    ws_timings.getTCPInterval().count());
+            shard_ptr->accumulate_ws_open_handshake_us(
+                    ws_timings.getOpeningHandshakeInterval().count());
+
+            if (associated) {
+                auto ass_timings = c.getAssociationTimings();
+                shard_ptr->accumulate_association_ms(
+                        ass_timings.getAssociationInterval().count());
+            }
+
+            auto connect_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                connect_end - intended_start).count();
+            shard_ptr->accumulate_connect_ms(
+                    static_cast<uint32_t>(std::max<int64_t>(0, connect_ms)),
+                    expected_interval_ms);
+        }
+
+        if (!associated)
+            record_failure(failure_phase::association_timeout);
+
+        return associated ? connect_outcome::associated
+                          : connect_outcome::not_associated;
+    } catch (const PCPClient::connection_association_response_failure& e) {
+        report_completion(false, true);
+        record_failure(failure_phase::association_rejected);
+        LOG_WARNING("Connection Task %1%: the Association of client %2% was "
+                    "rejected (%3%) - will wait %4% ms",
+                    task_id, c.configuration.common_name, e.what(),
+                    pause_ms.count());
+    } catch (const PCPClient::connection_association_error& e) {
+        report_completion(false, true);
+        record_failure(failure_phase::association_timeout);
+        LOG_WARNING("Connection Task %1%: client %2% failed to associate (%3%) "
+                    "- will wait %4% ms",
+                    task_id, c.configuration.common_name, e.what(),
+                    pause_ms.count());
+    } catch (const PCPClient::connection_error& e) {
+        report_completion(false, false);
+
+        if (failures_ptr) {
+            auto ws_timings = c.getConnectionTimings();
+            record_failure(classify_connect_error(
+                e.what(),
+                std::chrono::microseconds(ws_timings.getTCPInterval().count()),
+                std::chrono::microseconds(
+                    ws_timings.getOpeningHandshakeInterval().count()),
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - connect_start),
+                std::chrono::milliseconds(c.configuration.connection_timeout_ms)));
+        }
+
+        LOG_WARNING("Connection Task %1%: client %2% failed to connect (%3%) "
+                    "- will wait %4% ms",
+                    task_id, c.configuration.common_name, e.what(),
+                    pause_ms.count());
+    } catch (const std::exception& e) {
+        report_completion(false, false);
+        record_failure(failure_phase::other);
+        LOG_WARNING("Connection Task %1%: unexpected error for client %2% "
+                    "(%3%) - will wait %4% ms",
+                    task_id, c.configuration.common_name, e.what(),
+                    pause_ms.count());
+    }
+
+    return connect_outcome::failed;
+}
+
+// Once the pause following connect() has elapsed, the client must
+// still be associated for success
+static bool is_associated_after_pause(client& c,
+                                      connect_outcome outcome,
+                                      live_metrics* metrics_ptr,
+                                      failure_recorder* failures_ptr,
+                                      const unsigned int task_id,
+                                      std::chrono::milliseconds pause_ms)
+{
+    if (outcome == connect_outcome::associated && c.isAssociated())
+        return true;
+
+    if (metrics_ptr)
+        metrics_ptr->attempt_failed();
+
+    if (outcome == connect_outcome::failed)
+        return false;
+
+    // Failures to associate were classified by connect_client()
+    if (failures_ptr && outcome == connect_outcome::associated)
+        failures_ptr->record(
+            failure_phase::dropped_after_association,
+            std::chrono::milliseconds(
+                c.getAssociationTimings().getOverallSessionInterval_ms().count()));
+
+    LOG_WARNING("Connection Task %1%: client %2% is not associated "
+                "after %3% ms",
+                task_id, c.configuration.common_name, pause_ms.count());
+    return false;
+}
+
+static void accumulate_session_durations(
+        const std::vector<std::shared_ptr<client>>& client_ptrs,
+        connection_timings_shard* shard_ptr)
+{
+    if (!shard_ptr)
+        return;
+
+    for (auto &e_p : client_ptrs) {
+        if (e_p->isAssociated()) {
+            auto ass_timings = e_p->getAssociationTimings();
+            shard_ptr->accumulate_session_duration_ms(
+                    ass_timings.getOverallSessionInterval_ms().count());
+        }
+    }
+}
+
 int connect_clients_serially(std::vector<std::shared_ptr<client>> client_ptrs,
                              std::vector<uint32_t> pauses_ms,
                              bool randomize,
                              std::shared_ptr<connection_timings_accumulator> timings_acc_ptr,
+                             std::shared_ptr<live_metrics> metrics_ptr,
+                             std::shared_ptr<event_recorder> events_ptr,
+                             std::shared_ptr<failure_recorder> failures_ptr,
+                             bool correct_latency,
                              const unsigned int task_id)
 {
     assert(pauses_ms.size() > 0);
@@ -316,9 +1201,12 @@ int connect_clients_serially(std::vector<std::shared_ptr<client>> client_ptrs,
 
     int num_failures {0};
     auto start = std::chrono::system_clock::now();
-    bool associated;
     int idx {0};
 
+    // Timings are accumulated without locking, in a shard owned by this Task
+    std::shared_ptr<connection_timings_shard> shard_ptr {
+        timings_acc_ptr ? timings_acc_ptr->get_shard() : nullptr};
+
     // Initialize and use the constant pause value, if we're not randomizing
     std::chrono::milliseconds pause_ms {pauses_ms[0]};
 
@@ -326,74 +1214,406 @@ int connect_clients_serially(std::vector<std::shared_ptr<client>> client_ptrs,
         if (randomize)
             pause_ms = std::chrono::milliseconds(pauses_ms[idx++]);
 
-        try {
-            e_p->connect(1);
-            associated = e_p->isAssociated();
-
-            if (timings_acc_ptr) {
-                auto ws_timings = e_p->getConnectionTimings();
-                timings_acc_ptr->accumulate_tcp_us(
-                        ws_timings.getTCPInterval().count());
-                timings_acc_ptr->accumulate_ws_open_handshake_us(
-                        ws_timings.getOpeningHandshakeInterval().count());
-
-                if (associated) {
-                    auto ass_timings = e_p->getAssociationTimings();
-                    timings_acc_ptr->accumulate_association_ms(
-                            ass_timings.getAssociationInterval().count());
-                }
-            }
-
-            std::this_thread::sleep_for(pause_ms);
-
-            // Must still be associated after the pause for success
-            associated &= e_p->isAssociated();
-
-            if (!associated) {
-                LOG_WARNING("Connection Task %1%: client %2% is not associated "
-                            "after %3% ms",
-                            task_id, e_p->configuration.common_name, pause_ms.count());
-                num_failures++;
-            }
-        } catch (const PCPClient::connection_error& e) {
-            LOG_WARNING("Connection Task %1%: client %2% failed to connect (%3%) "
-                        "- will wait %4% ms",
-                        task_id, e_p->configuration.common_name, e.what(),
-                        pause_ms.count());
+        uint32_t expected_interval_ms =
+            correct_latency ? static_cast<uint32_t>(pause_ms.count()) : 0;
+        auto outcome = connect_client(*e_p, shard_ptr.get(), metrics_ptr.get(),
+                                      events_ptr.get(), failures_ptr.get(),
+                                      task_id, pause_ms,
+                                      std::chrono::steady_clock::now(),
+                                      expected_interval_ms);
+        std::this_thread::sleep_for(pause_ms);
+
+        if (!is_associated_after_pause(*e_p, outcome, metrics_ptr.get(),
+                                       failures_ptr.get(), task_id, pause_ms))
             num_failures++;
-            std::this_thread::sleep_for(pause_ms);
-        } catch (const std::exception& e) {
-            LOG_WARNING("Connection Task %1%: unexpected error for client %2% "
-                        "(%3%) - will wait %4% ms",
-                        task_id, e_p->configuration.common_name, e.what(),
-                        pause_ms.count());
-            num_failures++;
-            std::this_thread::sleep_for(pause_ms);
-        }
     }
 
-    for (auto &e_p : client_ptrs) {
-        if (timings_acc_ptr && e_p->isAssociated()) {
-            auto ass_timings = e_p->getAssociationTimings();
-            timings_acc_ptr->accumulate_session_duration_ms(
-                    ass_timings.getOverallSessionInterval_ms().count());
-        }
-    }
+    accumulate_session_durations(client_ptrs, shard_ptr.get());
+
+    if (shard_ptr)
+        shard_ptr->seal();
 
     auto d = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now() - start).count();
     LOG_INFO("Connection Task %1%: completed in %2%",
-             task_id, normalizeTimeInterval(d));
+             task_id, util::normalize_time_interval(d));
     return num_failures;
 }
 
+// Pooled Connection Task
+//
+// Same semantics of connect_clients_serially(), but the Task does
+// not own a thread: each connection step is executed by a worker of
+// the task_scheduler, whereas the inter-endpoint pause is modeled by
+// scheduling the association check, so that waiting sets do not
+// occupy any thread.
+
+class pooled_connection_task
+    : public std::enable_shared_from_this<pooled_connection_task>
+{
+  public:
+    pooled_connection_task(task_scheduler& scheduler,
+                           std::vector<std::shared_ptr<client>> client_ptrs,
+                           std::vector<uint32_t> pauses_ms,
+                           bool randomize,
+                           std::shared_ptr<connection_timings_accumulator> timings_acc_ptr,
+                           std::shared_ptr<live_metrics> metrics_ptr,
+                           std::shared_ptr<event_recorder> events_ptr,
+                           std::shared_ptr<failure_recorder> failures_ptr,
+                           bool correct_latency,
+                           const unsigned int task_id)
+        : scheduler_(scheduler),
+          client_ptrs_ {std::move(client_ptrs)},
+          pauses_ms_ {std::move(pauses_ms)},
+          randomize_ {randomize},
+          shard_ptr_ {timings_acc_ptr ? timings_acc_ptr->get_shard() : nullptr},
+          metrics_ptr_ {std::move(metrics_ptr)},
+          events_ptr_ {std::move(events_ptr)},
+          failures_ptr_ {std::move(failures_ptr)},
+          correct_latency_ {correct_latency},
+          task_id_ {task_id},
+          idx_ {0},
+          num_failures_ {0},
+          cancelled_ {false},
+          start_ {},
+          promise_ {}
+    {
+        assert(pauses_ms_.size() > 0);
+
+        if (pauses_ms_.size() > 1)
+            assert(pauses_ms_.size() == client_ptrs_.size());
+    }
+
+    std::future<int> start()
+    {
+        auto f = promise_.get_future();
+        start_ = std::chrono::system_clock::now();
+        auto self = shared_from_this();
+        scheduler_.schedule([self]() { self->connect_next(); });
+        return f;
+    }
+
+    // Stop scheduling connection steps; the Task will not complete
+    void cancel()
+    {
+        cancelled_ = true;
+    }
+
+  private:
+    task_scheduler& scheduler_;
+    std::vector<std::shared_ptr<client>> client_ptrs_;
+    std::vector<uint32_t> pauses_ms_;
+    bool randomize_;
+    std::shared_ptr<connection_timings_shard> shard_ptr_;
+    std::shared_ptr<live_metrics> metrics_ptr_;
+    std::shared_ptr<event_recorder> events_ptr_;
+    std::shared_ptr<failure_recorder> failures_ptr_;
+    bool correct_latency_;
+    const unsigned int task_id_;
+    std::size_t idx_;
+    int num_failures_;
+    std::atomic<bool> cancelled_;
+    std::chrono::system_clock::time_point start_;
+    std::promise<int> promise_;
+
+    void connect_next()
+    {
+        if (cancelled_)
+            return;
+
+        if (idx_ == client_ptrs_.size()) {
+            complete();
+            return;
+        }
+
+        std::chrono::milliseconds pause_ms {
+            pauses_ms_[randomize_ ? idx_ : 0]};
+        uint32_t expected_interval_ms =
+            correct_latency_ ? static_cast<uint32_t>(pause_ms.count()) : 0;
+        auto outcome = connect_client(*client_ptrs_[idx_], shard_ptr_.get(),
+                                      metrics_ptr_.get(), events_ptr_.get(),
+                                      failures_ptr_.get(), task_id_, pause_ms,
+                                      std::chrono::steady_clock::now(),
+                                      expected_interval_ms);
+        auto self = shared_from_this();
+        scheduler_.schedule_after(
+            pause_ms,
+            [self, outcome, pause_ms]() {
+                self->check_association(outcome, pause_ms);
+            });
+    }
+
+    void check_association(connect_outcome outcome,
+                           std::chrono::milliseconds pause_ms)
+    {
+        if (!is_associated_after_pause(*client_ptrs_[idx_], outcome,
+                                       metrics_ptr_.get(), failures_ptr_.get(),
+                                       task_id_, pause_ms))
+            num_failures_++;
+
+        idx_++;
+        connect_next();
+    }
+
+    void complete()
+    {
+        accumulate_session_durations(client_ptrs_, shard_ptr_.get());
+
+        if (shard_ptr_)
+            shard_ptr_->seal();
+
+        auto d = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now() - start_).count();
+        LOG_INFO("Connection Task %1%: completed in %2%",
+                 task_id_, util::normalize_time_interval(d));
+        promise_.set_value(num_failures_);
+    }
+};
+
+// Open-loop Connection Task
+//
+// Connection attempts are dispatched at the arrival times given by
+// the rate schedule of the run, independently of the completion of
+// previous attempts, so that the offered load does not drop when the
+// broker slows down. Each dispatch step schedules the next arrival
+// before executing its connection attempt; the association is then
+// checked once the inter-endpoint pause has elapsed.
+
+class open_loop_connection_task
+    : public std::enable_shared_from_this<open_loop_connection_task>
+{
+  public:
+    open_loop_connection_task(task_scheduler& scheduler,
+                              std::vector<std::shared_ptr<client>> client_ptrs,
+                              std::vector<std::chrono::microseconds> arrival_offsets,
+                              std::chrono::milliseconds pause_ms,
+                              std::shared_ptr<connection_timings_accumulator> timings_acc_ptr,
+                              std::shared_ptr<live_metrics> metrics_ptr,
+                              std::shared_ptr<event_recorder> events_ptr,
+                              std::shared_ptr<failure_recorder> failures_ptr)
+        : scheduler_(scheduler),
+          client_ptrs_ {std::move(client_ptrs)},
+          arrival_offsets_ {std::move(arrival_offsets)},
+          pause_ms_ {pause_ms},
+          shard_ptrs_ {},
+          metrics_ptr_ {std::move(metrics_ptr)},
+          events_ptr_ {std::move(events_ptr)},
+          failures_ptr_ {std::move(failures_ptr)},
+          num_pending_ {client_ptrs_.size()},
+          num_failures_ {0},
+          max_lag_us_ {0},
+          cancelled_ {false},
+          start_ {},
+          promise_ {}
+    {
+        assert(arrival_offsets_.size() == client_ptrs_.size());
+
+        // Attempts are executed concurrently; use a shard per worker
+        if (timings_acc_ptr)
+            for (unsigned int idx = 0; idx < scheduler_.num_threads(); idx++)
+                shard_ptrs_.push_back(timings_acc_ptr->get_shard());
+    }
+
+    std::future<int> start()
+    {
+        auto f = promise_.get_future();
+        start_ = task_scheduler::clock_type::now();
+
+        if (client_ptrs_.empty()) {
+            promise_.set_value(0);
+        } else {
+            auto self = shared_from_this();
+            scheduler_.schedule_at(start_ + arrival_offsets_[0],
+                                   [self]() { self->dispatch(0); });
+        }
+
+        return f;
+    }
+
+    // Stop dispatching connection attempts; the Task will not complete
+    void cancel()
+    {
+        cancelled_ = true;
+    }
+
+    // Failed attempts plus the ones that have not completed yet
+    int num_unsuccessful() const
+    {
+        return num_failures_.load() + static_cast<int>(num_pending_.load());
+    }
+
+  private:
+    task_scheduler& scheduler_;
+    std::vector<std::shared_ptr<client>> client_ptrs_;
+    std::vector<std::chrono::microseconds> arrival_offsets_;
+    std::chrono::milliseconds pause_ms_;
+    std::vector<std::shared_ptr<connection_timings_shard>> shard_ptrs_;
+    std::shared_ptr<live_metrics> metrics_ptr_;
+    std::shared_ptr<event_recorder> events_ptr_;
+    std::shared_ptr<failure_recorder> failures_ptr_;
+    std::atomic<std::size_t> num_pending_;
+    std::atomic<int> num_failures_;
+    std::atomic<int64_t> max_lag_us_;
+    std::atomic<bool> cancelled_;
+    task_scheduler::clock_type::time_point start_;
+    std::promise<int> promise_;
+
+    void dispatch(std::size_t idx)
+    {
+        if (cancelled_)
+            return;
+
+        auto self = shared_from_this();
+
+        if (idx + 1 < client_ptrs_.size())
+            scheduler_.schedule_at(start_ + arrival_offsets_[idx + 1],
+                                   [self, idx]() { self->dispatch(idx + 1); });
+
+        // The dispatch may be late if all workers were busy
+        int64_t lag_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            task_scheduler::clock_type::now() - start_ - arrival_offsets_[idx]).count();
+        auto max_lag_us = max_lag_us_.load();
+        while (lag_us > max_lag_us
+               && !max_lag_us_.compare_exchange_weak(max_lag_us, lag_us)) {}
+
+        // Measured from the arrival time, so that the lag is included
+        auto outcome = connect_client(*client_ptrs_[idx], worker_shard(),
+                                      metrics_ptr_.get(), events_ptr_.get(),
+                                      failures_ptr_.get(), 0, pause_ms_,
+                                      start_ + arrival_offsets_[idx], 0);
+        scheduler_.schedule_after(
+            pause_ms_,
+            [self, idx, outcome]() { self->check_association(idx, outcome); });
+    }
+
+    void check_association(std::size_t idx, connect_outcome outcome)
+    {
+        if (!is_associated_after_pause(*client_ptrs_[idx], outcome,
+                                       metrics_ptr_.get(), failures_ptr_.get(),
+                                       0, pause_ms_))
+            num_failures_++;
+
+        if (--num_pending_ == 0)
+            complete();
+    }
+
+    connection_timings_shard* worker_shard()
+    {
+        auto w_idx = task_scheduler::worker_index();
+        assert(w_idx >= 0);
+        return shard_ptrs_.empty() ? nullptr : shard_ptrs_[w_idx].get();
+    }
+
+    void complete()
+    {
+        // All attempts have completed; the shards of other workers
+        // are no longer modified
+        accumulate_session_durations(client_ptrs_, worker_shard());
+
+        for (auto& shard_ptr : shard_ptrs_)
+            shard_ptr->seal();
+
+        auto d = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    task_scheduler::clock_type::now() - start_).count();
+        auto max_lag_ms = max_lag_us_.load() / 1000;
+        LOG_INFO("Open-loop Connection Task: completed in %1%; maximum "
+                 "dispatch lag %2% ms", util::normalize_time_interval(d), max_lag_ms);
+
+        if (max_lag_ms > pause_ms_.count())
+            LOG_WARNING("Open-loop Connection Task: connection attempts were "
+                        "dispatched up to %1% ms late; the offered load was "
+                        "lower than requested (consider increasing %2%)",
+                        max_lag_ms, conn_par::ENGINE_THREADS);
+
+        promise_.set_value(num_failures_.load());
+    }
+};
+
 static const std::string CONNECTION_TEST_CLIENT_TYPE {"CONNECTION_TEST_CLIENT"};
 
-connection_test_result connection_test::perform_current_run()
+// Instantiate the clients with the specified names, split in chunks
+// that are built concurrently by the specified scheduler or, if none,
+// by a temporary pool of workers; that's worth it as each client loads
+// its certificate files. The broker of each client is determined by
+// its index, starting from first_client_idx. Client configuration
+// errors are rethrown.
+static std::vector<std::shared_ptr<client>> build_clients(
+        const std::vector<std::string>& names,
+        std::size_t first_client_idx,
+        const broker_distribution& distribution,
+        const client_configuration& c_cfg,
+        task_scheduler* scheduler_ptr)
+{
+    std::unique_ptr<task_scheduler> pool_ptr {};
+
+    if (!scheduler_ptr) {
+        pool_ptr.reset(new task_scheduler());
+        scheduler_ptr = pool_ptr.get();
+    }
+
+    std::vector<std::shared_ptr<client>> client_ptrs(names.size());
+    std::size_t chunk_size {
+        std::max<std::size_t>(1, names.size() / (4 * scheduler_ptr->num_threads()))};
+    std::vector<std::future<void>> futures {};
+
+    for (std::size_t first = 0; first < names.size(); first += chunk_size) {
+        auto last = std::min(names.size(), first + chunk_size);
+        auto promise_ptr = std::make_shared<std::promise<void>>();
+        futures.push_back(promise_ptr->get_future());
+
+        scheduler_ptr->schedule(
+            [&names, &client_ptrs, &distribution, &c_cfg,
+             first_client_idx, first, last, promise_ptr]()
+            {
+                try {
+                    auto cfg = c_cfg;
+
+                    for (auto idx = first; idx < last; idx++) {
+                        cfg.common_name = names[idx];
+                        cfg.client_idx  = first_client_idx + idx;
+                        cfg.broker_idx  = distribution.get_broker(
+                                              first_client_idx + idx, names[idx]);
+                        cfg.update_cert_paths();
+                        client_ptrs[idx] = std::make_shared<client>(cfg);
+                    }
+
+                    promise_ptr->set_value();
+                } catch (...) {
+                    promise_ptr->set_exception(std::current_exception());
+                }
+            });
+    }
+
+    // NB: wait for all chunks before rethrowing any error, as tasks
+    // refer to the above containers
+    for (auto& f : futures)
+        f.wait();
+
+    for (auto& f : futures)
+        f.get();
+
+    return client_ptrs;
+}
+
+connection_test_result connection_test::perform_current_run(
+        std::size_t first_name_idx,
+        const std::function<void()>& wait_start)
 {
     connection_test_result results {current_run_};
     std::shared_ptr<connection_timings_accumulator> timings_acc_ptr {nullptr};
 
+    // Tasks of a previous run that timed out keep their own recorder
+    auto failures_ptr = std::make_shared<failure_recorder>();
+
+    if (live_metrics_ptr_)
+        live_metrics_ptr_->set_run(current_run_.idx);
+
+    if (event_recorder_ptr_)
+        event_recorder_ptr_->set_run(current_run_.idx);
+
+    if (resource_monitor_ptr_)
+        resource_monitor_ptr_->start_run(current_run_.idx);
+
     if (show_stats_)
         timings_acc_ptr.reset(new connection_timings_accumulator());
 
@@ -405,6 +1625,11 @@ connection_test_result connection_test::perform_current_run()
     uint32_t max_tot_pause_ms {0};
     std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs {};
     std::vector<std::future<int>> task_futures {};
+    std::vector<std::shared_ptr<pooled_connection_task>> pooled_tasks {};
+    std::shared_ptr<open_loop_connection_task> open_loop_task_ptr {nullptr};
+
+    // In case of open-loop arrivals, the RNG models interarrivals
+    bool random_pauses = randomize_pause_ && !open_loop_;
     client_configuration c_cfg {"0000agent",
                                 CONNECTION_TEST_CLIENT_TYPE,
                                 app_opt_.broker_ws_uris,
@@ -413,18 +1638,6 @@ connection_test_result connection_test::perform_current_run()
                                 association_timeout_s_,
                                 association_request_ttl_s_};
 
-    // Spawn concurrent Connection Tasks
-
-    auto add_client =
-        [&c_cfg] (std::string name,
-                  std::vector<std::shared_ptr<client>>& task_client_ptrs) -> void
-        {
-            c_cfg.common_name = name;
-            c_cfg.update_cert_paths();
-            auto c_ptr = std::make_shared<client>(c_cfg);
-            task_client_ptrs.push_back(c_ptr);
-        };
-
     auto agents_it       = app_opt_.agents.begin();
     auto agents_end      = app_opt_.agents.end();
     auto controllers_it  = app_opt_.controllers.begin();
@@ -447,39 +1660,140 @@ connection_test_result connection_test::perform_current_run()
             return name;
         };
 
+    // In incremental ramp mode, only the clients that are not yet part
+    // of the pool are instantiated; pooled clients that lost their
+    // association are connected again
+
+    // Workers of a distributed test get their own range of names
+    for (std::size_t idx = 0; idx < first_name_idx; idx++)
+        get_name();
+
+    std::vector<std::shared_ptr<client>> attempt_client_ptrs {};
+    int num_pooled {0};
+
+    if (incremental_ramp_) {
+        attempt_client_ptrs = client_pool_.get_unassociated_clients();
+        num_pooled = static_cast<int>(client_pool_.size());
+        results.num_reused = num_pooled - static_cast<int>(attempt_client_ptrs.size());
+
+        // Pooled clients got the first names
+        for (auto idx = 0; idx < num_pooled; idx++)
+            get_name();
+    }
+
+    std::vector<std::string> new_names {};
+
+    for (auto idx = num_pooled;
+         idx < current_run_.concurrency * current_run_.num_endpoints;
+         idx++)
+        new_names.push_back(get_name());
+
+    // Instantiate the clients concurrently; the time to do so is not
+    // included in the time to establish the connections
+
+    std::vector<std::shared_ptr<client>> new_client_ptrs {};
+
+    if (!new_names.empty()) {
+        new_client_ptrs = build_clients(new_names,
+                                        first_name_idx + static_cast<std::size_t>(num_pooled),
+                                        broker_distribution_,
+                                        c_cfg,
+                                        scheduler_.get());
+        attempt_client_ptrs.insert(attempt_client_ptrs.end(),
+                                   new_client_ptrs.begin(), new_client_ptrs.end());
+
+        if (incremental_ramp_)
+            client_pool_.add(new_client_ptrs);
+    }
+
+    results.num_attempts = static_cast<int>(attempt_client_ptrs.size());
+
+    if (wait_start)
+        wait_start();
+
+    results.start = std::chrono::high_resolution_clock::now();
+
+    // Split the clients in sets and assign their pauses
+
+    std::vector<std::vector<uint32_t>> all_pauses_ms {};
+    auto min_set_size = results.num_attempts / current_run_.concurrency;
+    auto num_larger_sets = results.num_attempts % current_run_.concurrency;
+    auto c_itr = attempt_client_ptrs.begin();
+    int max_set_size {0};
+
     for (auto task_idx = 0; task_idx < current_run_.concurrency; task_idx++) {
-        std::vector<std::shared_ptr<client>> task_client_ptrs {};
+        auto set_size = min_set_size + (task_idx < num_larger_sets ? 1 : 0);
         std::vector<uint32_t> pauses_ms {};
         uint32_t tot_pause_ms {0};
 
-        for (auto idx = 0; idx < current_run_.num_endpoints; idx++) {
-            add_client(get_name(), task_client_ptrs);
+        if (max_set_size < set_size)
+            max_set_size = set_size;
+
+        all_clients_ptrs.emplace_back(c_itr, c_itr + set_size);
+        c_itr += set_size;
 
-            if (randomize_pause_) {
+        if (random_pauses) {
+            for (auto idx = 0; idx < set_size; idx++) {
                 auto p = (*rng_ptr)();
                 tot_pause_ms += p;
                 pauses_ms.push_back(std::move(p));
             }
-        }
 
-        if (randomize_pause_) {
             if (max_tot_pause_ms < tot_pause_ms)
                 max_tot_pause_ms = tot_pause_ms;
         } else {
-            if (tot_pause_ms == 0) {
-                // Push just one value in case of constant pause;
-                // the Connection Task will figure it out
-                pauses_ms.push_back(inter_endpoint_pause_ms_);
-                tot_pause_ms = current_run_.num_endpoints * inter_endpoint_pause_ms_;
+            // Push just one value in case of constant pause;
+            // the Connection Task will figure it out
+            pauses_ms.push_back(inter_endpoint_pause_ms_);
+            tot_pause_ms = set_size * inter_endpoint_pause_ms_;
+
+            if (max_tot_pause_ms < tot_pause_ms)
                 max_tot_pause_ms = tot_pause_ms;
-            }
         }
 
-        // Copy client pointers so this thread, or the Keep Alive one,
-        // will be in charge of destroying them, otherwise we would
+        all_pauses_ms.push_back(std::move(pauses_ms));
+    }
+
+    // Spawn concurrent Connection Tasks
+
+    std::vector<int> task_sizes {};
+
+    for (auto task_idx = 0; task_idx < current_run_.concurrency; task_idx++) {
+        // Copy client pointers so this thread will be in charge of
+        // destroying them, otherwise we would
         // include the close handshake times when reporting the
         // overall time to connect
-        all_clients_ptrs.emplace_back(task_client_ptrs);
+        auto task_client_ptrs = all_clients_ptrs[task_idx];
+        auto& pauses_ms = all_pauses_ms[task_idx];
+
+        // Open-loop attempts are dispatched once all sets are populated
+        if (open_loop_)
+            break;
+
+        // Sets can be empty in incremental ramp mode
+        if (task_client_ptrs.empty())
+            continue;
+
+        task_sizes.push_back(static_cast<int>(task_client_ptrs.size()));
+
+        if (connection_engine_ == conn_par::POOLED_ENGINE) {
+            auto t_ptr = std::make_shared<pooled_connection_task>(
+                            *scheduler_,
+                            std::move(task_client_ptrs),
+                            std::move(pauses_ms),
+                            random_pauses,
+                            timings_acc_ptr,
+                            live_metrics_ptr_,
+                            event_recorder_ptr_,
+                            failures_ptr,
+                            latency_correction_,
+                            task_idx);
+            task_futures.push_back(t_ptr->start());
+            pooled_tasks.push_back(std::move(t_ptr));
+            LOG_DEBUG("Run #%1% - scheduled Connection Task %2%",
+                      current_run_.idx, task_idx + 1);
+            continue;
+        }
 
         try {
             task_futures.push_back(
@@ -487,8 +1801,12 @@ connection_test_result connection_test::perform_current_run()
                            &connect_clients_serially,
                            std::move(task_client_ptrs),
                            std::move(pauses_ms),
-                           randomize_pause_,
+                           random_pauses,
                            timings_acc_ptr,
+                           live_metrics_ptr_,
+                           event_recorder_ptr_,
+                           failures_ptr,
+                           latency_correction_,
                            task_idx));
             LOG_DEBUG("Run #%1% - started Connection Task %2%",
                       current_run_.idx, task_idx + 1);
@@ -501,32 +1819,59 @@ connection_test_result connection_test::perform_current_run()
         }
     }
 
+    if (open_loop_) {
+        std::vector<std::shared_ptr<client>> arrival_client_ptrs {};
+
+        for (const auto& t_c_ptrs : all_clients_ptrs)
+            arrival_client_ptrs.insert(arrival_client_ptrs.end(),
+                                       t_c_ptrs.begin(), t_c_ptrs.end());
+
+        std::unique_ptr<exponential_integers> unit_rng_ptr {
+            randomize_pause_
+            ? new exponential_integers(1, current_run_.rng_seed, 1000000)
+            : nullptr};
+        auto arrival_offsets = get_arrival_offsets(
+            static_cast<int>(arrival_client_ptrs.size()),
+            current_run_.connection_rate,
+            std::chrono::milliseconds(ramp_up_ms_),
+            unit_rng_ptr.get());
+
+        // The last arrival plus the association check determine the
+        // total pause
+        max_tot_pause_ms = inter_endpoint_pause_ms_
+                           + (arrival_offsets.empty()
+                              ? 0
+                              : static_cast<uint32_t>(
+                                  arrival_offsets.back().count() / 1000));
+
+        open_loop_task_ptr = std::make_shared<open_loop_connection_task>(
+                                *scheduler_,
+                                std::move(arrival_client_ptrs),
+                                std::move(arrival_offsets),
+                                std::chrono::milliseconds(inter_endpoint_pause_ms_),
+                                timings_acc_ptr,
+                                live_metrics_ptr_,
+                                event_recorder_ptr_,
+                                failures_ptr);
+        task_futures.push_back(open_loop_task_ptr->start());
+        LOG_DEBUG("Run #%1% - started open-loop Connection Task", current_run_.idx);
+    }
+
     // Display timeout (the total pause may have ben randomized)
 
-    auto timeout_ms = max_tot_pause_ms + current_run_.total_endpoint_timeout_ms;
+    auto timeout_ms = max_tot_pause_ms
+                      + current_run_.endpoint_timeout_ms() * max_set_size;
     std::chrono::seconds timeout_s {timeout_ms / 1000};
 
     boost::nowide::cout << "                timeout for establishing all connections "
-                        << normalizeTimeInterval(timeout_ms)
+                        << util::normalize_time_interval(timeout_ms)
                         << std::endl;
 
-    // Start the Keep Alive Task
+    // Keep connections alive; in incremental ramp mode, the pooled
+    // clients are pinged until the end of the test
 
-    if (persist_connections_) {
-        stop_keepalive_task_ = false;
-
-        try {
-            keepalive_thread_ = std::thread {&connection_test::keepalive_task,
-                                             this,
-                                             std::move(all_clients_ptrs)};
-        } catch (std::exception& e) {
-            boost::nowide::cout
-            << "\n" << util::red("   [ERROR]   ")
-            << "failed to start Keep Alive Task - thread error: "
-            << e.what() << "\n";
-            throw fatal_error { "failed to start Keep Alive Task thread" };
-        }
-    }
+    if (persist_connections_)
+        keep_alive(new_client_ptrs);
 
     // Wait for threads to complete and get the number of failures (as futures)
 
@@ -541,134 +1886,307 @@ connection_test_result connection_test::perform_current_run()
         if (task_futures[thread_idx].wait_for(timeout) != std::future_status::ready) {
             LOG_WARNING("Run #%1% - Connection Task %2% timed out",
                         current_run_.idx, thread_idx);
-            results.num_failures += current_run_.num_endpoints;
+            results.num_failures += open_loop_task_ptr
+                                    ? open_loop_task_ptr->num_unsuccessful()
+                                    : task_sizes[thread_idx];
         } else {
             try {
                 results.num_failures += task_futures[thread_idx].get();
             } catch (std::exception& e) {
                 LOG_WARNING("Run #%1% - Connection Task %2% failure: %3%",
                             current_run_.idx, thread_idx, e.what());
-                results.num_failures += current_run_.num_endpoints;
+                results.num_failures += open_loop_task_ptr
+                                        ? results.num_attempts
+                                        : task_sizes[thread_idx];
             }
         }
     }
 
+    // The failures that were not classified are the attempts that timed
+    // out Tasks did not complete, or that failed Tasks did not perform
+    results.failures = failures_ptr->get_breakdown();
+    auto num_classified = results.failures.total();
+
+    if (static_cast<uint64_t>(results.num_failures) > num_classified)
+        results.failures.add(failure_phase::task_timeout,
+                             results.num_failures - num_classified);
+
+    // Timed out pooled Tasks must not keep the scheduler's workers busy
+    for (auto& t_ptr : pooled_tasks)
+        t_ptr->cancel();
+
+    if (open_loop_task_ptr)
+        open_loop_task_ptr->cancel();
+
     // Report completion and get timing stats
 
-    boost::nowide::cout << "                done - "
-                           "closing connections and retrieving results"
+    boost::nowide::cout << (incremental_ramp_
+                            ? "                done - retrieving results"
+                            : "                done - "
+                              "closing connections and retrieving results")
                         << std::endl;
     results.set_completion();
 
-    if (show_stats_)
-        results.conn_stats = timings_acc_ptr->get_connection_stats();
+    // Per broker breakdown of the attempts
 
-    LOG_INFO("Run #%1% - got Connection Task results; about to close connections",
-             current_run_.idx);
+    for (const auto& uri : app_opt_.broker_ws_uris)
+        results.brokers.push_back(broker_result {uri, 0, 0});
 
-    // Close connections
+    for (const auto& c_ptr : attempt_client_ptrs) {
+        auto& b_r = results.brokers[c_ptr->configuration.broker_idx];
+        b_r.num_attempts++;
 
-    if (persist_connections_) {
-        // Stop the Keepalive Task
-        assert(all_clients_ptrs.empty());
-        stop_keepalive_task_ = true;
-        keepalive_cv_.notify_one();
-
-        if (keepalive_thread_.joinable()) {
-            keepalive_thread_.join();
-            LOG_INFO("Run #%1% - Keep Alive Task completed", current_run_.idx);
-        } else {
-            LOG_ERROR("The Keep Alive Task thread is not joinable");
-        }
+        if (!c_ptr->isAssociated())
+            b_r.num_failures++;
+    }
+
+    if (incremental_ramp_) {
+        // Connections of the pool are kept for the next run
+        LOG_INFO("Run #%1% - got Connection Task results; %2% connections are "
+                 "kept for the next run", current_run_.idx, client_pool_.size());
+
+        if (persist_connections_)
+            results.keepalive = keepalive_ptr_->get_stats();
     } else {
+        if (reconnect_storm_)
+            results.reconnect = hold_connections(all_clients_ptrs);
+
+        LOG_INFO("Run #%1% - got Connection Task results; about to close "
+                 "connections", current_run_.idx);
+
+        // Close connections, once no longer pinged; the closing
+        // handshake timings are included in the stats
+        if (persist_connections_)
+            results.keepalive = stop_keepalive();
+
         if (current_run_.num_endpoints > 0)
             assert(!all_clients_ptrs.empty());
 
-        close_connections_concurrently(std::move(all_clients_ptrs));
+        results.teardown = close_connections(std::move(all_clients_ptrs),
+                                             timings_acc_ptr.get());
+    }
+
+    if (show_stats_) {
+        // Tasks that timed out do not seal their shards
+        if (auto num_unsealed = timings_acc_ptr->num_unsealed_shards())
+            LOG_WARNING("Run #%1% - timings of %2% incomplete Connection Tasks "
+                        "are not included in the stats",
+                        current_run_.idx, num_unsealed);
+
+        results.timings = timings_acc_ptr->get_timings();
+        results.conn_stats = results.timings.get_connection_stats();
+    }
+
+    if (resource_monitor_ptr_) {
+        results.resources = resource_monitor_ptr_->end_run();
+
+        if (results.resources.saturated)
+            LOG_WARNING("Run #%1% - pcp-test was saturated (mean CPU %2%%%, "
+                        "p99 scheduler lag %3% us)", current_run_.idx,
+                        static_cast<int>(results.resources.mean_cpu_percent),
+                        results.resources.lag_us.percentile(99));
     }
 
     return results;
 }
 
-static constexpr uint32_t PING_PAUSE_MS {2};
-
-void connection_test::keepalive_task(
-        std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs)
-{
-    assert(persist_connections_);
-    std::chrono::system_clock::time_point now {};
-    static const std::chrono::milliseconds ping_pause_ms {PING_PAUSE_MS};
-    uint32_t ping_loop_duration_s {
-        (current_run_.num_endpoints * current_run_.concurrency * PING_PAUSE_MS) / 1000};
-    std::chrono::seconds check_interval {
-        ws_connection_check_interval_s_ > ping_loop_duration_s
-        ? ws_connection_check_interval_s_ - ping_loop_duration_s
-        : 1};
-    std::unique_lock<std::mutex> lck {keepalive_mtx_};
-    LOG_INFO("Run #%1% - starting Keep Alive Task, period equal to %2% s",
-             current_run_.idx, check_interval.count());
-
-    while (!stop_keepalive_task_) {
-        now = std::chrono::system_clock::now();
-        keepalive_cv_.wait_until(lck, now + check_interval);
-
-        for (auto& task_clients_ptrs : all_clients_ptrs) {
-            for (auto &c_ptr : task_clients_ptrs) {
-                if (stop_keepalive_task_)
-                    break;
-
-                if (c_ptr->isAssociated()) {
-                    try {
-                        c_ptr->ping();
-                    } catch (const std::exception &e) {
-                        LOG_ERROR("Client %1% failed to ping (%2%)",
-                                  c_ptr->configuration.common_name, e.what());
-                    }
+// Dropped connections are reconnected by the I/O threads of the
+// connection engine
+reconnect_stats connection_test::hold_connections(
+        const std::vector<std::vector<std::shared_ptr<client>>>& all_clients_ptrs)
+{
+    std::vector<std::shared_ptr<client>> client_ptrs {};
+
+    for (const auto& t_c_ptrs : all_clients_ptrs)
+        client_ptrs.insert(client_ptrs.end(), t_c_ptrs.begin(), t_c_ptrs.end());
+
+    reconnect_monitor monitor {std::move(client_ptrs),
+                               reconnect_policy_,
+                               std::chrono::milliseconds(reconnect_check_interval_ms_),
+                               engine_threads_,
+                               current_run_.rng_seed};
+    boost::nowide::cout << "                holding " << monitor.num_connections()
+                        << " connections for "
+                        << util::normalize_time_interval(1000 * hold_duration_s_)
+                        << "; dropped ones are reconnected" << std::endl;
+    LOG_INFO("Run #%1% - holding %2% connections for %3% s",
+             current_run_.idx, monitor.num_connections(), hold_duration_s_);
+
+    return monitor.hold(std::chrono::seconds(hold_duration_s_));
+}
 
-                    std::this_thread::sleep_for(ping_pause_ms);
-                }
-            }
-        }
+// Pings are spread over the WebSocket connection check interval
+void connection_test::keep_alive(
+        const std::vector<std::shared_ptr<client>>& client_ptrs)
+{
+    if (!keepalive_ptr_) {
+        keepalive_ptr_.reset(new keepalive_scheduler(
+            std::chrono::seconds(ws_connection_check_interval_s_),
+            keepalive_threads_));
+        LOG_INFO("Run #%1% - started Keep Alive Task, period equal to %2% s",
+                 current_run_.idx, ws_connection_check_interval_s_);
     }
 
-    close_connections_concurrently(std::move(all_clients_ptrs));
+    std::vector<keepalive_scheduler::ping_type> pings {};
+
+    for (const auto& c_ptr : client_ptrs)
+        pings.push_back(
+            [c_ptr]() -> bool
+            {
+                if (!c_ptr->isAssociated())
+                    return false;
+
+                c_ptr->ping();
+                return true;
+            });
+
+    keepalive_ptr_->add(std::move(pings));
 }
 
-void connection_test::close_connections_concurrently(
-        std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs)
+// The ping functions own pointers to the clients; they are destroyed
+// together with the Keep Alive Task
+keepalive_stats connection_test::stop_keepalive()
 {
-    LOG_INFO("About to close all connections");
+    keepalive_stats k_s {};
 
-    if (all_clients_ptrs.size() > 1) {
-        // Trigger client dtors concurrently
-        std::vector<std::thread> dtor_threads{};
+    if (keepalive_ptr_) {
+        keepalive_ptr_->stop();
+        k_s = keepalive_ptr_->get_stats();
+        keepalive_ptr_.reset();
+        LOG_INFO("Keep Alive Task completed");
+    }
 
-        try {
-            for (auto &t_c_ptrs : all_clients_ptrs) {
-                dtor_threads.push_back(std::thread {
-                        [&t_c_ptrs]() {
-                            try {
-                                for (auto &c : t_c_ptrs)
-                                    c.reset();
-                            } catch (const std::exception &e) {
-                                LOG_ERROR("Exception closing connection: %1%",
-                                          e.what());
-                            }
-                        }});
-            }
-        } catch (const std::exception &e) {
-            LOG_ERROR("Failed to destroy clients (%1%)", e.what());
-        }
+    return k_s;
+}
 
-        for (auto &t : dtor_threads) {
-            try {
-                if (t.joinable())
-                    t.join();
-            } catch (const std::exception &e) {
-                LOG_ERROR("Exception joining threads: %1%", e.what());
+// Teardown
+//
+// Closes the connections with at most the specified number of closing
+// handshakes in progress; in case a teardown rate is specified, closes
+// are started at that rate. Each client is destroyed once closed.
+
+static constexpr uint32_t CLOSE_HANDSHAKE_TIMEOUT_MS {5000};
+
+teardown_result connection_test::close_connections(
+        std::vector<std::vector<std::shared_ptr<client>>> all_clients_ptrs,
+        connection_timings_accumulator* timings_acc_ptr)
+{
+    teardown_result t_r {};
+    std::vector<std::shared_ptr<client>> client_ptrs {};
+
+    for (auto& t_c_ptrs : all_clients_ptrs)
+        for (auto& c_ptr : t_c_ptrs)
+            client_ptrs.push_back(std::move(c_ptr));
+
+    if (client_ptrs.empty())
+        return t_r;
+
+    auto num_workers = std::min<std::size_t>(
+        client_ptrs.size(),
+        teardown_parallelism_ ? teardown_parallelism_
+                              : std::max<std::size_t>(1, all_clients_ptrs.size()));
+    all_clients_ptrs.clear();
+    LOG_INFO("About to close %1% connections, %2% at a time",
+             client_ptrs.size(), num_workers);
+
+    std::atomic<std::size_t> next_idx {0};
+    std::atomic<int> num_connections {0};
+    std::atomic<int> num_failures {0};
+    std::chrono::microseconds close_interval {
+        teardown_rate_ ? 1000000 / teardown_rate_ : 0};
+    auto start = std::chrono::steady_clock::now();
+    auto events_ptr = event_recorder_ptr_.get();
+
+    auto close_clients =
+        [&client_ptrs, &next_idx, &num_connections, &num_failures,
+         close_interval, start, timings_acc_ptr, events_ptr] () -> void
+        {
+            // Timings are accumulated without locking, in a shard owned
+            // by this worker
+            std::shared_ptr<connection_timings_shard> shard_ptr {
+                timings_acc_ptr ? timings_acc_ptr->get_shard() : nullptr};
+
+            for (auto idx = next_idx++; idx < client_ptrs.size(); idx = next_idx++) {
+                if (close_interval.count())
+                    std::this_thread::sleep_until(start + close_interval * idx);
+
+                auto& c_ptr = client_ptrs[idx];
+                auto endpoint_id = static_cast<uint32_t>(c_ptr->configuration.client_idx);
+
+                try {
+                    if (c_ptr->isConnected()) {
+                        num_connections++;
+
+                        if (!c_ptr->close(
+                                std::chrono::milliseconds(CLOSE_HANDSHAKE_TIMEOUT_MS))) {
+                            num_failures++;
+                            LOG_WARNING("Client %1% did not close its connection "
+                                        "within %2% ms",
+                                        c_ptr->configuration.common_name,
+                                        CLOSE_HANDSHAKE_TIMEOUT_MS);
+
+                            if (events_ptr)
+                                events_ptr->record(
+                                    endpoint_id,
+                                    connection_phase::ws_close_handshake,
+                                    event_outcome::failure,
+                                    std::chrono::milliseconds(CLOSE_HANDSHAKE_TIMEOUT_MS));
+                        } else if (shard_ptr || events_ptr) {
+                            auto close_us = c_ptr->getConnectionTimings()
+                                                  .getClosingHandshakeInterval().count();
+
+                            if (shard_ptr)
+                                shard_ptr->accumulate_ws_close_handshake_us(
+                                    static_cast<uint32_t>(close_us));
+
+                            if (events_ptr)
+                                events_ptr->record(
+                                    endpoint_id,
+                                    connection_phase::ws_close_handshake,
+                                    event_outcome::success,
+                                    std::chrono::microseconds(close_us));
+                        }
+                    }
+
+                    c_ptr.reset();
+                } catch (const std::exception& e) {
+                    num_failures++;
+                    LOG_ERROR("Exception closing connection: %1%", e.what());
+                }
             }
+
+            if (shard_ptr)
+                shard_ptr->seal();
+        };
+
+    // The calling thread is one of the workers
+    std::vector<std::thread> close_threads {};
+
+    try {
+        for (std::size_t idx = 1; idx < num_workers; idx++)
+            close_threads.push_back(std::thread {close_clients});
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to start all teardown threads (%1%)", e.what());
+    }
+
+    close_clients();
+
+    for (auto& t : close_threads) {
+        try {
+            if (t.joinable())
+                t.join();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Exception joining threads: %1%", e.what());
         }
     }
+
+    t_r.num_connections = num_connections.load();
+    t_r.num_failures = num_failures.load();
+    t_r.duration_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+
+    return t_r;
 }
 
 }  // namespace pcp_test
@@ -14,10 +14,60 @@ const std::string RANDOMIZE_INTER_ENDPOINT_PAUSE {"randomize-inter-endpoint-paus
 const std::string INTER_ENDPOINT_PAUSE_RNG_SEED {"inter-endpoint-pause-rng-seed"};
 const std::string WS_CONNECTION_TIMEOUT_MS {"ws-connection-timeout-ms"};
 const std::string WS_CONNECTION_CHECK_INTERVAL_S {"ws-connection-check-interval-s"};
+const std::string KEEPALIVE_THREADS {"keepalive-threads"};
 const std::string ASSOCIATION_TIMEOUT_S {"association-timeout-s"};
 const std::string ASSOCIATION_REQUEST_TTL_S {"association-request-ttl-s"};
 const std::string PERSIST_CONNECTIONS {"persist-connections"};
 const std::string SHOW_STATS {"show-stats"};
+const std::string CONNECTION_ENGINE {"connection-engine"};
+const std::string ENGINE_THREADS {"engine-threads"};
+const std::string ARRIVAL_MODE {"arrival-mode"};
+const std::string CONNECTION_RATE {"connection-rate"};
+const std::string CONNECTION_RATE_INCREMENT {"connection-rate-increment"};
+const std::string RAMP_UP_MS {"ramp-up-ms"};
+const std::string INCREMENTAL_RAMP {"incremental-ramp"};
+const std::string TEARDOWN_PARALLELISM {"teardown-parallelism"};
+const std::string TEARDOWN_RATE {"teardown-rate"};
+const std::string BROKER_DISTRIBUTION {"broker-distribution"};
+const std::string BROKER_WEIGHTS {"broker-weights"};
+const std::string WORKERS {"workers"};
+const std::string WORKER_PORT {"worker-port"};
+const std::string WORKER_BIND_ADDRESS {"worker-bind-address"};
+const std::string LIVE_METRICS {"live-metrics"};
+const std::string LIVE_METRICS_PORT {"live-metrics-port"};
+const std::string LIVE_METRICS_BIND_ADDRESS {"live-metrics-bind-address"};
+const std::string EVENT_LOG {"event-log"};
+const std::string RESOURCE_STATS {"resource-stats"};
+const std::string CAPACITY_SEARCH {"capacity-search"};
+const std::string MAX_FAILURES {"max-failures"};
+const std::string LATENCY_SLO_MS {"latency-slo-ms"};
+const std::string RECONNECT_STORM {"reconnect-storm"};
+const std::string HOLD_DURATION_S {"hold-duration-s"};
+const std::string RECONNECT_CHECK_INTERVAL_MS {"reconnect-check-interval-ms"};
+const std::string RECONNECT_BACKOFF {"reconnect-backoff"};
+const std::string RECONNECT_BACKOFF_MS {"reconnect-backoff-ms"};
+const std::string RECONNECT_BACKOFF_MAX_MS {"reconnect-backoff-max-ms"};
+const std::string RECONNECT_JITTER {"reconnect-jitter"};
+const std::string LATENCY_CORRECTION {"latency-correction"};
+
+const std::string THREADED_ENGINE {"threaded"};
+const std::string POOLED_ENGINE {"pooled"};
+
+const std::string CLOSED_LOOP_ARRIVALS {"closed-loop"};
+const std::string OPEN_LOOP_ARRIVALS {"open-loop"};
+
+const std::string FIRST_BROKER {"first"};
+const std::string ROUND_ROBIN_BROKERS {"round-robin"};
+const std::string WEIGHTED_BROKERS {"weighted"};
+const std::string HASHED_BROKERS {"hash"};
+
+const std::string CONSTANT_BACKOFF {"constant"};
+const std::string EXPONENTIAL_BACKOFF {"exponential"};
+
+const std::string NO_JITTER {"none"};
+const std::string FULL_JITTER {"full"};
+const std::string EQUAL_JITTER {"equal"};
+const std::string DECORRELATED_JITTER {"decorrelated"};
 
 }  // namespace connection_test_parameters
 }  // namespace pcp_test
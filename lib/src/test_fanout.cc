@@ -0,0 +1,556 @@
+#include <pcp-test/test_fanout.hpp>
+#include <pcp-test/test_fanout_parameters.hpp>
+#include <pcp-test/broadcast_tracker.hpp>
+#include <pcp-test/connection_stats.hpp>
+#include <pcp-test/client_configuration.hpp>
+#include <pcp-test/client.hpp>
+#include <pcp-test/message.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <cpp-pcp-client/protocol/chunks.hpp>
+
+#include <leatherman/logging/logging.hpp>
+#include <leatherman/json_container/json_container.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/format.hpp>
+
+#include <boost/nowide/iostream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+namespace fan_par  = pcp_test::fanout_test_parameters;
+namespace fs       = boost::filesystem;
+namespace lth_jc   = leatherman::json_container;
+
+using clock_type = std::chrono::steady_clock;
+
+static const std::string FANOUT_AGENT {"fanout_agent"};
+static const std::string FANOUT_CONTROLLER {"fanout_controller"};
+
+void run_fanout_test(const application_options& a_o)
+{
+    fanout_test test {a_o};
+    test.start();
+}
+
+static int get_optional_int(const application_options& a_o,
+                            const std::string& parameter,
+                            int default_value)
+{
+    return a_o.fanout_test_parameters.includes(parameter)
+           ? a_o.fanout_test_parameters.get<int>(parameter)
+           : default_value;
+}
+
+//
+// fanout_test_run
+//
+
+fanout_test_run::fanout_test_run(const application_options& a_o)
+    : agents_increment_ {get_optional_int(a_o, fan_par::AGENTS_INCREMENT, 0)},
+      controllers_increment_ {get_optional_int(a_o, fan_par::CONTROLLERS_INCREMENT, 0)},
+      idx {1},
+      num_agents {a_o.fanout_test_parameters.get<int>(fan_par::NUM_AGENTS)},
+      num_controllers {a_o.fanout_test_parameters.get<int>(fan_par::NUM_CONTROLLERS)}
+{
+}
+
+fanout_test_run& fanout_test_run::operator++()
+{
+    idx++;
+    num_agents      += agents_increment_;
+    num_controllers += controllers_increment_;
+    return *this;
+}
+
+std::string fanout_test_run::to_string() const
+{
+    return (boost::format("run %1%: %2% controllers, %3% agents")
+            % idx % num_controllers % num_agents).str();
+}
+
+//
+// fanout_test_result
+//
+
+fanout_test_result::fanout_test_result(const fanout_test_run& run)
+    : num_agents {run.num_agents},
+      num_controllers {run.num_controllers},
+      num_association_failures {0},
+      num_broadcasts {0},
+      num_failed_sends {0},
+      num_complete {0},
+      num_expected {0},
+      num_delivered {0},
+      num_duplicates {0},
+      num_late {0},
+      num_unknown {0},
+      duration_ms {0},
+      time_to_first_us {},
+      time_to_last_us {}
+{
+}
+
+double fanout_test_result::completeness() const
+{
+    return num_expected > 0 ? static_cast<double>(num_delivered) / num_expected : 0.0;
+}
+
+double fanout_test_result::delivery_rate() const
+{
+    return duration_ms > 0 ? (num_delivered * 1000.0) / duration_ms : 0.0;
+}
+
+static void display_times(std::ostream& out, const std::string& label, const stats& s)
+{
+    out << label << " mean "
+        << s.mean / 1000 << " ms, std dev "
+        << s.stddev / 1000 << " ms, max "
+        << static_cast<float>(s.max) / 1000 << " ms\n"
+        << "                        p50 "
+        << static_cast<float>(s.p50) / 1000 << " ms, p90 "
+        << static_cast<float>(s.p90) / 1000 << " ms, p99 "
+        << static_cast<float>(s.p99) / 1000 << " ms, p99.9 "
+        << static_cast<float>(s.p999) / 1000 << " ms\n";
+}
+
+std::ostream & operator<< (std::ostream& out, const fanout_test_result& r)
+{
+    if (r.num_association_failures) {
+        out << util::red("  [FAILURE]  ") << r.num_association_failures
+            << " clients failed to associate out of "
+            << r.num_agents + r.num_controllers << "; no request was sent\n";
+        return out;
+    }
+
+    if (r.num_complete < r.num_broadcasts || r.num_failed_sends) {
+        out << util::red("  [FAILURE]  ") << r.num_broadcasts - r.num_complete
+            << " incomplete broadcasts and " << r.num_failed_sends
+            << " failed sends out of " << r.num_broadcasts + r.num_failed_sends
+            << " broadcasts";
+    } else {
+        out << util::green("  [SUCCESS]  ") << r.num_broadcasts
+            << " complete broadcasts";
+    }
+
+    out << " to " << r.num_agents << " agents in "
+        << util::normalize_time_interval(r.duration_ms) << "; "
+        << r.num_delivered << " of " << r.num_expected << " responses ("
+        << r.completeness() * 100 << "%), " << r.delivery_rate() << " responses/s\n";
+
+    if (r.num_late || r.num_duplicates || r.num_unknown)
+        out << "  unexpected responses: " << r.num_late << " late, "
+            << r.num_duplicates << " duplicates, "
+            << r.num_unknown << " unknown\n";
+
+    display_times(out, "  Time to First: ......", stats(r.time_to_first_us));
+    display_times(out, "  Time to Last: .......", stats(r.time_to_last_us));
+
+    return out;
+}
+
+static void write_times(boost::nowide::ofstream& out, const stats& s)
+{
+    out << s.mean / 1000 << ","
+        << s.stddev / 1000 << ","
+        << static_cast<float>(s.max) / 1000 << ","
+        << static_cast<float>(s.p50) / 1000 << ","
+        << static_cast<float>(s.p90) / 1000 << ","
+        << static_cast<float>(s.p99) / 1000 << ","
+        << static_cast<float>(s.p999) / 1000;
+}
+
+std::ofstream & operator<< (boost::nowide::ofstream& out,
+                            const fanout_test_result& r)
+{
+    out << r.num_agents << ","
+        << r.num_controllers << ","
+        << r.num_association_failures << ","
+        << r.num_broadcasts << ","
+        << r.num_failed_sends << ","
+        << r.num_complete << ","
+        << r.num_expected << ","
+        << r.num_delivered << ","
+        << r.num_duplicates << ","
+        << r.num_late << ","
+        << r.num_unknown << ","
+        << r.duration_ms << ","
+        << r.completeness() << ","
+        << r.delivery_rate() << ",";
+    write_times(out, stats(r.time_to_first_us));
+    out << ",";
+    write_times(out, stats(r.time_to_last_us));
+
+    return out;
+}
+
+//
+// Agents and Controllers
+//
+
+// Replies to each request with a response that carries the same data
+class fanout_agent : public client
+{
+  public:
+    explicit fanout_agent(client_configuration config)
+        : client(std::move(config))
+    {
+    }
+
+  private:
+    virtual void process_request(const PCPClient::ParsedChunks& parsed_chunks)
+    {
+        echo(parsed_chunks);
+    }
+};
+
+// Sends the specified number of broadcasts, one at a time, and tracks
+// the responses with a broadcast_tracker. A broadcast is closed once
+// all agents have responded or the response timeout has elapsed; the
+// next one is sent after the broadcast pause.
+// Broadcasts are sent by send_broadcasts(), that blocks, whereas
+// responses are processed by the WebSocket event loop thread of the
+// client.
+class fanout_controller
+{
+  public:
+    fanout_controller(client_configuration config,
+                      const std::vector<std::string>& agent_uris,
+                      bool wildcard,
+                      int num_broadcasts,
+                      unsigned int broadcast_pause_ms,
+                      unsigned int response_timeout_ms)
+        : endpoints_ {wildcard
+                      ? std::vector<std::string> {"pcp://*/" + FANOUT_AGENT}
+                      : agent_uris},
+          num_broadcasts_ {num_broadcasts},
+          broadcast_pause_ {broadcast_pause_ms},
+          response_timeout_ {response_timeout_ms},
+          tracker_ {agent_uris},
+          num_failed_sends_ {0},
+          num_invalid_ {0},
+          mtx_ {},
+          cv_ {},
+          last_response_ {},
+          client_ {std::move(config)}
+    {
+        client_.response_callback =
+            [this](const PCPClient::ParsedChunks& parsed_chunks, client*)
+            {
+                process_response(parsed_chunks);
+            };
+    }
+
+    client& get_client() { return client_; }
+
+    void send_broadcasts()
+    {
+        const auto& cn = client_.configuration.common_name;
+        lth_jc::JsonContainer data {};
+
+        for (int idx = 0; idx < num_broadcasts_; idx++) {
+            if (idx)
+                std::this_thread::sleep_for(broadcast_pause_);
+
+            std::string transaction {cn + "_" + std::to_string(idx)};
+            data.set<std::string>("transaction", transaction);
+            data.set<int64_t>("seq", idx + 1);
+            data.set<int64_t>("sent_ns", util::get_monotonic_ns());
+
+            // NB: transactions are unique
+            tracker_.insert(transaction, clock_type::now());
+
+            if (!client_.send_request(endpoints_, data)) {
+                tracker_.cancel(transaction);
+                num_failed_sends_++;
+
+                if (!client_.isConnected()) {
+                    LOG_WARNING("%1%: the connection was lost; stop sending", cn);
+                    break;
+                }
+
+                continue;
+            }
+
+            {
+                std::unique_lock<std::mutex> lck {mtx_};
+                cv_.wait_for(lck, response_timeout_,
+                             [this, &transaction]() {
+                                 return tracker_.is_complete(transaction);
+                             });
+            }
+
+            tracker_.close(transaction);
+        }
+    }
+
+    void add_results(fanout_test_result& result,
+                     clock_type::time_point& last_response) const
+    {
+        auto counters = tracker_.get_counters();
+        result.num_broadcasts   += counters.broadcasts;
+        result.num_failed_sends += num_failed_sends_;
+        result.num_complete     += counters.complete;
+        result.num_expected     += counters.expected;
+        result.num_delivered    += counters.delivered;
+        result.num_duplicates   += counters.duplicates;
+        result.num_late         += counters.late;
+        result.num_unknown      += counters.unknown + num_invalid_.load();
+        result.time_to_first_us.merge(tracker_.get_time_to_first_us());
+        result.time_to_last_us.merge(tracker_.get_time_to_last_us());
+
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        last_response = std::max(last_response, last_response_);
+    }
+
+  private:
+    std::vector<std::string> endpoints_;
+    int num_broadcasts_;
+    std::chrono::milliseconds broadcast_pause_;
+    std::chrono::milliseconds response_timeout_;
+    broadcast_tracker tracker_;
+
+    // Accessed only by the sender thread
+    uint64_t num_failed_sends_;
+
+    std::atomic<uint64_t> num_invalid_;
+
+    // Synchronizes the wait for responses
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    clock_type::time_point last_response_;
+
+    // NB: declared last, so that it's destroyed first, with its event
+    // loop thread, before the state accessed by the response callback
+    client client_;
+
+    void process_response(const PCPClient::ParsedChunks& parsed_chunks)
+    {
+        auto now = clock_type::now();
+        broadcast_tracker::match_outcome outcome {};
+
+        try {
+            message_view resp {parsed_chunks};
+            outcome = tracker_.match(resp.transaction().to_string(), resp.sender(), now);
+        } catch (const message::error& e) {
+            LOG_WARNING("%1%: invalid response (%2%)",
+                        client_.configuration.common_name, e.what());
+            num_invalid_++;
+            return;
+        }
+
+        if (outcome != broadcast_tracker::match_outcome::delivered
+                && outcome != broadcast_tracker::match_outcome::completed)
+            return;
+
+        {
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            last_response_ = now;
+        }
+
+        if (outcome == broadcast_tracker::match_outcome::completed)
+            cv_.notify_all();
+    }
+};
+
+//
+// fanout_test
+//
+
+static constexpr int DEFAULT_RESPONSE_TIMEOUT_MS {5000};
+static constexpr int DEFAULT_WS_CONNECTION_TIMEOUT_MS {1500};
+
+fanout_test::fanout_test(const application_options& a_o)
+    : app_opt_(a_o),
+      num_runs_ {app_opt_.fanout_test_parameters.get<int>(fan_par::NUM_RUNS)},
+      inter_run_pause_ms_ {static_cast<unsigned int>(
+            app_opt_.fanout_test_parameters.get<int>(fan_par::INTER_RUN_PAUSE_MS))},
+      num_broadcasts_ {app_opt_.fanout_test_parameters.get<int>(fan_par::NUM_BROADCASTS)},
+      wildcard_ {
+            app_opt_.fanout_test_parameters.includes(fan_par::TARGETING)
+            && app_opt_.fanout_test_parameters.get<std::string>(fan_par::TARGETING)
+                == fan_par::WILDCARD_TARGETING},
+      broadcast_pause_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, fan_par::BROADCAST_PAUSE_MS, 0))},
+      response_timeout_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, fan_par::RESPONSE_TIMEOUT_MS, DEFAULT_RESPONSE_TIMEOUT_MS))},
+      message_ttl_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, fan_par::MESSAGE_TTL_S, DEFAULT_MESSAGE_TTL_S))},
+      ws_connection_timeout_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, fan_par::WS_CONNECTION_TIMEOUT_MS,
+                             DEFAULT_WS_CONNECTION_TIMEOUT_MS))},
+      association_timeout_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, fan_par::ASSOCIATION_TIMEOUT_S,
+                             DEFAULT_ASSOCIATION_TIMEOUT_S))},
+      current_run_ {app_opt_},
+      results_file_name_ {(boost::format("fanout_test_%1%.csv")
+                           % util::get_short_datetime()).str()},
+      results_file_stream_ {(fs::path(app_opt_.results_dir)
+                             / results_file_name_).string()}
+{
+    if (!results_file_stream_.is_open())
+        throw fatal_error {((boost::format("failed to open %1%")
+                             % results_file_name_).str())};
+}
+
+void fanout_test::start()
+{
+    auto start_time = std::chrono::system_clock::now();
+    LOG_INFO("Requested %1% runs", num_runs_);
+    boost::format run_msg_fmt {"Starting %1%"};
+    display_setup();
+
+    do {
+        boost::nowide::cout << (run_msg_fmt % current_run_.to_string()).str()
+                            << std::endl;
+        auto results = perform_current_run();
+        results_file_stream_ << results << '\n';
+        boost::nowide::cout << results << '\n';
+        ++current_run_;
+
+        if (current_run_.idx <= num_runs_)
+            std::this_thread::sleep_for(std::chrono::milliseconds(inter_run_pause_ms_));
+    } while (current_run_.idx <= num_runs_);
+
+    display_execution_time(start_time);
+}
+
+void fanout_test::display_setup()
+{
+    boost::nowide::cout
+        << "\nFan-out test setup:\n"
+        << "  " << current_run_.num_controllers << " controllers (+"
+        << get_optional_int(app_opt_, fan_par::CONTROLLERS_INCREMENT, 0)
+        << " per run), " << current_run_.num_agents << " agents (+"
+        << get_optional_int(app_opt_, fan_par::AGENTS_INCREMENT, 0) << " per run)\n"
+        << "  " << num_runs_ << " runs, " << inter_run_pause_ms_
+        << " ms pause between each run\n"
+        << "  " << num_broadcasts_ << " broadcasts per controller, addressed by "
+        << (wildcard_ ? "wildcard" : "explicit") << " endpoints, "
+        << broadcast_pause_ms_ << " ms pause between each broadcast\n"
+        << "  response timeout " << response_timeout_ms_ << " ms; message TTL "
+        << message_ttl_s_ << " s\n"
+        << "  WebSocket connection timeout " << ws_connection_timeout_ms_ << " ms; "
+        << "Association timeout " << association_timeout_s_ << " s\n\n";
+}
+
+void fanout_test::display_execution_time(
+        std::chrono::system_clock::time_point start_time)
+{
+    auto end_time = std::chrono::system_clock::now();
+    auto duration_m = std::chrono::duration_cast<std::chrono::minutes>(
+            end_time - start_time).count();
+    auto duration_s = std::chrono::duration_cast<std::chrono::seconds>(
+            end_time - start_time).count() - (duration_m * 60);
+
+    boost::nowide::cout
+        << "\nFan-out test: finished in " << duration_m << " m "
+        << duration_s << " s\n" << std::endl;
+}
+
+fanout_test_result fanout_test::perform_current_run()
+{
+    fanout_test_result result {current_run_};
+
+    // Instantiate clients
+
+    std::vector<std::unique_ptr<fanout_agent>> agents {};
+    std::vector<std::string> agent_uris {};
+    std::vector<std::unique_ptr<fanout_controller>> controllers {};
+    std::vector<client*> client_ptrs {};
+
+    auto agent_name_itr = app_opt_.agents.begin();
+    for (auto idx = 0; idx < current_run_.num_agents; idx++) {
+        agents.push_back(std::unique_ptr<fanout_agent>(
+            new fanout_agent(client_configuration(
+                    *agent_name_itr++,
+                    FANOUT_AGENT,
+                    app_opt_.broker_ws_uris,
+                    app_opt_.certificates_dir,
+                    ws_connection_timeout_ms_,
+                    association_timeout_s_,
+                    DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                    message_ttl_s_))));
+        agent_uris.push_back((boost::format("pcp://%1%/%2%")
+                              % agents.back()->configuration.common_name
+                              % FANOUT_AGENT).str());
+        client_ptrs.push_back(agents.back().get());
+    }
+
+    auto controller_name_itr = app_opt_.controllers.begin();
+    for (auto idx = 0; idx < current_run_.num_controllers; idx++) {
+        controllers.push_back(std::unique_ptr<fanout_controller>(
+            new fanout_controller(
+                    client_configuration(*controller_name_itr++,
+                                         FANOUT_CONTROLLER,
+                                         app_opt_.broker_ws_uris,
+                                         app_opt_.certificates_dir,
+                                         ws_connection_timeout_ms_,
+                                         association_timeout_s_,
+                                         DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                                         message_ttl_s_),
+                    agent_uris,
+                    wildcard_,
+                    num_broadcasts_,
+                    broadcast_pause_ms_,
+                    response_timeout_ms_)));
+        client_ptrs.push_back(&controllers.back()->get_client());
+    }
+
+    // Associate
+
+    boost::nowide::cout << "                connecting "
+                        << client_ptrs.size() << " clients" << std::endl;
+    result.num_association_failures = connect_clients(client_ptrs);
+
+    if (result.num_association_failures) {
+        LOG_WARNING("%1% clients failed to associate; skipping run %2%",
+                    result.num_association_failures, current_run_.idx);
+        return result;
+    }
+
+    // Broadcast
+
+    boost::nowide::cout << "                sending " << num_broadcasts_
+                        << " broadcasts per controller" << std::endl;
+    auto start = clock_type::now();
+    std::vector<std::thread> senders {};
+
+    for (auto& c_ptr : controllers)
+        senders.push_back(std::thread(&fanout_controller::send_broadcasts,
+                                      c_ptr.get()));
+
+    for (auto& s : senders)
+        s.join();
+
+    // Retrieve results
+
+    auto last_response = start;
+
+    for (auto& c_ptr : controllers)
+        c_ptr->add_results(result, last_response);
+
+    result.duration_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            last_response - start).count());
+
+    boost::nowide::cout << "                done - closing connections"
+                        << std::endl;
+
+    return result;
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,24 @@
+#include <pcp-test/test_fanout_parameters.hpp>
+
+namespace pcp_test{
+namespace fanout_test_parameters {
+
+const std::string NUM_RUNS {"num-runs"};
+const std::string INTER_RUN_PAUSE_MS {"inter-run-pause-ms"};
+const std::string NUM_AGENTS {"num-agents"};
+const std::string NUM_CONTROLLERS {"num-controllers"};
+const std::string NUM_BROADCASTS {"num-broadcasts"};
+const std::string AGENTS_INCREMENT {"agents-increment"};
+const std::string CONTROLLERS_INCREMENT {"controllers-increment"};
+const std::string TARGETING {"targeting"};
+const std::string BROADCAST_PAUSE_MS {"broadcast-pause-ms"};
+const std::string RESPONSE_TIMEOUT_MS {"response-timeout-ms"};
+const std::string MESSAGE_TTL_S {"message-ttl-s"};
+const std::string WS_CONNECTION_TIMEOUT_MS {"ws-connection-timeout-ms"};
+const std::string ASSOCIATION_TIMEOUT_S {"association-timeout-s"};
+
+const std::string WILDCARD_TARGETING {"wildcard"};
+const std::string EXPLICIT_TARGETING {"explicit"};
+
+}  // namespace fanout_test_parameters
+}  // namespace pcp_test
@@ -0,0 +1,684 @@
+#include <pcp-test/test_scenario.hpp>
+#include <pcp-test/test_scenario_parameters.hpp>
+#include <pcp-test/paced_traffic.hpp>
+#include <pcp-test/keepalive_scheduler.hpp>
+#include <pcp-test/task_scheduler.hpp>
+#include <pcp-test/arrival_schedule.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <leatherman/logging/logging.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/format.hpp>
+
+#include <boost/nowide/iostream.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>  // std::cref
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace pcp_test {
+
+namespace scen_par = pcp_test::scenario_test_parameters;
+namespace fs       = boost::filesystem;
+
+using clock_type = std::chrono::steady_clock;
+
+static const std::string SCENARIO_AGENT {"scenario_agent"};
+static const std::string SCENARIO_CONTROLLER {"scenario_controller"};
+
+void run_scenario_test(const application_options& a_o)
+{
+    scenario_test test {a_o};
+    test.start();
+}
+
+static int get_optional_int(const application_options& a_o,
+                            const std::string& parameter,
+                            int default_value)
+{
+    return a_o.scenario_test_parameters.includes(parameter)
+           ? a_o.scenario_test_parameters.get<int>(parameter)
+           : default_value;
+}
+
+//
+// phase_result
+//
+
+phase_result::phase_result()
+    : idx {0},
+      name {},
+      type {phase_type::hold},
+      duration_ms {0},
+      num_clients {0},
+      num_associated {0},
+      num_attempts {0},
+      num_failures {0},
+      num_responses {0},
+      num_errors {0},
+      num_late_sends {0},
+      num_skipped_sends {0},
+      traffic_ms {0},
+      latency_us {},
+      reconnect {},
+      resources {}
+{
+}
+
+double phase_result::throughput() const
+{
+    return traffic_ms > 0 ? (num_responses * 1000.0) / traffic_ms : 0.0;
+}
+
+static bool holds_connections(phase_type type)
+{
+    return type == phase_type::hold
+           || type == phase_type::messages
+           || type == phase_type::reconnect_storm;
+}
+
+// Labels of the attempts and failures, by phase type
+static std::pair<std::string, std::string> get_labels(phase_type type)
+{
+    switch (type) {
+        case phase_type::connect:
+            return {"connections", "not associated"};
+        case phase_type::messages:
+            return {"requests", "failed to send"};
+        case phase_type::reconnect_storm:
+            return {"dropped", "not re-associated"};
+        case phase_type::teardown:
+            return {"closes", "timed out"};
+        default:
+            return {"", ""};
+    }
+}
+
+std::ostream & operator<< (std::ostream& out, const phase_result& r)
+{
+    out << "  Phase " << r.idx << " (" << r.name << "): finished after "
+        << util::normalize_time_interval(static_cast<uint32_t>(r.duration_ms)) << "\n";
+
+    if (r.type != phase_type::hold) {
+        auto labels = get_labels(r.type);
+        out << "      " << r.num_attempts << " " << labels.first << ", ";
+
+        if (r.num_failures) {
+            out << util::red(std::to_string(r.num_failures));
+        } else {
+            out << r.num_failures;
+        }
+
+        out << " " << labels.second;
+
+        if (r.latency_us.count())
+            out << "; latency p50 "
+                << (boost::format("%.1f") % (r.latency_us.percentile(50) / 1000.0))
+                << " ms, p99 "
+                << (boost::format("%.1f") % (r.latency_us.percentile(99) / 1000.0))
+                << " ms, max "
+                << (boost::format("%.1f") % (r.latency_us.max() / 1000.0)) << " ms";
+
+        out << "\n";
+    }
+
+    if (r.type == phase_type::messages) {
+        out << "      " << (boost::format("%.1f") % r.throughput()) << " responses/s";
+
+        if (r.num_errors)
+            out << ", " << util::yellow(std::to_string(r.num_errors)) << " errors";
+
+        if (r.num_late_sends)
+            out << ", " << util::yellow(std::to_string(r.num_late_sends))
+                << " late sends";
+
+        if (r.num_skipped_sends)
+            out << ", " << util::red(std::to_string(r.num_skipped_sends))
+                << " skipped sends";
+
+        out << "\n";
+    }
+
+    out << "      associated " << r.num_associated << " of " << r.num_clients
+        << " clients; pcp-test RSS " << r.resources.max_rss_kb / 1024 << " MB, CPU "
+        << (boost::format("%.1f%%") % r.resources.mean_cpu_percent) << "\n";
+
+    if (holds_connections(r.type))
+        out << r.reconnect;
+
+    if (r.resources.saturated)
+        out << util::yellow("  [WARNING]  ")
+            << "pcp-test itself was saturated during the phase\n";
+
+    return out;
+}
+
+// CSV: phase, name, type, duration (ms), attempts, failures, latency
+// p50, p99 and max (ms), responses, errors, late sends, skipped sends,
+// throughput (responses/s),
+// clients, associated clients, reconnect storms, reconnection attempts,
+// time to full re-association (ms; -1 if not re-associated), pcp-test
+// mean CPU (%) and max RSS (KB)
+std::ofstream & operator<< (boost::nowide::ofstream& out, const phase_result& r)
+{
+    int num_reconnect_attempts {0};
+    int64_t reassociation_ms {0};
+
+    for (const auto& s : r.reconnect.storms) {
+        num_reconnect_attempts += s.num_attempts;
+        reassociation_ms = (s.reassociation_ms < 0 || reassociation_ms < 0)
+                           ? -1
+                           : std::max(reassociation_ms, s.reassociation_ms);
+    }
+
+    out << r.idx << ","
+        << r.name << ","
+        << phase_type_name(r.type) << ","
+        << r.duration_ms << ","
+        << r.num_attempts << ","
+        << r.num_failures << ","
+        << r.latency_us.percentile(50) / 1000.0 << ","
+        << r.latency_us.percentile(99) / 1000.0 << ","
+        << r.latency_us.max() / 1000.0 << ","
+        << r.num_responses << ","
+        << r.num_errors << ","
+        << r.num_late_sends << ","
+        << r.num_skipped_sends << ","
+        << (boost::format("%.1f") % r.throughput()) << ","
+        << r.num_clients << ","
+        << r.num_associated << ","
+        << r.reconnect.storms.size() << ","
+        << num_reconnect_attempts << ","
+        << reassociation_ms << ","
+        << (boost::format("%.1f") % r.resources.mean_cpu_percent) << ","
+        << r.resources.max_rss_kb;
+
+    return out;
+}
+
+//
+// scenario_test
+//
+
+static constexpr int DEFAULT_WS_CONNECTION_CHECK_INTERVAL_S {30};
+static constexpr int DEFAULT_RECONNECT_CHECK_INTERVAL_MS {1000};
+static constexpr int DEFAULT_WS_CONNECTION_TIMEOUT_MS {1500};
+static const std::chrono::milliseconds CLOSE_TIMEOUT {1000};
+static const std::chrono::milliseconds DRAIN_CHECK_INTERVAL {10};
+
+// Execute the task for each index in [0, num_tasks), at the given rate
+// [tasks/s] or, if null, as soon as possible, by using a pool of
+// threads; return once all are done, including those that throw
+static void run_paced(std::size_t num_tasks,
+                      unsigned int rate,
+                      std::function<void(std::size_t)> task)
+{
+    std::mutex mtx {};
+    std::condition_variable cv {};
+    std::size_t num_done {0};
+    auto offsets = rate
+                   ? get_arrival_offsets(static_cast<int>(num_tasks), rate,
+                                         std::chrono::milliseconds::zero())
+                   : std::vector<std::chrono::microseconds>(num_tasks);
+
+    // NB: the pool is destroyed, by joining its workers, before
+    // the above synchronization objects
+    task_scheduler pool {};
+    auto start = task_scheduler::clock_type::now();
+
+    for (std::size_t idx = 0; idx < num_tasks; idx++) {
+        pool.schedule_at(
+            start + offsets[idx],
+            [&mtx, &cv, &num_done, &task, idx]()
+            {
+                // NB: count the task as done even if it throws, so
+                // that the wait below completes
+                try {
+                    task(idx);
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Scenario task %1% failed: %2%", idx, e.what());
+                } catch (...) {
+                    LOG_ERROR("Scenario task %1% failed", idx);
+                }
+
+                {
+                    std::lock_guard<std::mutex> the_lock {mtx};
+                    num_done++;
+                }
+                cv.notify_one();
+            });
+    }
+
+    std::unique_lock<std::mutex> lck {mtx};
+    cv.wait(lck, [&]() { return num_done == num_tasks; });
+}
+
+static std::string describe_phase(const scenario_phase& phase)
+{
+    auto rate = [](unsigned int r, const std::string& unit) -> std::string
+                {
+                    return r ? (boost::format(" at %1% %2%/s") % r % unit).str()
+                             : std::string {};
+                };
+    auto duration = util::normalize_time_interval(phase.duration_s * 1000);
+    auto description = phase.name + " (" + phase_type_name(phase.type) + "): ";
+
+    switch (phase.type) {
+        case phase_type::connect:
+            return description
+                   + (boost::format("%1% agents and %2% controllers")
+                      % phase.num_agents % phase.num_controllers).str()
+                   + rate(phase.rate, "connections");
+        case phase_type::hold:
+            return description + "hold the connections for " + duration;
+        case phase_type::messages:
+            return description
+                   + (boost::format("%1% requests/s for %2%")
+                      % phase.request_rate % duration).str();
+        case phase_type::reconnect_storm:
+            return description
+                   + (boost::format("drop %1%%% of the clients; reconnect them for %2%")
+                      % phase.fraction_pct % duration).str();
+        case phase_type::teardown:
+            return description
+                   + (phase.num_agents < 0
+                      ? std::string {"close all clients"}
+                      : (boost::format("close %1% agents and %2% controllers")
+                         % phase.num_agents % phase.num_controllers).str())
+                   + rate(phase.rate, "closes");
+    }
+
+    return description;
+}
+
+scenario_test::scenario_test(const application_options& a_o)
+    : app_opt_(a_o),
+      phases_ {parse_scenario(a_o.scenario_test_parameters)},
+      ws_connection_check_interval_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, scen_par::WS_CONNECTION_CHECK_INTERVAL_S,
+                             DEFAULT_WS_CONNECTION_CHECK_INTERVAL_S))},
+      reconnect_check_interval_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, scen_par::RECONNECT_CHECK_INTERVAL_MS,
+                             DEFAULT_RECONNECT_CHECK_INTERVAL_MS))},
+      message_ttl_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, scen_par::MESSAGE_TTL_S, DEFAULT_MESSAGE_TTL_S))},
+      ws_connection_timeout_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, scen_par::WS_CONNECTION_TIMEOUT_MS,
+                             DEFAULT_WS_CONNECTION_TIMEOUT_MS))},
+      association_timeout_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, scen_par::ASSOCIATION_TIMEOUT_S,
+                             DEFAULT_ASSOCIATION_TIMEOUT_S))},
+      results_file_name_ {(boost::format("scenario_test_%1%.csv")
+                           % util::get_short_datetime()).str()},
+      results_file_stream_ {(fs::path(app_opt_.results_dir)
+                             / results_file_name_).string()},
+      next_agent_name_ {app_opt_.agents.begin()},
+      next_controller_name_ {app_opt_.controllers.begin()},
+      agents_ {},
+      controllers_ {},
+      first_active_agent_ {0},
+      first_active_controller_ {0},
+      keepalive_ptr_ {}
+{
+    if (!results_file_stream_.is_open())
+        throw fatal_error {((boost::format("failed to open %1%")
+                             % results_file_name_).str())};
+}
+
+// NB: defined here, where the clients are complete types
+scenario_test::~scenario_test() = default;
+
+void scenario_test::start()
+{
+    display_setup();
+
+    keepalive_ptr_.reset(new keepalive_scheduler(
+        std::chrono::seconds(ws_connection_check_interval_s_), 1));
+    resource_monitor monitor {""};
+    auto test_start = clock_type::now();
+
+    for (std::size_t idx = 0; idx < phases_.size(); idx++) {
+        const auto& phase = phases_[idx];
+        phase_result result {};
+        result.idx  = static_cast<int>(idx + 1);
+        result.name = phase.name;
+        result.type = phase.type;
+
+        boost::nowide::cout << "Phase " << result.idx << " - " << describe_phase(phase)
+                            << std::endl;
+        LOG_INFO("Scenario phase %1% (%2%) - starting", result.idx, phase.name);
+        monitor.start_run(result.idx);
+        auto phase_start = clock_type::now();
+
+        switch (phase.type) {
+            case phase_type::connect:
+                connect(phase, result);
+                break;
+            case phase_type::hold:
+                hold(phase, result);
+                break;
+            case phase_type::messages:
+                send_messages(phase, result);
+                break;
+            case phase_type::reconnect_storm:
+                reconnect_storm(phase, result);
+                break;
+            case phase_type::teardown:
+                teardown(phase, result);
+                break;
+        }
+
+        result.duration_ms = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                clock_type::now() - phase_start).count());
+        result.resources = monitor.end_run();
+
+        for (const auto& c_ptr : get_active_clients()) {
+            result.num_clients++;
+
+            if (c_ptr->isAssociated())
+                result.num_associated++;
+        }
+
+        results_file_stream_ << result << std::endl;
+        boost::nowide::cout << result << std::endl;
+    }
+
+    keepalive_ptr_->stop();
+
+    auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        clock_type::now() - test_start).count();
+    boost::nowide::cout << "Scenario test: finished after "
+                        << util::normalize_time_interval(static_cast<uint32_t>(duration_ms))
+                        << "\n" << std::endl;
+}
+
+void scenario_test::display_setup()
+{
+    auto population = get_scenario_population(phases_);
+
+    boost::nowide::cout
+        << "\nScenario test setup:\n"
+        << "  " << phases_.size() << " phases; " << population.num_agents
+        << " agents and " << population.num_controllers << " controllers in total\n";
+
+    for (std::size_t idx = 0; idx < phases_.size(); idx++)
+        boost::nowide::cout << "    " << idx + 1 << ". " << describe_phase(phases_[idx])
+                            << "\n";
+
+    boost::nowide::cout
+        << "  keep WebSocket connections alive by pinging every "
+        << ws_connection_check_interval_s_ << " s; check for dropped clients every "
+        << reconnect_check_interval_ms_ << " ms\n"
+        << "  message TTL " << message_ttl_s_ << " s; WebSocket connection timeout "
+        << ws_connection_timeout_ms_ << " ms; Association timeout "
+        << association_timeout_s_ << " s\n\n";
+}
+
+// Private
+
+client_configuration scenario_test::get_configuration(const std::string& common_name,
+                                                      const std::string& client_type) const
+{
+    return client_configuration(common_name,
+                                client_type,
+                                app_opt_.broker_ws_uris,
+                                app_opt_.certificates_dir,
+                                ws_connection_timeout_ms_,
+                                association_timeout_s_,
+                                DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                                message_ttl_s_);
+}
+
+std::vector<std::shared_ptr<client>> scenario_test::get_active_agents() const
+{
+    return std::vector<std::shared_ptr<client>>(agents_.begin() + first_active_agent_,
+                                                agents_.end());
+}
+
+// NB: the pointers share the ownership of the controllers
+std::vector<std::shared_ptr<client>> scenario_test::get_active_controllers() const
+{
+    std::vector<std::shared_ptr<client>> client_ptrs {};
+
+    for (auto idx = first_active_controller_; idx < controllers_.size(); idx++)
+        client_ptrs.push_back(std::shared_ptr<client>(controllers_[idx],
+                                                      &controllers_[idx]->get_client()));
+
+    return client_ptrs;
+}
+
+std::vector<std::shared_ptr<client>> scenario_test::get_active_clients() const
+{
+    auto client_ptrs = get_active_agents();
+    auto controller_ptrs = get_active_controllers();
+    client_ptrs.insert(client_ptrs.end(), controller_ptrs.begin(), controller_ptrs.end());
+    return client_ptrs;
+}
+
+void scenario_test::connect(const scenario_phase& phase, phase_result& result)
+{
+    auto first_agent = agents_.size();
+    auto first_controller = controllers_.size();
+
+    for (auto idx = 0; idx < phase.num_agents; idx++)
+        agents_.push_back(std::make_shared<echo_agent>(
+            get_configuration(*next_agent_name_++, SCENARIO_AGENT)));
+
+    for (auto idx = 0; idx < phase.num_controllers; idx++)
+        controllers_.push_back(std::make_shared<paced_controller>(
+            get_configuration(*next_controller_name_++, SCENARIO_CONTROLLER)));
+
+    std::vector<std::shared_ptr<client>> client_ptrs(agents_.begin() + first_agent,
+                                                     agents_.end());
+
+    for (auto idx = first_controller; idx < controllers_.size(); idx++)
+        client_ptrs.push_back(std::shared_ptr<client>(controllers_[idx],
+                                                      &controllers_[idx]->get_client()));
+
+    std::mutex mtx {};
+    run_paced(client_ptrs.size(), phase.rate,
+              [&client_ptrs, &mtx, &result](std::size_t idx)
+              {
+                  auto start = clock_type::now();
+                  auto associated = try_connect(*client_ptrs[idx]);
+                  auto connect_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      clock_type::now() - start).count();
+
+                  std::lock_guard<std::mutex> the_lock {mtx};
+
+                  if (associated) {
+                      result.latency_us.record(static_cast<uint32_t>(connect_us));
+                  } else {
+                      result.num_failures++;
+                  }
+              });
+
+    result.num_attempts = static_cast<int>(client_ptrs.size());
+
+    // NB: torn down clients are not associated, so they are skipped
+    std::vector<keepalive_scheduler::ping_type> pings {};
+
+    for (auto& c_ptr : client_ptrs)
+        pings.push_back(
+            [c_ptr]() -> bool
+            {
+                if (!c_ptr->isAssociated())
+                    return false;
+
+                c_ptr->ping();
+                return true;
+            });
+
+    keepalive_ptr_->add(std::move(pings));
+}
+
+void scenario_test::hold(const scenario_phase& phase, phase_result& result)
+{
+    reconnect_monitor monitor {get_active_clients(),
+                               phase.policy,
+                               std::chrono::milliseconds(reconnect_check_interval_ms_),
+                               std::thread::hardware_concurrency()};
+    result.reconnect = monitor.hold(std::chrono::seconds(phase.duration_s));
+}
+
+// Controllers reconnect before sending, so that only the agents are
+// monitored
+void scenario_test::send_messages(const scenario_phase& phase, phase_result& result)
+{
+    std::vector<std::string> agent_uris {};
+
+    for (auto idx = first_active_agent_; idx < agents_.size(); idx++)
+        agent_uris.push_back((boost::format("pcp://%1%/%2%")
+                              % agents_[idx]->configuration.common_name
+                              % SCENARIO_AGENT).str());
+
+    // Discard the responses of the previous phases, if late
+    traffic_interval t_i {};
+
+    for (auto idx = first_active_controller_; idx < controllers_.size(); idx++)
+        controllers_[idx]->take_interval(t_i);
+
+    t_i = traffic_interval {};
+
+    reconnect_monitor monitor {get_active_agents(),
+                               phase.policy,
+                               std::chrono::milliseconds(reconnect_check_interval_ms_),
+                               std::thread::hardware_concurrency()};
+    auto hold_result = std::async(std::launch::async,
+                                  [&monitor, &phase]()
+                                  {
+                                      return monitor.hold(
+                                          std::chrono::seconds(phase.duration_s));
+                                  });
+
+    // The request rate is evenly split among the controllers, that
+    // start from different agents
+    auto num_controllers = controllers_.size() - first_active_controller_;
+    auto start = clock_type::now();
+    std::vector<std::thread> threads {};
+
+    for (std::size_t idx = 0; idx < num_controllers; idx++) {
+        auto rate = phase.request_rate / num_controllers
+                    + (idx < phase.request_rate % num_controllers ? 1 : 0);
+        threads.push_back(std::thread(
+            &paced_controller::send_requests,
+            controllers_[first_active_controller_ + idx].get(),
+            std::cref(agent_uris), idx * agent_uris.size() / num_controllers,
+            static_cast<unsigned int>(rate),
+            start + std::chrono::seconds(phase.duration_s)));
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    result.traffic_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            clock_type::now() - start).count());
+    result.reconnect = hold_result.get();
+
+    // Wait for the responses in flight, up to a message TTL
+    auto drain_end = clock_type::now() + std::chrono::seconds(message_ttl_s_);
+
+    do {
+        for (auto idx = first_active_controller_; idx < controllers_.size(); idx++)
+            controllers_[idx]->take_interval(t_i);
+
+        if (t_i.num_responses + t_i.num_errors >= t_i.num_sent)
+            break;
+
+        std::this_thread::sleep_for(DRAIN_CHECK_INTERVAL);
+    } while (clock_type::now() < drain_end);
+
+    result.num_attempts      = static_cast<int>(t_i.num_sent);
+    result.num_failures      = static_cast<int>(t_i.num_failed_sends);
+    result.num_responses     = t_i.num_responses;
+    result.num_errors        = t_i.num_errors;
+    result.num_late_sends    = t_i.num_late_sends;
+    result.num_skipped_sends = t_i.num_skipped_sends;
+    result.latency_us        = t_i.latency_us;
+}
+
+// The dropped clients are evenly spread over the population; they are
+// closed once holding starts, so that the monitor detects the drops
+void scenario_test::reconnect_storm(const scenario_phase& phase, phase_result& result)
+{
+    auto client_ptrs = get_active_clients();
+    reconnect_monitor monitor {client_ptrs,
+                               phase.policy,
+                               std::chrono::milliseconds(reconnect_check_interval_ms_),
+                               std::thread::hardware_concurrency()};
+    auto hold_result = std::async(std::launch::async,
+                                  [&monitor, &phase]()
+                                  {
+                                      return monitor.hold(
+                                          std::chrono::seconds(phase.duration_s));
+                                  });
+
+    for (std::size_t idx = 0; idx < client_ptrs.size(); idx++) {
+        if ((idx + 1) * phase.fraction_pct / 100 == idx * phase.fraction_pct / 100)
+            continue;
+
+        if (client_ptrs[idx]->isAssociated()) {
+            client_ptrs[idx]->close(CLOSE_TIMEOUT);
+            result.num_attempts++;
+        }
+    }
+
+    LOG_INFO("Scenario phase %1% (%2%) - dropped %3% clients",
+             result.idx, phase.name, result.num_attempts);
+    result.reconnect = hold_result.get();
+    result.num_failures = result.reconnect.num_not_associated;
+}
+
+void scenario_test::teardown(const scenario_phase& phase, phase_result& result)
+{
+    auto num_agents = phase.num_agents < 0
+                      ? agents_.size() - first_active_agent_
+                      : static_cast<std::size_t>(phase.num_agents);
+    auto num_controllers = phase.num_controllers < 0
+                           ? controllers_.size() - first_active_controller_
+                           : static_cast<std::size_t>(phase.num_controllers);
+
+    std::vector<std::shared_ptr<client>> client_ptrs(
+        agents_.begin() + first_active_agent_,
+        agents_.begin() + first_active_agent_ + num_agents);
+
+    for (std::size_t idx = 0; idx < num_controllers; idx++) {
+        const auto& c_ptr = controllers_[first_active_controller_ + idx];
+        client_ptrs.push_back(std::shared_ptr<client>(c_ptr, &c_ptr->get_client()));
+    }
+
+    first_active_agent_      += num_agents;
+    first_active_controller_ += num_controllers;
+
+    std::mutex mtx {};
+    run_paced(client_ptrs.size(), phase.rate,
+              [&client_ptrs, &mtx, &result](std::size_t idx)
+              {
+                  auto start = clock_type::now();
+                  auto closed = client_ptrs[idx]->close(CLOSE_TIMEOUT);
+                  auto close_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      clock_type::now() - start).count();
+
+                  std::lock_guard<std::mutex> the_lock {mtx};
+
+                  if (closed) {
+                      result.latency_us.record(static_cast<uint32_t>(close_us));
+                  } else {
+                      result.num_failures++;
+                  }
+              });
+
+    result.num_attempts = static_cast<int>(client_ptrs.size());
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,34 @@
+#include <pcp-test/test_scenario_parameters.hpp>
+
+namespace pcp_test{
+namespace scenario_test_parameters {
+
+const std::string SCENARIO_FILE {"scenario-file"};
+const std::string PHASES {"phases"};
+const std::string WS_CONNECTION_CHECK_INTERVAL_S {"ws-connection-check-interval-s"};
+const std::string RECONNECT_CHECK_INTERVAL_MS {"reconnect-check-interval-ms"};
+const std::string MESSAGE_TTL_S {"message-ttl-s"};
+const std::string WS_CONNECTION_TIMEOUT_MS {"ws-connection-timeout-ms"};
+const std::string ASSOCIATION_TIMEOUT_S {"association-timeout-s"};
+
+const std::string TYPE {"type"};
+const std::string NAME {"name"};
+const std::string NUM_AGENTS {"num-agents"};
+const std::string NUM_CONTROLLERS {"num-controllers"};
+const std::string RATE {"rate"};
+const std::string DURATION_S {"duration-s"};
+const std::string REQUEST_RATE {"request-rate"};
+const std::string FRACTION_PCT {"fraction-pct"};
+const std::string RECONNECT_BACKOFF {"reconnect-backoff"};
+const std::string RECONNECT_BACKOFF_MS {"reconnect-backoff-ms"};
+const std::string RECONNECT_BACKOFF_MAX_MS {"reconnect-backoff-max-ms"};
+const std::string RECONNECT_JITTER {"reconnect-jitter"};
+
+const std::string CONNECT_PHASE {"connect"};
+const std::string HOLD_PHASE {"hold"};
+const std::string MESSAGES_PHASE {"messages"};
+const std::string RECONNECT_STORM_PHASE {"reconnect-storm"};
+const std::string TEARDOWN_PHASE {"teardown"};
+
+}  // namespace scenario_test_parameters
+}  // namespace pcp_test
@@ -0,0 +1,482 @@
+#include <pcp-test/test_soak.hpp>
+#include <pcp-test/test_soak_parameters.hpp>
+#include <pcp-test/keepalive_scheduler.hpp>
+#include <pcp-test/paced_traffic.hpp>
+#include <pcp-test/client_configuration.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/format.hpp>
+
+#include <boost/nowide/iostream.hpp>
+
+#include <algorithm>
+#include <functional>  // std::cref
+#include <thread>
+
+namespace pcp_test {
+
+namespace soak_par = pcp_test::soak_test_parameters;
+namespace fs       = boost::filesystem;
+
+using clock_type = std::chrono::steady_clock;
+
+static const std::string SOAK_AGENT {"soak_agent"};
+static const std::string SOAK_CONTROLLER {"soak_controller"};
+
+void run_soak_test(const application_options& a_o)
+{
+    soak_test test {a_o};
+    test.start();
+}
+
+static int get_optional_int(const application_options& a_o,
+                            const std::string& parameter,
+                            int default_value)
+{
+    return a_o.soak_test_parameters.includes(parameter)
+           ? a_o.soak_test_parameters.get<int>(parameter)
+           : default_value;
+}
+
+//
+// soak_snapshot
+//
+
+soak_snapshot::soak_snapshot()
+    : idx {0},
+      elapsed_s {0},
+      interval_ms {0},
+      num_sent {0},
+      num_failed_sends {0},
+      num_late_sends {0},
+      num_skipped_sends {0},
+      num_responses {0},
+      num_errors {0},
+      num_churned {0},
+      num_reconnected {0},
+      num_reconnect_failures {0},
+      num_clients {0},
+      num_associated {0},
+      latency_us {},
+      resources {}
+{
+}
+
+double soak_snapshot::throughput() const
+{
+    return interval_ms > 0 ? (num_responses * 1000.0) / interval_ms : 0.0;
+}
+
+void soak_snapshot::accumulate(const soak_snapshot& other)
+{
+    idx                     = other.idx;
+    elapsed_s               = other.elapsed_s;
+    interval_ms            += other.interval_ms;
+    num_sent               += other.num_sent;
+    num_failed_sends       += other.num_failed_sends;
+    num_late_sends         += other.num_late_sends;
+    num_skipped_sends      += other.num_skipped_sends;
+    num_responses          += other.num_responses;
+    num_errors             += other.num_errors;
+    num_churned            += other.num_churned;
+    num_reconnected        += other.num_reconnected;
+    num_reconnect_failures += other.num_reconnect_failures;
+    num_clients             = other.num_clients;
+    num_associated          = other.num_associated;
+    latency_us.merge(other.latency_us);
+    resources.merge(other.resources);
+}
+
+std::ostream & operator<< (std::ostream& out, const soak_snapshot& s)
+{
+    out << "  [" << util::normalize_time_interval(
+                        static_cast<uint32_t>(s.elapsed_s) * 1000) << "]  "
+        << (boost::format("%.1f") % s.throughput()) << " responses/s; "
+        << s.num_sent << " requests";
+
+    if (s.num_failed_sends)
+        out << " (" << util::red(std::to_string(s.num_failed_sends))
+            << " failed to send)";
+
+    if (s.num_late_sends)
+        out << ", " << util::yellow(std::to_string(s.num_late_sends)) << " late";
+
+    if (s.num_skipped_sends)
+        out << ", " << util::red(std::to_string(s.num_skipped_sends)) << " skipped";
+
+    if (s.num_errors)
+        out << ", " << util::yellow(std::to_string(s.num_errors)) << " errors";
+
+    out << "; latency p50 "
+        << (boost::format("%.1f") % (s.latency_us.percentile(50) / 1000.0))
+        << " ms, p99 "
+        << (boost::format("%.1f") % (s.latency_us.percentile(99) / 1000.0))
+        << " ms, max "
+        << (boost::format("%.1f") % (s.latency_us.max() / 1000.0)) << " ms\n"
+        << "                associated " << s.num_associated << " of "
+        << s.num_clients << " clients; " << s.num_churned << " churned, "
+        << s.num_reconnected << " reconnected";
+
+    if (s.num_reconnect_failures)
+        out << ", " << util::red(std::to_string(s.num_reconnect_failures))
+            << " failed to reconnect";
+
+    out << "; pcp-test RSS " << s.resources.max_rss_kb / 1024 << " MB, CPU "
+        << (boost::format("%.1f%%") % s.resources.mean_cpu_percent) << "\n";
+
+    if (s.resources.saturated)
+        out << util::yellow("  [WARNING]  ")
+            << "pcp-test itself was saturated during the interval\n";
+
+    return out;
+}
+
+// CSV: elapsed time (s), interval (ms), requests sent, failed sends,
+// late sends, skipped sends, responses, errors, throughput (responses/s), latency p50, p90, p99
+// and max (ms), associated clients, churned agents, reconnections,
+// reconnection failures, pcp-test mean CPU (%) and max RSS (KB)
+std::ofstream & operator<< (boost::nowide::ofstream& out, const soak_snapshot& s)
+{
+    out << s.elapsed_s << ","
+        << s.interval_ms << ","
+        << s.num_sent << ","
+        << s.num_failed_sends << ","
+        << s.num_late_sends << ","
+        << s.num_skipped_sends << ","
+        << s.num_responses << ","
+        << s.num_errors << ","
+        << (boost::format("%.1f") % s.throughput()) << ","
+        << s.latency_us.percentile(50) / 1000.0 << ","
+        << s.latency_us.percentile(90) / 1000.0 << ","
+        << s.latency_us.percentile(99) / 1000.0 << ","
+        << s.latency_us.max() / 1000.0 << ","
+        << s.num_associated << ","
+        << s.num_churned << ","
+        << s.num_reconnected << ","
+        << s.num_reconnect_failures << ","
+        << (boost::format("%.1f") % s.resources.mean_cpu_percent) << ","
+        << s.resources.max_rss_kb;
+
+    return out;
+}
+
+//
+// soak_test
+//
+
+static constexpr int DEFAULT_CHURN_PER_MIN {0};
+static constexpr int DEFAULT_SNAPSHOT_INTERVAL_S {60};
+static constexpr int DEFAULT_WS_CONNECTION_CHECK_INTERVAL_S {30};
+static constexpr int DEFAULT_WS_CONNECTION_TIMEOUT_MS {1500};
+static const std::chrono::milliseconds CLOSE_TIMEOUT {1000};
+static const std::chrono::milliseconds MAINTENANCE_INTERVAL {1000};
+
+soak_test::soak_test(const application_options& a_o)
+    : app_opt_(a_o),
+      duration_s_ {static_cast<unsigned int>(
+            app_opt_.soak_test_parameters.get<int>(soak_par::DURATION_S))},
+      num_agents_ {app_opt_.soak_test_parameters.get<int>(soak_par::NUM_AGENTS)},
+      num_controllers_ {app_opt_.soak_test_parameters.get<int>(soak_par::NUM_CONTROLLERS)},
+      request_rate_ {static_cast<unsigned int>(
+            app_opt_.soak_test_parameters.get<int>(soak_par::REQUEST_RATE))},
+      churn_per_min_ {static_cast<unsigned int>(
+            get_optional_int(a_o, soak_par::CHURN_PER_MIN, DEFAULT_CHURN_PER_MIN))},
+      snapshot_interval_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, soak_par::SNAPSHOT_INTERVAL_S,
+                             DEFAULT_SNAPSHOT_INTERVAL_S))},
+      ws_connection_check_interval_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, soak_par::WS_CONNECTION_CHECK_INTERVAL_S,
+                             DEFAULT_WS_CONNECTION_CHECK_INTERVAL_S))},
+      message_ttl_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, soak_par::MESSAGE_TTL_S, DEFAULT_MESSAGE_TTL_S))},
+      ws_connection_timeout_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, soak_par::WS_CONNECTION_TIMEOUT_MS,
+                             DEFAULT_WS_CONNECTION_TIMEOUT_MS))},
+      association_timeout_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, soak_par::ASSOCIATION_TIMEOUT_S,
+                             DEFAULT_ASSOCIATION_TIMEOUT_S))},
+      results_file_name_ {(boost::format("soak_test_%1%.csv")
+                           % util::get_short_datetime()).str()},
+      results_file_stream_ {(fs::path(app_opt_.results_dir)
+                             / results_file_name_).string()},
+      agents_ {},
+      controllers_ {},
+      num_churned_ {0},
+      num_reconnected_ {0},
+      num_reconnect_failures_ {0},
+      mtx_ {},
+      stop_cv_ {},
+      stopping_ {false},
+      latency_trend_ {},
+      rss_trend_ {}
+{
+    if (!results_file_stream_.is_open())
+        throw fatal_error {((boost::format("failed to open %1%")
+                             % results_file_name_).str())};
+}
+
+// NB: defined here, where the clients are complete types
+soak_test::~soak_test() = default;
+
+void soak_test::start()
+{
+    display_setup();
+
+    // Instantiate and associate the clients
+
+    std::vector<std::string> agent_uris {};
+    std::vector<client*> client_ptrs {};
+
+    auto agent_name_itr = app_opt_.agents.begin();
+    for (auto idx = 0; idx < num_agents_; idx++) {
+        agents_.push_back(std::unique_ptr<echo_agent>(
+            new echo_agent(client_configuration(
+                    *agent_name_itr++,
+                    SOAK_AGENT,
+                    app_opt_.broker_ws_uris,
+                    app_opt_.certificates_dir,
+                    ws_connection_timeout_ms_,
+                    association_timeout_s_,
+                    DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                    message_ttl_s_))));
+        agent_uris.push_back((boost::format("pcp://%1%/%2%")
+                              % agents_.back()->configuration.common_name
+                              % SOAK_AGENT).str());
+        client_ptrs.push_back(agents_.back().get());
+    }
+
+    // Controllers start from different agents, so that the load is
+    // evenly spread
+    auto controller_name_itr = app_opt_.controllers.begin();
+    for (auto idx = 0; idx < num_controllers_; idx++) {
+        controllers_.push_back(std::unique_ptr<paced_controller>(
+            new paced_controller(client_configuration(
+                    *controller_name_itr++,
+                    SOAK_CONTROLLER,
+                    app_opt_.broker_ws_uris,
+                    app_opt_.certificates_dir,
+                    ws_connection_timeout_ms_,
+                    association_timeout_s_,
+                    DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                    message_ttl_s_))));
+        client_ptrs.push_back(&controllers_.back()->get_client());
+    }
+
+    boost::nowide::cout << "Connecting " << client_ptrs.size() << " clients"
+                        << std::endl;
+
+    // NB: the agents that fail to associate are reconnected by the
+    // maintenance thread, the controllers before sending
+    if (auto num_failures = connect_clients(client_ptrs))
+        boost::nowide::cout << util::yellow("  [WARNING]  ") << num_failures
+                            << " clients failed to associate; will retry\n";
+
+    // NB: the pings refer to the clients, that outlive the scheduler
+    keepalive_scheduler keepalive {
+        std::chrono::seconds(ws_connection_check_interval_s_), 1};
+    std::vector<keepalive_scheduler::ping_type> pings {};
+
+    for (auto c_ptr : client_ptrs)
+        pings.push_back(
+            [c_ptr]() -> bool
+            {
+                if (!c_ptr->isAssociated())
+                    return false;
+
+                c_ptr->ping();
+                return true;
+            });
+
+    keepalive.add(std::move(pings));
+    resource_monitor monitor {""};
+
+    // Traffic and churn
+
+    boost::nowide::cout << "Sending " << request_rate_ * num_controllers_
+                        << " requests/s for "
+                        << util::normalize_time_interval(duration_s_ * 1000)
+                        << "\n" << std::endl;
+
+    auto start = clock_type::now();
+    auto end = start + std::chrono::seconds(duration_s_);
+    std::vector<std::thread> threads {};
+
+    for (std::size_t idx = 0; idx < controllers_.size(); idx++)
+        threads.push_back(std::thread(
+            &paced_controller::send_requests, controllers_[idx].get(),
+            std::cref(agent_uris), idx * agent_uris.size() / controllers_.size(),
+            request_rate_, end));
+
+    threads.push_back(std::thread(&soak_test::maintain_agents, this));
+
+    // Snapshots
+
+    soak_snapshot total {};
+    auto previous = start;
+    monitor.start_run(1);
+
+    for (int idx = 1; previous < end; idx++) {
+        auto next = std::min(start + std::chrono::seconds(snapshot_interval_s_ * idx), end);
+        std::this_thread::sleep_until(next);
+
+        auto s = take_snapshot(idx, start, previous);
+        s.resources = monitor.end_run();
+        monitor.start_run(idx + 1);
+        previous = next;
+
+        auto elapsed_h = s.elapsed_s / 3600.0;
+        latency_trend_.add(elapsed_h, s.latency_us.percentile(99) / 1000.0);
+        rss_trend_.add(elapsed_h, s.resources.max_rss_kb / 1024.0);
+        total.accumulate(s);
+
+        results_file_stream_ << s << std::endl;
+        boost::nowide::cout << s << std::flush;
+    }
+
+    // Stop
+
+    for (auto& c_ptr : controllers_)
+        c_ptr->stop();
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        stopping_ = true;
+    }
+
+    stop_cv_.notify_all();
+
+    for (auto& t : threads)
+        t.join();
+
+    keepalive.stop();
+    display_summary(total);
+}
+
+void soak_test::display_setup()
+{
+    boost::nowide::cout
+        << "\nSoak test setup:\n"
+        << "  " << num_controllers_ << " controllers, " << num_agents_
+        << " agents, for " << util::normalize_time_interval(duration_s_ * 1000) << "\n"
+        << "  " << request_rate_ << " requests/s per controller, round robin to the agents\n"
+        << "  " << churn_per_min_ << " agents disconnected and reconnected per minute\n"
+        << "  snapshots every " << snapshot_interval_s_ << " s; keep WebSocket "
+        << "connections alive by pinging every " << ws_connection_check_interval_s_ << " s\n"
+        << "  message TTL " << message_ttl_s_ << " s; WebSocket connection timeout "
+        << ws_connection_timeout_ms_ << " ms; Association timeout "
+        << association_timeout_s_ << " s\n\n";
+}
+
+void soak_test::display_summary(const soak_snapshot& total)
+{
+    boost::nowide::cout
+        << "\nSoak test: finished after "
+        << util::normalize_time_interval(static_cast<uint32_t>(total.elapsed_s) * 1000)
+        << "\n" << total;
+
+    // Drifts are meaningful only over a few snapshots
+    if (latency_trend_.count() > 2)
+        boost::nowide::cout
+            << "  Trends: ............ latency p99 "
+            << (boost::format("%+.3f") % latency_trend_.slope()) << " ms/h, "
+            << "pcp-test RSS " << (boost::format("%+.1f") % rss_trend_.slope())
+            << " MB/h\n";
+
+    boost::nowide::cout << std::endl;
+}
+
+// Private
+
+void soak_test::maintain_agents()
+{
+    auto tick = churn_per_min_
+                ? std::max(std::chrono::milliseconds(1),
+                           std::chrono::milliseconds(60000 / churn_per_min_))
+                : MAINTENANCE_INTERVAL;
+    auto next_check = clock_type::now() + MAINTENANCE_INTERVAL;
+    std::size_t churn_idx {0};
+    std::unique_lock<std::mutex> lck {mtx_};
+
+    while (!stop_cv_.wait_for(lck, tick, [this]() { return stopping_; })) {
+        lck.unlock();
+
+        if (churn_per_min_ && !agents_.empty()) {
+            auto& agent = *agents_[churn_idx++ % agents_.size()];
+
+            if (agent.isAssociated()) {
+                agent.close(CLOSE_TIMEOUT);
+                num_churned_++;
+                reconnect(agent);
+            }
+        }
+
+        // NB: dropped agents are checked at most once per second
+        if (clock_type::now() >= next_check) {
+            for (auto& a_ptr : agents_)
+                if (!a_ptr->isAssociated())
+                    reconnect(*a_ptr);
+
+            next_check = clock_type::now() + MAINTENANCE_INTERVAL;
+        }
+
+        lck.lock();
+    }
+}
+
+void soak_test::reconnect(echo_agent& agent)
+{
+    if (try_connect(agent)) {
+        num_reconnected_++;
+    } else {
+        num_reconnect_failures_++;
+    }
+}
+
+soak_snapshot soak_test::take_snapshot(int idx,
+                                       clock_type::time_point start,
+                                       clock_type::time_point previous)
+{
+    auto now = clock_type::now();
+    soak_snapshot s {};
+    s.idx = idx;
+    s.elapsed_s = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::seconds>(now - start).count());
+    s.interval_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - previous).count());
+
+    traffic_interval t_i {};
+
+    for (auto& c_ptr : controllers_) {
+        c_ptr->take_interval(t_i);
+
+        if (c_ptr->get_client().isAssociated())
+            s.num_associated++;
+    }
+
+    s.num_sent               = t_i.num_sent;
+    s.num_failed_sends       = t_i.num_failed_sends;
+    s.num_late_sends         = t_i.num_late_sends;
+    s.num_skipped_sends      = t_i.num_skipped_sends;
+    s.num_responses          = t_i.num_responses;
+    s.num_errors             = t_i.num_errors;
+    s.num_reconnected        = t_i.num_reconnected;
+    s.num_reconnect_failures = t_i.num_reconnect_failures;
+    s.latency_us             = t_i.latency_us;
+
+    for (auto& a_ptr : agents_)
+        if (a_ptr->isAssociated())
+            s.num_associated++;
+
+    s.num_clients = num_agents_ + num_controllers_;
+    s.num_churned            += num_churned_.exchange(0);
+    s.num_reconnected        += num_reconnected_.exchange(0);
+    s.num_reconnect_failures += num_reconnect_failures_.exchange(0);
+
+    return s;
+}
+
+}  // namespace pcp_test
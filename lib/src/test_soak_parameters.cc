@@ -0,0 +1,18 @@
+#include <pcp-test/test_soak_parameters.hpp>
+
+namespace pcp_test{
+namespace soak_test_parameters {
+
+const std::string DURATION_S {"duration-s"};
+const std::string NUM_AGENTS {"num-agents"};
+const std::string NUM_CONTROLLERS {"num-controllers"};
+const std::string REQUEST_RATE {"request-rate"};
+const std::string CHURN_PER_MIN {"churn-per-min"};
+const std::string SNAPSHOT_INTERVAL_S {"snapshot-interval-s"};
+const std::string WS_CONNECTION_CHECK_INTERVAL_S {"ws-connection-check-interval-s"};
+const std::string MESSAGE_TTL_S {"message-ttl-s"};
+const std::string WS_CONNECTION_TIMEOUT_MS {"ws-connection-timeout-ms"};
+const std::string ASSOCIATION_TIMEOUT_S {"association-timeout-s"};
+
+}  // namespace soak_test_parameters
+}  // namespace pcp_test
@@ -0,0 +1,1058 @@
+#include <pcp-test/test_throughput.hpp>
+#include <pcp-test/test_throughput_parameters.hpp>
+#include <pcp-test/connection_stats.hpp>
+#include <pcp-test/correlation_table.hpp>
+#include <pcp-test/client_configuration.hpp>
+#include <pcp-test/client.hpp>
+#include <pcp-test/message.hpp>
+#include <pcp-test/payload_generator.hpp>
+#include <pcp-test/pipelined_sender.hpp>
+#include <pcp-test/schemas.hpp>
+#include <pcp-test/sequence_tracker.hpp>
+#include <pcp-test/errors.hpp>
+#include <pcp-test/util.hpp>
+
+#include <cpp-pcp-client/connector/errors.hpp>
+#include <cpp-pcp-client/protocol/chunks.hpp>
+
+#include <leatherman/logging/logging.hpp>
+#include <leatherman/json_container/json_container.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/format.hpp>
+
+#include <boost/nowide/iostream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+namespace thr_par  = pcp_test::throughput_test_parameters;
+namespace fs       = boost::filesystem;
+namespace lth_jc   = leatherman::json_container;
+
+using clock_type = std::chrono::steady_clock;
+
+static const std::string THROUGHPUT_AGENT {"throughput_agent"};
+static const std::string THROUGHPUT_CONTROLLER {"throughput_controller"};
+
+void run_throughput_test(const application_options& a_o)
+{
+    throughput_test test {a_o};
+    test.start();
+}
+
+static int get_optional_int(const application_options& a_o,
+                            const std::string& parameter,
+                            int default_value)
+{
+    return a_o.throughput_test_parameters.includes(parameter)
+           ? a_o.throughput_test_parameters.get<int>(parameter)
+           : default_value;
+}
+
+//
+// throughput_test_run
+//
+
+throughput_test_run::throughput_test_run(const application_options& a_o)
+    : agents_increment_ {get_optional_int(a_o, thr_par::AGENTS_INCREMENT, 0)},
+      controllers_increment_ {get_optional_int(a_o, thr_par::CONTROLLERS_INCREMENT, 0)},
+      request_rate_increment_ {get_optional_int(a_o, thr_par::REQUEST_RATE_INCREMENT, 0)},
+      idx {1},
+      num_agents {a_o.throughput_test_parameters.get<int>(thr_par::NUM_AGENTS)},
+      num_controllers {a_o.throughput_test_parameters.get<int>(thr_par::NUM_CONTROLLERS)},
+      request_rate {get_optional_int(a_o, thr_par::REQUEST_RATE, 0)},
+      inflight_window {get_optional_int(a_o, thr_par::INFLIGHT_WINDOW, 0)},
+      send_batch_size {get_optional_int(a_o, thr_par::SEND_BATCH_SIZE, 0)}
+{
+}
+
+throughput_test_run& throughput_test_run::operator++()
+{
+    idx++;
+    num_agents      += agents_increment_;
+    num_controllers += controllers_increment_;
+
+    if (request_rate > 0)
+        request_rate += request_rate_increment_;
+
+    return *this;
+}
+
+std::string throughput_test_run::to_string() const
+{
+    auto s = (boost::format("run %1%: %2% controllers, %3% agents")
+              % idx % num_controllers % num_agents).str();
+
+    if (request_rate > 0)
+        s += (boost::format(", %1% requests/s per controller") % request_rate).str();
+
+    if (inflight_window > 0)
+        s += (boost::format(", at most %1% requests in flight per controller")
+              % inflight_window).str();
+
+    return s;
+}
+
+//
+// throughput_test_result
+//
+
+throughput_test_result::throughput_test_result(const throughput_test_run& run)
+    : num_agents {run.num_agents},
+      num_controllers {run.num_controllers},
+      num_association_failures {0},
+      num_requests {0},
+      num_responses {0},
+      num_failed_sends {0},
+      num_lost {0},
+      num_late {0},
+      num_duplicates {0},
+      num_unknown {0},
+      num_dropped {0},
+      num_reordered {0},
+      num_missing {0},
+      duration_ms {0},
+      rtt_us {},
+      latency_us {},
+      one_way_us {}
+{
+}
+
+double throughput_test_result::throughput() const
+{
+    return duration_ms > 0 ? (num_responses * 1000.0) / duration_ms : 0.0;
+}
+
+std::ostream & operator<< (std::ostream& out, const throughput_test_result& r)
+{
+    if (r.num_association_failures) {
+        out << util::red("  [FAILURE]  ") << r.num_association_failures
+            << " clients failed to associate out of "
+            << r.num_agents + r.num_controllers << "; no request was sent\n";
+        return out;
+    }
+
+    if (r.num_lost || r.num_failed_sends) {
+        out << util::red("  [FAILURE]  ") << r.num_lost << " lost responses and "
+            << r.num_failed_sends << " failed sends out of "
+            << r.num_requests + r.num_failed_sends << " requests";
+    } else {
+        out << util::green("  [SUCCESS]  ") << r.num_responses
+            << " responses to " << r.num_requests << " requests";
+    }
+
+    stats rtt {r.rtt_us};
+    out << " in " << util::normalize_time_interval(r.duration_ms)
+        << "; " << r.throughput() << " responses/s\n";
+
+    if (r.num_late || r.num_duplicates || r.num_unknown)
+        out << "  unexpected responses: " << r.num_late << " late, "
+            << r.num_duplicates << " duplicates, "
+            << r.num_unknown << " unknown\n";
+
+    if (r.num_dropped)
+        out << "  " << r.num_dropped << " requests dropped by the agents, "
+            << "as their responder queue was full\n";
+
+    out << "  Round Trip: ......... mean "
+        << rtt.mean / 1000 << " ms, std dev "
+        << rtt.stddev / 1000 << " ms, max "
+        << static_cast<float>(rtt.max) / 1000 << " ms\n"
+        << "                        p50 "
+        << static_cast<float>(rtt.p50) / 1000 << " ms, p90 "
+        << static_cast<float>(rtt.p90) / 1000 << " ms, p99 "
+        << static_cast<float>(rtt.p99) / 1000 << " ms, p99.9 "
+        << static_cast<float>(rtt.p999) / 1000 << " ms\n";
+
+    stats latency {r.latency_us};
+    out << "  Latency: ............ mean "
+        << latency.mean / 1000 << " ms, std dev "
+        << latency.stddev / 1000 << " ms, max "
+        << static_cast<float>(latency.max) / 1000 << " ms\n"
+        << "                        p50 "
+        << static_cast<float>(latency.p50) / 1000 << " ms, p90 "
+        << static_cast<float>(latency.p90) / 1000 << " ms, p99 "
+        << static_cast<float>(latency.p99) / 1000 << " ms, p99.9 "
+        << static_cast<float>(latency.p999) / 1000 << " ms\n";
+
+    stats one_way {r.one_way_us};
+    out << "  One Way: ............ mean "
+        << one_way.mean / 1000 << " ms, std dev "
+        << one_way.stddev / 1000 << " ms, max "
+        << static_cast<float>(one_way.max) / 1000 << " ms\n"
+        << "                        p50 "
+        << static_cast<float>(one_way.p50) / 1000 << " ms, p90 "
+        << static_cast<float>(one_way.p90) / 1000 << " ms, p99 "
+        << static_cast<float>(one_way.p99) / 1000 << " ms, p99.9 "
+        << static_cast<float>(one_way.p999) / 1000 << " ms\n";
+
+    if (r.num_reordered || r.num_missing)
+        out << "  requests received by the agents out of sequence: "
+            << r.num_reordered << " reordered, " << r.num_missing << " missing\n";
+
+    return out;
+}
+
+std::ofstream & operator<< (boost::nowide::ofstream& out,
+                            const throughput_test_result& r)
+{
+    stats rtt {r.rtt_us};
+    out << r.num_agents << ","
+        << r.num_controllers << ","
+        << r.num_association_failures << ","
+        << r.num_requests << ","
+        << r.num_responses << ","
+        << r.num_failed_sends << ","
+        << r.num_lost << ","
+        << r.num_late << ","
+        << r.num_duplicates << ","
+        << r.num_unknown << ","
+        << r.duration_ms << ","
+        << r.throughput() << ","
+        << rtt.mean / 1000 << ","
+        << rtt.stddev / 1000 << ","
+        << static_cast<float>(rtt.max) / 1000 << ","
+        << static_cast<float>(rtt.p50) / 1000 << ","
+        << static_cast<float>(rtt.p90) / 1000 << ","
+        << static_cast<float>(rtt.p99) / 1000 << ","
+        << static_cast<float>(rtt.p999) / 1000;
+
+    // The latency is appended, to keep the previous columns layout
+    stats latency {r.latency_us};
+    out << "," << latency.mean / 1000 << ","
+        << latency.stddev / 1000 << ","
+        << static_cast<float>(latency.max) / 1000 << ","
+        << static_cast<float>(latency.p50) / 1000 << ","
+        << static_cast<float>(latency.p90) / 1000 << ","
+        << static_cast<float>(latency.p99) / 1000 << ","
+        << static_cast<float>(latency.p999) / 1000;
+
+    stats one_way {r.one_way_us};
+    out << "," << one_way.mean / 1000 << ","
+        << one_way.stddev / 1000 << ","
+        << static_cast<float>(one_way.max) / 1000 << ","
+        << static_cast<float>(one_way.p50) / 1000 << ","
+        << static_cast<float>(one_way.p90) / 1000 << ","
+        << static_cast<float>(one_way.p99) / 1000 << ","
+        << static_cast<float>(one_way.p999) / 1000 << ","
+        << r.num_reordered << ","
+        << r.num_missing;
+
+    return out;
+}
+
+//
+// Agents and Controllers
+//
+
+static uint32_t ns_to_us(int64_t ns)
+{
+    return static_cast<uint32_t>(std::max<int64_t>(0, std::min<int64_t>(
+        ns / 1000, std::numeric_limits<uint32_t>::max())));
+}
+
+// Replies to each request with a response that carries the same data;
+// in case of a responder pool, requests are processed by its workers
+// instead of the WebSocket event loop thread.
+// On arrival, the one-way latency of requests is measured from their
+// send time (controllers and agents share the monotonic clock of the
+// process) and their sequence numbers are tracked per controller.
+class throughput_agent : public client
+{
+  public:
+    throughput_agent(client_configuration config, responder_pool* responders)
+        : client(std::move(config)),
+          responders_ {responders},
+          sequences_ {},
+          mtx_ {},
+          one_way_us_ {}
+    {
+    }
+
+    // Must be called once the agent stopped receiving requests
+    void add_results(throughput_test_result& result) const
+    {
+        auto counters = sequences_.get_counters();
+        result.num_reordered += counters.reordered;
+        result.num_missing   += counters.missing;
+
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        result.one_way_us.merge(one_way_us_);
+    }
+
+  private:
+    responder_pool* responders_;
+    sequence_tracker sequences_;
+
+    // Synchronizes access to the histogram, written by the event loop
+    // thread only
+    mutable std::mutex mtx_;
+    latency_histogram one_way_us_;
+
+    void record_arrival(const PCPClient::ParsedChunks& parsed_chunks)
+    {
+        auto now_ns = util::get_monotonic_ns();
+
+        try {
+            message_view req {parsed_chunks};
+            auto sent_ns = req.sent_ns();
+
+            if (!sent_ns)
+                return;
+
+            sequences_.record(req.sender(), req.sequence());
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            one_way_us_.record(ns_to_us(now_ns - sent_ns));
+        } catch (const message::error&) {
+            // NB: not echoed either; the controller deems it lost
+        }
+    }
+
+    virtual void process_request(const PCPClient::ParsedChunks& parsed_chunks)
+    {
+        record_arrival(parsed_chunks);
+
+        if (responders_) {
+            responders_->enqueue(parsed_chunks, this);
+        } else {
+            echo(parsed_chunks);
+        }
+    }
+};
+
+// Interval between the expiry of lost requests
+static const auto EXPIRY_INTERVAL = std::chrono::milliseconds(100);
+
+// Size of the correlation table in case no in-flight window is
+// specified: twice the requests sent in a response timeout interval
+static std::size_t get_correlation_capacity(int request_rate,
+                                            int inflight_window,
+                                            unsigned int response_timeout_ms)
+{
+    if (inflight_window > 0)
+        return static_cast<std::size_t>(inflight_window);
+
+    return std::max<std::size_t>(
+        1, 2 * static_cast<std::size_t>(request_rate) * response_timeout_ms / 1000);
+}
+
+// Sends requests to the agents, in a round-robin fashion, and tracks
+// the related responses with a correlation table; requests that are
+// not replied within the response timeout are deemed lost.
+// Requests are sent by send_requests(), that blocks, whereas responses
+// are processed by the WebSocket event loop thread of the client.
+// Requests carry the pre-built payloads of the specified generator,
+// in turn. The data chunks are built once per run and shared, read-only,
+// by all controllers; the transaction, sequence number, and send time
+// of each request are carried by a small header chunk, the only one
+// built per request (see message::write_header()).
+// Requests are numbered per agent, so that agents can detect reordered
+// and missing requests.
+// In case of a send batch size, requests are pipelined: they are queued,
+// each with its header chunk and a reference to its shared data chunk,
+// and sent in batches by the thread of a pipelined_sender, whose window
+// is the in-flight one; requests are registered in the correlation
+// table right before being sent.
+class throughput_controller
+{
+  public:
+    throughput_controller(client_configuration config,
+                          const std::vector<std::string>& agent_uris,
+                          std::size_t first_agent_idx,
+                          int request_rate,
+                          int inflight_window,
+                          int send_batch_size,
+                          unsigned int response_timeout_ms,
+                          const payload_generator& payloads)
+        : agent_endpoints_ {},
+          next_agent_idx_ {first_agent_idx},
+          agent_sequences_(agent_uris.size(), 0),
+          send_interval_ {request_rate > 0
+                          ? std::chrono::duration_cast<clock_type::duration>(
+                                std::chrono::duration<double>(1.0 / request_rate))
+                          : clock_type::duration::zero()},
+          table_ {get_correlation_capacity(request_rate, inflight_window,
+                                           response_timeout_ms),
+                  std::chrono::milliseconds(response_timeout_ms)},
+          payloads_(payloads),
+          next_payload_idx_ {0},
+          header_ {},
+          transaction_seq_ {0},
+          num_requests_ {0},
+          num_failed_sends_ {0},
+          num_invalid_ {0},
+          connection_lost_ {false},
+          mtx_ {},
+          cv_ {},
+          next_expiry_ {},
+          last_response_ {},
+          pipeline_ {},
+          client_ {std::move(config)}
+    {
+        for (const auto& uri : agent_uris)
+            agent_endpoints_.push_back(std::vector<std::string> {uri});
+
+        client_.response_callback =
+            [this](const PCPClient::ParsedChunks& parsed_chunks, client*)
+            {
+                process_response(parsed_chunks);
+            };
+
+        if (send_batch_size > 0)
+            pipeline_.reset(new pipelined_sender(
+                client_,
+                static_cast<std::size_t>(inflight_window),
+                static_cast<std::size_t>(send_batch_size),
+                [this](const outgoing_request& request)
+                {
+                    table_.insert(request.transaction, clock_type::now(),
+                                  request.intended_send);
+                },
+                [this](const outgoing_request& request, bool sent)
+                {
+                    process_send_outcome(request, sent);
+                }));
+    }
+
+    // The sender thread uses the client, so it must be joined first
+    ~throughput_controller()
+    {
+        if (pipeline_)
+            pipeline_->stop();
+    }
+
+    client& get_client() { return client_; }
+
+    // Send requests until the specified time point, by respecting
+    // the request rate and the in-flight window
+    void send_requests(clock_type::time_point end)
+    {
+        const auto& cn = client_.configuration.common_name;
+        auto next_send = clock_type::now();
+        next_expiry_ = next_send + EXPIRY_INTERVAL;
+
+        while (true) {
+            // In case of a request rate, requests are intended to be
+            // sent on schedule, even if the sender falls behind;
+            // otherwise, as soon as possible
+            auto intended_send = clock_type::now();
+
+            if (send_interval_ > clock_type::duration::zero()) {
+                if (next_send >= end)
+                    break;
+
+                std::this_thread::sleep_until(next_send);
+                intended_send = next_send;
+                next_send += send_interval_;
+            }
+
+            // NB: in case of synchronous sends, requests are stamped
+            // once an in-flight slot is available
+            if (!pipeline_ && !wait_for_slot(end))
+                break;
+
+            std::string transaction {cn + "_" + std::to_string(transaction_seq_++)};
+            const auto& endpoints = agent_endpoints_[next_agent_idx_];
+            auto sequence = ++agent_sequences_[next_agent_idx_];
+            auto sent_ns = util::get_monotonic_ns();
+            auto payload_idx = next_payload_idx_;
+            next_payload_idx_ = (next_payload_idx_ + 1) % payloads_.num_payloads();
+
+            message::write_header(header_, transaction, sequence, sent_ns);
+
+            if (pipeline_) {
+                outgoing_request request {transaction, &endpoints, payloads_.format(),
+                                          nullptr, nullptr, header_, intended_send};
+
+                if (payloads_.format() == payload_format::json) {
+                    request.json_data = &payloads_.get_data(payload_idx);
+                } else {
+                    request.binary_data = &payloads_.get(payload_idx);
+                }
+
+                if (!submit_pipelined(request, end))
+                    break;
+
+                next_agent_idx_ = (next_agent_idx_ + 1) % agent_endpoints_.size();
+                continue;
+            }
+
+            // NB: transactions are unique and a slot is available
+            table_.insert(transaction, clock_type::now(), intended_send);
+
+            auto sent = payloads_.format() == payload_format::json
+                        ? client_.send_request(endpoints,
+                                               payloads_.get_data(payload_idx),
+                                               header_)
+                        : client_.send_binary_request(endpoints,
+                                                      payloads_.get(payload_idx),
+                                                      header_);
+
+            if (sent) {
+                num_requests_++;
+            } else {
+                table_.cancel(transaction);
+                num_failed_sends_++;
+
+                if (!client_.isConnected()) {
+                    LOG_WARNING("%1%: the connection was lost; stop sending",
+                                cn);
+                    break;
+                }
+            }
+
+            next_agent_idx_ = (next_agent_idx_ + 1) % agent_endpoints_.size();
+        }
+
+        // Send the queued requests, if any
+        if (pipeline_)
+            pipeline_->stop();
+    }
+
+    // Wait until all in-flight requests are replied or the deadline;
+    // the requests that are still in flight are then expired
+    void wait_for_responses(clock_type::time_point deadline)
+    {
+        {
+            std::unique_lock<std::mutex> lck {mtx_};
+            cv_.wait_until(lck, deadline, [this]() { return table_.size() == 0; });
+        }
+
+        table_.expire_all();
+    }
+
+    // Must be called after wait_for_responses()
+    void add_results(throughput_test_result& result,
+                     clock_type::time_point& last_response) const
+    {
+        auto counters = table_.get_counters();
+        result.num_requests     += num_requests_;
+        result.num_responses    += counters.matched;
+        result.num_failed_sends += num_failed_sends_;
+        result.num_lost         += counters.expired;
+        result.num_late         += counters.late;
+        result.num_duplicates   += counters.duplicates;
+        result.num_unknown      += counters.unknown + num_invalid_.load();
+        result.rtt_us.merge(table_.get_rtt_us());
+        result.latency_us.merge(table_.get_latency_us());
+
+        if (pipeline_) {
+            auto p_counters = pipeline_->get_counters();
+            LOG_DEBUG("%1%: %2% requests sent in %3% batches",
+                      client_.configuration.common_name,
+                      p_counters.sent, p_counters.batches);
+        }
+
+        std::lock_guard<std::mutex> the_lock {mtx_};
+        last_response = std::max(last_response, last_response_);
+    }
+
+  private:
+    std::vector<std::vector<std::string>> agent_endpoints_;
+    std::size_t next_agent_idx_;
+    std::vector<uint64_t> agent_sequences_;  // last sent, per agent
+    clock_type::duration send_interval_;
+    correlation_table table_;
+
+    // Accessed only by the sender thread
+    const payload_generator& payloads_;
+    std::size_t next_payload_idx_;
+    lth_jc::JsonContainer header_;
+    uint64_t transaction_seq_;
+    uint64_t num_requests_;
+    uint64_t num_failed_sends_;
+
+    std::atomic<uint64_t> num_invalid_;
+    std::atomic<bool> connection_lost_;
+
+    // Synchronizes the wait for in-flight slots and responses
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    clock_type::time_point next_expiry_;
+    clock_type::time_point last_response_;
+
+    // NB: acknowledged by the response callback, so it must outlive
+    // the client
+    std::unique_ptr<pipelined_sender> pipeline_;
+
+    // NB: declared last, so that it's destroyed first, with its event
+    // loop thread, before the state accessed by the response callback
+    client client_;
+
+    // Wait until the number of in-flight requests is below the table
+    // capacity, by periodically expiring lost requests; return false
+    // in case the specified time point is reached first
+    bool wait_for_slot(clock_type::time_point end)
+    {
+        std::unique_lock<std::mutex> lck {mtx_};
+
+        while (true) {
+            auto now = clock_type::now();
+
+            if (now >= end)
+                return false;
+
+            if (now >= next_expiry_) {
+                table_.expire(now);
+                next_expiry_ = now + EXPIRY_INTERVAL;
+            }
+
+            if (table_.size() < table_.capacity())
+                return true;
+
+            cv_.wait_until(lck, std::min(end, next_expiry_));
+        }
+    }
+
+    // Queue the request, by expiring lost requests while waiting for a
+    // slot of the pipeline window; return false in case the specified
+    // time point is reached first or the connection was lost
+    bool submit_pipelined(outgoing_request& request, clock_type::time_point end)
+    {
+        while (!connection_lost_) {
+            auto now = clock_type::now();
+
+            if (now >= end)
+                return false;
+
+            // NB: next_expiry_ is accessed only by this thread when
+            // requests are pipelined
+            if (now >= next_expiry_) {
+                pipeline_->acknowledge(table_.expire(now));
+                next_expiry_ = now + EXPIRY_INTERVAL;
+            }
+
+            if (pipeline_->submit(request, std::min(end, next_expiry_)))
+                return true;
+        }
+
+        LOG_WARNING("%1%: the connection was lost; stop sending",
+                    client_.configuration.common_name);
+        return false;
+    }
+
+    // Executed by the pipeline thread after each send attempt
+    void process_send_outcome(const outgoing_request& request, bool sent)
+    {
+        if (sent) {
+            num_requests_++;
+            return;
+        }
+
+        table_.cancel(request.transaction);
+        num_failed_sends_++;
+
+        if (!client_.isConnected())
+            connection_lost_ = true;
+    }
+
+    void process_response(const PCPClient::ParsedChunks& parsed_chunks)
+    {
+        auto now = clock_type::now();
+
+        try {
+            message_view resp {parsed_chunks};
+
+            if (table_.match(resp.transaction().to_string(), now)
+                    != correlation_table::match_outcome::matched)
+                return;
+
+            if (pipeline_)
+                pipeline_->acknowledge();
+        } catch (const message::error& e) {
+            LOG_WARNING("%1%: invalid response (%2%)",
+                        client_.configuration.common_name, e.what());
+            num_invalid_++;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> the_lock {mtx_};
+            last_response_ = now;
+        }
+        cv_.notify_all();
+    }
+};
+
+//
+// throughput_test
+//
+
+static constexpr int DEFAULT_RESPONSE_TIMEOUT_MS {5000};
+static constexpr int DEFAULT_WS_CONNECTION_TIMEOUT_MS {1500};
+static constexpr int DEFAULT_NUM_PAYLOADS {64};
+
+static payload_size_distribution get_payload_size_distribution(
+        const application_options& a_o)
+{
+    const auto& p = a_o.throughput_test_parameters;
+
+    if (!p.includes(thr_par::PAYLOAD_SIZE_DISTRIBUTION))
+        return payload_size_distribution::fixed;
+
+    auto distribution = p.get<std::string>(thr_par::PAYLOAD_SIZE_DISTRIBUTION);
+
+    if (distribution == thr_par::UNIFORM_SIZE)
+        return payload_size_distribution::uniform;
+
+    if (distribution == thr_par::EXPONENTIAL_SIZE)
+        return payload_size_distribution::exponential;
+
+    return payload_size_distribution::fixed;
+}
+
+static delay_distribution get_processing_delay_distribution(
+        const application_options& a_o)
+{
+    const auto& p = a_o.throughput_test_parameters;
+
+    if (!p.includes(thr_par::PROCESSING_DELAY_DISTRIBUTION))
+        return delay_distribution::fixed;
+
+    auto distribution = p.get<std::string>(thr_par::PROCESSING_DELAY_DISTRIBUTION);
+
+    if (distribution == thr_par::UNIFORM_SIZE)
+        return delay_distribution::uniform;
+
+    if (distribution == thr_par::EXPONENTIAL_SIZE)
+        return delay_distribution::exponential;
+
+    return delay_distribution::fixed;
+}
+
+throughput_test::throughput_test(const application_options& a_o)
+    : app_opt_(a_o),
+      num_runs_ {app_opt_.throughput_test_parameters.get<int>(thr_par::NUM_RUNS)},
+      inter_run_pause_ms_ {static_cast<unsigned int>(
+            app_opt_.throughput_test_parameters.get<int>(thr_par::INTER_RUN_PAUSE_MS))},
+      run_duration_s_ {static_cast<unsigned int>(
+            app_opt_.throughput_test_parameters.get<int>(thr_par::RUN_DURATION_S))},
+      response_timeout_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::RESPONSE_TIMEOUT_MS, DEFAULT_RESPONSE_TIMEOUT_MS))},
+      message_ttl_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::MESSAGE_TTL_S, DEFAULT_MESSAGE_TTL_S))},
+      ws_connection_timeout_ms_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::WS_CONNECTION_TIMEOUT_MS,
+                             DEFAULT_WS_CONNECTION_TIMEOUT_MS))},
+      association_timeout_s_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::ASSOCIATION_TIMEOUT_S,
+                             DEFAULT_ASSOCIATION_TIMEOUT_S))},
+      payload_format_ {
+            app_opt_.throughput_test_parameters.includes(thr_par::PAYLOAD_FORMAT)
+            && app_opt_.throughput_test_parameters.get<std::string>(thr_par::PAYLOAD_FORMAT)
+                == thr_par::BINARY_PAYLOAD
+            ? payload_format::binary
+            : payload_format::json},
+      payload_size_distribution_ {get_payload_size_distribution(a_o)},
+      payload_size_ {static_cast<std::size_t>(
+            get_optional_int(a_o, thr_par::PAYLOAD_SIZE, 0))},
+      payload_max_size_ {static_cast<std::size_t>(
+            get_optional_int(a_o, thr_par::PAYLOAD_MAX_SIZE, 0))},
+      num_payloads_ {static_cast<std::size_t>(
+            get_optional_int(a_o, thr_par::NUM_PAYLOADS, DEFAULT_NUM_PAYLOADS))},
+      responder_threads_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::RESPONDER_THREADS, 0))},
+      responder_queue_size_ {static_cast<std::size_t>(
+            get_optional_int(a_o, thr_par::RESPONDER_QUEUE_SIZE,
+                             static_cast<int>(responder_pool::DEFAULT_QUEUE_CAPACITY)))},
+      processing_delay_distribution_ {get_processing_delay_distribution(a_o)},
+      processing_delay_us_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::PROCESSING_DELAY_US, 0))},
+      processing_delay_max_us_ {static_cast<unsigned int>(
+            get_optional_int(a_o, thr_par::PROCESSING_DELAY_MAX_US, 0))},
+      current_run_ {app_opt_},
+      results_file_name_ {(boost::format("throughput_test_%1%.csv")
+                           % util::get_short_datetime()).str()},
+      results_file_stream_ {(fs::path(app_opt_.results_dir)
+                             / results_file_name_).string()}
+{
+    if (!results_file_stream_.is_open())
+        throw fatal_error {((boost::format("failed to open %1%")
+                             % results_file_name_).str())};
+}
+
+void throughput_test::start()
+{
+    auto start_time = std::chrono::system_clock::now();
+    LOG_INFO("Requested %1% runs", num_runs_);
+    boost::format run_msg_fmt {"Starting %1%"};
+    display_setup();
+
+    do {
+        boost::nowide::cout << (run_msg_fmt % current_run_.to_string()).str()
+                            << std::endl;
+        auto results = perform_current_run();
+        results_file_stream_ << results << '\n';
+        boost::nowide::cout << results << '\n';
+        ++current_run_;
+
+        if (current_run_.idx <= num_runs_)
+            std::this_thread::sleep_for(std::chrono::milliseconds(inter_run_pause_ms_));
+    } while (current_run_.idx <= num_runs_);
+
+    display_execution_time(start_time);
+}
+
+void throughput_test::display_setup()
+{
+    boost::nowide::cout
+        << "\nThroughput test setup:\n"
+        << "  " << current_run_.num_controllers << " controllers (+"
+        << get_optional_int(app_opt_, thr_par::CONTROLLERS_INCREMENT, 0)
+        << " per run), " << current_run_.num_agents << " agents (+"
+        << get_optional_int(app_opt_, thr_par::AGENTS_INCREMENT, 0) << " per run)\n"
+        << "  " << num_runs_ << " runs of " << run_duration_s_ << " s, "
+        << inter_run_pause_ms_ << " ms pause between each run\n"
+        << "  request rate per controller: ";
+
+    if (current_run_.request_rate > 0) {
+        boost::nowide::cout
+            << current_run_.request_rate << " requests/s (+"
+            << get_optional_int(app_opt_, thr_par::REQUEST_RATE_INCREMENT, 0)
+            << " per run)\n";
+    } else {
+        boost::nowide::cout << "unlimited\n";
+    }
+
+    boost::nowide::cout << "  in-flight window per controller: ";
+
+    if (current_run_.inflight_window > 0) {
+        boost::nowide::cout << current_run_.inflight_window << " requests\n";
+    } else {
+        boost::nowide::cout << "unlimited\n";
+    }
+
+    if (current_run_.send_batch_size > 0)
+        boost::nowide::cout << "  pipelined sends, in batches of at most "
+                            << current_run_.send_batch_size << " requests\n";
+
+    boost::nowide::cout
+        << "  payload: " << (payload_format_ == payload_format::json ? "JSON" : "binary")
+        << ", " << payload_size_ << " bytes";
+
+    switch (payload_size_distribution_) {
+        case (payload_size_distribution::uniform):
+            boost::nowide::cout << " to " << payload_max_size_
+                                << " bytes (uniform distribution)";
+            break;
+        case (payload_size_distribution::exponential):
+            boost::nowide::cout << " (mean value - exp. distribution, max "
+                                << payload_max_size_ << " bytes)";
+            break;
+        default:
+            break;
+    }
+
+    boost::nowide::cout
+        << ", " << num_payloads_ << " pre-built payloads\n";
+
+    if (responder_threads_ > 0) {
+        boost::nowide::cout
+            << "  agents' responder pool: " << responder_threads_ << " threads, "
+            << "queue of " << responder_queue_size_ << " requests; processing delay "
+            << processing_delay_us_ << " us";
+
+        switch (processing_delay_distribution_) {
+            case (delay_distribution::uniform):
+                boost::nowide::cout << " to " << processing_delay_max_us_
+                                    << " us (uniform distribution)";
+                break;
+            case (delay_distribution::exponential):
+                boost::nowide::cout << " (mean value - exp. distribution, max "
+                                    << processing_delay_max_us_ << " us)";
+                break;
+            default:
+                break;
+        }
+
+        boost::nowide::cout << "\n";
+    }
+
+    boost::nowide::cout
+        << "  response timeout " << response_timeout_ms_ << " ms; message TTL "
+        << message_ttl_s_ << " s\n"
+        << "  WebSocket connection timeout " << ws_connection_timeout_ms_ << " ms; "
+        << "Association timeout " << association_timeout_s_ << " s\n\n";
+}
+
+void throughput_test::display_execution_time(
+        std::chrono::system_clock::time_point start_time)
+{
+    auto end_time = std::chrono::system_clock::now();
+    auto duration_m = std::chrono::duration_cast<std::chrono::minutes>(
+            end_time - start_time).count();
+    auto duration_s = std::chrono::duration_cast<std::chrono::seconds>(
+            end_time - start_time).count() - (duration_m * 60);
+
+    boost::nowide::cout
+        << "\nThroughput test: finished in " << duration_m << " m "
+        << duration_s << " s\n" << std::endl;
+}
+
+throughput_test_result throughput_test::perform_current_run()
+{
+    throughput_test_result result {current_run_};
+
+    // Instantiate clients; payloads are built once per run and shared
+    // by all controllers. NB: declared before the controllers, as their
+    // pipelined requests reference the data chunks
+
+    payload_generator payloads {payload_format_,
+                                payload_size_distribution_,
+                                num_payloads_,
+                                payload_size_,
+                                payload_max_size_,
+                                current_run_.idx};
+
+    // NB: declared before the agents, as their event loop threads may
+    // enqueue requests until they are destroyed; the workers must be
+    // stopped before destroying the agents, though
+    std::unique_ptr<responder_pool> responders {};
+
+    if (responder_threads_ > 0)
+        responders.reset(new responder_pool(
+            [](const PCPClient::ParsedChunks& parsed_chunks, client* client_ptr)
+            {
+                client_ptr->echo(parsed_chunks);
+            },
+            responder_threads_,
+            responder_queue_size_,
+            processing_delay_distribution_,
+            processing_delay_us_,
+            processing_delay_max_us_,
+            current_run_.idx));
+
+    std::vector<std::unique_ptr<throughput_agent>> agents {};
+    std::vector<std::string> agent_uris {};
+    std::vector<std::unique_ptr<throughput_controller>> controllers {};
+    std::vector<client*> client_ptrs {};
+
+    auto agent_name_itr = app_opt_.agents.begin();
+    for (auto idx = 0; idx < current_run_.num_agents; idx++) {
+        agents.push_back(std::unique_ptr<throughput_agent>(
+            new throughput_agent(client_configuration(
+                    *agent_name_itr++,
+                    THROUGHPUT_AGENT,
+                    app_opt_.broker_ws_uris,
+                    app_opt_.certificates_dir,
+                    ws_connection_timeout_ms_,
+                    association_timeout_s_,
+                    DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                    message_ttl_s_),
+                responders.get())));
+        agent_uris.push_back((boost::format("pcp://%1%/%2%")
+                              % agents.back()->configuration.common_name
+                              % THROUGHPUT_AGENT).str());
+        client_ptrs.push_back(agents.back().get());
+    }
+
+    auto controller_name_itr = app_opt_.controllers.begin();
+    for (auto idx = 0; idx < current_run_.num_controllers; idx++) {
+        // Spread the first requests of the controllers across the agents
+        controllers.push_back(std::unique_ptr<throughput_controller>(
+            new throughput_controller(
+                    client_configuration(*controller_name_itr++,
+                                         THROUGHPUT_CONTROLLER,
+                                         app_opt_.broker_ws_uris,
+                                         app_opt_.certificates_dir,
+                                         ws_connection_timeout_ms_,
+                                         association_timeout_s_,
+                                         DEFAULT_ASSOCIATION_REQUEST_TTL_S,
+                                         message_ttl_s_),
+                    agent_uris,
+                    idx % agent_uris.size(),
+                    current_run_.request_rate,
+                    current_run_.inflight_window,
+                    current_run_.send_batch_size,
+                    response_timeout_ms_,
+                    payloads)));
+        client_ptrs.push_back(&controllers.back()->get_client());
+    }
+
+    // Associate
+
+    boost::nowide::cout << "                connecting "
+                        << client_ptrs.size() << " clients" << std::endl;
+    result.num_association_failures = connect_clients(client_ptrs);
+
+    if (result.num_association_failures) {
+        LOG_WARNING("%1% clients failed to associate; skipping run %2%",
+                    result.num_association_failures, current_run_.idx);
+
+        if (responders)
+            responders->stop();
+
+        return result;
+    }
+
+    // Send requests
+
+    boost::nowide::cout << "                sending requests for "
+                        << run_duration_s_ << " s" << std::endl;
+    auto start = clock_type::now();
+    auto end = start + std::chrono::seconds(run_duration_s_);
+    std::vector<std::thread> senders {};
+
+    try {
+        for (auto& c_ptr : controllers)
+            senders.push_back(std::thread(&throughput_controller::send_requests,
+                                          c_ptr.get(), end));
+    } catch (std::exception& e) {
+        boost::nowide::cout
+            << "\n" << util::red("   [ERROR]   ")
+            << "failed to start the sender threads - thread error: "
+            << e.what() << "\n";
+
+        // NB: the senders already started stop at the end of the run
+        for (auto& s : senders)
+            s.join();
+
+        throw fatal_error { "failed to start the sender threads" };
+    }
+
+    for (auto& s : senders)
+        s.join();
+
+    auto deadline = clock_type::now() + std::chrono::milliseconds(response_timeout_ms_);
+
+    for (auto& c_ptr : controllers)
+        c_ptr->wait_for_responses(deadline);
+
+    // Retrieve results
+
+    auto last_response = start;
+
+    for (auto& c_ptr : controllers)
+        c_ptr->add_results(result, last_response);
+
+    for (auto& a_ptr : agents)
+        a_ptr->add_results(result);
+
+    result.duration_ms = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            last_response - start).count());
+
+    if (responders) {
+        responders->stop();
+        result.num_dropped = responders->get_counters().dropped;
+    }
+
+    boost::nowide::cout << "                done - closing connections"
+                        << std::endl;
+
+    return result;
+}
+
+}  // namespace pcp_test
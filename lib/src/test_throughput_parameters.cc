@@ -0,0 +1,40 @@
+#include <pcp-test/test_throughput_parameters.hpp>
+
+namespace pcp_test{
+namespace throughput_test_parameters {
+
+const std::string NUM_RUNS {"num-runs"};
+const std::string INTER_RUN_PAUSE_MS {"inter-run-pause-ms"};
+const std::string NUM_AGENTS {"num-agents"};
+const std::string NUM_CONTROLLERS {"num-controllers"};
+const std::string RUN_DURATION_S {"run-duration-s"};
+const std::string AGENTS_INCREMENT {"agents-increment"};
+const std::string CONTROLLERS_INCREMENT {"controllers-increment"};
+const std::string REQUEST_RATE {"request-rate"};
+const std::string REQUEST_RATE_INCREMENT {"request-rate-increment"};
+const std::string INFLIGHT_WINDOW {"inflight-window"};
+const std::string SEND_BATCH_SIZE {"send-batch-size"};
+const std::string RESPONSE_TIMEOUT_MS {"response-timeout-ms"};
+const std::string MESSAGE_TTL_S {"message-ttl-s"};
+const std::string WS_CONNECTION_TIMEOUT_MS {"ws-connection-timeout-ms"};
+const std::string ASSOCIATION_TIMEOUT_S {"association-timeout-s"};
+const std::string PAYLOAD_SIZE {"payload-size"};
+const std::string PAYLOAD_MAX_SIZE {"payload-max-size"};
+const std::string PAYLOAD_SIZE_DISTRIBUTION {"payload-size-distribution"};
+const std::string PAYLOAD_FORMAT {"payload-format"};
+const std::string NUM_PAYLOADS {"num-payloads"};
+const std::string RESPONDER_THREADS {"responder-threads"};
+const std::string RESPONDER_QUEUE_SIZE {"responder-queue-size"};
+const std::string PROCESSING_DELAY_US {"processing-delay-us"};
+const std::string PROCESSING_DELAY_MAX_US {"processing-delay-max-us"};
+const std::string PROCESSING_DELAY_DISTRIBUTION {"processing-delay-distribution"};
+
+const std::string FIXED_SIZE {"fixed"};
+const std::string UNIFORM_SIZE {"uniform"};
+const std::string EXPONENTIAL_SIZE {"exponential"};
+
+const std::string JSON_PAYLOAD {"json"};
+const std::string BINARY_PAYLOAD {"binary"};
+
+}  // namespace throughput_test_parameters
+}  // namespace pcp_test
@@ -0,0 +1,42 @@
+#include <pcp-test/trend.hpp>
+
+namespace pcp_test {
+
+linear_trend::linear_trend()
+        : n_ {0},
+          mean_x_ {0.0},
+          mean_y_ {0.0},
+          m2_x_ {0.0},
+          c_xy_ {0.0}
+{
+}
+
+void linear_trend::add(double x, double y)
+{
+    n_++;
+    auto dx = x - mean_x_;
+    mean_x_ += dx / n_;
+    mean_y_ += (y - mean_y_) / n_;
+
+    // NB: the deviation of x from the old mean times the one of y
+    // (or of x) from the new mean
+    m2_x_ += dx * (x - mean_x_);
+    c_xy_ += dx * (y - mean_y_);
+}
+
+std::size_t linear_trend::count() const
+{
+    return n_;
+}
+
+double linear_trend::slope() const
+{
+    return (n_ < 2 || m2_x_ <= 0.0) ? 0.0 : c_xy_ / m2_x_;
+}
+
+double linear_trend::intercept() const
+{
+    return mean_y_ - slope() * mean_x_;
+}
+
+}  // namespace pcp_test
@@ -6,7 +6,12 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 
+#include <chrono>
 #include <ctime>
+#include <functional>  // std::hash
+#include <mutex>
+#include <random>
+#include <thread>
 #include <time.h>
 
 namespace pcp_test {
@@ -39,6 +44,34 @@ std::string get_short_datetime()
     return get_expiry_datetime(0, SHORT_DATETIME_FORMAT);
 }
 
+std::string get_ISO8601_time()
+{
+    struct tm time_info;
+    char time_buffer[80];
+    time_t now {time(nullptr)};
+    gmtime_r(&now, &time_info);
+
+    if (strftime(time_buffer, 80, "%Y-%m-%dT%H:%M:%SZ", &time_info) == 0)
+        return "";
+
+    return std::string(time_buffer);
+}
+
+std::string normalize_time_interval(uint32_t duration_ms)
+{
+    auto min = duration_ms / 60000;
+    auto s   = (duration_ms - min * 60000) / 1000;
+    auto ms  = duration_ms % 1000;
+
+    if (min > 0)
+        return (boost::format("%1% min %2% s") % min % s).str();
+
+    if (s > 0)
+        return (boost::format("%1%.%2$03d s") % s % ms).str();
+
+    return (boost::format("%1% ms") % ms).str();
+}
+
 std::string cyan(std::string const& message)
 {
     static boost::format f {"\33[0;36m%1%\33[0m"};
@@ -65,10 +98,57 @@ std::string red(std::string const& message)
 
 std::string get_UUID()
 {
+    // NOTE: random_generator is not thread-safe; requests may be
+    // created concurrently by multiple controllers
+    static std::mutex gen_mtx;
     static boost::uuids::random_generator gen;
+    std::lock_guard<std::mutex> the_lock {gen_mtx};
     boost::uuids::uuid uuid = gen();
     return boost::uuids::to_string(uuid);
 }
 
+// The seed combines OS entropy, the thread ID, and the time, so that
+// the sequences of different threads / processes don't overlap
+static std::mt19937_64::result_type get_message_id_seed()
+{
+    std::random_device rd {};
+    uint64_t seed {(static_cast<uint64_t>(rd()) << 32) | rd()};
+    seed ^= std::hash<std::thread::id>()(std::this_thread::get_id());
+    seed ^= static_cast<uint64_t>(get_monotonic_ns()) * 0x9E3779B97F4A7C15ULL;
+    return seed;
+}
+
+std::string get_message_id()
+{
+    static thread_local std::mt19937_64 engine {get_message_id_seed()};
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    uint64_t high {engine()};
+    uint64_t low {engine()};
+
+    // Version 4 and RFC 4122 variant, as boost's random_generator does
+    high = (high & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
+    low  = (low  & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+
+    // 8-4-4-4-12 hex digits
+    std::string id(36, '-');
+    std::size_t pos {0};
+
+    for (int nibble = 0; nibble < 32; nibble++) {
+        if (pos == 8 || pos == 13 || pos == 18 || pos == 23)
+            pos++;
+        auto bits = nibble < 16 ? high : low;
+        id[pos++] = HEX_DIGITS[(bits >> (60 - 4 * (nibble % 16))) & 0xF];
+    }
+
+    return id;
+}
+
+int64_t get_monotonic_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 }  // namespace util
 }  // namespace pcp-test
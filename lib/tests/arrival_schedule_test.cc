@@ -0,0 +1,58 @@
+#include <catch.hpp>
+
+#include <pcp-test/arrival_schedule.hpp>
+#include <pcp-test/random.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace pcp_test {
+
+using us = std::chrono::microseconds;
+using ms = std::chrono::milliseconds;
+
+SCENARIO("get_arrival_offsets", "[arrivals]") {
+    SECTION("returns no arrivals if none is requested") {
+        REQUIRE(get_arrival_offsets(0, 10, ms(0)).empty());
+    }
+
+    SECTION("equally spaces arrivals without ramp-up") {
+        auto offsets = get_arrival_offsets(4, 10, ms(0));
+
+        REQUIRE(offsets == (std::vector<us> {us(100000), us(200000),
+                                             us(300000), us(400000)}));
+    }
+
+    SECTION("delays the earlier arrivals during the ramp-up") {
+        auto offsets = get_arrival_offsets(40, 10, ms(2000));
+
+        REQUIRE(std::is_sorted(offsets.begin(), offsets.end()));
+
+        // With a linear ramp over 2 s, 10 arrivals are expected
+        // in the first 2 s; afterwards the rate is constant
+        REQUIRE(offsets[9] == us(2000000));
+        REQUIRE(offsets[0] > us(100000));
+        REQUIRE(offsets[39] - offsets[38] == us(100000));
+    }
+
+    SECTION("generates Poisson arrivals with the requested mean rate") {
+        exponential_integers rng {1, 42, 1000000};
+        auto offsets = get_arrival_offsets(10000, 1000, ms(0), &rng);
+
+        REQUIRE(std::is_sorted(offsets.begin(), offsets.end()));
+
+        // 10000 arrivals at 1 kHz take 10 s on average
+        REQUIRE(offsets.back() > us(9500000));
+        REQUIRE(offsets.back() < us(10500000));
+    }
+
+    SECTION("specifying the RNG seed guarantees repeatability") {
+        exponential_integers rng_1 {1, 42, 1000000};
+        exponential_integers rng_2 {1, 42, 1000000};
+
+        REQUIRE(get_arrival_offsets(100, 50, ms(1000), &rng_1)
+                == get_arrival_offsets(100, 50, ms(1000), &rng_2));
+    }
+}
+
+}  // namespace pcp_test
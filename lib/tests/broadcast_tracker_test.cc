@@ -0,0 +1,122 @@
+#include <catch.hpp>
+
+#include <pcp-test/broadcast_tracker.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+using clock_type = broadcast_tracker::clock_type;
+using outcome    = broadcast_tracker::match_outcome;
+
+static const std::vector<std::string> TARGETS {"pcp://a/agent",
+                                               "pcp://b/agent",
+                                               "pcp://c/agent"};
+
+SCENARIO("broadcast_tracker matches responses", "[fanout]") {
+    broadcast_tracker tracker {TARGETS};
+    auto t0 = clock_type::now();
+    REQUIRE(tracker.num_targets() == 3);
+
+    SECTION("measures the times to the first and to the last response") {
+        REQUIRE(tracker.insert("t1", t0));
+        REQUIRE(tracker.match("t1", "pcp://b/agent", t0 + std::chrono::microseconds(1000))
+                == outcome::delivered);
+        REQUIRE(tracker.match("t1", "pcp://a/agent", t0 + std::chrono::microseconds(2000))
+                == outcome::delivered);
+        REQUIRE_FALSE(tracker.is_complete("t1"));
+        REQUIRE(tracker.match("t1", "pcp://c/agent", t0 + std::chrono::microseconds(5000))
+                == outcome::completed);
+        REQUIRE(tracker.is_complete("t1"));
+
+        tracker.close("t1");
+        REQUIRE(tracker.size() == 0);
+        REQUIRE(tracker.get_time_to_first_us().max() == 1000);
+        REQUIRE(tracker.get_time_to_last_us().max() == 5000);
+
+        auto counters = tracker.get_counters();
+        REQUIRE(counters.broadcasts == 1);
+        REQUIRE(counters.expected == 3);
+        REQUIRE(counters.delivered == 3);
+        REQUIRE(counters.complete == 1);
+    }
+
+    SECTION("does not record the time to the last response of incomplete broadcasts") {
+        REQUIRE(tracker.insert("t1", t0));
+        REQUIRE(tracker.match("t1", "pcp://a/agent", t0 + std::chrono::microseconds(1000))
+                == outcome::delivered);
+        tracker.close("t1");
+
+        REQUIRE(tracker.get_time_to_first_us().count() == 1);
+        REQUIRE(tracker.get_time_to_last_us().count() == 0);
+        REQUIRE(tracker.get_counters().complete == 0);
+    }
+
+    SECTION("classifies duplicate, late, and unknown responses") {
+        REQUIRE(tracker.insert("t1", t0));
+        REQUIRE(tracker.match("t1", "pcp://a/agent") == outcome::delivered);
+        REQUIRE(tracker.match("t1", "pcp://a/agent") == outcome::duplicate);
+        REQUIRE(tracker.match("t1", "pcp://z/agent") == outcome::unknown);
+        REQUIRE(tracker.match("t2", "pcp://a/agent") == outcome::unknown);
+        tracker.close_all();
+        REQUIRE(tracker.match("t1", "pcp://b/agent") == outcome::late);
+
+        auto counters = tracker.get_counters();
+        REQUIRE(counters.delivered == 1);
+        REQUIRE(counters.duplicates == 1);
+        REQUIRE(counters.unknown == 2);
+        REQUIRE(counters.late == 1);
+    }
+
+    SECTION("does not account for cancelled broadcasts") {
+        REQUIRE(tracker.insert("t1", t0));
+        REQUIRE_FALSE(tracker.insert("t1", t0));
+        tracker.cancel("t1");
+
+        auto counters = tracker.get_counters();
+        REQUIRE(counters.broadcasts == 0);
+        REQUIRE(counters.expected == 0);
+        REQUIRE(tracker.match("t1", "pcp://a/agent") == outcome::unknown);
+    }
+}
+
+SCENARIO("broadcast_tracker forgets old broadcasts", "[fanout]") {
+    broadcast_tracker tracker {TARGETS, 2};
+
+    for (auto t : {"t1", "t2", "t3"}) {
+        REQUIRE(tracker.insert(t));
+        tracker.close(t);
+    }
+
+    REQUIRE(tracker.match("t1", "pcp://a/agent") == outcome::unknown);
+    REQUIRE(tracker.match("t3", "pcp://a/agent") == outcome::late);
+}
+
+SCENARIO("broadcast_tracker can be used by concurrent threads", "[fanout]") {
+    std::vector<std::string> targets {};
+
+    for (int idx = 0; idx < 100; idx++)
+        targets.push_back("pcp://agent" + std::to_string(idx) + "/agent");
+
+    broadcast_tracker tracker {targets};
+    REQUIRE(tracker.insert("t1"));
+    std::vector<std::thread> responders {};
+
+    for (int t_idx = 0; t_idx < 4; t_idx++)
+        responders.push_back(std::thread([&tracker, &targets, t_idx]() {
+            for (std::size_t idx = t_idx; idx < targets.size(); idx += 4)
+                tracker.match("t1", targets[idx]);
+        }));
+
+    for (auto& r : responders)
+        r.join();
+
+    REQUIRE(tracker.is_complete("t1"));
+    tracker.close("t1");
+    REQUIRE(tracker.get_counters().complete == 1);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,99 @@
+#include <catch.hpp>
+
+#include <pcp-test/broker_distribution.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+static std::vector<int> count_clients(const broker_distribution& d,
+                                      std::size_t num_clients)
+{
+    std::vector<int> counts(d.num_brokers(), 0);
+
+    for (std::size_t idx = 0; idx < num_clients; idx++)
+        counts[d.get_broker(idx, "client_" + std::to_string(idx))]++;
+
+    return counts;
+}
+
+SCENARIO("broker_distribution ctor", "[broker]") {
+    SECTION("throws a fatal_error in case of no brokers") {
+        REQUIRE_THROWS_AS(broker_distribution(broker_policy::first, 0),
+                          fatal_error);
+    }
+
+    SECTION("throws a fatal_error in case of invalid weights") {
+        REQUIRE_THROWS_AS(broker_distribution(broker_policy::weighted, 2, {1}),
+                          fatal_error);
+        REQUIRE_THROWS_AS(broker_distribution(broker_policy::weighted, 2, {0, 0}),
+                          fatal_error);
+        REQUIRE_THROWS_AS(broker_distribution(broker_policy::weighted, 2,
+                                              {MAX_BROKER_TOTAL_WEIGHT, 1}),
+                          fatal_error);
+    }
+
+    SECTION("caps the sum of the weights once reduced by their gcd") {
+        REQUIRE(get_reduced_total_weight({6000, 6000}) == 2);
+        REQUIRE(get_reduced_total_weight({0, 0}) == 0);
+        REQUIRE_NOTHROW(broker_distribution(broker_policy::weighted, 2,
+                                            {6000, 6000}));
+    }
+}
+
+SCENARIO("broker_distribution assigns clients", "[broker]") {
+    SECTION("first") {
+        broker_distribution d {broker_policy::first, 3};
+        REQUIRE(count_clients(d, 10) == (std::vector<int> {10, 0, 0}));
+    }
+
+    SECTION("round-robin") {
+        broker_distribution d {broker_policy::round_robin, 3};
+
+        for (std::size_t idx = 0; idx < 6; idx++)
+            REQUIRE(d.get_broker(idx, "") == idx % 3);
+    }
+
+    SECTION("weighted, with interleaved brokers") {
+        broker_distribution d {broker_policy::weighted, 3, {5, 1, 1}};
+        REQUIRE(count_clients(d, 700) == (std::vector<int> {500, 100, 100}));
+
+        std::vector<std::size_t> brokers {};
+        for (std::size_t idx = 0; idx < 7; idx++)
+            brokers.push_back(d.get_broker(idx, ""));
+
+        REQUIRE(brokers == (std::vector<std::size_t> {0, 0, 1, 0, 2, 0, 0}));
+    }
+
+    SECTION("only the weight ratios matter") {
+        broker_distribution reduced {broker_policy::hash, 2, {1, 2}};
+        broker_distribution d {broker_policy::hash, 2, {1000, 2000}};
+
+        for (std::size_t idx = 0; idx < 100; idx++) {
+            auto cn = "client_" + std::to_string(idx);
+            REQUIRE(d.get_broker(idx, cn) == reduced.get_broker(idx, cn));
+        }
+    }
+
+    SECTION("brokers with zero weight get no client") {
+        broker_distribution d {broker_policy::weighted, 3, {1, 0, 1}};
+        REQUIRE(count_clients(d, 10) == (std::vector<int> {5, 0, 5}));
+    }
+
+    SECTION("hash, independently of the client index") {
+        broker_distribution d {broker_policy::hash, 4};
+        auto b = d.get_broker(0, "0042agent");
+
+        for (std::size_t idx = 1; idx < 10; idx++)
+            REQUIRE(d.get_broker(idx, "0042agent") == b);
+
+        for (auto c : count_clients(d, 4000)) {
+            REQUIRE(c > 800);
+            REQUIRE(c < 1200);
+        }
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,62 @@
+#include <catch.hpp>
+
+#include <pcp-test/capacity_search.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <vector>
+
+namespace pcp_test {
+
+// Return the levels that are run, given the capacity
+static std::vector<int> search(capacity_search& s, int capacity)
+{
+    std::vector<int> levels {};
+
+    do {
+        levels.push_back(s.level());
+    } while (s.next(s.level() <= capacity));
+
+    return levels;
+}
+
+SCENARIO("capacity_search", "[capacity]") {
+    SECTION("throws a fatal_error in case of a negative maximum level") {
+        REQUIRE_THROWS_AS(capacity_search(-1), fatal_error);
+    }
+
+    SECTION("ramps up exponentially, then bisects") {
+        capacity_search s {100};
+
+        REQUIRE(search(s, 21) == (std::vector<int> {0, 1, 2, 4, 8, 16, 32, 24, 20, 22, 21}));
+        REQUIRE(s.highest_passing_level() == 21);
+        REQUIRE(s.lowest_failing_level() == 22);
+    }
+
+    SECTION("stops at the maximum level") {
+        capacity_search s {10};
+
+        REQUIRE(search(s, 50) == (std::vector<int> {0, 1, 2, 4, 8, 10}));
+        REQUIRE(s.highest_passing_level() == 10);
+        REQUIRE(s.lowest_failing_level() == -1);
+    }
+
+    SECTION("stops if the initial run fails") {
+        capacity_search s {10};
+
+        REQUIRE(search(s, -1) == (std::vector<int> {0}));
+        REQUIRE(s.highest_passing_level() == -1);
+        REQUIRE(s.lowest_failing_level() == 0);
+    }
+
+    SECTION("finds any capacity within the levels") {
+        for (int capacity = 0; capacity <= 20; capacity++) {
+            capacity_search s {20};
+            auto levels = search(s, capacity);
+
+            REQUIRE(s.highest_passing_level() == capacity);
+            REQUIRE(levels.size() <= 12);
+        }
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,98 @@
+#include <catch.hpp>
+
+#include <pcp-test/cert_store.hpp>
+
+#include <pcp-test/root_path.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <openssl/bio.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+
+#include <iterator>  // std::distance
+
+namespace pcp_test {
+
+namespace fs = boost::filesystem;
+
+static const auto SSL_PATH = fs::path(PCP_TEST_ROOT_PATH) / "test-resources" / "ssl";
+
+static X509* read_cert(const fs::path& path)
+{
+    auto bio = BIO_new_file(path.string().c_str(), "r");
+    auto cert = bio ? PEM_read_bio_X509(bio, nullptr, nullptr, nullptr) : nullptr;
+    BIO_free_all(bio);
+    return cert;
+}
+
+SCENARIO("cert_store::common_name", "[certificates]") {
+    REQUIRE(cert_store::common_name("agent", 42) == "0042agent");
+    REQUIRE(cert_store::common_name("controller", 12345) == "12345controller");
+}
+
+SCENARIO("cert_store lookup", "[certificates]") {
+    cert_store store {SSL_PATH.string(), false};
+
+    SECTION("returns the names of the stored pairs") {
+        auto names = store.get_common_names("agent", 3);
+        REQUIRE(names == (std::set<std::string> {"0000agent", "0001agent", "0002agent"}));
+    }
+
+    SECTION("stops at the first missing pair") {
+        REQUIRE(store.get_common_names("controller", 100).size() == 10);
+        REQUIRE(store.num_generated() == 0);
+    }
+}
+
+SCENARIO("cert_store generation", "[certificates]") {
+    auto dir = fs::temp_directory_path() / fs::unique_path("pcp-test-certs-%%%%%%");
+    fs::create_directories(dir);
+    fs::copy_file(SSL_PATH / cert_store::CA_CERT_FILE, dir / cert_store::CA_CERT_FILE);
+
+    SECTION("requires the CA key") {
+        REQUIRE_THROWS_AS(cert_store(dir.string(), true), cert_store::error);
+    }
+
+    SECTION("generates the missing pairs, signed by the CA") {
+        fs::copy_file(SSL_PATH / cert_store::CA_KEY_FILE, dir / cert_store::CA_KEY_FILE);
+
+        {
+            cert_store store {dir.string(), true};
+            REQUIRE(store.get_common_names("agent", 2).size() == 2);
+            REQUIRE(store.num_generated() == 2);
+        }
+
+        auto crt_path = dir / "test" / "0001agent.example.com_crt.pem";
+        auto key_path = dir / "test" / "0001agent.example.com_key.pem";
+        REQUIRE(fs::exists(key_path));
+        REQUIRE((fs::status(key_path).permissions() & (fs::group_all | fs::others_all))
+                == fs::no_perms);
+
+        // No temporary files are left behind
+        REQUIRE(std::distance(fs::directory_iterator(dir / "test"),
+                              fs::directory_iterator()) == 4);
+
+        auto ca_cert = read_cert(dir / cert_store::CA_CERT_FILE);
+        auto cert = read_cert(crt_path);
+        REQUIRE(ca_cert != nullptr);
+        REQUIRE(cert != nullptr);
+
+        auto ca_key = X509_get_pubkey(ca_cert);
+        REQUIRE(X509_verify(cert, ca_key) == 1);
+        EVP_PKEY_free(ca_key);
+        X509_free(cert);
+        X509_free(ca_cert);
+
+        SECTION("and reuses them afterwards") {
+            cert_store store {dir.string(), true};
+            REQUIRE(store.get_common_names("agent", 3).size() == 3);
+            REQUIRE(store.num_generated() == 1);
+        }
+    }
+
+    fs::remove_all(dir);
+}
+
+}  // namespace pcp_test
@@ -63,6 +63,30 @@ SCENARIO("configuration::validate_test_type", "[configuration]") {
         REQUIRE_THROWS_AS(configuration::validate_test_type(ao),
                           configuration_error);
     }
+
+    SECTION("accepts the throughput test type") {
+        application_options ao {};
+        ao.test = "throughput";
+        REQUIRE_NOTHROW(configuration::validate_test_type(ao));
+    }
+
+    SECTION("accepts the fanout test type") {
+        application_options ao {};
+        ao.test = "fanout";
+        REQUIRE_NOTHROW(configuration::validate_test_type(ao));
+    }
+
+    SECTION("accepts the soak test type") {
+        application_options ao {};
+        ao.test = "soak";
+        REQUIRE_NOTHROW(configuration::validate_test_type(ao));
+    }
+
+    SECTION("accepts the scenario test type") {
+        application_options ao {};
+        ao.test = "scenario";
+        REQUIRE_NOTHROW(configuration::validate_test_type(ao));
+    }
 }
 
 static const auto CONFIG_PATH = TEST_PATH / "configuration";
@@ -10,6 +10,8 @@
 #include <boost/filesystem/path.hpp>
 
 #include <iostream>
+#include <thread>
+#include <vector>
 
 namespace pcp_test {
 
@@ -58,6 +60,79 @@ SCENARIO("connection_timings_accumulator accumulate method", "[stats]") {
 
         REQUIRE(c_stats.session_duration_ms.mean == 2000);
     }
+
+    SECTION("provides percentiles") {
+        connection_timings_accumulator t_acc {};
+
+        for (uint32_t ms = 1; ms <= 100; ms++)
+            t_acc.accumulate_association_ms(ms);
+
+        auto c_stats = t_acc.get_connection_stats();
+
+        REQUIRE(c_stats.association_ms.p50 == 50);
+        REQUIRE(c_stats.association_ms.p90 == 90);
+        REQUIRE(c_stats.association_ms.p99 == 99);
+        REQUIRE(c_stats.association_ms.p999 == 100);
+    }
+
+    SECTION("corrects the connect latency for coordinated omission") {
+        connection_timings_accumulator t_acc {};
+        t_acc.accumulate_connect_ms(50);
+        t_acc.accumulate_connect_ms(40, 100);
+        t_acc.accumulate_connect_ms(300, 100);
+        auto c_stats = t_acc.get_connection_stats();
+
+        // 300 ms with a 100 ms interval also records 200 and 100 ms
+        REQUIRE(c_stats.connect_ms.count == 5);
+        REQUIRE(c_stats.connect_ms.max == 300);
+    }
+}
+
+SCENARIO("connection_timings_accumulator shards", "[stats]") {
+    connection_timings_accumulator t_acc {};
+    t_acc.accumulate_session_duration_ms(1000);
+
+    SECTION("timings of sealed shards are merged") {
+        auto shard_1 = t_acc.get_shard();
+        auto shard_2 = t_acc.get_shard();
+        shard_1->accumulate_session_duration_ms(2000);
+        shard_2->accumulate_session_duration_ms(3000);
+        shard_1->seal();
+        shard_2->seal();
+        auto c_stats = t_acc.get_connection_stats();
+
+        REQUIRE(c_stats.session_duration_ms.count == 3);
+        REQUIRE(c_stats.session_duration_ms.mean == 2000);
+        REQUIRE(c_stats.session_duration_ms.max == 3000);
+        REQUIRE(t_acc.num_unsealed_shards() == 0);
+    }
+
+    SECTION("timings of unsealed shards are not included") {
+        auto shard = t_acc.get_shard();
+        shard->accumulate_session_duration_ms(5000);
+        auto c_stats = t_acc.get_connection_stats();
+
+        REQUIRE(c_stats.session_duration_ms.count == 1);
+        REQUIRE(t_acc.num_unsealed_shards() == 1);
+    }
+
+    SECTION("shards can be filled concurrently") {
+        std::vector<std::thread> threads {};
+
+        for (int t_idx = 0; t_idx < 4; t_idx++)
+            threads.push_back(std::thread {
+                [&t_acc]() {
+                    auto shard = t_acc.get_shard();
+                    for (uint32_t ms = 0; ms < 1000; ms++)
+                        shard->accumulate_association_ms(ms);
+                    shard->seal();
+                }});
+
+        for (auto& t : threads)
+            t.join();
+
+        REQUIRE(t_acc.get_connection_stats().association_ms.count == 4000);
+    }
 }
 
 }  // namespace pcp_test
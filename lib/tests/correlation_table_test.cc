@@ -0,0 +1,150 @@
+#include <catch.hpp>
+
+#include <pcp-test/correlation_table.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+using clock_type = correlation_table::clock_type;
+using outcome    = correlation_table::match_outcome;
+
+SCENARIO("correlation_table matches responses", "[correlation]") {
+    correlation_table table {10, std::chrono::milliseconds(100)};
+    auto t0 = clock_type::now();
+
+    SECTION("records the RTT of a matched request") {
+        REQUIRE(table.insert("t1", t0));
+        REQUIRE(table.size() == 1);
+
+        std::chrono::microseconds rtt {0};
+        REQUIRE(table.match("t1", t0 + std::chrono::microseconds(2500), &rtt)
+                == outcome::matched);
+        REQUIRE(rtt.count() == 2500);
+        REQUIRE(table.size() == 0);
+
+        auto h = table.get_rtt_us();
+        REQUIRE(h.count() == 1);
+        REQUIRE(h.max() == 2500);
+        REQUIRE(table.get_counters().matched == 1);
+    }
+
+    SECTION("measures the latency from the intended send time") {
+        REQUIRE(table.insert("t1", t0 + std::chrono::microseconds(3000), t0));
+        REQUIRE(table.match("t1", t0 + std::chrono::microseconds(4000))
+                == outcome::matched);
+
+        REQUIRE(table.get_rtt_us().max() == 1000);
+        REQUIRE(table.get_latency_us().max() == 4000);
+    }
+
+    SECTION("expires requests by their send time") {
+        REQUIRE(table.insert("t1", t0, t0 - std::chrono::milliseconds(500)));
+        REQUIRE(table.expire(t0 + std::chrono::milliseconds(50)) == 0);
+        REQUIRE(table.expire(t0 + std::chrono::milliseconds(150)) == 1);
+    }
+
+    SECTION("classifies duplicate and unknown responses") {
+        REQUIRE(table.insert("t1", t0));
+        REQUIRE(table.match("t1", t0) == outcome::matched);
+        REQUIRE(table.match("t1", t0) == outcome::duplicate);
+        REQUIRE(table.match("t2", t0) == outcome::unknown);
+
+        auto c = table.get_counters();
+        REQUIRE(c.matched == 1);
+        REQUIRE(c.duplicates == 1);
+        REQUIRE(c.unknown == 1);
+    }
+
+    SECTION("rejects a transaction that is already in flight") {
+        REQUIRE(table.insert("t1", t0));
+        REQUIRE_FALSE(table.insert("t1", t0));
+        REQUIRE(table.size() == 1);
+    }
+
+    SECTION("cancelled requests are not accounted") {
+        REQUIRE(table.insert("t1", t0));
+        table.cancel("t1");
+        REQUIRE(table.size() == 0);
+        REQUIRE(table.expire_all() == 0);
+        REQUIRE(table.match("t1", t0) == outcome::unknown);
+    }
+}
+
+SCENARIO("correlation_table is bounded", "[correlation]") {
+    correlation_table table {3, std::chrono::milliseconds(100), 2};
+    auto t0 = clock_type::now();
+
+    for (auto idx = 0; idx < 3; idx++)
+        REQUIRE(table.insert("t" + std::to_string(idx), t0));
+
+    REQUIRE_FALSE(table.insert("t3", t0));
+    REQUIRE(table.size() == 3);
+
+    REQUIRE(table.match("t0", t0) == outcome::matched);
+    REQUIRE(table.insert("t3", t0));
+}
+
+SCENARIO("correlation_table expires requests", "[correlation]") {
+    correlation_table table {10, std::chrono::milliseconds(100)};
+    auto t0 = clock_type::now();
+
+    REQUIRE(table.insert("old", t0));
+    REQUIRE(table.insert("new", t0 + std::chrono::milliseconds(80)));
+
+    SECTION("once in flight for longer than the timeout") {
+        REQUIRE(table.expire(t0 + std::chrono::milliseconds(50)) == 0);
+        REQUIRE(table.expire(t0 + std::chrono::milliseconds(150)) == 1);
+        REQUIRE(table.size() == 1);
+        REQUIRE(table.get_counters().expired == 1);
+    }
+
+    SECTION("responses to expired requests are late") {
+        table.expire(t0 + std::chrono::milliseconds(150));
+        REQUIRE(table.match("old") == outcome::late);
+        REQUIRE(table.match("new") == outcome::matched);
+        REQUIRE(table.get_counters().late == 1);
+    }
+
+    SECTION("all at once") {
+        REQUIRE(table.expire_all() == 2);
+        REQUIRE(table.size() == 0);
+        REQUIRE(table.get_counters().expired == 2);
+    }
+}
+
+SCENARIO("correlation_table can be used concurrently", "[correlation]") {
+    const int num_threads {4};
+    const int num_requests {2000};
+    correlation_table table {num_threads * num_requests, std::chrono::seconds(10)};
+    std::atomic<int> num_matched {0};
+    std::vector<std::thread> threads {};
+
+    for (auto t = 0; t < num_threads; t++)
+        threads.push_back(std::thread(
+            [&table, &num_matched, t, num_requests]()
+            {
+                for (auto idx = 0; idx < num_requests; idx++) {
+                    auto transaction = std::to_string(t) + "_" + std::to_string(idx);
+                    if (table.insert(transaction)
+                            && table.match(transaction) == outcome::matched)
+                        num_matched++;
+                }
+            }));
+
+    for (auto& t : threads)
+        t.join();
+
+    REQUIRE(num_matched.load() == num_threads * num_requests);
+    REQUIRE(table.size() == 0);
+    REQUIRE(table.get_counters().matched
+            == static_cast<uint64_t>(num_threads * num_requests));
+    REQUIRE(table.get_rtt_us().count()
+            == static_cast<uint64_t>(num_threads * num_requests));
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,61 @@
+#include <catch.hpp>
+
+#include <pcp-test/distributed.hpp>
+
+#include <numeric>
+#include <vector>
+
+namespace pcp_test {
+
+static int total_concurrency(const std::vector<worker_assignment>& assignments)
+{
+    return std::accumulate(assignments.begin(), assignments.end(), 0,
+                           [](int sum, const worker_assignment& a) {
+                               return sum + a.concurrency;
+                           });
+}
+
+SCENARIO("split_run", "[distributed]") {
+    SECTION("splits the sets evenly, with contiguous names") {
+        auto assignments = split_run(10, 7, 0, 3);
+
+        REQUIRE(assignments.size() == 3);
+        REQUIRE(assignments[0].concurrency == 3);
+        REQUIRE(assignments[1].concurrency == 2);
+        REQUIRE(assignments[2].concurrency == 2);
+        REQUIRE(assignments[0].first_name_idx == 0);
+        REQUIRE(assignments[1].first_name_idx == 30);
+        REQUIRE(assignments[2].first_name_idx == 50);
+
+        for (const auto& a : assignments)
+            REQUIRE(a.connection_rate == 0);
+    }
+
+    SECTION("workers may get no set") {
+        auto assignments = split_run(10, 2, 0, 4);
+
+        REQUIRE(total_concurrency(assignments) == 2);
+        REQUIRE(assignments[2].concurrency == 0);
+        REQUIRE(assignments[3].concurrency == 0);
+    }
+
+    SECTION("splits the connection rate proportionally") {
+        auto assignments = split_run(10, 7, 100, 3);
+        auto tot_rate = 0;
+
+        for (const auto& a : assignments)
+            tot_rate += a.connection_rate;
+
+        REQUIRE(tot_rate == 100);
+        REQUIRE(assignments[0].connection_rate == 42);
+    }
+
+    SECTION("workers with a set get a positive rate") {
+        auto assignments = split_run(10, 3, 1, 3);
+
+        for (const auto& a : assignments)
+            REQUIRE(a.connection_rate >= 1);
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,160 @@
+#include <catch.hpp>
+
+#include <pcp-test/event_recorder.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <chrono>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+namespace fs = boost::filesystem;
+
+static connection_event make_event(uint32_t endpoint_id)
+{
+    return connection_event {0, endpoint_id, 0, 0,
+                             connection_phase::tcp, event_outcome::success};
+}
+
+SCENARIO("event_ring", "[events]") {
+    SECTION("rounds the capacity up to a power of 2") {
+        event_ring ring {5};
+
+        REQUIRE(ring.capacity() == 8);
+    }
+
+    SECTION("pops the events in order") {
+        event_ring ring {4};
+        connection_event event {};
+
+        REQUIRE_FALSE(ring.try_pop(event));
+
+        for (uint32_t idx = 0; idx < 10; idx++) {
+            REQUIRE(ring.try_push(make_event(idx)));
+            REQUIRE(ring.try_pop(event));
+            REQUIRE(event.endpoint_id == idx);
+        }
+    }
+
+    SECTION("does not push once full") {
+        event_ring ring {4};
+        connection_event event {};
+
+        for (uint32_t idx = 0; idx < 4; idx++)
+            REQUIRE(ring.try_push(make_event(idx)));
+
+        REQUIRE_FALSE(ring.try_push(make_event(4)));
+        REQUIRE(ring.try_pop(event));
+        REQUIRE(event.endpoint_id == 0);
+        REQUIRE(ring.try_push(make_event(4)));
+    }
+
+    SECTION("delivers the events of concurrent producers once") {
+        event_ring ring {1 << 10};
+        const uint32_t num_producers {4};
+        const uint32_t num_per_producer {2000};
+        std::vector<std::thread> producers {};
+
+        for (uint32_t p = 0; p < num_producers; p++)
+            producers.emplace_back(
+                [&ring, p, num_per_producer]()
+                {
+                    for (uint32_t idx = 0; idx < num_per_producer; idx++)
+                        while (!ring.try_push(make_event(p * num_per_producer + idx)))
+                            std::this_thread::yield();
+                });
+
+        std::set<uint32_t> ids {};
+        connection_event event {};
+
+        while (ids.size() < num_producers * num_per_producer)
+            if (ring.try_pop(event))
+                REQUIRE(ids.insert(event.endpoint_id).second);
+
+        for (auto& t : producers)
+            t.join();
+
+        REQUIRE_FALSE(ring.try_pop(event));
+        REQUIRE(*ids.rbegin() == num_producers * num_per_producer - 1);
+    }
+}
+
+SCENARIO("event_recorder file", "[events]") {
+    auto file_path = (fs::temp_directory_path()
+                      / fs::unique_path("pcp-test-events-%%%%%%.bin")).string();
+
+    {
+        event_recorder recorder {file_path};
+        recorder.set_run(2);
+        recorder.record(7, connection_phase::tcp, event_outcome::success,
+                        std::chrono::microseconds(1500));
+        recorder.record(7, connection_phase::association, event_outcome::failure,
+                        std::chrono::microseconds(-3));
+
+        REQUIRE(recorder.num_dropped() == 0);
+    }
+
+    REQUIRE(fs::file_size(file_path)
+            == event_recorder::FILE_MAGIC.size() + 2 * event_recorder::RECORD_SIZE);
+
+    SECTION("can be read back") {
+        boost::nowide::ifstream in_stream {file_path, std::ios::binary};
+        connection_event event {};
+        read_events_header(in_stream);
+
+        REQUIRE(read_event(in_stream, event));
+        REQUIRE(event.endpoint_id == 7);
+        REQUIRE(event.duration_us == 1500);
+        REQUIRE(event.run_idx == 2);
+        REQUIRE(event.phase == connection_phase::tcp);
+        REQUIRE(event.outcome == event_outcome::success);
+        REQUIRE(event.timestamp_us > 0);
+
+        REQUIRE(read_event(in_stream, event));
+        REQUIRE(event.duration_us == 0);
+        REQUIRE(event.phase == connection_phase::association);
+        REQUIRE(event.outcome == event_outcome::failure);
+
+        REQUIRE_FALSE(read_event(in_stream, event));
+    }
+
+    SECTION("can be converted to CSV") {
+        boost::nowide::ifstream in_stream {file_path, std::ios::binary};
+        std::ostringstream out_stream {};
+
+        REQUIRE(convert_events_to_csv(in_stream, out_stream) == 2);
+
+        auto csv = out_stream.str();
+        REQUIRE(csv.find(",7,1500,2,tcp,success\n") != std::string::npos);
+        REQUIRE(csv.find(",7,0,2,association,failure\n") != std::string::npos);
+    }
+
+    fs::remove(file_path);
+}
+
+SCENARIO("convert_events_to_csv", "[events]") {
+    SECTION("throws if the magic doesn't match") {
+        std::istringstream in_stream {"NOTEVENTS"};
+        std::ostringstream out_stream {};
+
+        REQUIRE_THROWS_AS(convert_events_to_csv(in_stream, out_stream), fatal_error);
+    }
+
+    SECTION("throws in case of a truncated record") {
+        std::istringstream in_stream {event_recorder::FILE_MAGIC + "0123"};
+        std::ostringstream out_stream {};
+
+        REQUIRE_THROWS_AS(convert_events_to_csv(in_stream, out_stream), fatal_error);
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,131 @@
+#include <catch.hpp>
+
+#include <pcp-test/failure_stats.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+SCENARIO("classify_connect_error", "[failures]") {
+    const milliseconds timeout {1500};
+
+    SECTION("by error message") {
+        REQUIRE(classify_connect_error("Connection refused", microseconds(0),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::tcp_refused);
+        REQUIRE(classify_connect_error("TLS handshake failed", microseconds(200),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::tls);
+        REQUIRE(classify_connect_error("certificate verify failed", microseconds(0),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::tls);
+        REQUIRE(classify_connect_error("Invalid HTTP status", microseconds(200),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::ws_upgrade);
+    }
+
+    SECTION("by timings") {
+        // TCP connected, but no upgrade
+        REQUIRE(classify_connect_error("failed to open", microseconds(200),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::ws_upgrade);
+
+        // No TCP connection, before the timeout
+        REQUIRE(classify_connect_error("failed to open", microseconds(0),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::tcp_refused);
+
+        // No TCP connection, at the timeout
+        REQUIRE(classify_connect_error("failed to open", microseconds(0),
+                                       microseconds(0), timeout, timeout)
+                == failure_phase::tcp_timeout);
+        REQUIRE(classify_connect_error("operation timed out", microseconds(0),
+                                       microseconds(0), milliseconds(3), timeout)
+                == failure_phase::tcp_timeout);
+
+        // The WebSocket connection was established
+        REQUIRE(classify_connect_error("unknown", microseconds(200),
+                                       microseconds(300), milliseconds(3), timeout)
+                == failure_phase::other);
+    }
+}
+
+SCENARIO("failure_breakdown", "[failures]") {
+    failure_breakdown b {};
+
+    SECTION("is initially empty") {
+        REQUIRE(b.total() == 0);
+
+        std::ostringstream out {};
+        out << b;
+        REQUIRE(out.str().empty());
+    }
+
+    SECTION("counts failures by phase") {
+        b.record(failure_phase::tcp_refused, 2);
+        b.record(failure_phase::tcp_refused, 4);
+        b.record(failure_phase::association_timeout, 1000);
+        b.add(failure_phase::task_timeout, 5);
+
+        REQUIRE(b.count(failure_phase::tcp_refused) == 2);
+        REQUIRE(b.count(failure_phase::association_timeout) == 1);
+        REQUIRE(b.count(failure_phase::task_timeout) == 5);
+        REQUIRE(b.count(failure_phase::tls) == 0);
+        REQUIRE(b.total() == 8);
+        REQUIRE(b.latency_ms[0].count() == 2);
+        REQUIRE(b.latency_ms[static_cast<std::size_t>(failure_phase::task_timeout)]
+                .count() == 0);
+
+        std::ostringstream out {};
+        out << b;
+        REQUIRE(out.str().find("TCP refused: 2") != std::string::npos);
+        REQUIRE(out.str().find("Task timeout: 5\n") != std::string::npos);
+        REQUIRE(out.str().find("TLS") == std::string::npos);
+    }
+
+    SECTION("merges") {
+        failure_breakdown other {};
+        b.record(failure_phase::tls, 10);
+        other.record(failure_phase::tls, 20);
+        other.record(failure_phase::other, 1);
+        b.merge(other);
+
+        REQUIRE(b.count(failure_phase::tls) == 2);
+        REQUIRE(b.count(failure_phase::other) == 1);
+        REQUIRE(b.latency_ms[static_cast<std::size_t>(failure_phase::tls)].max()
+                >= 20);
+    }
+}
+
+SCENARIO("failure_recorder", "[failures]") {
+    failure_recorder recorder {};
+    std::vector<std::thread> threads {};
+
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&recorder]() {
+            for (int i = 0; i < 1000; i++)
+                recorder.record(failure_phase::association_rejected,
+                                milliseconds(i));
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    auto b = recorder.get_breakdown();
+    REQUIRE(b.count(failure_phase::association_rejected) == 4000);
+    REQUIRE(b.total() == 4000);
+
+    // Negative latencies are clamped
+    recorder.record(failure_phase::other, milliseconds(-5));
+    REQUIRE(recorder.get_breakdown().latency_ms[
+                static_cast<std::size_t>(failure_phase::other)].max() == 0);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,197 @@
+#include <catch.hpp>
+
+#include <pcp-test/histogram.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace pcp_test {
+
+SCENARIO("latency_histogram bucket layout", "[histogram]") {
+    SECTION("small values are stored exactly") {
+        for (uint32_t v = 0; v < 128; v++) {
+            auto idx = latency_histogram::bucket_index(v);
+            REQUIRE(latency_histogram::bucket_lowest_value(idx) == v);
+            REQUIRE(latency_histogram::bucket_highest_value(idx) == v);
+        }
+    }
+
+    SECTION("buckets are contiguous and cover the uint32_t range") {
+        for (std::size_t idx = 1; idx < latency_histogram::NUM_BUCKETS; idx++)
+            REQUIRE(latency_histogram::bucket_lowest_value(idx)
+                    == latency_histogram::bucket_highest_value(idx - 1) + 1);
+
+        REQUIRE(latency_histogram::bucket_index(std::numeric_limits<uint32_t>::max())
+                == latency_histogram::NUM_BUCKETS - 1);
+    }
+
+    SECTION("values fall within their bucket, with bounded relative error") {
+        for (uint32_t v : {128u, 1000u, 65535u, 123456789u, 4000000000u}) {
+            auto idx = latency_histogram::bucket_index(v);
+            auto low = latency_histogram::bucket_lowest_value(idx);
+            auto high = latency_histogram::bucket_highest_value(idx);
+            REQUIRE(low <= v);
+            REQUIRE(v <= high);
+            REQUIRE(static_cast<double>(high - low) / low < 1.0 / 64);
+        }
+    }
+}
+
+SCENARIO("latency_histogram stats", "[histogram]") {
+    latency_histogram h {};
+
+    SECTION("is empty at first") {
+        REQUIRE(h.count() == 0);
+        REQUIRE(h.percentile(99) == 0);
+        REQUIRE(h.min() == 0);
+        REQUIRE(h.max() == 0);
+    }
+
+    SECTION("computes count, min, max, mean, and variance") {
+        h.record(1000);
+        h.record(3000);
+        h.record(2000, 2);
+
+        REQUIRE(h.count() == 4);
+        REQUIRE(h.min() == 1000);
+        REQUIRE(h.max() == 3000);
+        REQUIRE(h.mean() == Approx(2000));
+        REQUIRE(h.variance() == Approx(500000));
+    }
+
+    SECTION("computes percentiles") {
+        for (uint32_t v = 1; v <= 1000; v++)
+            h.record(v);
+
+        REQUIRE(h.percentile(0) == 1);
+        REQUIRE(h.percentile(100) == 1000);
+        REQUIRE(std::abs(static_cast<int>(h.percentile(50)) - 500) <= 8);
+        REQUIRE(std::abs(static_cast<int>(h.percentile(90)) - 900) <= 15);
+        REQUIRE(std::abs(static_cast<int>(h.percentile(99)) - 990) <= 16);
+    }
+
+    SECTION("percentiles are capped by the max value") {
+        h.record(1000);
+        REQUIRE(h.percentile(50) == 1000);
+        REQUIRE(h.percentile(99.9) == 1000);
+    }
+}
+
+SCENARIO("latency_histogram merge", "[histogram]") {
+    SECTION("merging is equivalent to recording all values") {
+        latency_histogram all {};
+        latency_histogram a {};
+        latency_histogram b {};
+
+        for (uint32_t v = 0; v < 5000; v += 7) {
+            all.record(v);
+            (v % 2 ? a : b).record(v);
+        }
+
+        a.merge(b);
+
+        REQUIRE(a.count() == all.count());
+        REQUIRE(a.min() == all.min());
+        REQUIRE(a.max() == all.max());
+        REQUIRE(a.mean() == Approx(all.mean()));
+        REQUIRE(a.variance() == Approx(all.variance()));
+
+        for (double p : {10.0, 50.0, 90.0, 99.0, 99.9})
+            REQUIRE(a.percentile(p) == all.percentile(p));
+    }
+
+    SECTION("merging an empty histogram has no effect") {
+        latency_histogram a {};
+        a.record(42);
+        a.merge(latency_histogram {});
+
+        REQUIRE(a.count() == 1);
+        REQUIRE(a.min() == 42);
+    }
+}
+
+SCENARIO("latency_histogram coordinated omission correction", "[histogram]") {
+    latency_histogram h {};
+
+    SECTION("values within the expected interval are recorded once") {
+        h.record_corrected(10, 10);
+        h.record_corrected(3, 10);
+
+        REQUIRE(h.count() == 2);
+        REQUIRE(h.max() == 10);
+    }
+
+    SECTION("the samples missed by a stall are recorded") {
+        h.record_corrected(45, 10);
+
+        REQUIRE(h.count() == 4);
+        REQUIRE(h.min() == 15);
+        REQUIRE(h.max() == 45);
+        REQUIRE(h.mean() == Approx(30.0));
+    }
+
+    SECTION("no correction for a null interval") {
+        h.record_corrected(1000, 0);
+
+        REQUIRE(h.count() == 1);
+    }
+}
+
+SCENARIO("latency_histogram serialization", "[histogram]") {
+    SECTION("restores the exact state") {
+        latency_histogram h {};
+
+        for (uint32_t v = 1; v < 200000; v = v * 3 + 1)
+            h.record(v, v % 5 + 1);
+
+        auto d = latency_histogram::deserialize(h.serialize());
+
+        REQUIRE(d.count() == h.count());
+        REQUIRE(d.min() == h.min());
+        REQUIRE(d.max() == h.max());
+        REQUIRE(d.mean() == h.mean());
+        REQUIRE(d.variance() == h.variance());
+
+        for (std::size_t idx = 0; idx < latency_histogram::NUM_BUCKETS; idx++)
+            REQUIRE(d.bucket_count(idx) == h.bucket_count(idx));
+    }
+
+    SECTION("merging deserialized histograms is lossless") {
+        latency_histogram all {};
+        latency_histogram a {};
+        latency_histogram b {};
+
+        for (uint32_t v = 0; v < 5000; v += 7) {
+            all.record(v);
+            (v % 2 ? a : b).record(v);
+        }
+
+        auto merged = latency_histogram::deserialize(a.serialize());
+        merged.merge(latency_histogram::deserialize(b.serialize()));
+        a.merge(b);
+
+        REQUIRE(merged.count() == all.count());
+        REQUIRE(merged.mean() == a.mean());
+        REQUIRE(merged.variance() == a.variance());
+
+        for (double p : {50.0, 99.0, 99.9})
+            REQUIRE(merged.percentile(p) == all.percentile(p));
+    }
+
+    SECTION("an empty histogram") {
+        auto d = latency_histogram::deserialize(latency_histogram {}.serialize());
+
+        REQUIRE(d.count() == 0);
+        REQUIRE(d.percentile(50) == 0);
+    }
+
+    SECTION("throws in case of invalid strings") {
+        REQUIRE_THROWS_AS(latency_histogram::deserialize("foo"), fatal_error);
+        REQUIRE_THROWS_AS(latency_histogram::deserialize("2 1 1 1 0 1:1"), fatal_error);
+        REQUIRE_THROWS_AS(latency_histogram::deserialize("1 1 1 1 0 99999:1"),
+                          fatal_error);
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,82 @@
+#include <catch.hpp>
+
+#include <pcp-test/keepalive_scheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+using ping_type = keepalive_scheduler::ping_type;
+
+SCENARIO("keepalive_scheduler pings periodically", "[keepalive]") {
+    const int num_connections {20};
+    std::vector<std::atomic<int>> num_pings(num_connections);
+    std::vector<ping_type> pings {};
+
+    for (auto& n : num_pings) {
+        n = 0;
+        pings.push_back([&n]() { n++; return true; });
+    }
+
+    keepalive_scheduler k_s {std::chrono::milliseconds(50), 2};
+    k_s.add(std::move(pings));
+    REQUIRE(k_s.num_connections() == static_cast<std::size_t>(num_connections));
+
+    // First pings are within the first period, then once per period
+    std::this_thread::sleep_for(std::chrono::milliseconds(175));
+    k_s.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    for (auto& n : num_pings) {
+        REQUIRE(n.load() >= 2);
+        REQUIRE(n.load() <= 4);
+    }
+
+    auto stats = k_s.get_stats();
+    REQUIRE(stats.num_pings == stats.lag_us.count());
+    REQUIRE(stats.num_failures == 0);
+    REQUIRE(stats.num_not_associated == 0);
+
+    SECTION("does not ping once stopped") {
+        auto total = stats.num_pings;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        REQUIRE(k_s.get_stats().num_pings == total);
+    }
+}
+
+SCENARIO("keepalive_scheduler accounts for unsuccessful pings", "[keepalive]") {
+    keepalive_scheduler k_s {std::chrono::milliseconds(20), 1};
+    k_s.add({ []() { return false; },
+              []() -> bool { throw std::runtime_error("boom"); } });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    k_s.stop();
+    auto stats = k_s.get_stats();
+
+    REQUIRE(stats.num_pings == 0);
+    REQUIRE(stats.num_not_associated >= 2);
+    REQUIRE(stats.num_failures >= 2);
+}
+
+SCENARIO("keepalive_scheduler skips missed slots", "[keepalive]") {
+    keepalive_scheduler k_s {std::chrono::milliseconds(10), 1};
+    std::atomic<int> count {0};
+
+    // The ping blocks the only worker for longer than 3 periods
+    k_s.add({ [&count]() {
+        if (count++ == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(45));
+        return true;
+    } });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    k_s.stop();
+
+    REQUIRE(k_s.get_stats().num_missed >= 3);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,102 @@
+#include <catch.hpp>
+
+#include <pcp-test/live_metrics.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/nowide/fstream.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+namespace fs = boost::filesystem;
+
+SCENARIO("live_metrics samples", "[live_metrics]") {
+    live_metrics metrics {};
+    metrics.set_run(3);
+
+    SECTION("count what happened since the previous sample") {
+        metrics.attempt_started();
+        metrics.attempt_started();
+        metrics.attempt_completed(true, std::chrono::milliseconds(20));
+
+        auto s = metrics.sample();
+
+        REQUIRE(s.run_idx == 3);
+        REQUIRE(s.counters.num_attempts == 2);
+        REQUIRE(s.counters.num_associated == 1);
+        REQUIRE(s.counters.num_failures == 0);
+        REQUIRE(s.num_in_flight == 1);
+        REQUIRE(s.connect_ms.count() == 1);
+        REQUIRE(s.connect_ms.max() == 20);
+
+        metrics.attempt_completed(false, std::chrono::milliseconds(1500));
+        metrics.attempt_failed();
+        s = metrics.sample();
+
+        REQUIRE(s.counters.num_attempts == 0);
+        REQUIRE(s.counters.num_associated == 0);
+        REQUIRE(s.counters.num_failures == 1);
+        REQUIRE(s.num_in_flight == 0);
+        REQUIRE(s.connect_ms.count() == 1);
+        REQUIRE(s.connect_ms.min() == 1500);
+    }
+
+    SECTION("keep the totals and the last sample") {
+        metrics.attempt_started();
+        metrics.attempt_completed(true, std::chrono::milliseconds(5));
+        metrics.sample();
+        metrics.attempt_started();
+
+        auto totals = metrics.get_totals();
+        REQUIRE(totals.num_attempts == 2);
+        REQUIRE(totals.num_associated == 1);
+        REQUIRE(metrics.get_last_sample().counters.num_attempts == 1);
+    }
+}
+
+SCENARIO("live_metrics_reporter writes a row per sample", "[live_metrics]") {
+    auto file_path = (fs::temp_directory_path()
+                      / fs::unique_path("pcp-test-live-%%%%%%.csv")).string();
+    live_metrics metrics {};
+
+    {
+        live_metrics_reporter reporter {metrics, file_path, 0};
+        metrics.set_run(1);
+        metrics.attempt_started();
+        metrics.attempt_completed(true, std::chrono::milliseconds(42));
+    }
+
+    boost::nowide::ifstream in_stream {file_path};
+    std::vector<std::string> rows {};
+    std::string row {};
+
+    while (std::getline(in_stream, row))
+        rows.push_back(row);
+
+    fs::remove(file_path);
+
+    REQUIRE(rows.size() == 1);
+    REQUIRE(rows[0].find(",1,1,1,0,0,42,42,42,42") != std::string::npos);
+}
+
+SCENARIO("live_metrics_reporter HTTP endpoint", "[live_metrics]") {
+    auto file_path = (fs::temp_directory_path()
+                      / fs::unique_path("pcp-test-live-%%%%%%.csv")).string();
+    live_metrics metrics {};
+
+    SECTION("throws a fatal_error in case of an invalid bind address") {
+        REQUIRE_THROWS_AS(live_metrics_reporter(metrics, file_path, 9100,
+                                                "not-an-address"),
+                          fatal_error);
+    }
+
+    fs::remove(file_path);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,144 @@
+#include <catch.hpp>
+
+#include <pcp-test/message.hpp>
+#include <pcp-test/schemas.hpp>
+
+#include <string>
+
+namespace pcp_test {
+
+SCENARIO("message::write_binary_data", "[message]") {
+    std::string buffer {"some previous content"};
+    message::write_binary_data(buffer, "tx_1", std::string("\0\1\2", 3));
+    REQUIRE(buffer == std::string("tx_1\n\0\1\2", 8));
+
+    SECTION("includes the sequence number and the send time") {
+        message::write_binary_data(buffer, "tx_1", 42, 1234567890123, "abc");
+        REQUIRE(buffer == "tx_1 42 1234567890123\nabc");
+    }
+}
+
+SCENARIO("message_view of binary data", "[message]") {
+    PCPClient::ParsedChunks parsed_chunks {};
+    parsed_chunks.has_data  = true;
+    parsed_chunks.data_type = PCPClient::ContentType::Binary;
+
+    SECTION("references the transaction and the payload") {
+        message::write_binary_data(parsed_chunks.binary_data, "tx_1",
+                                   std::string("\0\1\n", 3));
+        message_view view {parsed_chunks};
+
+        REQUIRE(view.is_binary());
+        REQUIRE(view.transaction() == "tx_1");
+        REQUIRE(view.binary_payload() == boost::string_ref("\0\1\n", 3));
+        REQUIRE(view.binary_payload().data() == parsed_chunks.binary_data.data() + 5);
+        REQUIRE(view.sequence() == 0);
+        REQUIRE(view.sent_ns() == 0);
+    }
+
+    SECTION("parses the sequence number and the send time") {
+        message::write_binary_data(parsed_chunks.binary_data, "tx_1", 7, 99, "abc");
+        message_view view {parsed_chunks};
+
+        REQUIRE(view.transaction() == "tx_1");
+        REQUIRE(view.binary_payload() == "abc");
+        REQUIRE(view.sequence() == 7);
+        REQUIRE(view.sent_ns() == 99);
+
+        message msg {"pcp-test-binary-response", "pcp://a/b", "tx_1"};
+        msg.set_send_info(7);
+        REQUIRE(msg.sent_ns() > 0);
+        REQUIRE(msg.get_binary_data().find("tx_1 7 ") == 0);
+    }
+
+    SECTION("throws in case of invalid data") {
+        parsed_chunks.binary_data = "no header";
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+
+        parsed_chunks.binary_data = "tx_1 x 1\n";
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+
+        parsed_chunks.binary_data = "tx_1\n";
+        parsed_chunks.invalid_data = true;
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+    }
+
+    SECTION("throws in case of out of range numbers") {
+        parsed_chunks.binary_data = "tx_1 18446744073709551615 1\n";
+        REQUIRE(message_view {parsed_chunks}.sequence() == UINT64_MAX);
+
+        parsed_chunks.binary_data = "tx_1 18446744073709551616 1\n";
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+
+        parsed_chunks.binary_data = "tx_1 99999999999999999999 1\n";
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+
+        parsed_chunks.binary_data = "tx_1 1 9223372036854775807\n";
+        REQUIRE(message_view {parsed_chunks}.sent_ns() == INT64_MAX);
+
+        parsed_chunks.binary_data = "tx_1 1 9223372036854775808\n";
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+    }
+}
+
+SCENARIO("message header chunk", "[message]") {
+    PCPClient::ParsedChunks parsed_chunks {};
+    parsed_chunks.envelope.set<std::string>("id", "1234");
+    parsed_chunks.envelope.set<std::string>("sender", "pcp://a/b");
+    parsed_chunks.has_data     = true;
+    parsed_chunks.invalid_data = false;
+
+    leatherman::json_container::JsonContainer header {};
+    message::write_header(header, "tx_1", 7, 99);
+    parsed_chunks.debug.push_back(leatherman::json_container::JsonContainer {});
+    parsed_chunks.debug.push_back(header);
+
+    SECTION("is found among the debug chunks") {
+        REQUIRE(message::find_header(parsed_chunks) == &parsed_chunks.debug[1]);
+
+        parsed_chunks.debug.clear();
+        REQUIRE(message::find_header(parsed_chunks) == nullptr);
+    }
+
+    SECTION("provides the header of binary data, that is all payload") {
+        parsed_chunks.data_type   = PCPClient::ContentType::Binary;
+        parsed_chunks.binary_data = std::string("\0\1\n", 3);
+        message_view view {parsed_chunks};
+
+        REQUIRE(view.transaction() == "tx_1");
+        REQUIRE(view.binary_payload() == boost::string_ref("\0\1\n", 3));
+        REQUIRE(view.sequence() == 7);
+        REQUIRE(view.sent_ns() == 99);
+
+        parsed_chunks.envelope.set<std::string>("message_type",
+                                                schemas::BINARY_RESPONSE_TYPE);
+        message msg {parsed_chunks};
+        REQUIRE(msg.transaction() == "tx_1");
+        REQUIRE(msg.payload() == std::string("\0\1\n", 3));
+        REQUIRE(msg.sequence() == 7);
+    }
+
+    SECTION("provides the header of JSON data without transaction") {
+        parsed_chunks.data_type = PCPClient::ContentType::Json;
+        parsed_chunks.data.set<std::string>("payload", "abc");
+        message_view view {parsed_chunks};
+
+        REQUIRE(view.transaction() == "tx_1");
+        REQUIRE(view.sequence() == 7);
+        REQUIRE(view.sent_ns() == 99);
+
+        parsed_chunks.envelope.set<std::string>("message_type", schemas::RESPONSE_TYPE);
+        message msg {parsed_chunks};
+        REQUIRE(msg.transaction() == "tx_1");
+        REQUIRE(msg.payload() == "abc");
+        REQUIRE(msg.sent_ns() == 99);
+    }
+
+    SECTION("throws in case of no transaction") {
+        parsed_chunks.debug.clear();
+        parsed_chunks.data_type = PCPClient::ContentType::Json;
+        REQUIRE_THROWS_AS(message_view {parsed_chunks}, message::error);
+    }
+}
+
+}  // namespace pcp_test
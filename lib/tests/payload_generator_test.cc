@@ -0,0 +1,78 @@
+#include <catch.hpp>
+
+#include <pcp-test/payload_generator.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace pcp_test {
+
+SCENARIO("payload_generator builds payloads", "[payload]") {
+    SECTION("of fixed size") {
+        payload_generator g {payload_format::json,
+                             payload_size_distribution::fixed, 4, 1024};
+        REQUIRE(g.num_payloads() == 4);
+
+        for (std::size_t idx = 0; idx < g.num_payloads(); idx++)
+            REQUIRE(g.get(idx).size() == 1024);
+
+        REQUIRE(g.mean_size() == Approx(1024));
+    }
+
+    SECTION("that are reused cyclically") {
+        payload_generator g {payload_format::binary,
+                             payload_size_distribution::fixed, 3, 16};
+        REQUIRE(&g.get(1) == &g.get(4));
+    }
+
+    SECTION("with uniformly distributed sizes") {
+        payload_generator g {payload_format::binary,
+                             payload_size_distribution::uniform, 200, 100, 200, 7};
+
+        for (std::size_t idx = 0; idx < g.num_payloads(); idx++) {
+            REQUIRE(g.get(idx).size() >= 100);
+            REQUIRE(g.get(idx).size() <= 200);
+        }
+
+        REQUIRE(g.mean_size() == Approx(150).epsilon(0.1));
+    }
+
+    SECTION("with exponentially distributed sizes, capped to the maximum") {
+        payload_generator g {payload_format::binary,
+                             payload_size_distribution::exponential, 1000, 100, 400, 7};
+
+        for (std::size_t idx = 0; idx < g.num_payloads(); idx++)
+            REQUIRE(g.get(idx).size() <= 400);
+
+        REQUIRE(g.mean_size() == Approx(100).epsilon(0.15));
+    }
+
+    SECTION("of alphanumeric characters, in case of JSON format") {
+        payload_generator g {payload_format::json,
+                             payload_size_distribution::fixed, 2, 512, 0, 3};
+        const auto& p = g.get(0);
+        REQUIRE(std::all_of(p.begin(), p.end(),
+                            [](char c) { return std::isalnum(c) != 0; }));
+    }
+
+    SECTION("with their JSON data chunks") {
+        payload_generator g {payload_format::json,
+                             payload_size_distribution::fixed, 2, 16};
+        REQUIRE(g.get_data(1).get<std::string>("payload") == g.get(1));
+        REQUIRE(&g.get_data(3) == &g.get_data(1));
+
+        payload_generator empty {payload_format::json,
+                                 payload_size_distribution::fixed, 1, 0};
+        REQUIRE_FALSE(empty.get_data(0).includes("payload"));
+    }
+
+    SECTION("at least one, even if empty") {
+        payload_generator g {payload_format::json,
+                             payload_size_distribution::fixed, 0, 0};
+        REQUIRE(g.num_payloads() == 1);
+        REQUIRE(g.get(0).empty());
+    }
+}
+
+}  // namespace pcp_test
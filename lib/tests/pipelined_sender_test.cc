@@ -0,0 +1,183 @@
+#include <catch.hpp>
+
+#include <pcp-test/pipelined_sender.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pcp_test {
+
+using clock_type = pipelined_sender::clock_type;
+
+static const std::vector<std::string> ENDPOINTS {"pcp://agent/test"};
+static const std::string DATA {"data"};
+
+static outgoing_request make_request(const std::string& transaction)
+{
+    return outgoing_request {transaction, &ENDPOINTS, payload_format::binary,
+                             nullptr, &DATA, {}, clock_type::now()};
+}
+
+static clock_type::time_point in_ms(int ms)
+{
+    return clock_type::now() + std::chrono::milliseconds(ms);
+}
+
+SCENARIO("pipelined_sender window", "[pipeline]") {
+    std::atomic<int> num_sent {0};
+    pipelined_sender sender {[&num_sent](const outgoing_request&)
+                             {
+                                 num_sent++;
+                                 return true;
+                             },
+                             2, 8};
+
+    REQUIRE(sender.window() == 2);
+
+    SECTION("applies backpressure when the window is full") {
+        auto r1 = make_request("t1");
+        auto r2 = make_request("t2");
+        auto r3 = make_request("t3");
+        REQUIRE(sender.submit(r1, in_ms(1000)));
+        REQUIRE(sender.submit(r2, in_ms(1000)));
+        REQUIRE_FALSE(sender.submit(r3, in_ms(20)));
+        REQUIRE(r3.transaction == "t3");
+        REQUIRE(sender.in_flight() == 2);
+
+        sender.acknowledge();
+        REQUIRE(sender.submit(r3, in_ms(1000)));
+        REQUIRE(sender.in_flight() == 2);
+    }
+
+    SECTION("sends the queued requests when stopped") {
+        auto r1 = make_request("t1");
+        auto r2 = make_request("t2");
+        REQUIRE(sender.submit(r1, in_ms(1000)));
+        REQUIRE(sender.submit(r2, in_ms(1000)));
+        sender.stop();
+
+        REQUIRE(num_sent.load() == 2);
+        REQUIRE(sender.num_queued() == 0);
+        REQUIRE(sender.get_counters().sent == 2);
+
+        auto r3 = make_request("t3");
+        REQUIRE_FALSE(sender.submit(r3, in_ms(1000)));
+
+        sender.acknowledge(2);
+        REQUIRE(sender.in_flight() == 0);
+    }
+}
+
+SCENARIO("pipelined_sender batches", "[pipeline]") {
+    std::mutex mtx {};
+    std::condition_variable cv {};
+    bool first_send_started {false};
+    bool gate_open {false};
+    std::vector<std::string> sent {};
+
+    pipelined_sender sender {
+        [&](const outgoing_request& request)
+        {
+            std::unique_lock<std::mutex> lck {mtx};
+            sent.push_back(request.transaction);
+
+            if (!first_send_started) {
+                first_send_started = true;
+                cv.notify_all();
+                cv.wait(lck, [&]() { return gate_open; });
+            }
+
+            return true;
+        },
+        16, 4};
+
+    // Block the sender on the first request, so that the others queue up
+    auto r0 = make_request("t0");
+    REQUIRE(sender.submit(r0, in_ms(1000)));
+
+    {
+        std::unique_lock<std::mutex> lck {mtx};
+        REQUIRE(cv.wait_for(lck, std::chrono::seconds(5),
+                            [&]() { return first_send_started; }));
+    }
+
+    for (int idx = 1; idx < 10; idx++) {
+        auto r = make_request("t" + std::to_string(idx));
+        REQUIRE(sender.submit(r, in_ms(1000)));
+    }
+
+    REQUIRE(sender.num_queued() == 9);
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx};
+        gate_open = true;
+    }
+    cv.notify_all();
+    sender.stop();
+
+    auto counters = sender.get_counters();
+    REQUIRE(counters.sent == 10);
+    REQUIRE(counters.batches == 4);  // 1 + 4 + 4 + 1 requests
+
+    std::vector<std::string> expected {};
+    for (int idx = 0; idx < 10; idx++)
+        expected.push_back("t" + std::to_string(idx));
+    REQUIRE(sent == expected);
+}
+
+SCENARIO("pipelined_sender callbacks", "[pipeline]") {
+    std::vector<std::string> events {};
+    std::mutex mtx {};
+
+    pipelined_sender sender {
+        [&](const outgoing_request& request)
+        {
+            std::lock_guard<std::mutex> the_lock {mtx};
+            events.push_back("send " + request.transaction);
+            return request.transaction != "t2";
+        },
+        1, 4,
+        [&](const outgoing_request& request)
+        {
+            std::lock_guard<std::mutex> the_lock {mtx};
+            events.push_back("before " + request.transaction);
+        },
+        [&](const outgoing_request& request, bool ok)
+        {
+            std::lock_guard<std::mutex> the_lock {mtx};
+            events.push_back((ok ? "sent " : "failed ") + request.transaction);
+        }};
+
+    SECTION("are executed around each send attempt") {
+        auto r1 = make_request("t1");
+        REQUIRE(sender.submit(r1, in_ms(1000)));
+        sender.stop();
+
+        REQUIRE(events == (std::vector<std::string> {"before t1", "send t1", "sent t1"}));
+    }
+
+    SECTION("the slots of failed sends are released") {
+        // NB: the window has a single slot, that is released only by
+        // the failure, as the request is not acknowledged
+        auto r2 = make_request("t2");
+        auto r3 = make_request("t3");
+        REQUIRE(sender.submit(r2, in_ms(1000)));
+        REQUIRE(sender.submit(r3, in_ms(5000)));
+        sender.stop();
+
+        REQUIRE(events.size() == 6);
+        REQUIRE(events[2] == "failed t2");
+        REQUIRE(events[5] == "sent t3");
+
+        auto counters = sender.get_counters();
+        REQUIRE(counters.sent == 1);
+        REQUIRE(counters.failed == 1);
+        REQUIRE(sender.in_flight() == 1);
+    }
+}
+
+}  // namespace pcp_test
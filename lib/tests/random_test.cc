@@ -31,6 +31,15 @@ SCENARIO("exponential_integers call operator", "[random]") {
         REQUIRE(v_1 == v_2);
         REQUIRE(v_1 != v_3);
     }
+
+    SECTION("can generate interarrivals in a different time unit") {
+        exponential_integers e_ms {2, 42};
+        exponential_integers e_us {2, 42, 1000000};
+        auto v_ms = e_ms();
+        auto v_us = e_us();
+
+        REQUIRE(v_us / 1000 == v_ms);
+    }
 }
 
 }  // namespace pcp_test
@@ -0,0 +1,138 @@
+#include <catch.hpp>
+
+#include <pcp-test/reconnect_storm.hpp>
+#include <pcp-test/errors.hpp>
+
+#include <chrono>
+
+namespace pcp_test {
+
+using ms = std::chrono::milliseconds;
+
+static reconnect_policy make_policy(backoff_policy backoff, jitter_policy jitter)
+{
+    return reconnect_policy {backoff, jitter, ms(100), ms(1000)};
+}
+
+SCENARIO("reconnect_backoff", "[reconnect]") {
+    SECTION("throws a fatal_error in case of invalid delays") {
+        REQUIRE_THROWS_AS(reconnect_backoff(reconnect_policy {backoff_policy::constant,
+                                                              jitter_policy::none,
+                                                              ms(0), ms(10)}),
+                          fatal_error);
+        REQUIRE_THROWS_AS(reconnect_backoff(reconnect_policy {backoff_policy::constant,
+                                                              jitter_policy::none,
+                                                              ms(100), ms(10)}),
+                          fatal_error);
+    }
+
+    SECTION("constant") {
+        reconnect_backoff b {make_policy(backoff_policy::constant, jitter_policy::none)};
+
+        REQUIRE(b.delay(0, ms(0)) == ms(100));
+        REQUIRE(b.delay(5, ms(100)) == ms(100));
+    }
+
+    SECTION("exponential, up to the maximum delay") {
+        reconnect_backoff b {make_policy(backoff_policy::exponential, jitter_policy::none)};
+
+        REQUIRE(b.delay(0, ms(0)) == ms(100));
+        REQUIRE(b.delay(1, ms(0)) == ms(200));
+        REQUIRE(b.delay(3, ms(0)) == ms(800));
+        REQUIRE(b.delay(4, ms(0)) == ms(1000));
+        REQUIRE(b.delay(1000, ms(0)) == ms(1000));
+    }
+
+    SECTION("full jitter") {
+        reconnect_backoff b {make_policy(backoff_policy::exponential, jitter_policy::full), 7};
+
+        for (int idx = 0; idx < 1000; idx++) {
+            auto d = b.delay(2, ms(0));
+            REQUIRE(d >= ms(0));
+            REQUIRE(d <= ms(400));
+        }
+    }
+
+    SECTION("equal jitter") {
+        reconnect_backoff b {make_policy(backoff_policy::exponential, jitter_policy::equal), 7};
+
+        for (int idx = 0; idx < 1000; idx++) {
+            auto d = b.delay(2, ms(0));
+            REQUIRE(d >= ms(200));
+            REQUIRE(d <= ms(400));
+        }
+    }
+
+    SECTION("decorrelated jitter") {
+        reconnect_backoff b {make_policy(backoff_policy::constant,
+                                         jitter_policy::decorrelated), 7};
+        ms previous {0};
+
+        for (int idx = 0; idx < 1000; idx++) {
+            auto d = b.delay(static_cast<unsigned int>(idx), previous);
+            REQUIRE(d >= ms(100));
+            REQUIRE(d <= std::min(ms(1000), 3 * std::max(ms(100), previous)));
+            previous = d;
+        }
+    }
+}
+
+SCENARIO("reconnect_storm_tracker", "[reconnect]") {
+    using clock_type = reconnect_storm_tracker::clock_type;
+    auto t0 = clock_type::now();
+    reconnect_storm_tracker tracker {3};
+
+    SECTION("no storm") {
+        auto r_s = tracker.get_stats();
+
+        REQUIRE(r_s.num_connections == 3);
+        REQUIRE(r_s.num_not_associated == 0);
+        REQUIRE(r_s.storms.empty());
+    }
+
+    SECTION("measures the time to full re-association and the peak attempt rate") {
+        tracker.dropped(t0);
+        tracker.dropped(t0 + ms(10));
+        tracker.attempt_started(t0 + ms(100));
+        tracker.attempt_started(t0 + ms(200));
+        tracker.attempt_failed();
+        tracker.attempt_started(t0 + ms(1100));
+        tracker.reassociated(t0 + ms(1500));
+
+        REQUIRE(tracker.num_disconnected() == 1);
+
+        auto ongoing = tracker.get_stats();
+        REQUIRE(ongoing.num_not_associated == 1);
+        REQUIRE(ongoing.storms.size() == 1);
+        REQUIRE(ongoing.storms[0].reassociation_ms == -1);
+
+        tracker.reassociated(t0 + ms(2500));
+        auto r_s = tracker.get_stats();
+
+        REQUIRE(r_s.num_not_associated == 0);
+        REQUIRE(r_s.storms.size() == 1);
+        REQUIRE(r_s.storms[0].num_dropped == 2);
+        REQUIRE(r_s.storms[0].num_attempts == 3);
+        REQUIRE(r_s.storms[0].num_failed_attempts == 1);
+        REQUIRE(r_s.storms[0].reassociation_ms == 2500);
+        REQUIRE(r_s.storms[0].peak_attempt_rate == 2);
+    }
+
+    SECTION("separates the storms") {
+        tracker.dropped(t0);
+        tracker.attempt_started(t0 + ms(1));
+        tracker.reassociated(t0 + ms(50));
+        tracker.dropped(t0 + ms(5000));
+        tracker.attempt_started(t0 + ms(5001));
+        tracker.reassociated(t0 + ms(5300));
+
+        auto r_s = tracker.get_stats();
+
+        REQUIRE(r_s.storms.size() == 2);
+        REQUIRE(r_s.storms[0].reassociation_ms == 50);
+        REQUIRE(r_s.storms[1].reassociation_ms == 300);
+        REQUIRE(r_s.storms[1].num_dropped == 1);
+    }
+}
+
+}  // namespace pcp_test
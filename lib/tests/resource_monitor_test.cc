@@ -0,0 +1,84 @@
+#include <catch.hpp>
+
+#include <pcp-test/resource_monitor.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace pcp_test {
+
+namespace fs = boost::filesystem;
+
+SCENARIO("resource_usage merge", "[resources]") {
+    resource_usage a {};
+    a.num_samples = 3;
+    a.mean_cpu_percent = 40.0;
+    a.max_rss_kb = 1000;
+    a.max_fds = 20;
+    a.lag_us.record(100);
+
+    resource_usage b {};
+    b.num_samples = 2;
+    b.mean_cpu_percent = 95.0;
+    b.max_rss_kb = 500;
+    b.max_fds = 30;
+    b.lag_us.record(5000);
+    b.saturated = true;
+
+    a.merge(b);
+
+    REQUIRE(a.num_samples == 3);
+    REQUIRE(a.mean_cpu_percent == Approx(95.0));
+    REQUIRE(a.max_rss_kb == 1000);
+    REQUIRE(a.max_fds == 30);
+    REQUIRE(a.lag_us.count() == 2);
+    REQUIRE(a.saturated);
+}
+
+SCENARIO("resource_monitor sampling", "[resources]") {
+    auto file_path = (fs::temp_directory_path()
+                      / fs::unique_path("pcp-test-resources-%%%%%%.csv")).string();
+
+    {
+        resource_monitor monitor {file_path};
+        monitor.start_run(1);
+
+        // Keep this thread busy for a while
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        volatile uint64_t n {0};
+
+        while (std::chrono::steady_clock::now() < end)
+            n = n + 1;
+
+        auto usage = monitor.end_run();
+
+        REQUIRE(usage.num_samples == 1);
+        REQUIRE(usage.mean_cpu_percent > 0.0);
+        REQUIRE(usage.lag_us.count() > 0);
+        REQUIRE(monitor.get_last_sample().run_idx == 1);
+
+#ifdef __linux__
+        REQUIRE(usage.max_rss_kb > 0);
+        REQUIRE(usage.max_threads >= 2);
+        REQUIRE(usage.max_fds > 0);
+#endif
+    }
+
+    // A row for the end of the run and one for the stop
+    boost::nowide::ifstream file {file_path};
+    std::string line {};
+    int num_rows {0};
+
+    while (std::getline(file, line))
+        if (!line.empty())
+            num_rows++;
+
+    REQUIRE(num_rows == 2);
+    fs::remove(file_path);
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,104 @@
+#include <catch.hpp>
+
+#include <pcp-test/responder_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace pcp_test {
+
+SCENARIO("responder_pool processing", "[responders]") {
+    std::mutex mtx {};
+    std::condition_variable cv {};
+    std::atomic<int> count {0};
+    PCPClient::ParsedChunks parsed_chunks {};
+
+    auto counting_handler =
+        [&](const PCPClient::ParsedChunks&, client*)
+        {
+            count++;
+            cv.notify_one();
+        };
+
+    SECTION("processes all enqueued requests") {
+        responder_pool pool {counting_handler, 4};
+        REQUIRE(pool.num_threads() == 4);
+
+        for (int idx = 0; idx < 1000; idx++)
+            REQUIRE(pool.enqueue(parsed_chunks, nullptr));
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5),
+                    [&]() { return count.load() == 1000; });
+        REQUIRE(count.load() == 1000);
+        lck.unlock();
+
+        pool.stop();
+        REQUIRE(pool.get_counters().processed == 1000);
+    }
+
+    SECTION("waits for the processing delay") {
+        responder_pool pool {counting_handler, 1, 16, delay_distribution::fixed, 20000};
+        auto start = std::chrono::steady_clock::now();
+
+        for (int idx = 0; idx < 3; idx++)
+            REQUIRE(pool.enqueue(parsed_chunks, nullptr));
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5),
+                    [&]() { return count.load() == 3; });
+        REQUIRE(count.load() == 3);
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(60));
+    }
+
+    SECTION("does not accept requests once stopped") {
+        responder_pool pool {counting_handler, 2};
+        pool.stop();
+        REQUIRE_FALSE(pool.enqueue(parsed_chunks, nullptr));
+        REQUIRE(pool.get_counters().dropped == 0);
+    }
+}
+
+SCENARIO("responder_pool queue", "[responders]") {
+    std::mutex mtx {};
+    std::condition_variable cv {};
+    bool started {false};
+    bool gate_open {false};
+    PCPClient::ParsedChunks parsed_chunks {};
+
+    // The single worker blocks on the first request
+    responder_pool pool {
+        [&](const PCPClient::ParsedChunks&, client*)
+        {
+            std::unique_lock<std::mutex> lck {mtx};
+            started = true;
+            cv.notify_all();
+            cv.wait(lck, [&]() { return gate_open; });
+        },
+        1, 2};
+
+    REQUIRE(pool.enqueue(parsed_chunks, nullptr));
+
+    {
+        std::unique_lock<std::mutex> lck {mtx};
+        REQUIRE(cv.wait_for(lck, std::chrono::seconds(5), [&]() { return started; }));
+    }
+
+    SECTION("drops requests when full, without blocking") {
+        REQUIRE(pool.enqueue(parsed_chunks, nullptr));
+        REQUIRE(pool.enqueue(parsed_chunks, nullptr));
+        REQUIRE_FALSE(pool.enqueue(parsed_chunks, nullptr));
+        REQUIRE(pool.get_counters().dropped == 1);
+    }
+
+    {
+        std::lock_guard<std::mutex> the_lock {mtx};
+        gate_open = true;
+    }
+    cv.notify_all();
+    pool.stop();
+}
+
+}  // namespace pcp_test
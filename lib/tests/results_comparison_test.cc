@@ -0,0 +1,121 @@
+#include <catch.hpp>
+
+#include <pcp-test/results_comparison.hpp>
+
+namespace pcp_test {
+
+static run_summary get_summary(const std::string& key,
+                               double throughput,
+                               double failure_rate_pct,
+                               double connect_p99_ms)
+{
+    run_summary s {};
+    s.key = key;
+    s.throughput = throughput;
+    s.failure_rate_pct = failure_rate_pct;
+    s.latencies_ms["connect_p99"] = connect_p99_ms;
+    return s;
+}
+
+static const metric_change& get_change(const results_comparison& c,
+                                       const std::string& metric,
+                                       std::size_t run = 0)
+{
+    std::size_t count {0};
+
+    for (const auto& m_c : c.changes)
+        if (m_c.metric == metric && count++ == run)
+            return m_c;
+
+    FAIL("no change for " << metric);
+    return c.changes.front();
+}
+
+SCENARIO("compare_results", "[comparison]") {
+    comparison_thresholds t {};
+    std::vector<run_summary> baseline {get_summary("40x4", 100.0, 0.0, 50.0)};
+
+    SECTION("does not flag identical results") {
+        auto c = compare_results(baseline, baseline, t);
+        REQUIRE(c.changes.size() == 3);
+        REQUIRE(c.unmatched_runs.empty());
+        REQUIRE_FALSE(c.has_regressions());
+    }
+
+    SECTION("flags a throughput drop beyond the threshold") {
+        std::vector<run_summary> candidate {get_summary("40x4", 85.0, 0.0, 50.0)};
+        auto c = compare_results(baseline, candidate, t);
+        const auto& m_c = get_change(c, "throughput");
+        REQUIRE(m_c.change_pct == Approx(-15.0));
+        REQUIRE(m_c.regression);
+        REQUIRE(c.has_regressions());
+    }
+
+    SECTION("does not flag a throughput increase or a small drop") {
+        std::vector<run_summary> candidate {get_summary("40x4", 95.0, 0.0, 50.0),
+                                            get_summary("40x4", 150.0, 0.0, 50.0)};
+        std::vector<run_summary> twice {baseline.front(), baseline.front()};
+        auto c = compare_results(twice, candidate, t);
+        REQUIRE_FALSE(get_change(c, "throughput", 0).regression);
+        REQUIRE_FALSE(get_change(c, "throughput", 1).regression);
+        REQUIRE_FALSE(c.has_regressions());
+    }
+
+    SECTION("flags a latency increase beyond the threshold") {
+        std::vector<run_summary> candidate {get_summary("40x4", 100.0, 0.0, 65.0)};
+        auto c = compare_results(baseline, candidate, t);
+        const auto& m_c = get_change(c, "connect_p99_ms");
+        REQUIRE(m_c.change_pct == Approx(30.0));
+        REQUIRE(m_c.regression);
+    }
+
+    SECTION("does not flag a latency increase below the ms floor") {
+        std::vector<run_summary> b {get_summary("40x4", 100.0, 0.0, 2.0)};
+        std::vector<run_summary> candidate {get_summary("40x4", 100.0, 0.0, 2.8)};
+        auto c = compare_results(b, candidate, t);
+        REQUIRE(get_change(c, "connect_p99_ms").change_pct == Approx(40.0));
+        REQUIRE_FALSE(c.has_regressions());
+    }
+
+    SECTION("flags a failure rate increase in percentage points") {
+        std::vector<run_summary> candidate {get_summary("40x4", 100.0, 1.5, 50.0)};
+        auto c = compare_results(baseline, candidate, t);
+        const auto& m_c = get_change(c, "failure_rate_pct");
+        REQUIRE(m_c.change_pct == 0.0);  // the baseline is 0
+        REQUIRE(m_c.regression);
+    }
+
+    SECTION("compares only the latencies present in both runs") {
+        std::vector<run_summary> candidate {get_summary("40x4", 100.0, 0.0, 50.0)};
+        candidate.front().latencies_ms["tcp_p99"] = 5.0;
+        auto c = compare_results(baseline, candidate, t);
+        REQUIRE(c.changes.size() == 3);
+    }
+
+    SECTION("matches runs by key, in order") {
+        std::vector<run_summary> b {get_summary("40x4", 100.0, 0.0, 50.0),
+                                    get_summary("80x4", 200.0, 0.0, 50.0),
+                                    get_summary("40x4", 110.0, 0.0, 50.0)};
+        std::vector<run_summary> candidate {get_summary("80x4", 200.0, 0.0, 50.0),
+                                            get_summary("40x4", 100.0, 0.0, 50.0),
+                                            get_summary("40x4", 110.0, 0.0, 50.0)};
+        auto c = compare_results(b, candidate, t);
+        REQUIRE(c.changes.size() == 9);
+        REQUIRE(c.unmatched_runs.empty());
+        REQUIRE_FALSE(c.has_regressions());
+    }
+
+    SECTION("reports the unmatched runs of both results") {
+        std::vector<run_summary> candidate {get_summary("40x4", 100.0, 0.0, 50.0),
+                                            get_summary("40x4", 100.0, 0.0, 50.0),
+                                            get_summary("80x4", 200.0, 0.0, 50.0)};
+        std::vector<run_summary> b {baseline.front(),
+                                    get_summary("160x4", 400.0, 0.0, 50.0)};
+        auto c = compare_results(b, candidate, t);
+        REQUIRE(c.changes.size() == 3);
+        REQUIRE(c.unmatched_runs
+                == (std::vector<std::string> {"160x4", "40x4", "80x4"}));
+    }
+}
+
+}  // namespace pcp_test
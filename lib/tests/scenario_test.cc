@@ -0,0 +1,145 @@
+#include <catch.hpp>
+
+#include <pcp-test/scenario.hpp>
+#include <pcp-test/errors.hpp>
+
+namespace pcp_test {
+
+static scenario_phase get_connect(int num_agents, int num_controllers)
+{
+    scenario_phase phase {phase_type::connect};
+    phase.num_agents = num_agents;
+    phase.num_controllers = num_controllers;
+    return phase;
+}
+
+static scenario_phase get_timed(phase_type type, unsigned int duration_s)
+{
+    scenario_phase phase {type};
+    phase.duration_s = duration_s;
+    phase.request_rate = 100;
+    return phase;
+}
+
+static scenario_phase get_teardown(int num_agents, int num_controllers)
+{
+    scenario_phase phase {phase_type::teardown};
+    phase.num_agents = num_agents;
+    phase.num_controllers = num_controllers;
+    return phase;
+}
+
+SCENARIO("phase_type_name", "[scenario]") {
+    SECTION("returns the names used in scenarios") {
+        REQUIRE(phase_type_name(phase_type::connect) == "connect");
+        REQUIRE(phase_type_name(phase_type::hold) == "hold");
+        REQUIRE(phase_type_name(phase_type::messages) == "messages");
+        REQUIRE(phase_type_name(phase_type::reconnect_storm) == "reconnect-storm");
+        REQUIRE(phase_type_name(phase_type::teardown) == "teardown");
+    }
+
+    SECTION("names phases by their type, by default") {
+        REQUIRE(scenario_phase {phase_type::reconnect_storm}.name == "reconnect-storm");
+    }
+}
+
+SCENARIO("validate_scenario", "[scenario]") {
+    SECTION("accepts a scenario with all phase types") {
+        auto storm = get_timed(phase_type::reconnect_storm, 30);
+        storm.fraction_pct = 50;
+        std::vector<scenario_phase> phases {get_connect(100, 10),
+                                            get_timed(phase_type::hold, 60),
+                                            get_timed(phase_type::messages, 300),
+                                            storm,
+                                            get_teardown(50, 0),
+                                            get_teardown(-1, -1)};
+        REQUIRE_NOTHROW(validate_scenario(phases));
+    }
+
+    SECTION("throws a configuration_error in case of no phases") {
+        REQUIRE_THROWS_AS(validate_scenario({}), configuration_error);
+    }
+
+    SECTION("throws a configuration_error in case of a connect phase without clients") {
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(0, 0)}), configuration_error);
+    }
+
+    SECTION("throws a configuration_error in case of a hold without clients") {
+        REQUIRE_THROWS_AS(validate_scenario({get_timed(phase_type::hold, 10)}),
+                          configuration_error);
+    }
+
+    SECTION("throws a configuration_error in case of a null duration") {
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(1, 1),
+                                             get_timed(phase_type::hold, 0)}),
+                          configuration_error);
+    }
+
+    SECTION("requires agents and controllers for message load") {
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(10, 0),
+                                             get_timed(phase_type::messages, 10)}),
+                          configuration_error);
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(0, 10),
+                                             get_timed(phase_type::messages, 10)}),
+                          configuration_error);
+    }
+
+    SECTION("requires a positive request rate for message load") {
+        auto messages = get_timed(phase_type::messages, 10);
+        messages.request_rate = 0;
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(1, 1), messages}),
+                          configuration_error);
+    }
+
+    SECTION("throws a configuration_error in case of an invalid storm fraction") {
+        auto storm = get_timed(phase_type::reconnect_storm, 10);
+        storm.fraction_pct = 101;
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(1, 1), storm}),
+                          configuration_error);
+        storm.fraction_pct = 0;
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(1, 1), storm}),
+                          configuration_error);
+    }
+
+    SECTION("throws a configuration_error in case of an invalid reconnect policy") {
+        auto hold = get_timed(phase_type::hold, 10);
+        hold.policy.max_delay = hold.policy.base_delay - std::chrono::milliseconds(1);
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(1, 1), hold}),
+                          configuration_error);
+    }
+
+    SECTION("does not close more clients than connected") {
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(10, 1), get_teardown(11, 0)}),
+                          configuration_error);
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(10, 1), get_teardown(0, 2)}),
+                          configuration_error);
+    }
+
+    SECTION("accounts for the clients torn down by the previous phases") {
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(10, 1),
+                                             get_teardown(10, 0),
+                                             get_timed(phase_type::messages, 10)}),
+                          configuration_error);
+        REQUIRE_THROWS_AS(validate_scenario({get_connect(10, 1),
+                                             get_teardown(-1, -1),
+                                             get_teardown(-1, -1)}),
+                          configuration_error);
+        REQUIRE_NOTHROW(validate_scenario({get_connect(10, 1),
+                                           get_teardown(-1, -1),
+                                           get_connect(5, 1),
+                                           get_timed(phase_type::messages, 10)}));
+    }
+}
+
+SCENARIO("get_scenario_population", "[scenario]") {
+    SECTION("counts the clients of all connect phases") {
+        auto p = get_scenario_population({get_connect(10, 1),
+                                          get_timed(phase_type::hold, 10),
+                                          get_teardown(-1, -1),
+                                          get_connect(5, 2)});
+        REQUIRE(p.num_agents == 15);
+        REQUIRE(p.num_controllers == 3);
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,89 @@
+#include <catch.hpp>
+
+#include <pcp-test/sequence_tracker.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+SCENARIO("sequence_tracker", "[sequence]") {
+    SECTION("does not report in-order messages") {
+        sequence_tracker tracker {};
+
+        for (uint64_t seq = 1; seq <= 10; seq++) {
+            tracker.record("a", seq);
+            tracker.record("b", seq);
+        }
+
+        auto counters = tracker.get_counters();
+        REQUIRE(tracker.num_senders() == 2);
+        REQUIRE(counters.received == 20);
+        REQUIRE(counters.reordered == 0);
+        REQUIRE(counters.duplicates == 0);
+        REQUIRE(counters.missing == 0);
+    }
+
+    SECTION("detects missing and reordered messages") {
+        sequence_tracker tracker {};
+
+        for (uint64_t seq : {1, 2, 5, 3, 6})
+            tracker.record("a", seq);
+
+        auto counters = tracker.get_counters();
+        REQUIRE(counters.reordered == 1);  // 3
+        REQUIRE(counters.missing == 1);    // 4
+
+        tracker.record("a", 4);
+        REQUIRE(tracker.get_counters().reordered == 2);
+        REQUIRE(tracker.get_counters().missing == 0);
+    }
+
+    SECTION("detects duplicates") {
+        sequence_tracker tracker {};
+
+        for (uint64_t seq : {1, 2, 2, 1})
+            tracker.record("a", seq);
+
+        REQUIRE(tracker.get_counters().duplicates == 2);
+    }
+
+    SECTION("forgets old gaps") {
+        sequence_tracker tracker {2};
+
+        for (uint64_t seq : {1, 5, 2})
+            tracker.record("a", seq);
+
+        auto counters = tracker.get_counters();
+        REQUIRE(counters.missing == 3);
+        REQUIRE(counters.duplicates == 1);
+        REQUIRE(counters.reordered == 0);
+    }
+
+    SECTION("ignores messages without sequence number") {
+        sequence_tracker tracker {};
+        tracker.record("a", 0);
+        REQUIRE(tracker.get_counters().received == 0);
+        REQUIRE(tracker.num_senders() == 0);
+    }
+
+    SECTION("can be used by concurrent threads") {
+        sequence_tracker tracker {};
+        std::vector<std::thread> threads {};
+
+        for (int t_idx = 0; t_idx < 4; t_idx++)
+            threads.push_back(std::thread([&tracker, t_idx]() {
+                auto sender = "s" + std::to_string(t_idx);
+                for (uint64_t seq = 1; seq <= 1000; seq++)
+                    tracker.record(sender, seq);
+            }));
+
+        for (auto& t : threads)
+            t.join();
+
+        REQUIRE(tracker.get_counters().received == 4000);
+        REQUIRE(tracker.get_counters().missing == 0);
+    }
+}
+
+}  // namespace pcp_test
@@ -0,0 +1,134 @@
+#include <catch.hpp>
+
+#include <pcp-test/task_scheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+SCENARIO("task_scheduler ctor", "[scheduler]") {
+    SECTION("can instantiate") {
+        REQUIRE_NOTHROW(task_scheduler(2));
+    }
+
+    SECTION("starts one worker per hardware thread by default") {
+        task_scheduler s {};
+        REQUIRE(s.num_threads() > 0);
+    }
+}
+
+SCENARIO("task_scheduler execution", "[scheduler]") {
+    std::mutex mtx {};
+    std::condition_variable cv {};
+
+    SECTION("executes all scheduled tasks") {
+        task_scheduler s {3};
+        std::atomic<int> count {0};
+
+        for (int idx = 0; idx < 100; idx++)
+            s.schedule([&]() { count++; cv.notify_one(); });
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5),
+                    [&]() { return count.load() == 100; });
+        REQUIRE(count.load() == 100);
+    }
+
+    SECTION("executes tasks in order of due time") {
+        task_scheduler s {1};
+        std::vector<int> order {};
+        auto now = task_scheduler::clock_type::now();
+
+        // The first task blocks the only worker, so that the
+        // following ones get queued before being executed
+        s.schedule([]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        });
+        s.schedule_at(now + std::chrono::milliseconds(30),
+                      [&]() { std::lock_guard<std::mutex> l {mtx}; order.push_back(3); });
+        s.schedule_at(now + std::chrono::milliseconds(10),
+                      [&]() { std::lock_guard<std::mutex> l {mtx}; order.push_back(1); });
+        s.schedule_at(now + std::chrono::milliseconds(10),
+                      [&]() { std::lock_guard<std::mutex> l {mtx}; order.push_back(2); });
+        s.schedule_at(now + std::chrono::milliseconds(40),
+                      [&]() { std::lock_guard<std::mutex> l {mtx}; order.push_back(4);
+                              cv.notify_one(); });
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5),
+                    [&]() { return order.size() == 4; });
+        REQUIRE(order == (std::vector<int> {1, 2, 3, 4}));
+    }
+
+    SECTION("does not execute a task before its due time") {
+        task_scheduler s {2};
+        auto scheduled = task_scheduler::clock_type::now();
+        task_scheduler::clock_type::time_point executed {};
+        bool done {false};
+
+        s.schedule_after(std::chrono::milliseconds(50),
+                         [&]() {
+                             std::lock_guard<std::mutex> l {mtx};
+                             executed = task_scheduler::clock_type::now();
+                             done = true;
+                             cv.notify_one();
+                         });
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5), [&]() { return done; });
+        REQUIRE(done);
+        REQUIRE(executed - scheduled >= std::chrono::milliseconds(50));
+    }
+
+    SECTION("keeps executing tasks after a task throws") {
+        task_scheduler s {1};
+        bool done {false};
+
+        s.schedule([]() { throw std::runtime_error("oops"); });
+        s.schedule([&]() {
+            std::lock_guard<std::mutex> l {mtx};
+            done = true;
+            cv.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5), [&]() { return done; });
+        REQUIRE(done);
+    }
+
+    SECTION("provides the index of the executing worker") {
+        task_scheduler s {2};
+        int idx {-2};
+        bool done {false};
+
+        REQUIRE(task_scheduler::worker_index() == -1);
+
+        s.schedule([&]() {
+            std::lock_guard<std::mutex> l {mtx};
+            idx = task_scheduler::worker_index();
+            done = true;
+            cv.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lck {mtx};
+        cv.wait_for(lck, std::chrono::seconds(5), [&]() { return done; });
+        REQUIRE((idx == 0 || idx == 1));
+    }
+
+    SECTION("discards pending tasks when destroyed") {
+        std::atomic<int> count {0};
+        {
+            task_scheduler s {1};
+            s.schedule_after(std::chrono::seconds(60), [&]() { count++; });
+            REQUIRE(s.num_pending() == 1);
+        }
+        REQUIRE(count.load() == 0);
+    }
+}
+
+}  // namespace pcp_test
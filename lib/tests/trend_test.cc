@@ -0,0 +1,52 @@
+#include <catch.hpp>
+
+#include <pcp-test/trend.hpp>
+
+namespace pcp_test {
+
+SCENARIO("linear_trend", "[trend]") {
+    linear_trend t {};
+
+    SECTION("has no slope with less than two samples") {
+        REQUIRE(t.slope() == 0.0);
+        t.add(1.0, 5.0);
+        REQUIRE(t.count() == 1);
+        REQUIRE(t.slope() == 0.0);
+        REQUIRE(t.intercept() == Approx(5.0));
+    }
+
+    SECTION("has no slope if all x values are equal") {
+        t.add(2.0, 1.0);
+        t.add(2.0, 3.0);
+        REQUIRE(t.slope() == 0.0);
+        REQUIRE(t.intercept() == Approx(2.0));
+    }
+
+    SECTION("fits a line") {
+        for (int x = 0; x < 10; x++)
+            t.add(x, 3.0 + 0.5 * x);
+
+        REQUIRE(t.count() == 10);
+        REQUIRE(t.slope() == Approx(0.5));
+        REQUIRE(t.intercept() == Approx(3.0));
+    }
+
+    SECTION("fits noisy samples by least squares") {
+        // Residuals +1, -1, -1, +1 are orthogonal to a line
+        t.add(0.0, 1.0);
+        t.add(1.0, 1.0);
+        t.add(2.0, 3.0);
+        t.add(3.0, 7.0);
+        REQUIRE(t.slope() == Approx(2.0));
+        REQUIRE(t.intercept() == Approx(0.0));
+    }
+
+    SECTION("keeps its precision with large offsets") {
+        for (int x = 0; x < 100; x++)
+            t.add(1e6 + x, 1e9 + 2.0 * x);
+
+        REQUIRE(t.slope() == Approx(2.0));
+    }
+}
+
+}  // namespace pcp_test
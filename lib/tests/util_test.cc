@@ -0,0 +1,55 @@
+#include <catch.hpp>
+
+#include <pcp-test/util.hpp>
+
+#include <boost/regex.hpp>
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcp_test {
+
+SCENARIO("util::get_message_id", "[util]") {
+    static const boost::regex UUID_V4 {
+        "[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}"};
+
+    SECTION("returns version 4 UUIDs") {
+        for (int idx = 0; idx < 100; idx++)
+            REQUIRE(boost::regex_match(util::get_message_id(), UUID_V4));
+    }
+
+    SECTION("returns unique IDs across threads") {
+        std::mutex mtx {};
+        std::set<std::string> ids {};
+        std::vector<std::thread> threads {};
+
+        for (int t_idx = 0; t_idx < 4; t_idx++) {
+            threads.push_back(std::thread([&]() {
+                std::vector<std::string> local_ids {};
+
+                for (int idx = 0; idx < 10000; idx++)
+                    local_ids.push_back(util::get_message_id());
+
+                std::lock_guard<std::mutex> the_lock {mtx};
+                ids.insert(local_ids.begin(), local_ids.end());
+            }));
+        }
+
+        for (auto& t : threads)
+            t.join();
+
+        REQUIRE(ids.size() == 40000);
+    }
+}
+
+SCENARIO("util::get_ISO8601_time", "[util]") {
+    static const boost::regex ISO8601_UTC {
+        "[0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9]{2}:[0-9]{2}:[0-9]{2}Z"};
+
+    REQUIRE(boost::regex_match(util::get_ISO8601_time(), ISO8601_UTC));
+}
+
+}  // namespace pcp_test